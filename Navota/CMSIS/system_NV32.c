@@ -4,11 +4,58 @@
 #include "NV32_wdog.h"
 #include "NV32_ics.h"
 #include "NV32_sim.h"
+#include "NV32_vector.h"
+#include "NV32_clkmgr.h"
+#include "NV32_flltrim.h"
 
 #pragma location = "NV"
 __root const NV_Type NV = {
   NV_BACKKEY, 0xFF, 0xFF, 0xFF, 0xFF, NV_EEPROT, NV_FPROT, NV_FSEC, NV_FOPT };
 
+/* IRC reference clock, FEI : 37.5K * 1280 = 48 MHz */
+#define IRC_CLK_FREQ_HZ           ( 37500L )
+
+/* FLL reference divider set by ICS_SetClkDivider for EXTAL_CLK_FREQ_KHZ,
+ * the low range divides by 1, the high range by 32 ~ 1024 */
+#if ( EXTAL_CLK_FREQ_KHZ < 4000 )
+#define EXTAL_RDIV                ( 0 )
+#define EXTAL_RDIV_VALUE          ( 1 )
+#elif ( EXTAL_CLK_FREQ_KHZ <= 5120 )
+#define EXTAL_RDIV                ( 2 )
+#define EXTAL_RDIV_VALUE          ( 128 )
+#elif ( EXTAL_CLK_FREQ_KHZ <= 10240 )
+#define EXTAL_RDIV                ( 3 )
+#define EXTAL_RDIV_VALUE          ( 256 )
+#elif ( EXTAL_CLK_FREQ_KHZ <= 20480 )
+#define EXTAL_RDIV                ( 4 )
+#define EXTAL_RDIV_VALUE          ( 512 )
+#else
+#define EXTAL_RDIV                ( 5 )
+#define EXTAL_RDIV_VALUE          ( 1024 )
+#endif
+
+/* core clock after SystemInit, computed as SystemCoreClockUpdate does */
+#if ( FAST_BOOT_DEFER_CLOCK > 0 )
+#define SYSTEM_BOOT_CLOCK         ( IRC_CLK_FREQ_HZ * 1280 / 2 )
+#elif ( EXTAL_CLK_FREQ_KHZ == 0 )
+#if ( FLL_BYPASSED == 0 )
+#define SYSTEM_BOOT_CLOCK         ( IRC_CLK_FREQ_HZ * 1280 )
+#else
+#define SYSTEM_BOOT_CLOCK         ( IRC_CLK_FREQ_HZ )
+#endif
+#elif ( FLL_BYPASSED == 0 )
+#define SYSTEM_BOOT_CLOCK         ( EXTAL_CLK_FREQ_KHZ * 1000L * 10 / EXTAL_RDIV_VALUE * 128 )
+#else
+#define SYSTEM_BOOT_CLOCK         ( EXTAL_CLK_FREQ_KHZ * 1000L )
+#endif
+
+/* C3 and C4 SCFTRIM after SystemInit, ICS_DeInit leaves 0x54 untrimmed */
+#if ( ICS_TRIM_ENABLED > 0 )
+#define SYSTEM_BOOT_TRIM          ( FLLTRIM_Load( ) )
+#else
+#define SYSTEM_BOOT_TRIM          ( 0x054 )
+#endif
+
 /**
  * @brief System clock frequency (core clock)
  *
@@ -17,8 +64,157 @@ __root const NV_Type NV = {
  * SysTick timer or configure other parameters. It may also be used by debugger to
  * query the frequency of the debug timer or configure the trace clock speed
  * SystemCoreClock is initialized with a correct predefined value.
+ *
+ * SystemInit runs before the C startup initializes the data, so the value
+ * seen by main is this initializer. With FAST_BOOT_ENABLED it is computed
+ * from the clock configuration instead of taken from SYSTEM_CORE_CLOCK.
  */
+#if ( FAST_BOOT_ENABLED > 0 )
+uint32_t SystemCoreClock = SYSTEM_BOOT_CLOCK;
+#else
 uint32_t SystemCoreClock = SYSTEM_CORE_CLOCK;
+#endif
+
+/**
+ * @brief Fill the ICS configuration from NV32_config.h.
+ */
+static void SystemClockConfig( ICS_ConfigType * pConfig )
+{
+#if  (EXTAL_CLK_FREQ_KHZ == 0)              /* Uses IRC */
+
+  /* reference clock frequency in KHz; use value 32 for 31.25KHz to 39.0625KHz */
+  pConfig->u32ClkFreq = 32;
+
+#if ( FLL_BYPASSED == 0 )
+  pConfig->u8ClkMode = ICS_CLK_MODE_FEI; /* ICS to the default state */
+
+#elif ( FLL_ENABLED > 0 )
+  pConfig->u8ClkMode = ICS_CLK_MODE_FBI;
+
+#else
+  pConfig->u8ClkMode = ICS_CLK_MODE_FBILP;
+
+#endif
+
+#else // (EXTAL_CLK_FREQ_KHZ != 0)          /* Uses OSC */
+
+  /* reference clock frequency in KHz; use value 32 for 31.25KHz to 39.0625KHz */
+  pConfig->u32ClkFreq = EXTAL_CLK_FREQ_KHZ;
+  pConfig->oscConfig.bEnable = 1; /* enable OSC */
+
+#if ( EXTAL_CLK_FREQ_KHZ == XTAL_CLK_FREQ_KHZ )
+  pConfig->oscConfig.bIsCryst = 1; /* external passive crystal */
+#endif
+
+#if (OSC_STOP_ENABLED > 0 )
+  pConfig->oscConfig.bStopEnable = 1; /* enabled in stop mode */
+#endif
+
+#if (OSC_HIGH_GRAIN > 0)
+  pConfig->oscConfig.bGain = 1; /* high gain */
+#endif
+
+#if  (EXTAL_CLK_FREQ_KHZ >= 4000)
+  pConfig->oscConfig.bRange = 1; /* high range */
+#endif
+
+#if ( FLL_BYPASSED == 0 )
+
+#if ( EXTAL_CLK_FREQ_KHZ != XTAL_CLK_FREQ_KHZ )
+  pConfig->u8ClkMode = ICS_CLK_MODE_FEE_OSC; /* external active oscillator */
+#else
+  pConfig->u8ClkMode = ICS_CLK_MODE_FEE; /* external passive crystal */
+#endif
+
+#else // ( FLL_BYPASSED != 0 )
+
+#if ( FLL_ENABLED == 0 )
+  pConfig->u8ClkMode = ICS_CLK_MODE_FBELP;
+#elif ( EXTAL_CLK_FREQ_KHZ != XTAL_CLK_FREQ_KHZ )
+  pConfig->u8ClkMode = ICS_CLK_MODE_FBE_OSC; /* external active oscillator */
+#else
+  pConfig->u8ClkMode = ICS_CLK_MODE_FBE; /* external passive crystal */
+#endif
+
+#endif
+
+#endif
+}
+
+#if ( FAST_BOOT_ENABLED > 0 ) && ( FAST_BOOT_DEFER_CLOCK > 0 )
+/**
+ * @brief Check whether the ICS runs as after a reset: FEI, not low power,
+ *        the output divided by 2.
+ */
+static uint8_t SystemClockAtReset( void )
+{
+  return ( ( ICS->C1 & ( ICS_C1_CLKS_MASK | ICS_C1_IREFS_MASK ) ) == ICS_C1_IREFS_MASK ) &&
+         ( ( ICS->C2 & ( ICS_C2_BDIV_MASK | ICS_C2_LP_MASK ) ) == ICS_C2_BDIV( 1 ) );
+}
+#elif ( FAST_BOOT_ENABLED > 0 )
+/**
+ * @brief Check whether the ICS already runs in the state the full path of
+ *        SystemInit would leave: clock source and reference in C1, the FLL
+ *        reference divider when the FLL runs from the crystal, BDIV and LP
+ *        in C2, the trim in C3 and C4 SCFTRIM, the FLL locked and the
+ *        oscillator up.
+ *
+ * Every reset returns the ICS to FEI with the output divided by 2, so this
+ * holds only when SystemInit is entered again without a reset, e.g. from a
+ * bootloader which set up the same clock.
+ */
+static uint8_t SystemClockReady( ICS_ConfigType * pConfig )
+{
+  uint8_t  u8Mode = pConfig->u8ClkMode;
+  uint8_t  u8C1   = ICS_C1_IREFS_MASK;
+  uint8_t  u8C2   = ICS_C2_BDIV( 0 );
+  uint8_t  u8Mask = ICS_C1_CLKS_MASK | ICS_C1_IREFS_MASK;
+  uint16_t u16Trim = SYSTEM_BOOT_TRIM;
+
+  switch ( u8Mode )
+  {
+    case ICS_CLK_MODE_FEE:
+    case ICS_CLK_MODE_FEE_OSC:
+      u8C1    = ICS_C1_RDIV( EXTAL_RDIV );
+      u8Mask |= ICS_C1_RDIV_MASK;
+      break;
+
+    case ICS_CLK_MODE_FBILP:
+      u8C2 |= ICS_C2_LP_MASK;
+      /* fall through */
+    case ICS_CLK_MODE_FBI:
+      u8C1 |= ICS_C1_CLKS( 1 );
+      break;
+
+    case ICS_CLK_MODE_FBELP:
+      u8C2 |= ICS_C2_LP_MASK;
+      /* fall through */
+    case ICS_CLK_MODE_FBE:
+    case ICS_CLK_MODE_FBE_OSC:
+      u8C1 = ICS_C1_CLKS( 2 );
+      break;
+
+    default:
+      break;
+  }
+
+  if ( ( ( ICS->C1 & u8Mask ) != u8C1 ) ||
+       ( ( ICS->C2 & ( ICS_C2_BDIV_MASK | ICS_C2_LP_MASK ) ) != u8C2 ) ||
+       ( ICS->C3 != ( uint8_t )u16Trim ) ||
+       ( ( ICS->C4 & ICS_C4_SCFTRIM_MASK ) != ( ( u16Trim >> 8 ) & 0x01 ) ) )
+    return 0;
+
+  /* the FLL has to be locked */
+  if ( ( ( u8C1 & ICS_C1_CLKS_MASK ) == ICS_C1_CLKS( 0 ) ) && !( ICS->S & ICS_S_LOCK_MASK ) )
+    return 0;
+
+  /* an external reference has to be running */
+  if ( !( u8C1 & ICS_C1_IREFS_MASK ) && !( OSC->CR & OSC_CR_OSCINIT_MASK ) )
+    return 0;
+
+  return 1;
+}
+#endif
 
 /**
  * @brief Setup the microcontroller system.
@@ -29,14 +225,28 @@ uint32_t SystemCoreClock = SYSTEM_CORE_CLOCK;
  */
 void SystemInit( void )
 {
+#if ( BOOT_TIME_ENABLED > 0 )
+  /* count core clocks from here to SystemBootClocks in main */
+  SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL  = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+#endif
+
   extern uint32_t __vector_table;
   SCB->VTOR = (uint32_t) &__vector_table;
+#if ( VECTOR_IN_RAM > 0 )
+  /* copy to RAM, drivers install their handlers at run time */
+  VECTOR_Init( );
+#endif
 
   SIM_ConfigType sSIMConfig = {
     {
       0 }, 0 };
   ICS_ConfigType sICSConfig = {
     0 };
+#if ( FAST_BOOT_ENABLED > 0 ) && ( FAST_BOOT_DEFER_CLOCK > 0 ) && ( ICS_TRIM_ENABLED > 0 )
+  uint16_t u16Trim;
+#endif
 
 #if ( WDOG_ENABLED > 0 )
   /* Disable the watchdog ETMer but enable update */
@@ -77,74 +287,95 @@ void SystemInit( void )
 
   SIM_Init( &sSIMConfig ); /* initialize SIM */
 
-  /* initialize ICS to the default state : FEI @ 48 MHZ */
-  ICS_DeInit( );
+  SystemClockConfig( &sICSConfig );
+
+#if ( FAST_BOOT_ENABLED > 0 ) && ( FAST_BOOT_DEFER_CLOCK > 0 )
+  /* run on as after the reset, the divider by 2 keeps the core in range
+   * while the FLL locks, SystemClockComplete switches to the mode above */
+  if ( !SystemClockAtReset( ) )
+    ICS_DeInit( );
 
 #if (ICS_TRIM_ENABLED > 0 )
-  /* if not trimmed, do trim first */
-  ICS_Trim( ICS_TRIM_VALUE );
+  /* as ICS_Trim, without waiting for the FLL to lock again */
+  u16Trim = SYSTEM_BOOT_TRIM;
+  ICS->C3 = ( uint8_t )u16Trim;
+  ICS->C4 = ( ICS->C4 & ~( ICS_C4_SCFTRIM_MASK ) ) | ( ( u16Trim >> 8 ) & 0x01 );
 #endif
 
-#if  (EXTAL_CLK_FREQ_KHZ == 0)              /* Uses IRC */
-
-  /* reference clock frequency in KHz; use value 32 for 31.25KHz to 39.0625KHz */
-  sICSConfig.u32ClkFreq = 32;
-
-#if ( FLL_BYPASSED == 0 )
-  sICSConfig.u8ClkMode = ICS_CLK_MODE_FEI; /* ICS to the default state */
-
-#elif ( FLL_ENABLED > 0 )
-  sICSConfig.u8ClkMode = ICS_CLK_MODE_FBI;
+#if ( EXTAL_CLK_FREQ_KHZ != 0 )
+  /* start the crystal now, it settles while the application starts */
+  sICSConfig.oscConfig.bWaitInit = 0;
+  OSC_Init( &sICSConfig.oscConfig );
+#endif
 
+  return;
 #else
-  sICSConfig.u8ClkMode = ICS_CLK_MODE_FBILP;
 
+#if ( FAST_BOOT_ENABLED > 0 )
+  if ( SystemClockReady( &sICSConfig ) )
+    return;
 #endif
 
-#else // (EXTAL_CLK_FREQ_KHZ != 0)          /* Uses OSC */
-
-  /* reference clock frequency in KHz; use value 32 for 31.25KHz to 39.0625KHz */
-  sICSConfig.u32ClkFreq = EXTAL_CLK_FREQ_KHZ;
-  sICSConfig.oscConfig.bEnable = 1; /* enable OSC */
+  /* initialize ICS to the default state : FEI @ 48 MHZ */
+  ICS_DeInit( );
 
-#if (OSC_STOP_ENABLED > 0 )
-  sICSConfig.oscConfig.bStopEnable = 1; /* enabled in stop mode */
+#if (ICS_TRIM_ENABLED > 0 )
+  /* if not trimmed, do trim first, with the last auto-trim if stored */
+  ICS_Trim( FLLTRIM_Load( ) );
 #endif
 
-#if (OSC_HIGH_GRAIN > 0)
-  sICSConfig.oscConfig.bGain = 1; /* high gain */
-#endif
+  ICS_Init( &sICSConfig ); /* initialize ICS */
 
-#if  (EXTAL_CLK_FREQ_KHZ >= 4000)
-  sICSConfig.oscConfig.bRange = 1; /* high range */
+#if ( FAST_BOOT_ENABLED == 0 )
+  SystemCoreClockUpdate( );
 #endif
-
-#if ( FLL_BYPASSED == 0 )
-
-#if ( EXTAL_CLK_FREQ_KHZ != XTAL_CLK_FREQ_KHZ )
-  sICSConfig.u8ClkMode = ICS_CLK_MODE_FEE_OSC; /* external active oscillator */
-#else
-  sICSConfig.u8ClkMode = ICS_CLK_MODE_FEE; /* external passive crystal */
 #endif
+}
 
-#else // ( FLL_BYPASSED != 0 )
+#if ( FAST_BOOT_ENABLED > 0 ) && ( FAST_BOOT_DEFER_CLOCK > 0 )
+/**
+ * @brief Switch to the clock mode of NV32_config.h after a fast boot.
+ *
+ * Called by the application when it can wait for the FLL and the crystal,
+ * the clock manager updates SystemCoreClock and notifies the registered
+ * peripherals.
+ */
+void SystemClockComplete( void )
+{
+  ICS_ConfigType sICSConfig = {
+    0 };
 
-#if ( FLL_ENABLED == 0 )
-  sICSConfig.u8ClkMode = ICS_CLK_MODE_FBELP;
-#elif ( EXTAL_CLK_FREQ_KHZ != XTAL_CLK_FREQ_KHZ )
-  sICSConfig.u8ClkMode = ICS_CLK_MODE_FBE_OSC; /* external active oscillator */
-#else
-  sICSConfig.u8ClkMode = ICS_CLK_MODE_FBE; /* external passive crystal */
-#endif
+  SystemClockConfig( &sICSConfig );
+  sICSConfig.oscConfig.bWaitInit = 1;
 
-#endif
+  /* locked to the trim before the divider by 2 goes */
+  while ( !( ICS->S & ICS_S_LOCK_MASK ) )
+    ;
 
+  CLKMGR_SetMode( &sICSConfig, 0 );
+}
 #endif
 
-  ICS_Init( &sICSConfig ); /* initialize ICS */
+#if ( BOOT_TIME_ENABLED > 0 )
+/**
+ * @brief Core clocks since SystemInit, called first in main.
+ *
+ * The count starts after the reset sequence and the jump to Reset_Handler,
+ * and includes the C startup. A GPIO toggled here, timed against the RESET
+ * pin on a scope, gives the full reset to main time. The SysTick is
+ * stopped and left as after a reset, free for the application.
+ */
+uint32_t SystemBootClocks( void )
+{
+  uint32_t u32Clocks = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
 
-  SystemCoreClockUpdate( );
+  SysTick->CTRL = 0;
+  SysTick->LOAD = 0;
+  SysTick->VAL  = 0;
+
+  return u32Clocks;
 }
+#endif
 
 /**
  * @brief Updates the SystemCoreClock variable.
@@ -159,17 +390,17 @@ void SystemCoreClockUpdate( void )
   uint8_t IREFS = ICS->C1 & ICS_C1_IREFS_MASK;
   uint8_t RDIV = ( ICS->C1 & ICS_C1_RDIV_MASK ) >> ICS_C1_RDIV_SHIFT;  // 0 - 32, 1 - 64, 6 - 2048
   uint8_t BDIV = ( ICS->C2 & ICS_C2_BDIV_MASK ) >> ICS_C2_BDIV_SHIFT;  // 0 - 1, 1 - 2, 7 - 128
-  uint32_t RDIV_Val = 32;
+  uint32_t RDIV_Val = ( OSC->CR & OSC_CR_RANGE_MASK ) ? 32 : 1;  // low range : 1 - 128
 
-  SystemCoreClock = EXTAL_CLK_FREQ_KHZ;  // ⲿʱԴ
-  if ( SystemCoreClock == 0 )
-    SystemCoreClock = 32768;  // ڲʱԴ
+  SystemCoreClock = EXTAL_CLK_FREQ_KHZ * 1000;  // ⲿʱԴ
+  if ( CLKS == ICS_C1_CLKS( 1 ) )
+    SystemCoreClock = IRC_CLK_FREQ_HZ;  // ڲʱԴ
 
   if ( CLKS == ICS_C1_CLKS( 0 ) )  // FLL 
   {
     if ( IREFS )  // ѡڲοʱԴ
     {
-      SystemCoreClock = 48000000;  // 37500 * 1280
+      SystemCoreClock = IRC_CLK_FREQ_HZ * 1280;
     }
     else  // ѡⲿοʱԴ
     {
@@ -56,6 +56,18 @@ void SystemCoreClockUpdate (void);
 
 uint32_t SystemClockGet( ClockType_TypeDef ClockType );
 
+/**
+ * @brief Switch to the configured clock mode after a fast boot which
+ *        deferred the clock switch (FAST_BOOT_DEFER_CLOCK).
+ */
+void SystemClockComplete (void);
+
+/**
+ * @brief Core clocks from SystemInit to the call, first thing in main
+ *        (BOOT_TIME_ENABLED). Stops the SysTick.
+ */
+uint32_t SystemBootClocks (void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -601,6 +601,50 @@ extern "C" {
 #endif
 
 /*! @} End of BME_Utilities                                                   */
+
+/******************************************************************************
+* BME register operations used by the drivers
+*
+*//*! @addtogroup BME_Driver
+* @{
+*******************************************************************************/
+
+/*!
+ * @brief GPIO alias in the peripheral bridge, GPIOA/GPIOB at 0x400FF000 are
+ * outside of the BME space and decorated through 0x4000F000. The alias is
+ * that of the Kinetis parts the BME comes from and has not been verified on
+ * a NV32, which is why BME_ENABLED is 0 by default.
+ */
+#define BME_GPIO_ALIAS_OFFSET   0x000F0000u
+
+/*!
+ * @brief driver register updates, with BME_ENABLED each one is a single
+ * decorated store the BME turns into an atomic read-modify-write on the bus,
+ * so no interrupt masking is needed around shared registers. Without it they
+ * fall back to the plain read-modify-write sequences.
+ */
+#if BME_ENABLED
+#define BME_REG_SET(REG,MASK)       ( BME_OR( &( REG ) ) = ( MASK ) )                 /*!< REG |= MASK on 32-bit */
+#define BME_REG_CLEAR(REG,MASK)     ( BME_AND( &( REG ) ) = ~( uint32_t )( MASK ) )   /*!< REG &= ~MASK on 32-bit */
+#define BME_REG_SET_8b(REG,MASK)    ( BME_OR_8b( &( REG ) ) = ( MASK ) )              /*!< REG |= MASK on 8-bit */
+#define BME_REG_CLEAR_8b(REG,MASK)  ( BME_AND_8b( &( REG ) ) = ( uint8_t )~( MASK ) ) /*!< REG &= ~MASK on 8-bit */
+#define BME_REG_INSERT(REG,bit,width,VALUE)   \
+    ( BME_BITFIELD_INSERT( &( REG ), bit, width ) = ( VALUE ) )                     /*!< replace a bitfield, VALUE in place */
+#define BME_GPIO_SET(REG,MASK)      \
+    ( BME_OR( ( ( uint32_t )&( REG ) - BME_GPIO_ALIAS_OFFSET ) ) = ( MASK ) )           /*!< GPIO REG |= MASK */
+#define BME_GPIO_CLEAR(REG,MASK)    \
+    ( BME_AND( ( ( uint32_t )&( REG ) - BME_GPIO_ALIAS_OFFSET ) ) = ~( uint32_t )( MASK ) ) /*!< GPIO REG &= ~MASK */
+#else
+#define BME_REG_SET(REG,MASK)       ( ( REG ) |= ( MASK ) )
+#define BME_REG_CLEAR(REG,MASK)     ( ( REG ) &= ~( MASK ) )
+#define BME_REG_SET_8b(REG,MASK)    ( ( REG ) |= ( MASK ) )
+#define BME_REG_CLEAR_8b(REG,MASK)  ( ( REG ) &= ~( MASK ) )
+#define BME_REG_INSERT(REG,bit,width,VALUE)   \
+    ( ( REG ) = ( ( REG ) & ~( ( ( 1u << ( width ) ) - 1u ) << ( bit ) ) ) | ( VALUE ) )
+#define BME_GPIO_SET(REG,MASK)      ( ( REG ) |= ( MASK ) )
+#define BME_GPIO_CLEAR(REG,MASK)    ( ( REG ) &= ~( MASK ) )
+#endif
+/*! @} End of BME_Driver                                                      */
 #ifdef __cplusplus
 }
 #endif
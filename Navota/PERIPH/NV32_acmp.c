@@ -9,6 +9,8 @@
 ******************************************************************************/
 #include "NV32_config.h"
 #include "NV32_acmp.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
 /******************************************************************************
 * Global variables
 ******************************************************************************/
@@ -24,21 +26,55 @@
 /******************************************************************************
 * Local function prototypes
 ******************************************************************************/
+#ifdef ACMP0_STATIC_CALLBACK
+void ACMP0_STATIC_CALLBACK( void );
+#else
+void ACMP0_Isr( void );
+#endif
+#ifdef ACMP1_STATIC_CALLBACK
+void ACMP1_STATIC_CALLBACK( void );
+#else
+void ACMP1_Isr( void );
+#endif
 
 /******************************************************************************
 * Local variables
 ******************************************************************************/
 
+#if !defined( ACMP0_STATIC_CALLBACK ) || !defined( ACMP1_STATIC_CALLBACK )
 ACMP_CallbackPtr ACMP_Callback[2] = {( ACMP_CallbackPtr )NULL};
+#endif
 
 /******************************************************************************
 * Local functions
 ******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  ACMP isr body, shared by the static and the dynamic handler.
+*
+* @param  u8Id         ISRSTAT_ACMP0 or ISRSTAT_ACMP1.
+* @param  pfnCallback  callback routine, a constant in the static handler.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE void ACMP_Isr( uint8_t u8Id, ACMP_CallbackPtr pfnCallback )
+{
+  ISRSTAT_ENTER( u8Id );
+  if ( pfnCallback )
+  {
+    pfnCallback();                  /* call callback routine */
+  }
+
+  ISRSTAT_EXIT( u8Id );
+}
+
 /******************************************************************************
 * Global functions
 ******************************************************************************/
-void ACMP0_Isr( void );
-void ACMP1_Isr( void );
 
 /******************************************************************************
 * ACMP api list.
@@ -171,11 +207,28 @@ void ACMP_SetCallback( ACMP_Type * pACMPx, ACMP_CallbackPtr pfnCallback )
 {
   if ( ACMP0 == pACMPx )
   {
+#ifdef ACMP0_STATIC_CALLBACK
+    /* bound at link time, ACMP0_IRQHandler calls ACMP0_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == ACMP0_STATIC_CALLBACK ) );
+#else
     ACMP_Callback[0] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    /* ACMP0_Isr only calls the callback, vector to it directly */
+    VECTOR_Install( ACMP0_IRQn, VECTOR_DIRECT( pfnCallback, ACMP0_Isr ) );
+#endif
+#endif
   }
   else
   {
+#ifdef ACMP1_STATIC_CALLBACK
+    /* bound at link time, ACMP1_IRQHandler calls ACMP1_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == ACMP1_STATIC_CALLBACK ) );
+#else
     ACMP_Callback[1] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( ACMP1_IRQn, VECTOR_DIRECT( pfnCallback, ACMP1_Isr ) );
+#endif
+#endif
   }
 }
 
@@ -193,13 +246,17 @@ void ACMP_SetCallback( ACMP_Type * pACMPx, ACMP_CallbackPtr pfnCallback )
 * @ Pass/ Fail criteria: none.
 *
 *****************************************************************************/
+#ifdef ACMP0_STATIC_CALLBACK
+void ACMP0_IRQHandler( void )
+{
+  ACMP_Isr( ISRSTAT_ACMP0, ACMP0_STATIC_CALLBACK );
+}
+#else
 void ACMP0_Isr( void )
 {
-  if ( ACMP_Callback[0] )
-  {
-    ACMP_Callback[0]();             /* call callback routine */
-  }
+  ACMP_Isr( ISRSTAT_ACMP0, ACMP_Callback[0] );
 }
+#endif
 
 /*****************************************************************************//*!
 *
@@ -212,12 +269,16 @@ void ACMP0_Isr( void )
 * @ Pass/ Fail criteria: none.
 *
 *****************************************************************************/
+#ifdef ACMP1_STATIC_CALLBACK
+void ACMP1_IRQHandler( void )
+{
+  ACMP_Isr( ISRSTAT_ACMP1, ACMP1_STATIC_CALLBACK );
+}
+#else
 void ACMP1_Isr( void )
 {
-  if ( ACMP_Callback[1] )
-  {
-    ACMP_Callback[1]();             /* call callback routine */
-  }
+  ACMP_Isr( ISRSTAT_ACMP1, ACMP_Callback[1] );
 }
+#endif
 
 
@@ -7,10 +7,17 @@
 ******************************************************************************/
 #include "NV32_config.h"
 #include "NV32_adc.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
+#include "NV32_BME.h"
 /******************************************************************************
 * Local function
 ******************************************************************************/
+#ifdef ADC_STATIC_CALLBACK
+void ADC_STATIC_CALLBACK( void );
+#else
 ADC_CallbackType ADC_Callback[1] = {NULL};
+#endif
 /******************************************************************************
 * Local variables
 ******************************************************************************/
@@ -18,6 +25,7 @@ ADC_CallbackType ADC_Callback[1] = {NULL};
 /******************************************************************************
 * Local function prototypes
 ******************************************************************************/
+void ADC_Isr( void );
 
 /******************************************************************************
 * define ADC APIs
@@ -183,7 +191,16 @@ unsigned int ADC_PollRead( ADC_Type * pADC, uint8_t u8Channel )
    *****************************************************************************/
 void ADC_SetCallBack( ADC_CallbackType pADC_CallBack )
 {
+#ifdef ADC_STATIC_CALLBACK
+  /* bound at link time, ADC0_IRQHandler calls ADC_STATIC_CALLBACK */
+  ASSERT( ( pADC_CallBack == NULL ) || ( pADC_CallBack == ADC_STATIC_CALLBACK ) );
+#else
   ADC_Callback[0] = pADC_CallBack;
+#if ( VECTOR_IN_RAM > 0 )
+  /* ADC_Isr only calls the callback, vector to it directly */
+  VECTOR_Install( ADC0_IRQn, VECTOR_DIRECT( pADC_CallBack, ADC_Isr ) );
+#endif
+#endif
 }
 
 /*****************************************************************************//*!
@@ -199,10 +216,7 @@ void ADC_SetCallBack( ADC_CallbackType pADC_CallBack )
    *****************************************************************************/
 void ADC_SetChannel( ADC_Type * pADC, uint8_t u8Channel )
 {
-  uint32_t u32temp;
-  u32temp = pADC->SC1;
-  u32temp &= ~ADC_SC1_ADCH_MASK;
-  pADC->SC1 = u32temp | ADC_SC1_ADCH( u8Channel );
+  BME_REG_INSERT( pADC->SC1, ADC_SC1_ADCH_SHIFT, 5, ADC_SC1_ADCH( u8Channel ) );
 }
 /*****************************************************************************//*!
    *
@@ -255,10 +269,7 @@ void ADC_SelectClockDivide( ADC_Type * pADC, uint8_t u8Div )
    *****************************************************************************/
 void ADC_SetMode( ADC_Type * pADC, uint8_t u8Mode )
 {
-  uint32_t u32Temp;
-  u32Temp = pADC->SC3;
-  u32Temp &= ~ADC_SC3_MODE_MASK;
-  pADC->SC3 = u32Temp | ADC_SC3_MODE( u8Mode );
+  BME_REG_INSERT( pADC->SC3, ADC_SC3_MODE_SHIFT, 2, ADC_SC3_MODE( u8Mode ) );
 }
 /*****************************************************************************//*!
    *
@@ -311,14 +322,26 @@ void ADC_SetFifoLevel( ADC_Type * pADC, uint8_t u8FifoLevel )
    *
    * @ Pass/ Fail criteria: none.
    *****************************************************************************/
+#ifdef ADC_STATIC_CALLBACK
+void ADC0_IRQHandler( void )
+{
+  ISRSTAT_ENTER( ISRSTAT_ADC );
+  ADC_STATIC_CALLBACK();
+  ISRSTAT_EXIT( ISRSTAT_ADC );
+}
+#else
 void ADC_Isr( void )
 {
+  ISRSTAT_ENTER( ISRSTAT_ADC );
   //  printf("input any character to start a new conversion!\n");
   if ( ADC_Callback[0] )
   {
     ADC_Callback[0]();
   }
+
+  ISRSTAT_EXIT( ISRSTAT_ADC );
 }
+#endif
 
 
 
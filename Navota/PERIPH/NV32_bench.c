@@ -0,0 +1,413 @@
+/******************************************************************************
+* @brief providing APIs for driver micro-benchmark harness (BENCH).
+*
+*******************************************************************************
+*
+* BENCH_Run calls the code under test N times with interrupts disabled and
+* times every call with the SysTick on the core clock. The cost of the
+* timing itself, measured on an empty case first, is taken out, so a case
+* reports the clocks of its own body. The SysTick is borrowed and given
+* back: a running SysTick on the core clock resumes with its count less the
+* clocks of the runs, and a tick that fell due meanwhile is pended, later
+* ones are lost as with any masked stretch. One on the external reference
+* restarts its period.
+*
+* BENCH_Report prints one CSV line per case:
+*
+*   bench,<name>,<runs>,<min>,<median>,<max>,<bytes>,<bytes per 1000 clocks>
+*
+* so logs of two revisions can be diffed or compared by a script. The
+* suite covers the driver hot paths (UART_PutChar, SPI_TransferWait,
+* CRC_Cal32, GPIO_PinToggle, Flash_Program, ADC_PollRead), the
+* GPIO_PIN_TOGGLE macro against GPIO_PinToggle, BME stores against
+* read-modify-write and PBUS write throughput.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_bench.h"
+#include "NV32_gpio.h"
+#include "NV32_BME.h"
+#include "NV32_crc.h"
+#include "NV32_adc.h"
+#include "NV32_flash.h"
+#include "NV32_pbus.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define BENCH_BLOCK             64          /*!< bytes per block case */
+#define BENCH_SPI_BLOCK         16          /*!< bytes per SPI_TransferWait case */
+#define BENCH_FLASH_BLOCK       8           /*!< bytes per Flash_Program case */
+#define BENCH_BME_BIT           0x80000000u /*!< CRC GPOLY bit, 0 in the CRC-32 polynomial */
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static uint8_t  BENCH_u8Block[BENCH_BLOCK];
+static uint8_t  BENCH_u8Rx[BENCH_SPI_BLOCK];
+static uint8_t  BENCH_u8Channel;
+static uint32_t BENCH_u32Flash;
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  time one call in core clocks with the running SysTick.
+*
+* @param[in]    pfnCase     code under test.
+* @param[in]    pParam      parameter of the code under test.
+*
+* @return core clocks, harness overhead included.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t BENCH_Time( BENCH_FuncType pfnCase, void * pParam )
+{
+  uint32_t u32Start = SysTick->VAL;
+  pfnCase( pParam );
+  return ( u32Start - SysTick->VAL ) & SysTick_LOAD_RELOAD_Msk;
+}
+
+static void BENCH_Empty( void * pParam )
+{
+}
+
+static void BENCH_UartPutChar( void * pParam )
+{
+  UART_PutChar( ( UART_Type * )pParam, ' ' );
+}
+
+static void BENCH_SpiTransfer( void * pParam )
+{
+  SPI_TransferWait( ( SPI_Type * )pParam, BENCH_u8Rx, BENCH_u8Block, BENCH_SPI_BLOCK );
+}
+
+static void BENCH_Crc32( void * pParam )
+{
+  CRC_Cal32( 0xFFFFFFFF, BENCH_u8Block, BENCH_BLOCK );
+}
+
+/* two toggles, the pin ends as it was */
+static void BENCH_GpioToggleFunction( void * pParam )
+{
+  GPIO_PinToggle( BENCH_GPIO_PIN );
+  GPIO_PinToggle( BENCH_GPIO_PIN );
+}
+
+static void BENCH_GpioToggleMacro( void * pParam )
+{
+  GPIO_PIN_TOGGLE( BENCH_GPIO_PIN );
+  GPIO_PIN_TOGGLE( BENCH_GPIO_PIN );
+}
+
+/* set and clear a bit, the register ends as it was */
+static void BENCH_BmeSetClear( void * pParam )
+{
+  BME_OR( &CRC0->GPOLY )  = BENCH_BME_BIT;
+  BME_AND( &CRC0->GPOLY ) = ~BENCH_BME_BIT;
+}
+
+static void BENCH_RmwSetClear( void * pParam )
+{
+  CRC0->GPOLY |= BENCH_BME_BIT;
+  CRC0->GPOLY &= ~BENCH_BME_BIT;
+}
+
+static void BENCH_AdcPollRead( void * pParam )
+{
+  ADC_PollRead( ADC, BENCH_u8Channel );
+}
+
+static void BENCH_FlashProgram( void * pParam )
+{
+  Flash_Program( BENCH_u32Flash, BENCH_u8Block, BENCH_FLASH_BLOCK );
+  BENCH_u32Flash += BENCH_FLASH_BLOCK;
+}
+
+static void BENCH_PbusWriteData( void * pParam )
+{
+  PBUS_WriteData( BENCH_u8Block, BENCH_BLOCK );
+}
+
+static void BENCH_PbusWriteRepeat( void * pParam )
+{
+  PBUS_WriteRepeat( 0x55AA, BENCH_BLOCK / 2 );
+}
+
+static void BENCH_PutString( UART_Type * pUART, const char * pString )
+{
+  while ( *pString )
+  {
+    UART_PutChar( pUART, *pString++ );
+  }
+}
+
+static void BENCH_PutDec( UART_Type * pUART, uint32_t u32Value )
+{
+  char    cDigit[10];
+  uint8_t i = 0;
+
+  do
+  {
+    cDigit[i++] = '0' + u32Value % 10;
+    u32Value /= 10;
+  }
+  while ( u32Value );
+
+  while ( i )
+  {
+    UART_PutChar( pUART, cDigit[--i] );
+  }
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* BENCH api lists
+*
+*//*! @addtogroup bench_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  run a benchmark case, interrupts are disabled during the runs.
+*         A case is at most 2^24 core clocks.
+*
+* @param[in]    pfnCase     code under test.
+* @param[in]    pParam      parameter of the code under test.
+* @param[in]    u32Bytes    bytes moved per call, for the throughput.
+* @param[in]    u32Runs     number of calls, 1 ~ BENCH_RUNS_MAX.
+* @param[out]   pResult     min, median and max core clocks of a call.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void BENCH_Run( BENCH_FuncType pfnCase, void * pParam, uint32_t u32Bytes, uint32_t u32Runs, BENCH_ResultType * pResult )
+{
+  uint32_t   u32Sample[BENCH_RUNS_MAX];
+  uint32_t   u32Overhead = SysTick_LOAD_RELOAD_Msk;
+  uint32_t   u32Cycles;
+  uint32_t   u32Ctrl;
+  uint32_t   u32Load;
+  uint32_t   u32Val;
+  uint32_t   i;
+  uint32_t   j;
+  __istate_t interrupt_state;
+  ASSERT( ( u32Runs != 0 ) && ( u32Runs <= BENCH_RUNS_MAX ) );
+
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  u32Ctrl = SysTick->CTRL;
+  u32Load = SysTick->LOAD;
+  u32Val  = SysTick->VAL;
+  SysTick->CTRL = 0;
+  SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL  = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+  for ( i = 0; i < 4; i++ )
+  {
+    u32Cycles = BENCH_Time( BENCH_Empty, NULL );
+
+    if ( u32Cycles < u32Overhead )
+    {
+      u32Overhead = u32Cycles;
+    }
+  }
+
+  /* insertion sort as the samples come */
+  for ( i = 0; i < u32Runs; i++ )
+  {
+    u32Cycles = BENCH_Time( pfnCase, pParam );
+    u32Cycles = ( u32Cycles > u32Overhead ) ? u32Cycles - u32Overhead : 0;
+
+    for ( j = i; ( j > 0 ) && ( u32Sample[j - 1] > u32Cycles ); j-- )
+    {
+      u32Sample[j] = u32Sample[j - 1];
+    }
+
+    u32Sample[j] = u32Cycles;
+  }
+
+  u32Cycles = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+  SysTick->CTRL = 0;
+
+  if ( u32Ctrl & SysTick_CTRL_ENABLE_Msk )
+  {
+    if ( !( u32Ctrl & SysTick_CTRL_CLKSOURCE_Msk ) )
+    {
+      u32Val = u32Load + 1;
+    }
+    else if ( u32Cycles >= u32Val )
+    {
+      /* the tick fell due during the runs */
+      if ( u32Ctrl & SysTick_CTRL_TICKINT_Msk )
+      {
+        SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+      }
+
+      u32Val = u32Load + 1 - ( u32Cycles - u32Val ) % ( u32Load + 1 );
+    }
+    else
+    {
+      u32Val -= u32Cycles;
+    }
+
+    /* VAL only clears, the rest of the period goes through LOAD once */
+    SysTick->LOAD = u32Val - 1;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = u32Ctrl & ~SysTick_CTRL_COUNTFLAG_Msk;
+  }
+
+  SysTick->LOAD = u32Load;
+  __set_interrupt_state( interrupt_state );
+
+  pResult->u32Runs   = u32Runs;
+  pResult->u32Min    = u32Sample[0];
+  pResult->u32Median = u32Sample[u32Runs / 2];
+  pResult->u32Max    = u32Sample[u32Runs - 1];
+  pResult->u32Bytes  = u32Bytes;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  print a result as a CSV line, the throughput is taken at the
+*         median.
+*
+* @param[in]    pUART       console.
+* @param[in]    pName       case name, without commas.
+* @param[in]    pResult     result of BENCH_Run.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void BENCH_Report( UART_Type * pUART, const char * pName, BENCH_ResultType * pResult )
+{
+  BENCH_PutString( pUART, "bench," );
+  BENCH_PutString( pUART, pName );
+  UART_PutChar( pUART, ',' );
+  BENCH_PutDec( pUART, pResult->u32Runs );
+  UART_PutChar( pUART, ',' );
+  BENCH_PutDec( pUART, pResult->u32Min );
+  UART_PutChar( pUART, ',' );
+  BENCH_PutDec( pUART, pResult->u32Median );
+  UART_PutChar( pUART, ',' );
+  BENCH_PutDec( pUART, pResult->u32Max );
+  UART_PutChar( pUART, ',' );
+  BENCH_PutDec( pUART, pResult->u32Bytes );
+  UART_PutChar( pUART, ',' );
+  BENCH_PutDec( pUART, pResult->u32Median ? pResult->u32Bytes * 1000 / pResult->u32Median : 0 );
+  BENCH_PutString( pUART, "\r\n" );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  run the driver suite and print a CSV header and one line per
+*         case. The CRC is set up for CRC-32 and BENCH_GPIO_PIN toggles
+*         twice per run. The flash sector at u32FlashAddress is erased
+*         before and after its case, which needs Flash_Init done.
+*
+* @param[in]    pConfig     suite configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void BENCH_RunSuite( BENCH_SuiteConfigType * pConfig )
+{
+  UART_Type        *pUART = pConfig->pUART;
+  uint32_t         u32Runs = pConfig->u32Runs;
+  BENCH_ResultType sResult;
+  CRC_ConfigType   sCRCConfig = {0};
+  uint32_t         i;
+
+  for ( i = 0; i < BENCH_BLOCK; i++ )
+  {
+    BENCH_u8Block[i] = ( i & 1 ) ? 0xAA : 0x55;
+  }
+
+  sCRCConfig.bWidth              = CRC_WIDTH_32BIT;
+  sCRCConfig.bTransposeReadType  = CRC_READ_TRANSPOSE_ALL;
+  sCRCConfig.bTransposeWriteType = CRC_WRITE_TRANSPOSE_BIT;
+  sCRCConfig.bFinalXOR           = CRC_READ_COMPLETE;
+  sCRCConfig.u32PolyData         = 0x04C11DB7;
+  CRC_Init( &sCRCConfig );
+
+  BENCH_PutString( pUART, "bench,name,runs,min,median,max,bytes,bytes_per_kclk\r\n" );
+
+  BENCH_Run( BENCH_GpioToggleFunction, NULL, 0, u32Runs, &sResult );
+  BENCH_Report( pUART, "gpio_toggle_x2_function", &sResult );
+
+  BENCH_Run( BENCH_GpioToggleMacro, NULL, 0, u32Runs, &sResult );
+  BENCH_Report( pUART, "gpio_toggle_x2_macro", &sResult );
+
+  BENCH_Run( BENCH_RmwSetClear, NULL, 0, u32Runs, &sResult );
+  BENCH_Report( pUART, "set_clear_rmw", &sResult );
+
+  BENCH_Run( BENCH_BmeSetClear, NULL, 0, u32Runs, &sResult );
+  BENCH_Report( pUART, "set_clear_bme", &sResult );
+
+  BENCH_Run( BENCH_Crc32, NULL, BENCH_BLOCK, u32Runs, &sResult );
+  BENCH_Report( pUART, "crc_cal32", &sResult );
+
+  BENCH_Run( BENCH_UartPutChar, pUART, 1, u32Runs, &sResult );
+  BENCH_Report( pUART, "uart_putchar", &sResult );
+
+  if ( pConfig->pSPI )
+  {
+    BENCH_Run( BENCH_SpiTransfer, pConfig->pSPI, BENCH_SPI_BLOCK, u32Runs, &sResult );
+    BENCH_Report( pUART, "spi_transferwait", &sResult );
+  }
+
+  if ( pConfig->u8AdcChannel != BENCH_NONE )
+  {
+    BENCH_u8Channel = pConfig->u8AdcChannel;
+
+    BENCH_Run( BENCH_AdcPollRead, NULL, 0, u32Runs, &sResult );
+    BENCH_Report( pUART, "adc_pollread", &sResult );
+  }
+
+  if ( pConfig->u32FlashAddress )
+  {
+    ASSERT( u32Runs * BENCH_FLASH_BLOCK <= FLASH_SECTOR_SIZE );
+    BENCH_u32Flash = pConfig->u32FlashAddress;
+    Flash_EraseSector( BENCH_u32Flash );
+
+    BENCH_Run( BENCH_FlashProgram, NULL, BENCH_FLASH_BLOCK, u32Runs, &sResult );
+    BENCH_Report( pUART, "flash_program", &sResult );
+
+    Flash_EraseSector( pConfig->u32FlashAddress );
+  }
+
+  if ( pConfig->bPbus )
+  {
+    BENCH_Run( BENCH_PbusWriteData, NULL, BENCH_BLOCK, u32Runs, &sResult );
+    BENCH_Report( pUART, "pbus_writedata", &sResult );
+
+    BENCH_Run( BENCH_PbusWriteRepeat, NULL, BENCH_BLOCK, u32Runs, &sResult );
+    BENCH_Report( pUART, "pbus_writerepeat", &sResult );
+  }
+}
+/*! @} End of bench_api_list                                                  */
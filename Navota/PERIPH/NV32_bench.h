@@ -0,0 +1,92 @@
+/******************************************************************************
+* @brief header file for driver micro-benchmark harness (BENCH).
+*
+*******************************************************************************
+*
+* provide APIs for timing driver hot paths in core clocks with the SysTick
+* and reporting min/median/max as CSV lines over UART
+******************************************************************************/
+#ifndef __NV32_BENCH_H__
+#define __NV32_BENCH_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_uart.h"
+#include "NV32_spi.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define BENCH_RUNS_MAX          32          /*!< samples kept for the median */
+#define BENCH_NONE              0xFF        /*!< suite case not configured */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* BENCH configure struct.
+*
+*//*! @addtogroup bench_configstruct
+* @{
+*******************************************************************************/
+/*! @brief code under test, called once per run with interrupts disabled */
+typedef void ( *BENCH_FuncType )( void * pParam );
+
+/*!
+* @brief result of a benchmark, core clocks of one call with the harness
+*        overhead taken out.
+*/
+typedef struct
+{
+  uint32_t      u32Runs;
+  uint32_t      u32Min;
+  uint32_t      u32Median;
+  uint32_t      u32Max;
+  uint32_t      u32Bytes;               /*!< bytes moved per call, 0 if not a transfer */
+} BENCH_ResultType, *BENCH_ResultPtr;
+
+/*!
+* @brief driver suite configure struct, the peripherals are initialized by
+*        the application.
+*/
+typedef struct
+{
+  UART_Type     *pUART;                 /*!< report console, also timed by UART_PutChar */
+  SPI_Type      *pSPI;                  /*!< SPI master for SPI_TransferWait, or NULL */
+  uint8_t       u8AdcChannel;           /*!< channel for ADC_PollRead, or BENCH_NONE */
+  uint8_t       bPbus;                  /*!< 1: PBUS_Init done, time PBUS writes */
+  uint32_t      u32FlashAddress;        /*!< spare flash sector for Flash_Program, or 0 */
+  uint32_t      u32Runs;                /*!< runs per case, up to BENCH_RUNS_MAX */
+} BENCH_SuiteConfigType, *BENCH_SuiteConfigPtr;
+/*! @} End of bench_configstruct                                              */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void BENCH_Run( BENCH_FuncType pfnCase, void * pParam, uint32_t u32Bytes, uint32_t u32Runs, BENCH_ResultType * pResult );
+void BENCH_Report( UART_Type * pUART, const char * pName, BENCH_ResultType * pResult );
+void BENCH_RunSuite( BENCH_SuiteConfigType * pConfig );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_BENCH_H__ */
@@ -0,0 +1,912 @@
+/******************************************************************************
+* @brief providing APIs for A/B firmware update and bootloader (BOOT).
+*
+*******************************************************************************
+*
+* The bootloader owns the flash below BOOT_SLOT_A_ADDRESS, with the flash
+* configuration field and the control sector at BOOT_CONTROL_ADDRESS. Two
+* application slots follow, an image is linked for the slot it goes to
+* (NV32F100_SlotA.icf or NV32F100_SlotB.icf). SystemInit points VTOR at
+* the vector table of the image it belongs to.
+*
+* BOOT_Receive takes an image over a UART into the slot not holding the
+* confirmed one. The slot is erased once the START frame tells the size,
+* before the host streams, since the code can not run while a sector is
+* erased. The host then keeps up to BOOT_WINDOW DATA frames in flight, the
+* receive interrupt puts them in a RAM ring while Flash_Program programs
+* the previous block. EFM_LaunchCMD masks the interrupts while a command
+* runs, the receive interrupt being in flash too, so a program command of
+* BOOT_PROGRAM_US must be shorter than the two characters the UART holds at
+* BOOT_BAUDRATE, which is checked below. No character comes while the slot
+* is erased, the host waits for the START acknowledge.
+* A frame is acknowledged once programmed, a bad or missing one is asked
+* again once and the host resends from there. The END frame is answered
+* with the throughput measured with the SysTick after the CRC-32 of the
+* whole slot, as CRC_Cal32 computes it, matched the START frame.
+*
+* The state is a record appended to the control sector, its last word
+* programmed last, so switching to a new image is one program command. A
+* new image is PENDING, BOOT_Select counts its starts in new records and
+* rolls back to the last CONFIRMED image after BOOT_TRIES starts without
+* BOOT_Confirm from the application, or when its CRC no longer matches.
+* A full control sector is erased keeping the last confirmed record, a
+* power fail during that erase leaves the image in slot A started without
+* a record, as the one programmed in production is.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_boot.h"
+#include "NV32_flash.h"
+#include "NV32_crc.h"
+
+#if ( BOOT_WINDOW * ( BOOT_BLOCK_SIZE + 8 ) > 1024 ) || ( BOOT_BLOCK_SIZE & 7 )
+#error "BOOT_WINDOW frames of BOOT_BLOCK_SIZE, a multiple of 8, must fit the 1024 bytes receive ring"
+#endif
+
+/* two longwords of 10 us per program command, two characters of 10 bits */
+#define BOOT_PROGRAM_US         20
+
+#if ( BOOT_PROGRAM_US * BOOT_BAUDRATE >= 2 * 10 * 1000000 )
+#error "BOOT_BAUDRATE too high, the UART overruns while a program command masks the interrupts"
+#endif
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define BOOT_TAG                0xB7
+#define BOOT_ERASED             0xFFFFFFFF
+#define BOOT_RECORDS            ( FLASH_SECTOR_SIZE / sizeof( BOOT_RecordType ) )
+#define BOOT_RAM_START          0x1FFFF800  /*!< initial stack pointer range of an image */
+#define BOOT_RAM_END            0x20001800
+
+#define BOOT_SOF                0xA5
+#define BOOT_FRAME_HEAD         6           /*!< SOF, type, sequence, length */
+#define BOOT_RING_SIZE          1024
+#define BOOT_RING_MASK          ( BOOT_RING_SIZE - 1 )
+#define BOOT_TIMEOUT_MS         2000        /*!< no frame this long closes the session */
+
+#define BOOT_FRAME_NONE         0           /*!< no complete frame yet */
+#define BOOT_FRAME_BAD          1           /*!< CRC, length or overrun error */
+
+#define BOOT_GET16(p)           ( ( uint16_t )( ( p )[0] | ( ( p )[1] << 8 ) ) )
+#define BOOT_UART_IRQ(uart)     ( ( IRQn_Type )( UART0_IRQn + ( ( ( uint32_t )( uart ) - UART0_BASE ) >> 12 ) ) )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+enum
+{
+  BOOT_PHASE_LISTEN = 0,      /*!< waiting for HELLO */
+  BOOT_PHASE_OPEN,            /*!< waiting for START */
+  BOOT_PHASE_DATA             /*!< slot erased, taking DATA and END */
+};
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static volatile uint8_t  BOOT_u8Ring[BOOT_RING_SIZE];
+static volatile uint32_t BOOT_u32Head;
+static volatile uint8_t  BOOT_bOverrun;
+static uint32_t          BOOT_u32Tail;
+
+/* the frame starts 2 bytes in, so its payload is word aligned for Flash_Program */
+static uint32_t          BOOT_u32Frame[( 2 + BOOT_FRAME_HEAD + BOOT_BLOCK_SIZE + 2 + 3 ) / 4];
+static uint8_t           *const BOOT_pu8Frame = ( uint8_t * )BOOT_u32Frame + 2;
+static uint16_t          BOOT_u16Got;       /*!< frame bytes so far */
+static uint16_t          BOOT_u16Need;      /*!< frame bytes in all */
+
+static uint32_t          BOOT_u32Last;      /*!< SysTick value at the last poll */
+static uint32_t          BOOT_u32Clocks;    /*!< core clocks since BOOT_ClockStart */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  count core clocks with the SysTick, which the bootloader owns.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void BOOT_ClockStart( void )
+{
+  SysTick->CTRL  = 0;
+  SysTick->LOAD  = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL   = 0;
+  SysTick->CTRL  = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+  BOOT_u32Last   = SysTick->VAL;
+  BOOT_u32Clocks = 0;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  core clocks since BOOT_ClockStart, polled at least once per
+*         SysTick period.
+*
+* @param  none.
+*
+* @return core clocks.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t BOOT_Clocks( void )
+{
+  uint32_t u32Now = SysTick->VAL;
+
+  /* the SysTick counts down over its full 24 bits */
+  BOOT_u32Clocks += ( BOOT_u32Last - u32Now ) & SysTick_LOAD_RELOAD_Msk;
+  BOOT_u32Last    = u32Now;
+
+  return BOOT_u32Clocks;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  set the CRC module up for the frames or for the image.
+*
+* @param[in]    bImage      TRUE: CRC-32 as zlib, FALSE: CRC-16/CCITT.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void BOOT_CrcInit( uint8_t bImage )
+{
+  CRC_ConfigType sCrc = {
+    0 };
+
+  if ( bImage )
+  {
+    /* reflected in and out, final complement, seed 0xFFFFFFFF */
+    sCrc.bWidth              = 1;
+    sCrc.bTransposeWriteType = CRC_WRITE_TRANSPOSE_BIT;
+    sCrc.bTransposeReadType  = CRC_READ_TRANSPOSE_ALL;
+    sCrc.bFinalXOR           = 1;
+    sCrc.u32PolyData         = 0x04C11DB7;
+  }
+  else
+  {
+    /* seed 0xFFFF */
+    sCrc.u32PolyData         = 0x1021;
+  }
+
+  CRC_Init( &sCrc );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  read a little endian word.
+*
+* @param[in]    pu8Data     first byte.
+*
+* @return the word.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t BOOT_Get32( const uint8_t * pu8Data )
+{
+  return pu8Data[0] | ( ( uint32_t )pu8Data[1] << 8 ) | ( ( uint32_t )pu8Data[2] << 16 ) |
+         ( ( uint32_t )pu8Data[3] << 24 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  write a little endian word.
+*
+* @param[out]   pu8Data     first byte.
+* @param[in]    u32Value    the word.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void BOOT_Put32( uint8_t * pu8Data, uint32_t u32Value )
+{
+  pu8Data[0] = ( uint8_t )u32Value;
+  pu8Data[1] = ( uint8_t )( u32Value >> 8 );
+  pu8Data[2] = ( uint8_t )( u32Value >> 16 );
+  pu8Data[3] = ( uint8_t )( u32Value >> 24 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  check that a slot starts with a vector table.
+*
+* @param[in]    u8Slot      BOOT_SLOT_A or BOOT_SLOT_B.
+*
+* @return TRUE when the stack pointer is in RAM and the reset handler in
+*         the slot.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t BOOT_Sane( uint8_t u8Slot )
+{
+  const uint32_t *pu32Vector = ( const uint32_t * )BOOT_SLOT_ADDRESS( u8Slot );
+
+  return ( pu32Vector[0] > BOOT_RAM_START ) && ( pu32Vector[0] <= BOOT_RAM_END ) &&
+         ( pu32Vector[1] > ( uint32_t )pu32Vector ) &&
+         ( pu32Vector[1] < ( uint32_t )pu32Vector + BOOT_SLOT_SIZE );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  check the image a record is for.
+*
+* @param[in]    pRecord     the record, size 0 for the image in slot A
+*                           without a record.
+*
+* @return TRUE when it can be started.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t BOOT_Verify( const BOOT_RecordType * pRecord )
+{
+  uint8_t bGood;
+
+  if ( !BOOT_Sane( pRecord->u8Slot ) || ( pRecord->u32Size > BOOT_SLOT_SIZE ) )
+  {
+    return FALSE;
+  }
+
+  if ( pRecord->u32Size == 0 )
+  {
+    return TRUE;
+  }
+
+  BOOT_CrcInit( TRUE );
+  bGood = ( CRC_Cal32( 0xFFFFFFFF, ( uint8_t * )BOOT_SLOT_ADDRESS( pRecord->u8Slot ),
+                       pRecord->u32Size ) == pRecord->u32Crc );
+  BOOT_CrcInit( FALSE );
+
+  return bGood;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  last complete record in a state.
+*
+* @param[in]    u8State     BOOT_STATE_PENDING, BOOT_STATE_CONFIRMED or 0
+*                           for any.
+* @param[out]   pu32Free    first erased record, BOOT_RECORDS when full.
+*                           May be NULL.
+*
+* @return the record in flash, NULL when none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static const BOOT_RecordType * BOOT_Find( uint8_t u8State, uint32_t * pu32Free )
+{
+  const BOOT_RecordType *pRecord = ( const BOOT_RecordType * )BOOT_CONTROL_ADDRESS;
+  const BOOT_RecordType *pFound  = NULL;
+  uint32_t              u32Free  = 0;
+  uint32_t              i;
+
+  for ( i = 0; i < BOOT_RECORDS; i++, pRecord++ )
+  {
+    if ( *( const uint32_t * )pRecord != BOOT_ERASED )
+    {
+      u32Free = i + 1;
+    }
+
+    if ( ( pRecord->u8Tag == BOOT_TAG ) && ( pRecord->u32Check == ~*( const uint32_t * )pRecord ) &&
+         ( ( u8State == 0 ) || ( pRecord->u8State == u8State ) ) )
+    {
+      pFound = pRecord;
+    }
+  }
+
+  if ( pu32Free != NULL )
+  {
+    *pu32Free = u32Free;
+  }
+
+  return pFound;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  program a record, its check word last.
+*
+* @param[in]    u32Index    erased record, 0 ~ BOOT_RECORDS - 1.
+* @param[in]    pRecord     the record, check word set.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void BOOT_Program( uint32_t u32Index, const BOOT_RecordType * pRecord )
+{
+  const uint32_t *pu32Word  = ( const uint32_t * )pRecord;
+  uint32_t       u32Address = BOOT_CONTROL_ADDRESS + u32Index * sizeof( BOOT_RecordType );
+
+  Flash_Program2LongWords( u32Address, pu32Word[0], pu32Word[1] );
+  Flash_Program2LongWords( u32Address + 8, pu32Word[2], pu32Word[3] );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  append a record, which is then in force.
+*
+* @param[in]    pRecord     slot, state, tries, size and CRC, the rest is
+*                           filled here.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void BOOT_Append( BOOT_RecordType * pRecord )
+{
+  const BOOT_RecordType *pGood;
+  BOOT_RecordType       sGood;
+  uint32_t              u32Free;
+
+  pRecord->u8Tag    = BOOT_TAG;
+  pRecord->u32Check = ~*( uint32_t * )pRecord;
+
+  BOOT_Find( 0, &u32Free );
+
+  if ( u32Free == BOOT_RECORDS )
+  {
+    pGood = BOOT_Find( BOOT_STATE_CONFIRMED, NULL );
+
+    if ( pGood != NULL )
+    {
+      sGood = *pGood;
+    }
+
+    Flash_EraseSector( BOOT_CONTROL_ADDRESS );
+    u32Free = 0;
+
+    if ( pGood != NULL )
+    {
+      BOOT_Program( u32Free++, &sGood );
+    }
+  }
+
+  BOOT_Program( u32Free, pRecord );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  the last confirmed image. The image in slot A without any
+*         confirmed record, as programmed in production, counts as one.
+*
+* @param[out]   pRecord     its record, size 0 for the image without one.
+*
+* @return TRUE when there is one.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t BOOT_Good( BOOT_RecordType * pRecord )
+{
+  const BOOT_RecordType *pGood = BOOT_Find( BOOT_STATE_CONFIRMED, NULL );
+
+  if ( pGood != NULL )
+  {
+    *pRecord = *pGood;
+    return TRUE;
+  }
+
+  pRecord->u8Slot  = BOOT_SLOT_A;
+  pRecord->u8State = BOOT_STATE_CONFIRMED;
+  pRecord->u8Tries = 0;
+  pRecord->u32Size = 0;
+  pRecord->u32Crc  = 0;
+
+  return BOOT_Sane( BOOT_SLOT_A );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  take the received bytes into the frame buffer.
+*
+* @param  none.
+*
+* @return frame type, BOOT_FRAME_NONE or BOOT_FRAME_BAD.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t BOOT_Poll( void )
+{
+  uint16_t u16Crc;
+  uint8_t  u8Byte;
+
+  if ( BOOT_bOverrun )
+  {
+    BOOT_bOverrun = FALSE;
+    BOOT_u32Tail  = BOOT_u32Head;
+    BOOT_u16Got   = 0;
+    return BOOT_FRAME_BAD;
+  }
+
+  while ( BOOT_u32Tail != BOOT_u32Head )
+  {
+    u8Byte = BOOT_u8Ring[BOOT_u32Tail++ & BOOT_RING_MASK];
+
+    if ( ( BOOT_u16Got == 0 ) && ( u8Byte != BOOT_SOF ) )
+    {
+      continue;                             /* hunt for the start of a frame */
+    }
+
+    BOOT_pu8Frame[BOOT_u16Got++] = u8Byte;
+
+    if ( BOOT_u16Got == BOOT_FRAME_HEAD )
+    {
+      BOOT_u16Need = BOOT_FRAME_HEAD + BOOT_GET16( &BOOT_pu8Frame[4] ) + 2;
+
+      if ( BOOT_u16Need > BOOT_FRAME_HEAD + BOOT_BLOCK_SIZE + 2 )
+      {
+        BOOT_u16Got = 0;
+        return BOOT_FRAME_BAD;
+      }
+    }
+    else if ( ( BOOT_u16Got > BOOT_FRAME_HEAD ) && ( BOOT_u16Got == BOOT_u16Need ) )
+    {
+      BOOT_u16Got = 0;
+      u16Crc = ( uint16_t )CRC_Cal16( 0xFFFF, &BOOT_pu8Frame[1], BOOT_u16Need - 3 );
+
+      if ( ( BOOT_pu8Frame[BOOT_u16Need - 2] != ( uint8_t )( u16Crc >> 8 ) ) ||
+           ( BOOT_pu8Frame[BOOT_u16Need - 1] != ( uint8_t )u16Crc ) )
+      {
+        return BOOT_FRAME_BAD;
+      }
+
+      return BOOT_pu8Frame[1];
+    }
+  }
+
+  return BOOT_FRAME_NONE;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  send a frame to the host.
+*
+* @param[in]    pUART       bootloader port.
+* @param[in]    u8Type      BOOT_FRAME_ACK or BOOT_FRAME_NAK.
+* @param[in]    u16Seq      sequence.
+* @param[in]    pu8Data     payload.
+* @param[in]    u8Length    payload bytes, up to 16.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void BOOT_Send( UART_Type * pUART, uint8_t u8Type, uint16_t u16Seq, const uint8_t * pu8Data,
+                       uint8_t u8Length )
+{
+  uint8_t  u8Frame[BOOT_FRAME_HEAD + 16 + 2];
+  uint16_t u16Crc;
+  uint8_t  i;
+
+  ASSERT( u8Length <= 16 );
+
+  u8Frame[0] = BOOT_SOF;
+  u8Frame[1] = u8Type;
+  u8Frame[2] = ( uint8_t )u16Seq;
+  u8Frame[3] = ( uint8_t )( u16Seq >> 8 );
+  u8Frame[4] = u8Length;
+  u8Frame[5] = 0;
+
+  for ( i = 0; i < u8Length; i++ )
+  {
+    u8Frame[BOOT_FRAME_HEAD + i] = pu8Data[i];
+  }
+
+  u16Crc = ( uint16_t )CRC_Cal16( 0xFFFF, &u8Frame[1], BOOT_FRAME_HEAD - 1 + u8Length );
+  u8Frame[BOOT_FRAME_HEAD + u8Length]     = ( uint8_t )( u16Crc >> 8 );
+  u8Frame[BOOT_FRAME_HEAD + u8Length + 1] = ( uint8_t )u16Crc;
+
+  UART_SendWait( pUART, u8Frame, BOOT_FRAME_HEAD + u8Length + 2 );
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  receive interrupt callback, bound with UART_SetCallback or as
+*         UART_STATIC_CALLBACK in the bootloader.
+*
+* @param[in]    pUART       bootloader port.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void BOOT_UartIsr( UART_Type * pUART )
+{
+  uint8_t u8Status = pUART->S1;
+  uint8_t u8Byte   = pUART->D;
+
+  if ( ( u8Status & UART_S1_OR_MASK ) || ( BOOT_u32Head - BOOT_u32Tail >= BOOT_RING_SIZE ) )
+  {
+    BOOT_bOverrun = TRUE;
+  }
+  else if ( u8Status & UART_S1_RDRF_MASK )
+  {
+    BOOT_u8Ring[BOOT_u32Head & BOOT_RING_MASK] = u8Byte;
+    BOOT_u32Head++;
+  }
+}
+
+/******************************************************************************
+* BOOT api lists
+*
+*//*! @addtogroup boot_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  bootloader main: listen BOOT_LISTEN_MS for a host, then start the
+*         application BOOT_Select chooses. Without one, or after an image
+*         was received, take images and reset, does not return.
+*
+* @param[in]    pUART       bootloader port, its pins routed by SystemInit.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void BOOT_Main( UART_Type * pUART )
+{
+  UART_ConfigType sUart;
+  BOOT_StatsType  sStats;
+  uint8_t         u8Slot;
+
+  sUart.u32SysClkHz = SystemClockGet( CLOCK_BUS );
+  sUart.u32Baudrate = BOOT_BAUDRATE;
+  UART_Init( pUART, &sUart );
+  Flash_Init();
+
+  if ( !BOOT_Receive( pUART, BOOT_LISTEN_MS, &sStats ) )
+  {
+    u8Slot = BOOT_Select();
+
+    if ( u8Slot != BOOT_NONE )
+    {
+      UART_WaitTxComplete( pUART );
+      BOOT_Jump( u8Slot );
+    }
+
+    while ( !BOOT_Receive( pUART, 0, &sStats ) );
+  }
+
+  UART_WaitTxComplete( pUART );
+  NVIC_SystemReset();
+}
+
+/*****************************************************************************//*!
+*
+* @brief  run an update session: HELLO, START, DATA frames and END.
+*
+* @param[in]    pUART       bootloader port, initialized.
+* @param[in]    u32ListenMs time to wait for HELLO, 0: no limit.
+* @param[out]   pStats      throughput of the session.
+*
+* @return TRUE when an image was verified and is pending, FALSE when no
+*         host came or the session broke off.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t BOOT_Receive( UART_Type * pUART, uint32_t u32ListenMs, BOOT_StatsType * pStats )
+{
+  BOOT_RecordType sRecord;
+  uint8_t         u8Reply[14];
+  uint8_t         *pu8Payload = &BOOT_pu8Frame[BOOT_FRAME_HEAD];
+  uint32_t        u32MsClocks = SystemCoreClock / 1000;
+  uint32_t        u32Idle     = 0;
+  uint32_t        u32Start    = 0;
+  uint32_t        u32Base     = 0;
+  uint32_t        u32Next     = 0;
+  uint32_t        u32Now;
+  uint16_t        u16Expect   = 0;
+  uint16_t        u16Seq;
+  uint16_t        u16Length;
+  uint8_t         u8Phase     = BOOT_PHASE_LISTEN;
+  uint8_t         u8Target;
+  uint8_t         bNaked      = FALSE;
+  uint8_t         bDone       = FALSE;
+
+  pStats->u32Bytes       = 0;
+  pStats->u32Clocks      = 0;
+  pStats->u32BytesPerSec = 0;
+  pStats->u16Naks        = 0;
+
+  sRecord.u32Size = 0;
+  sRecord.u32Crc  = 0;
+  u8Target        = BOOT_Good( &sRecord ) ? !sRecord.u8Slot : BOOT_SLOT_A;
+
+  BOOT_ClockStart();
+  BOOT_CrcInit( FALSE );
+  BOOT_u32Tail  = BOOT_u32Head;
+  BOOT_u16Got   = 0;
+  BOOT_bOverrun = FALSE;
+  UART_SetCallback( BOOT_UartIsr );
+  UART_EnableInterrupt( pUART, UART_RxBuffFullInt );
+  NVIC_EnableIRQ( BOOT_UART_IRQ( pUART ) );
+
+  while ( !bDone )
+  {
+    u32Now = BOOT_Clocks();
+
+    if ( ( u8Phase == BOOT_PHASE_LISTEN ) ? ( ( u32ListenMs > 0 ) && ( u32Now - u32Idle > u32ListenMs * u32MsClocks ) ) :
+         ( u32Now - u32Idle > BOOT_TIMEOUT_MS * u32MsClocks ) )
+    {
+      break;
+    }
+
+    switch ( BOOT_Poll() )
+    {
+      case BOOT_FRAME_NONE:
+        continue;
+
+      case BOOT_FRAME_BAD:
+        if ( ( u8Phase == BOOT_PHASE_DATA ) && !bNaked )
+        {
+          BOOT_Send( pUART, BOOT_FRAME_NAK, u16Expect, NULL, 0 );
+          pStats->u16Naks++;
+          bNaked = TRUE;
+        }
+
+        continue;
+
+      case BOOT_FRAME_HELLO:
+        /* target slot, window, block size and link address of the slot */
+        u8Reply[0] = u8Target;
+        u8Reply[1] = BOOT_WINDOW;
+        u8Reply[2] = ( uint8_t )BOOT_BLOCK_SIZE;
+        u8Reply[3] = ( uint8_t )( BOOT_BLOCK_SIZE >> 8 );
+        BOOT_Put32( &u8Reply[4], BOOT_SLOT_ADDRESS( u8Target ) );
+        BOOT_Send( pUART, BOOT_FRAME_ACK, 0, u8Reply, 8 );
+        u8Phase = BOOT_PHASE_OPEN;
+        break;
+
+      case BOOT_FRAME_START:
+        sRecord.u8Slot  = u8Target;
+        sRecord.u8State = BOOT_STATE_PENDING;
+        sRecord.u8Tries = 0;
+        sRecord.u32Size = BOOT_Get32( &pu8Payload[0] );
+        sRecord.u32Crc  = BOOT_Get32( &pu8Payload[4] );
+        u32Base         = BOOT_SLOT_ADDRESS( u8Target );
+
+        if ( ( u8Phase == BOOT_PHASE_LISTEN ) || ( BOOT_GET16( &BOOT_pu8Frame[4] ) != 12 ) ||
+             ( BOOT_Get32( &pu8Payload[8] ) != u32Base ) ||
+             ( sRecord.u32Size == 0 ) || ( sRecord.u32Size > BOOT_SLOT_SIZE ) )
+        {
+          BOOT_Send( pUART, BOOT_FRAME_NAK, 0, NULL, 0 );
+          break;
+        }
+
+        for ( u32Next = u32Base; u32Next < u32Base + sRecord.u32Size; u32Next += FLASH_SECTOR_SIZE )
+        {
+          Flash_EraseSector( u32Next );
+          BOOT_Clocks();
+        }
+
+        u32Next   = u32Base;
+        u16Expect = 0;
+        bNaked    = FALSE;
+        u8Phase   = BOOT_PHASE_DATA;
+        BOOT_Send( pUART, BOOT_FRAME_ACK, 0, NULL, 0 );
+        u32Start  = BOOT_Clocks();
+        break;
+
+      case BOOT_FRAME_DATA:
+        u16Seq    = BOOT_GET16( &BOOT_pu8Frame[2] );
+        u16Length = BOOT_GET16( &BOOT_pu8Frame[4] );
+
+        if ( u8Phase != BOOT_PHASE_DATA )
+        {
+          break;
+        }
+
+        if ( ( u16Seq == u16Expect ) && ( u16Length > 0 ) &&
+             ( u32Next + u16Length <= u32Base + sRecord.u32Size ) &&
+             ( !( u16Length & 7 ) || ( u32Next + u16Length == u32Base + sRecord.u32Size ) ) )
+        {
+          /* the next frames come in meanwhile */
+          Flash_Program( u32Next, pu8Payload, u16Length );
+          u32Next += u16Length;
+          u16Expect++;
+          bNaked = FALSE;
+          BOOT_Send( pUART, BOOT_FRAME_ACK, u16Seq, NULL, 0 );
+        }
+        else if ( ( uint16_t )( u16Expect - u16Seq - 1 ) < BOOT_WINDOW )
+        {
+          /* resent while the acknowledge was on its way */
+          BOOT_Send( pUART, BOOT_FRAME_ACK, u16Expect - 1, NULL, 0 );
+        }
+        else if ( !bNaked )
+        {
+          BOOT_Send( pUART, BOOT_FRAME_NAK, u16Expect, NULL, 0 );
+          pStats->u16Naks++;
+          bNaked = TRUE;
+        }
+
+        break;
+
+      case BOOT_FRAME_END:
+        if ( ( u8Phase != BOOT_PHASE_DATA ) || ( u32Next != u32Base + sRecord.u32Size ) ||
+             !BOOT_Verify( &sRecord ) )
+        {
+          BOOT_Send( pUART, BOOT_FRAME_NAK, u16Expect, NULL, 0 );
+          break;
+        }
+
+        BOOT_Append( &sRecord );
+
+        pStats->u32Bytes       = sRecord.u32Size;
+        pStats->u32Clocks      = BOOT_Clocks() - u32Start;
+        pStats->u32BytesPerSec = ( uint32_t )( ( uint64_t )pStats->u32Bytes * SystemCoreClock /
+                                               pStats->u32Clocks );
+        BOOT_Put32( &u8Reply[0], pStats->u32Bytes );
+        BOOT_Put32( &u8Reply[4], pStats->u32Clocks );
+        BOOT_Put32( &u8Reply[8], pStats->u32BytesPerSec );
+        u8Reply[12] = ( uint8_t )pStats->u16Naks;
+        u8Reply[13] = ( uint8_t )( pStats->u16Naks >> 8 );
+        BOOT_Send( pUART, BOOT_FRAME_ACK, u16Expect, u8Reply, 14 );
+        bDone = TRUE;
+        break;
+
+      default:
+        break;
+    }
+
+    u32Idle = BOOT_Clocks();
+  }
+
+  NVIC_DisableIRQ( BOOT_UART_IRQ( pUART ) );
+  UART_DisableInterrupt( pUART, UART_RxBuffFullInt );
+
+  return bDone;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  choose the application to start. A pending image is started up to
+*         BOOT_TRIES times, each start recorded, then or when its CRC fails
+*         the last confirmed image is recorded in force again.
+*
+* @param  none.
+*
+* @return BOOT_SLOT_A, BOOT_SLOT_B or BOOT_NONE.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t BOOT_Select( void )
+{
+  const BOOT_RecordType *pLast = BOOT_Find( 0, NULL );
+  BOOT_RecordType       sLast;
+  BOOT_RecordType       sGood;
+  uint8_t               bGood  = BOOT_Good( &sGood );
+
+  if ( ( pLast != NULL ) && ( pLast->u8State == BOOT_STATE_PENDING ) )
+  {
+    sLast = *pLast;
+
+    if ( ( sLast.u8Tries < BOOT_TRIES ) && BOOT_Verify( &sLast ) )
+    {
+      sLast.u8Tries++;
+      BOOT_Append( &sLast );
+      return sLast.u8Slot;
+    }
+
+    /* roll back */
+    if ( bGood )
+    {
+      BOOT_Append( &sGood );
+    }
+  }
+
+  if ( bGood && BOOT_Verify( &sGood ) )
+  {
+    return sGood.u8Slot;
+  }
+
+  return BOOT_NONE;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  start an application as from reset, but with the clocks the
+*         bootloader set (see FAST_BOOT_ENABLED) and the interrupts masked,
+*         the application unmasks them once set up. Does not return.
+*
+* @param[in]    u8Slot      BOOT_SLOT_A or BOOT_SLOT_B.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void BOOT_Jump( uint8_t u8Slot )
+{
+  const uint32_t *pu32Vector = ( const uint32_t * )BOOT_SLOT_ADDRESS( u8Slot );
+  uint32_t u32Stack         = pu32Vector[0];
+  void ( *pfnReset )( void ) = ( void ( * )( void ) )pu32Vector[1];
+
+  __disable_interrupt();
+  SysTick->CTRL  = 0;
+  NVIC->ICER[0]  = 0xFFFFFFFF;
+  NVIC->ICPR[0]  = 0xFFFFFFFF;
+  SIM->SCGC      = SIM_SCGC_FLASH_MASK | SIM_SCGC_SWD_MASK;
+  SCB->VTOR      = ( uint32_t )pu32Vector;
+  /* nothing on the old stack is read past here */
+  __set_MSP( u32Stack );
+  pfnReset();
+}
+
+/*****************************************************************************//*!
+*
+* @brief  confirm, from the application, that the running image works. Until
+*         then the bootloader counts its starts and rolls back.
+*
+* @param  none.
+*
+* @return TRUE when the running image is the confirmed one.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t BOOT_Confirm( void )
+{
+  extern uint32_t       __vector_table;
+  const BOOT_RecordType *pLast = BOOT_Find( 0, NULL );
+  BOOT_RecordType       sLast;
+  uint8_t               u8Slot;
+
+  u8Slot = ( ( uint32_t )&__vector_table == BOOT_SLOT_B_ADDRESS ) ? BOOT_SLOT_B : BOOT_SLOT_A;
+
+  if ( pLast == NULL )
+  {
+    return ( u8Slot == BOOT_SLOT_A );       /* programmed in production */
+  }
+
+  if ( pLast->u8Slot != u8Slot )
+  {
+    return FALSE;
+  }
+
+  if ( pLast->u8State == BOOT_STATE_PENDING )
+  {
+    sLast         = *pLast;
+    sLast.u8State = BOOT_STATE_CONFIRMED;
+    sLast.u8Tries = 0;
+    Flash_Init();
+    BOOT_Append( &sLast );
+  }
+
+  return TRUE;
+}
+/*! @} End of boot_api_list                                                   */
@@ -0,0 +1,111 @@
+/******************************************************************************
+* @brief header file for A/B firmware update and bootloader (BOOT).
+*
+*******************************************************************************
+*
+* provide APIs for the bootloader to receive an application image over a
+* UART into the slot not in use, verify it, try it and roll back to the
+* last confirmed one, and for the application to confirm it runs
+******************************************************************************/
+#ifndef __NV32_BOOT_H__
+#define __NV32_BOOT_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_uart.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define BOOT_SLOT_A             0           /*!< application at BOOT_SLOT_A_ADDRESS */
+#define BOOT_SLOT_B             1           /*!< application at BOOT_SLOT_B_ADDRESS */
+#define BOOT_NONE               0xFF        /*!< no application to start */
+
+/*! @brief state of a boot record */
+enum
+{
+  BOOT_STATE_PENDING = 1,     /*!< received and verified, not confirmed by the application */
+  BOOT_STATE_CONFIRMED        /*!< confirmed by the application */
+};
+
+/*!
+* @brief frame types. A frame is 0xA5, type, sequence (2), payload length
+*        (2), payload and the CRC-16/CCITT of type to payload, big endian.
+*        Other fields are little endian.
+*/
+#define BOOT_FRAME_HELLO        'H'         /*!< host: open a session */
+#define BOOT_FRAME_START        'S'         /*!< host: size, CRC-32 and link address of the image */
+#define BOOT_FRAME_DATA         'D'         /*!< host: next BOOT_BLOCK_SIZE bytes, multiple of 8 except the last */
+#define BOOT_FRAME_END          'E'         /*!< host: image complete */
+#define BOOT_FRAME_ACK          'A'         /*!< target: done up to the sequence */
+#define BOOT_FRAME_NAK          'N'         /*!< target: resend from the sequence */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define BOOT_SLOT_ADDRESS(slot) ( ( slot ) == BOOT_SLOT_B ? BOOT_SLOT_B_ADDRESS : BOOT_SLOT_A_ADDRESS )
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* BOOT configure struct.
+*
+*//*! @addtogroup boot_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief record appended to the control sector, the last one is in force.
+*/
+typedef struct
+{
+  uint8_t       u8Slot;             /*!< BOOT_SLOT_A or BOOT_SLOT_B */
+  uint8_t       u8State;            /*!< BOOT_STATE_PENDING or BOOT_STATE_CONFIRMED */
+  uint8_t       u8Tries;            /*!< starts of a pending image so far */
+  uint8_t       u8Tag;              /*!< BOOT_TAG */
+  uint32_t      u32Size;            /*!< image bytes */
+  uint32_t      u32Crc;             /*!< CRC-32 of the image */
+  uint32_t      u32Check;           /*!< complement of the first word, programmed last */
+} BOOT_RecordType, *BOOT_RecordPtr;
+
+/*!
+* @brief measured update throughput, from the START to the END frame.
+*/
+typedef struct
+{
+  uint32_t      u32Bytes;           /*!< image bytes */
+  uint32_t      u32Clocks;          /*!< core clocks, the slot erase excluded */
+  uint32_t      u32BytesPerSec;     /*!< u32Bytes over the time */
+  uint16_t      u16Naks;            /*!< frames resent on request */
+} BOOT_StatsType, *BOOT_StatsPtr;
+/*! @} End of boot_configstruct                                               */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void BOOT_Main( UART_Type * pUART );
+uint8_t BOOT_Receive( UART_Type * pUART, uint32_t u32ListenMs, BOOT_StatsType * pStats );
+uint8_t BOOT_Select( void );
+void BOOT_Jump( uint8_t u8Slot );
+uint8_t BOOT_Confirm( void );
+void BOOT_UartIsr( UART_Type * pUART );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_BOOT_H__ */
@@ -0,0 +1,555 @@
+/******************************************************************************
+* @brief providing APIs for RTC calendar and alarm service (CAL).
+*
+*******************************************************************************
+*
+* The time is kept as seconds since the epoch in Q32. The RTC counter runs
+* continuously and its modulo is set to the count of the nearest alarm, up
+* to the 16-bit maximum, so the RTC interrupts only when an alarm is due or
+* the counter is about to wrap. The counts elapsed are folded into the time
+* at every interrupt and before every reprogramming, since writing the
+* modulo restarts the counter; the fraction below the Q32 LSB is carried.
+*
+* Date conversions use multiply and shift reciprocals and a month table
+* with the year starting in March, valid from 1970 to 2099.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_calendar.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+/*! @brief seconds per RTC count in Q48. */
+#define CAL_SEC_PER_COUNT_Q48   ( ( ( uint64_t )CAL_RTC_DIVIDER << 48 ) / CAL_RTC_CLOCK_HZ )
+
+/*! @brief RTC counts per second in Q16. */
+#define CAL_COUNTS_PER_SEC_Q16  ( uint32_t )( ( ( uint64_t )CAL_RTC_CLOCK_HZ << 16 ) / CAL_RTC_DIVIDER )
+
+#define CAL_MIN_COUNTS          2           /*!< shortest RTC period, keeps the wrap detectable */
+#define CAL_MAX_COUNTS          0xFFFF
+
+/*! @brief days from 1968-03-01, start of a leap year cycle, to the epoch. */
+#define CAL_EPOCH_DAYS          671
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static uint32_t CAL_ReadCounter( void );
+static void CAL_Update( uint8_t bWrapped );
+static void CAL_Program( uint8_t bWrapped );
+static void CAL_Insert( CAL_AlarmType * pAlarm );
+static void CAL_Remove( CAL_AlarmType * pAlarm );
+static void CAL_Isr( void );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static CAL_AlarmType    *CAL_pHead;             /*!< earliest pending alarm */
+static uint64_t         CAL_u64Time;            /*!< time at the last update, seconds in Q32 */
+static uint32_t         CAL_u32TimeFrac;        /*!< time below the Q32 LSB, in 1/2^16 */
+static uint32_t         CAL_u32Folded;          /*!< counts of this RTC period in CAL_u64Time */
+static uint8_t          CAL_bInIsr;             /*!< 1: alarm callbacks are running */
+
+/*! @brief day of the year the months start on, the year starting in March. */
+static const uint16_t CAL_u16MonthStart[12] = { 0, 31, 61, 92, 122, 153, 184, 214, 245, 275, 306, 337 };
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  read the RTC counter, which runs from an asynchronous clock, until
+*         two reads agree.
+*
+* @param  none.
+*
+* @return counter value.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t CAL_ReadCounter( void )
+{
+  uint32_t u32Count;
+
+  do
+  {
+    u32Count = RTC->CNT;
+  }
+  while ( u32Count != RTC->CNT );
+
+  return u32Count;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  fold the counts elapsed since the last update into the time,
+*         interrupts must be masked.
+*
+* @param[in]    bWrapped    1: the counter reached the modulo in this period.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAL_Update( uint8_t bWrapped )
+{
+  uint32_t u32Count = CAL_ReadCounter();
+  uint32_t u32Mod;
+  uint64_t u64Add;
+
+  if ( bWrapped )
+  {
+    /* the flag rises at the modulo, the counter restarts one count later */
+    u32Mod   = RTC->MOD;
+    u32Count = ( u32Count == u32Mod ) ? u32Mod : ( u32Mod + 1 + u32Count );
+  }
+
+  u64Add          = ( uint64_t )( u32Count - CAL_u32Folded ) * CAL_SEC_PER_COUNT_Q48 + CAL_u32TimeFrac;
+  CAL_u64Time    += u64Add >> 16;
+  CAL_u32TimeFrac = ( uint32_t )u64Add & 0xFFFF;
+  CAL_u32Folded   = u32Count;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  update the time and restart the RTC period to end at the earliest
+*         alarm, interrupts must be masked.
+*
+* @param[in]    bWrapped    1: the counter reached the modulo in this period.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAL_Program( uint8_t bWrapped )
+{
+  uint32_t u32Counts = CAL_MAX_COUNTS;
+  uint64_t u64Delta;
+
+  CAL_Update( bWrapped );
+
+  if ( CAL_pHead )
+  {
+    u64Delta = CAL_pHead->u64Time - CAL_u64Time;
+
+    if ( ( int64_t )u64Delta <= 0 )
+    {
+      u32Counts = CAL_MIN_COUNTS;
+    }
+    else if ( ( u64Delta >> 32 ) < CAL_MAX_COUNTS )
+    {
+      /* round up so the alarm is due when the interrupt comes */
+      u64Delta  = ( ( u64Delta >> 16 ) * CAL_COUNTS_PER_SEC_Q16 + 0xFFFFFFFF ) >> 32;
+      u32Counts = ( u64Delta > CAL_MAX_COUNTS ) ? CAL_MAX_COUNTS : ( uint32_t )u64Delta;
+      u32Counts = ( u32Counts < CAL_MIN_COUNTS ) ? CAL_MIN_COUNTS : u32Counts;
+    }
+  }
+
+  RTC_SetModulo( u32Counts );
+  CAL_u32Folded = 0;
+  RTC_ClrFlags();
+  NVIC_ClearPendingIRQ( RTC_IRQn );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  link an alarm into the queue behind all alarms not later than it.
+*
+* @param[in]    pAlarm      pointer to an alarm not in the queue.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAL_Insert( CAL_AlarmType * pAlarm )
+{
+  CAL_AlarmType **ppLink = &CAL_pHead;
+
+  while ( *ppLink && ( ( int64_t )( ( *ppLink )->u64Time - pAlarm->u64Time ) <= 0 ) )
+  {
+    ppLink = &( *ppLink )->pNext;
+  }
+
+  pAlarm->pNext    = *ppLink;
+  pAlarm->bPending = 1;
+  *ppLink = pAlarm;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  unlink a pending alarm from the queue.
+*
+* @param[in]    pAlarm      pointer to a pending alarm.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAL_Remove( CAL_AlarmType * pAlarm )
+{
+  CAL_AlarmType **ppLink = &CAL_pHead;
+
+  while ( *ppLink != pAlarm )
+  {
+    ppLink = &( *ppLink )->pNext;
+  }
+
+  *ppLink = pAlarm->pNext;
+  pAlarm->bPending = 0;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  RTC callback: run the due alarms and program the next one.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAL_Isr( void )
+{
+  CAL_AlarmType *pAlarm;
+  /* RTC_Isr has cleared the flag, the period did end */
+  CAL_Update( 1 );
+  CAL_bInIsr = 1;
+
+  while ( CAL_pHead && ( ( int64_t )( CAL_pHead->u64Time - CAL_u64Time ) <= 0 ) )
+  {
+    pAlarm    = CAL_pHead;
+    CAL_pHead = pAlarm->pNext;
+    pAlarm->bPending = 0;
+
+    if ( pAlarm->u64Period )
+    {
+      pAlarm->u64Time += pAlarm->u64Period;
+      CAL_Insert( pAlarm );
+    }
+
+    pAlarm->pfnCallback( pAlarm->pParam );
+  }
+
+  CAL_bInIsr = 0;
+  CAL_Program( 1 );
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* CAL api lists
+*
+*//*! @addtogroup cal_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  start the calendar on the RTC clocked as set by CAL_RTC_CLKSRC and
+*         CAL_RTC_PRESCALER. The RTC is owned by the calendar afterwards.
+*
+* @param[in]    pTime       initial time, NULL for the epoch.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_Init( const CAL_TimeType * pTime )
+{
+  RTC_ConfigType sRTCConfig = {0};
+  CAL_pHead       = NULL;
+  CAL_u64Time     = pTime ? ( ( ( uint64_t )pTime->u32Seconds << 32 ) | pTime->u32Fraction ) : 0;
+  CAL_u32TimeFrac = 0;
+  CAL_u32Folded   = 0;
+  CAL_bInIsr      = 0;
+
+  if ( RTC_CLKSRC_IREF == CAL_RTC_CLKSRC )
+  {
+    /* keep ICSIRCLK running in Stop */
+    ICS->C1 |= ICS_C1_IRCLKEN_MASK | ICS_C1_IREFSTEN_MASK;
+  }
+
+  sRTCConfig.bInterruptEn   = 1;
+  sRTCConfig.bFlag          = 1;
+  sRTCConfig.bClockSource   = CAL_RTC_CLKSRC;
+  sRTCConfig.bClockPresaler = CAL_RTC_PRESCALER;
+  sRTCConfig.u16ModuloValue = CAL_MAX_COUNTS;
+  RTC_SetCallback( CAL_Isr );
+  RTC_Init( &sRTCConfig );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop the calendar and release the RTC. Pending alarms are dropped.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_DeInit( void )
+{
+  RTC_DeInit();
+  RTC_SetCallback( ( RTC_CallbackType )NULL );
+  CAL_pHead = NULL;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the current time.
+*
+* @param[out]   pTime       pointer to the time.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_GetTime( CAL_TimeType * pTime )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  CAL_Update( RTC_GetFlags() );
+  pTime->u32Seconds  = ( uint32_t )( CAL_u64Time >> 32 );
+  pTime->u32Fraction = ( uint32_t )CAL_u64Time;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  set the current time. Pending alarms keep their absolute time, the
+*         ones now in the past are due at once.
+*
+* @param[in]    pTime       pointer to the new time.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_SetTime( const CAL_TimeType * pTime )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  CAL_Update( RTC_GetFlags() );
+  CAL_u64Time     = ( ( uint64_t )pTime->u32Seconds << 32 ) | pTime->u32Fraction;
+  CAL_u32TimeFrac = 0;
+
+  if ( !CAL_bInIsr )
+  {
+    CAL_Program( 0 );
+  }
+
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  convert seconds since the epoch to date and time.
+*
+* @param[in]    u32Seconds  seconds since 1970-01-01 00:00:00.
+* @param[out]   pDate       pointer to the date, u16Millisecond is set to 0.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_SecondsToDate( uint32_t u32Seconds, CAL_DateTimeType * pDate )
+{
+  uint32_t u32Days;
+  uint32_t u32Rem;
+  uint32_t u32Cycle;
+  uint32_t u32Year;
+  uint32_t u32Month;
+  uint32_t u32Value;
+  /* u32Seconds / 86400, exact over the 32-bit range */
+  u32Days  = ( uint32_t )( ( ( uint64_t )u32Seconds * 0xC22E4507 ) >> 48 );
+  u32Rem   = u32Seconds - u32Days * 86400;
+  /* / 3600 and / 60, exact within a day and an hour */
+  u32Value = ( u32Rem * 37283 ) >> 27;
+  pDate->u8Hour   = u32Value;
+  u32Rem  -= u32Value * 3600;
+  u32Value = ( u32Rem * 2185 ) >> 17;
+  pDate->u8Minute = u32Value;
+  pDate->u8Second = u32Rem - u32Value * 60;
+  pDate->u16Millisecond = 0;
+  /* the epoch is a Thursday, / 7 */
+  u32Value = u32Days + 4;
+  pDate->u8WeekDay = u32Value - ( ( u32Value * 74899 ) >> 19 ) * 7;
+  /* days into a four year cycle starting 1968-03-01, / 1461 and / 365 */
+  u32Days += CAL_EPOCH_DAYS;
+  u32Cycle = ( u32Days * 22967 ) >> 25;
+  u32Days -= u32Cycle * 1461;
+  u32Year  = ( u32Days * 1437 ) >> 19;
+  u32Year  = ( u32Year > 3 ) ? 3 : u32Year;
+  u32Days -= u32Year * 365;
+  /* month 3 ~ 14 from the day of the March based year */
+  u32Month = ( u32Days * 2141 + 197913 ) >> 16;
+  pDate->u8Day = u32Days - CAL_u16MonthStart[u32Month - 3] + 1;
+
+  if ( u32Month > 12 )
+  {
+    u32Month -= 12;
+    u32Year++;
+  }
+
+  pDate->u8Month = u32Month;
+  pDate->u16Year = 1968 + u32Cycle * 4 + u32Year;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  convert date and time to seconds since the epoch.
+*
+* @param[in]    pDate       pointer to the date, u8WeekDay and u16Millisecond
+*                           are ignored.
+*
+* @return seconds since 1970-01-01 00:00:00.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t CAL_DateToSeconds( const CAL_DateTimeType * pDate )
+{
+  uint32_t u32Year  = pDate->u16Year;
+  uint32_t u32Month = pDate->u8Month;
+  uint32_t u32Days;
+  ASSERT( ( u32Year >= CAL_YEAR_MIN ) && ( u32Year <= CAL_YEAR_MAX ) );
+  ASSERT( ( u32Month >= 1 ) && ( u32Month <= 12 ) );
+
+  if ( u32Month < 3 )
+  {
+    u32Year--;
+    u32Month += 12;
+  }
+
+  u32Days = ( ( ( u32Year - 1968 ) * 1461 ) >> 2 ) + CAL_u16MonthStart[u32Month - 3] + pDate->u8Day - 1 - CAL_EPOCH_DAYS;
+  return u32Days * 86400 + pDate->u8Hour * 3600 + pDate->u8Minute * 60 + pDate->u8Second;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the current date and time.
+*
+* @param[out]   pDate       pointer to the date.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_GetDate( CAL_DateTimeType * pDate )
+{
+  CAL_TimeType sTime;
+  CAL_GetTime( &sTime );
+  CAL_SecondsToDate( sTime.u32Seconds, pDate );
+  pDate->u16Millisecond = ( uint16_t )( ( ( uint64_t )sTime.u32Fraction * 1000 ) >> 32 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  initialize an alarm before first use.
+*
+* @param[in]    pAlarm      pointer to the alarm.
+* @param[in]    pfnCallback alarm callback, runs in the RTC interrupt.
+* @param[in]    pParam      callback parameter.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_AlarmInit( CAL_AlarmType * pAlarm, CAL_CallbackType pfnCallback, void * pParam )
+{
+  pAlarm->pNext       = NULL;
+  pAlarm->u64Time     = 0;
+  pAlarm->u64Period   = 0;
+  pAlarm->pfnCallback = pfnCallback;
+  pAlarm->pParam      = pParam;
+  pAlarm->bPending    = 0;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  (re)start an alarm, also from an alarm callback. An alarm already
+*         in the past is due at the next RTC count.
+*
+* @param[in]    pAlarm      pointer to the alarm.
+* @param[in]    pTime       due time.
+* @param[in]    u32PeriodMs interval of later alarms in ms, 0 for one-shot.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_AlarmStart( CAL_AlarmType * pAlarm, const CAL_TimeType * pTime, uint32_t u32PeriodMs )
+{
+  uint64_t u64Period = ( ( uint64_t )u32PeriodMs << 32 ) / 1000;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  if ( pAlarm->bPending )
+  {
+    CAL_Remove( pAlarm );
+  }
+
+  pAlarm->u64Time   = ( ( uint64_t )pTime->u32Seconds << 32 ) | pTime->u32Fraction;
+  pAlarm->u64Period = u64Period;
+  CAL_Insert( pAlarm );
+
+  if ( ( pAlarm == CAL_pHead ) && !CAL_bInIsr )
+  {
+    CAL_Program( RTC_GetFlags() );
+  }
+
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop an alarm, no effect if it is not pending.
+*
+* @param[in]    pAlarm      pointer to the alarm.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAL_AlarmStop( CAL_AlarmType * pAlarm )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  if ( pAlarm->bPending )
+  {
+    /* the RTC period may end early, the interrupt then finds nothing due */
+    CAL_Remove( pAlarm );
+  }
+
+  __set_interrupt_state( interrupt_state );
+}
+
+/*! @} End of cal_api_list                                                    */
@@ -0,0 +1,147 @@
+/******************************************************************************
+* @brief header file for RTC calendar and alarm service (CAL).
+*
+*******************************************************************************
+*
+* provide APIs for epoch time with sub-second resolution, date conversion
+* and alarms waking the CPU only when they are due
+******************************************************************************/
+#ifndef __NV32_CALENDAR_H__
+#define __NV32_CALENDAR_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_rtc.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define CAL_YEAR_MIN            1970        /*!< first year of the epoch */
+#define CAL_YEAR_MAX            2099        /*!< last year the conversions are valid for */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* CAL callback function declaration
+*
+*//*! @addtogroup cal_callback
+* @{
+*******************************************************************************/
+typedef void ( *CAL_CallbackType )( void * pParam );    /*!< CAL alarm callback type, runs in RTC interrupt */
+/*! @} End of cal_callback                                                    */
+
+/******************************************************************************
+* CAL time struct.
+*
+*//*! @addtogroup cal_timestruct
+* @{
+*******************************************************************************/
+/*!
+* @brief point in time, seconds since 1970-01-01 00:00:00 and fraction of the
+*        second.
+*/
+typedef struct
+{
+  uint32_t  u32Seconds;                     /*!< seconds since the epoch */
+  uint32_t  u32Fraction;                    /*!< fraction of the second in 1/2^32 */
+} CAL_TimeType, *CAL_TimePtr;
+
+/*!
+* @brief broken down date and time.
+*/
+typedef struct
+{
+  uint16_t  u16Year;                        /*!< CAL_YEAR_MIN ~ CAL_YEAR_MAX */
+  uint8_t   u8Month;                        /*!< 1 ~ 12 */
+  uint8_t   u8Day;                          /*!< 1 ~ 31 */
+  uint8_t   u8Hour;                         /*!< 0 ~ 23 */
+  uint8_t   u8Minute;                       /*!< 0 ~ 59 */
+  uint8_t   u8Second;                       /*!< 0 ~ 59 */
+  uint8_t   u8WeekDay;                      /*!< 0 ~ 6, Sunday is 0 */
+  uint16_t  u16Millisecond;                 /*!< 0 ~ 999 */
+} CAL_DateTimeType, *CAL_DateTimePtr;
+/*! @} End of cal_timestruct                                                  */
+
+/******************************************************************************
+* CAL alarm struct.
+*
+*//*! @addtogroup cal_alarmstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief alarm, owned by the caller and linked into the time ordered queue
+*        while pending. Initialize with CAL_AlarmInit, the fields are private.
+*/
+typedef struct CAL_Alarm
+{
+  struct CAL_Alarm  *pNext;                 /*!< next later alarm */
+  uint64_t          u64Time;                /*!< due time, seconds in Q32 */
+  uint64_t          u64Period;              /*!< reload, seconds in Q32, 0 for one-shot */
+  CAL_CallbackType  pfnCallback;            /*!< alarm callback */
+  void              *pParam;                /*!< callback parameter */
+  uint8_t           bPending;               /*!< 1: linked into the queue */
+} CAL_AlarmType, *CAL_AlarmPtr;
+/*! @} End of cal_alarmstruct                                                 */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+/******************************************************************************
+* CAL inline functions
+*
+*//*! @addtogroup cal_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  check whether an alarm is pending.
+*
+* @param[in]    pAlarm      pointer to the alarm.
+*
+* @return TRUE if pending, FALSE otherwise.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE uint8_t CAL_AlarmIsPending( CAL_AlarmType * pAlarm )
+{
+  return pAlarm->bPending;
+}
+
+/*! @} End of cal_api_list                                                    */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void CAL_Init( const CAL_TimeType * pTime );
+void CAL_DeInit( void );
+void CAL_GetTime( CAL_TimeType * pTime );
+void CAL_SetTime( const CAL_TimeType * pTime );
+void CAL_SecondsToDate( uint32_t u32Seconds, CAL_DateTimeType * pDate );
+uint32_t CAL_DateToSeconds( const CAL_DateTimeType * pDate );
+void CAL_GetDate( CAL_DateTimeType * pDate );
+void CAL_AlarmInit( CAL_AlarmType * pAlarm, CAL_CallbackType pfnCallback, void * pParam );
+void CAL_AlarmStart( CAL_AlarmType * pAlarm, const CAL_TimeType * pTime, uint32_t u32PeriodMs );
+void CAL_AlarmStop( CAL_AlarmType * pAlarm );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_CALENDAR_H__ */
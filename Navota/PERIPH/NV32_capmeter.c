@@ -0,0 +1,522 @@
+/******************************************************************************
+* @brief providing APIs for ETM input capture frequency/period meter (CAPMETER).
+*
+*******************************************************************************
+*
+* The free running 16-bit ETM counter is extended to 32 bits with the overflow
+* interrupt. When a capture and an overflow are pending together, the capture
+* value tells which came first: a capture in the lower half of the counter
+* range was taken after the wrap. This holds as long as the interrupt latency
+* stays below half a counter period.
+*
+* Slow inputs are measured reciprocally over u8AvgEdges periods, with a
+* capture interrupt per edge. Fast inputs are counted instead: the ETM
+* switches to its external clock, the TCLK pin the input is routed to as
+* well, and the PIT channel u8GateChannel reads the count every gate time,
+* so only the gate and the counter overflow interrupt. A gate with fewer
+* edges than the range takes the meter back to the capture. Results are
+* published through a sequence counter and read without masking interrupts.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_capmeter.h"
+#include "NV32_pit.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define CAPMETER_MAX_NO             3       /*!< one meter per ETM module */
+
+#define CAPMETER_INDEX(pETM)        ( ( ( uint32_t )( pETM ) - ( uint32_t )ETM0_BASE ) >> 12 )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+typedef struct
+{
+  ETM_Type          *pETM;
+  uint8_t           u8Channel;
+  uint8_t           u8AvgEdges;
+  uint8_t           u8Mode;
+  uint8_t           u8ClockPrescale;
+  uint8_t           u8GateChannel;
+  uint8_t           bStarted;
+  volatile uint8_t  u8Seq;              /*!< odd while the ISR updates sResult */
+  uint8_t           u8ReadSeq;          /*!< u8Seq at the last CAPMETER_GetResult */
+  volatile uint16_t u16OverflowHigh;    /*!< upper 16 bits of the timestamp */
+  uint32_t          u32RangeTicks;
+  uint32_t          u32GateTicks;
+  uint32_t          u32TimeoutTicks;
+  uint32_t          u32ClockHz;
+  uint32_t          u32StartStamp;
+  uint32_t          u32LastStamp;
+  uint32_t          u32Edges;
+  uint32_t          u32GateCount;       /*!< extended edge count at the last gate */
+  volatile CAPMETER_ResultType sResult;
+} CAPMETER_ContextType;
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static void CAPMETER_Publish( CAPMETER_ContextType * pCtx, uint32_t u32Ticks, uint32_t u32Periods );
+static void CAPMETER_StartCapture( CAPMETER_ContextType * pCtx );
+static void CAPMETER_StartCount( CAPMETER_ContextType * pCtx );
+static void CAPMETER_Service( CAPMETER_ContextType * pCtx );
+static void CAPMETER_Gate( CAPMETER_ContextType * pCtx );
+static void CAPMETER_ETM0Callback( void );
+static void CAPMETER_ETM1Callback( void );
+static void CAPMETER_ETM2Callback( void );
+static void CAPMETER_Gate0Callback( void );
+static void CAPMETER_Gate1Callback( void );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static CAPMETER_ContextType CAPMETER_Context[CAPMETER_MAX_NO];
+
+static const ETM_CallbackPtr CAPMETER_Callback[CAPMETER_MAX_NO] =
+{
+  CAPMETER_ETM0Callback,
+  CAPMETER_ETM1Callback,
+  CAPMETER_ETM2Callback,
+};
+
+/* the meter each PIT channel gates */
+static CAPMETER_ContextType *CAPMETER_pGate[2];
+
+static const PIT_CallbackType CAPMETER_GateCallback[2] =
+{
+  CAPMETER_Gate0Callback,
+  CAPMETER_Gate1Callback,
+};
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  publish a result for the reader, called from interrupt context.
+*
+* @param[in]    pCtx        meter context.
+* @param[in]    u32Ticks    timer ticks of the measurement.
+* @param[in]    u32Periods  input periods of the measurement.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAPMETER_Publish( CAPMETER_ContextType * pCtx, uint32_t u32Ticks, uint32_t u32Periods )
+{
+  pCtx->u8Seq++;
+  pCtx->sResult.u32Ticks   = u32Ticks;
+  pCtx->sResult.u32Periods = u32Periods;
+  pCtx->sResult.u8Mode     = pCtx->u8Mode;
+  pCtx->u8Seq++;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  timestamp the input edges with the channel capture, on the timer
+*         clock, starting over.
+*
+* @param[in]    pCtx        meter context.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAPMETER_StartCapture( CAPMETER_ContextType * pCtx )
+{
+  ETM_Type *pETM = pCtx->pETM;
+
+  ETM_ClockSet( pETM, ETM_CLOCK_NOCLOCK, pCtx->u8ClockPrescale );
+  pETM->CNT             = 0;
+  pCtx->u16OverflowHigh = 0;
+  pCtx->bStarted        = 0;
+  pCtx->u8Mode          = CAPMETER_MODE_RECIPROCAL;
+  ETM_ClrChannelFlag( pETM, pCtx->u8Channel );
+  ETM_ClrOverFlowFlag( pETM );
+  ETM_EnableChannelInt( pETM, pCtx->u8Channel );
+  ETM_ClockSet( pETM, ETM_CLOCK_SYSTEMCLOCK, pCtx->u8ClockPrescale );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  count the input edges on the external clock over the PIT gate, the
+*         capture interrupt off.
+*
+* @param[in]    pCtx        meter context.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAPMETER_StartCount( CAPMETER_ContextType * pCtx )
+{
+  ETM_Type *pETM = pCtx->pETM;
+
+  ETM_DisableChannelInt( pETM, pCtx->u8Channel );
+  ETM_ClockSet( pETM, ETM_CLOCK_NOCLOCK, ETM_CLOCK_PS_DIV1 );
+  pETM->CNT             = 0;
+  pCtx->u16OverflowHigh = 0;
+  pCtx->u32GateCount    = 0;
+  pCtx->bStarted        = 0;
+  pCtx->u8Mode          = CAPMETER_MODE_GATED;
+  ETM_ClrOverFlowFlag( pETM );
+  ETM_ClockSet( pETM, ETM_CLOCK_EXTERNALCLOCK, ETM_CLOCK_PS_DIV1 );
+  PIT_ChannelClrFlags( pCtx->u8GateChannel );
+  PIT_ChannelEnable( pCtx->u8GateChannel );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  ETM capture and overflow service for one meter.
+*
+* @param[in]    pCtx        meter context.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAPMETER_Service( CAPMETER_ContextType * pCtx )
+{
+  ETM_Type  *pETM = pCtx->pETM;
+  uint16_t  u16Capture;
+  uint16_t  u16High;
+  uint32_t  u32Stamp;
+  uint32_t  u32Span;
+
+  /* counting, the channel still captures but its flag is not used */
+  if ( ( CAPMETER_MODE_GATED != pCtx->u8Mode ) && ETM_GetChannelFlag( pETM, pCtx->u8Channel ) )
+  {
+    u16Capture = pETM->CONTROLS[pCtx->u8Channel].CnV;
+    ETM_ClrChannelFlag( pETM, pCtx->u8Channel );
+    u16High = pCtx->u16OverflowHigh;
+
+    /* overflow pending and capture early in the count: the wrap came first */
+    if ( ETM_GetOverFlowFlag( pETM ) && ( u16Capture < 0x8000 ) )
+    {
+      u16High++;
+    }
+
+    u32Stamp = ( ( uint32_t )u16High << 16 ) | u16Capture;
+
+    if ( !pCtx->bStarted )
+    {
+      pCtx->bStarted      = 1;
+      pCtx->u32Edges      = 0;
+      pCtx->u32StartStamp = u32Stamp;
+    }
+    else
+    {
+      pCtx->u32Edges++;
+      u32Span = u32Stamp - pCtx->u32StartStamp;
+
+      if ( pCtx->u32Edges >= pCtx->u8AvgEdges )
+      {
+        CAPMETER_Publish( pCtx, u32Span, pCtx->u32Edges );
+
+        /* periods shorter than the range are counted from now on */
+        if ( u32Span < ( uint64_t )pCtx->u32RangeTicks * pCtx->u32Edges )
+        {
+          CAPMETER_StartCount( pCtx );
+          return;
+        }
+
+        pCtx->u32Edges      = 0;
+        pCtx->u32StartStamp = u32Stamp;
+      }
+    }
+
+    pCtx->u32LastStamp = u32Stamp;
+  }
+
+  if ( ETM_GetOverFlowFlag( pETM ) )
+  {
+    ETM_ClrOverFlowFlag( pETM );
+    pCtx->u16OverflowHigh++;
+    u32Stamp = ( uint32_t )pCtx->u16OverflowHigh << 16;
+
+    if ( pCtx->bStarted && ( ( u32Stamp - pCtx->u32LastStamp ) > pCtx->u32TimeoutTicks ) )
+    {
+      pCtx->bStarted = 0;
+      pCtx->u8Mode   = CAPMETER_MODE_TIMEOUT;
+      CAPMETER_Publish( pCtx, 0, 0 );
+      pCtx->u8Mode   = CAPMETER_MODE_RECIPROCAL;
+    }
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  end of a gate: publish the edges counted since the last one, back
+*         to the capture below the range.
+*
+* @param[in]    pCtx        meter context.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CAPMETER_Gate( CAPMETER_ContextType * pCtx )
+{
+  uint32_t u32Count;
+  uint32_t u32Edges;
+
+  if ( CAPMETER_MODE_GATED != pCtx->u8Mode )
+  {
+    return;
+  }
+
+  u32Count           = CAPMETER_GetTimestamp( pCtx->pETM );
+  u32Edges           = u32Count - pCtx->u32GateCount;
+  pCtx->u32GateCount = u32Count;
+  CAPMETER_Publish( pCtx, pCtx->u32GateTicks, u32Edges );
+
+  if ( ( uint64_t )pCtx->u32RangeTicks * u32Edges <= pCtx->u32GateTicks )
+  {
+    PIT_ChannelDisable( pCtx->u8GateChannel );
+    CAPMETER_StartCapture( pCtx );
+  }
+}
+
+static void CAPMETER_ETM0Callback( void )
+{
+  CAPMETER_Service( &CAPMETER_Context[0] );
+}
+
+static void CAPMETER_ETM1Callback( void )
+{
+  CAPMETER_Service( &CAPMETER_Context[1] );
+}
+
+static void CAPMETER_ETM2Callback( void )
+{
+  CAPMETER_Service( &CAPMETER_Context[2] );
+}
+
+static void CAPMETER_Gate0Callback( void )
+{
+  CAPMETER_Gate( CAPMETER_pGate[0] );
+}
+
+static void CAPMETER_Gate1Callback( void )
+{
+  CAPMETER_Gate( CAPMETER_pGate[1] );
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* CAPMETER api lists
+*
+*//*! @addtogroup capmeter_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  initialize a capture meter on one ETM channel, with a PIT channel
+*         for the gate. The ETM counter is free running and counts the input
+*         in the high range, so the other channels of the module can only be
+*         used for capture.
+*
+* @param[in]    pConfig     pointer to CAPMETER configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAPMETER_Init( CAPMETER_ConfigType * pConfig )
+{
+  CAPMETER_ContextType *pCtx;
+  PIT_ConfigType sGate = { 0 };
+  uint8_t u8Index;
+  ASSERT( ( ETM0 == pConfig->pETM ) || ( ETM1 == pConfig->pETM ) || ( ETM2 == pConfig->pETM ) );
+  ASSERT( pConfig->u8AvgEdges > 0 );
+  ASSERT( pConfig->u32TimeoutTicks < 0x80000000 );
+  ASSERT( pConfig->u8GateChannel < 2 );
+  u8Index = CAPMETER_INDEX( pConfig->pETM );
+  pCtx    = &CAPMETER_Context[u8Index];
+  pCtx->pETM            = pConfig->pETM;
+  pCtx->u8Channel       = pConfig->u8Channel;
+  pCtx->u8AvgEdges      = pConfig->u8AvgEdges;
+  pCtx->u8ClockPrescale = pConfig->u8ClockPrescale;
+  pCtx->u8GateChannel   = pConfig->u8GateChannel;
+  pCtx->u8Seq           = 0;
+  pCtx->u8ReadSeq       = 0;
+  pCtx->u32RangeTicks   = pConfig->u32RangeTicks;
+  pCtx->u32GateTicks    = pConfig->u32GateTicks;
+  pCtx->u32TimeoutTicks = pConfig->u32TimeoutTicks;
+  /* the ETM counts the timer clock, which is the ICS output clock */
+  pCtx->u32ClockHz      = SystemClockGet( CLOCK_CORE ) >> pConfig->u8ClockPrescale;
+
+  /* the PIT counts bus clocks, stopped until the first count */
+  CAPMETER_pGate[pConfig->u8GateChannel] = pCtx;
+  sGate.bInterruptEn = 1;
+  sGate.u32LoadValue = ( uint32_t )( ( uint64_t )pConfig->u32GateTicks * SystemClockGet( CLOCK_BUS ) /
+                                     pCtx->u32ClockHz ) - 1;
+  PIT_SetCallback( pConfig->u8GateChannel, CAPMETER_GateCallback[pConfig->u8GateChannel] );
+  PIT_Init( pConfig->u8GateChannel, &sGate );
+
+  ETM_SetCallback( pConfig->pETM, CAPMETER_Callback[u8Index] );
+  /* opens the clock gate, sets MOD to 0xFFFF and enables the channel interrupt */
+  ETM_InputCaptureInit( pConfig->pETM, pConfig->u8Channel, pConfig->u8CaptureEdge );
+  ETM_EnableOverflowInt( pConfig->pETM );
+  CAPMETER_StartCapture( pCtx );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop a capture meter and reset its ETM module.
+*
+* @param[in]    pETM        ETM module of the meter.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CAPMETER_DeInit( ETM_Type * pETM )
+{
+  CAPMETER_ContextType *pCtx = &CAPMETER_Context[CAPMETER_INDEX( pETM )];
+
+  PIT_ChannelDisable( pCtx->u8GateChannel );
+  PIT_ChannelDisableInt( pCtx->u8GateChannel );
+  PIT_SetCallback( pCtx->u8GateChannel, ( PIT_CallbackType )NULL );
+  ETM_DeInit( pETM );
+  ETM_SetCallback( pETM, ( ETM_CallbackPtr )NULL );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the latest measurement.
+*
+* @param[in]    pETM        ETM module of the meter.
+* @param[out]   pResult     latest result, u32Periods is 0 on timeout or if no
+*                           measurement has completed yet.
+*
+* @return TRUE if the result is new since the last call, FALSE otherwise.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t CAPMETER_GetResult( ETM_Type * pETM, CAPMETER_ResultType * pResult )
+{
+  CAPMETER_ContextType *pCtx = &CAPMETER_Context[CAPMETER_INDEX( pETM )];
+  uint8_t u8Seq;
+
+  /* retry if the ISR published while copying */
+  do
+  {
+    u8Seq    = pCtx->u8Seq;
+    *pResult = pCtx->sResult;
+  }
+  while ( ( u8Seq & 1 ) || ( u8Seq != pCtx->u8Seq ) );
+
+  if ( u8Seq == pCtx->u8ReadSeq )
+  {
+    return FALSE;
+  }
+
+  pCtx->u8ReadSeq = u8Seq;
+  return TRUE;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  read the 32-bit extended counter outside the interrupt.
+*
+* @param[in]    pETM        ETM module of the meter.
+*
+* @return current timestamp in timer ticks.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t CAPMETER_GetTimestamp( ETM_Type * pETM )
+{
+  CAPMETER_ContextType *pCtx = &CAPMETER_Context[CAPMETER_INDEX( pETM )];
+  uint16_t u16High;
+  uint16_t u16Count;
+  uint8_t  u8Overflow;
+
+  do
+  {
+    u16High    = pCtx->u16OverflowHigh;
+    u16Count   = pETM->CNT;
+    u8Overflow = ETM_GetOverFlowFlag( pETM );
+  }
+  while ( u16High != pCtx->u16OverflowHigh );
+
+  if ( u8Overflow && ( u16Count < 0x8000 ) )
+  {
+    u16High++;
+  }
+
+  return ( ( uint32_t )u16High << 16 ) | u16Count;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  convert a result to frequency.
+*
+* @param[in]    pETM        ETM module of the meter.
+* @param[in]    pResult     result from CAPMETER_GetResult.
+*
+* @return frequency in mHz, 0 on timeout.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t CAPMETER_GetFrequency_mHz( ETM_Type * pETM, CAPMETER_ResultType * pResult )
+{
+  uint64_t u64Num;
+
+  if ( ( 0 == pResult->u32Periods ) || ( 0 == pResult->u32Ticks ) )
+  {
+    return 0;
+  }
+
+  u64Num = ( uint64_t )CAPMETER_Context[CAPMETER_INDEX( pETM )].u32ClockHz * 1000 * pResult->u32Periods;
+  return ( uint32_t )( ( u64Num + ( pResult->u32Ticks >> 1 ) ) / pResult->u32Ticks );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  convert a result to the mean period.
+*
+* @param[in]    pETM        ETM module of the meter.
+* @param[in]    pResult     result from CAPMETER_GetResult.
+*
+* @return period in us, 0 on timeout.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t CAPMETER_GetPeriod_us( ETM_Type * pETM, CAPMETER_ResultType * pResult )
+{
+  uint64_t u64Den;
+
+  if ( 0 == pResult->u32Periods )
+  {
+    return 0;
+  }
+
+  u64Den = ( uint64_t )CAPMETER_Context[CAPMETER_INDEX( pETM )].u32ClockHz * pResult->u32Periods;
+  return ( uint32_t )( ( ( uint64_t )pResult->u32Ticks * 1000000 + ( u64Den >> 1 ) ) / u64Den );
+}
+
+/*! @} End of capmeter_api_list                                               */
@@ -0,0 +1,116 @@
+/******************************************************************************
+* @brief header file for ETM input capture frequency/period meter (CAPMETER).
+*
+*******************************************************************************
+*
+* provide APIs for measuring period and frequency of a pulse input with a
+* 32-bit extended ETM capture timestamp
+******************************************************************************/
+#ifndef __NV32_CAPMETER_H__
+#define __NV32_CAPMETER_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_etm.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+
+/******************************************************************************
+* CAPMETER measurement mode definition
+*
+*//*! @addtogroup capmeter_mode
+* @{
+*******************************************************************************/
+#define CAPMETER_MODE_RECIPROCAL    0   /*!< low range: result every u8AvgEdges periods */
+#define CAPMETER_MODE_GATED         1   /*!< high range: edges counted over each gate time */
+#define CAPMETER_MODE_TIMEOUT       2   /*!< no edge within the timeout, frequency is 0 */
+/*! @} End of capmeter_mode                                                   */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* CAPMETER configure struct.
+*
+*//*! @addtogroup capmeter_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief CAPMETER configure struct.
+*
+* Timestamps count the ETM timer clock divided by u8ClockPrescale. Periods
+* longer than u32RangeTicks are averaged over u8AvgEdges periods, shorter
+* ones are counted over a gate of u32GateTicks timed by the PIT channel
+* u8GateChannel. The count runs on the ETM external clock, so the input
+* must reach the TCLK pin of pETM as well as the capture channel, and the
+* gate should hold more than one u32RangeTicks period.
+* Example for 0.1 Hz ~ 100 kHz at 48 MHz, DIV8 (6 MHz, 32-bit wrap ~ 11 min):
+* u8AvgEdges = 4, u32RangeTicks = 600000 (10 Hz), u32GateTicks = 6000000 (1 s),
+* u32TimeoutTicks = 120000000 (20 s).
+*/
+typedef struct
+{
+  ETM_Type  *pETM;                  /*!< ETM0, ETM1 or ETM2 */
+  uint8_t   u8Channel;              /*!< capture channel of pETM */
+  uint8_t   u8CaptureEdge;          /*!< ETM_INPUTCAPTURE_RISINGEDGE or ETM_INPUTCAPTURE_FALLINGEDGE */
+  uint8_t   u8ClockPrescale;        /*!< ETM_CLOCK_PS_DIV1 ~ ETM_CLOCK_PS_DIV128 */
+  uint8_t   u8AvgEdges;             /*!< periods averaged in reciprocal mode, 1 ~ 255 */
+  uint8_t   u8GateChannel;          /*!< PIT_CHANNEL0 or PIT_CHANNEL1, timing the gate */
+  uint32_t  u32RangeTicks;          /*!< period threshold between gated and reciprocal mode */
+  uint32_t  u32GateTicks;           /*!< gate time in gated mode, in timer ticks */
+  uint32_t  u32TimeoutTicks;        /*!< report frequency 0 after this time without edges */
+} CAPMETER_ConfigType, *CAPMETER_ConfigPtr;
+/*! @} End of capmeter_configstruct                                           */
+
+/******************************************************************************
+* CAPMETER result struct.
+*
+*//*! @addtogroup capmeter_resultstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief one measurement: u32Periods input periods took u32Ticks timer ticks.
+*/
+typedef struct
+{
+  uint32_t  u32Ticks;               /*!< timer ticks between first and last edge, or the gate time */
+  uint32_t  u32Periods;             /*!< number of input periods, 0 on timeout */
+  uint8_t   u8Mode;                 /*!< CAPMETER_MODE_x used for this result */
+} CAPMETER_ResultType, *CAPMETER_ResultPtr;
+/*! @} End of capmeter_resultstruct                                           */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void CAPMETER_Init( CAPMETER_ConfigType * pConfig );
+void CAPMETER_DeInit( ETM_Type * pETM );
+uint8_t CAPMETER_GetResult( ETM_Type * pETM, CAPMETER_ResultType * pResult );
+uint32_t CAPMETER_GetTimestamp( ETM_Type * pETM );
+uint32_t CAPMETER_GetFrequency_mHz( ETM_Type * pETM, CAPMETER_ResultType * pResult );
+uint32_t CAPMETER_GetPeriod_us( ETM_Type * pETM, CAPMETER_ResultType * pResult );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_CAPMETER_H__ */
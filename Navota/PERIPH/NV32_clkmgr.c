@@ -0,0 +1,524 @@
+/******************************************************************************
+* @brief providing APIs for runtime clock manager (CLKMGR).
+*
+*******************************************************************************
+*
+* CLKMGR_SetMode moves the ICS from the mode it is in to the one asked for
+* with the FEI_to_FEE family of ICS functions, passing through FBI or FBE
+* when leaving or entering a low power bypass mode, then sets BDIV. Every
+* registered notifier is called with CLKMGR_PRE_CHANGE before, so it can
+* let a transfer finish, and with CLKMGR_POST_CHANGE after, once
+* SystemCoreClock holds the new frequency, to reprogram its divider. The
+* switch and the POST notifiers run with interrupts masked, no interrupt
+* service routine sees a peripheral still set for the old clock.
+*
+* The flash program and erase timing is derived from the bus clock, so
+* Flash_Init is run again after the change. Its read wait state does not
+* depend on the clock. Below 1 MHz bus clock the flash cannot be programmed
+* and the timing is left alone. Bit-banged buses timed in loops, such as
+* SWBUS, have to be calibrated again by the application.
+*
+* The software timers and the timestamp counter own their PIT channels and
+* follow a change with CLKMGR_SwtmrNotify and CLKMGR_TstampNotify. The plain
+* CLKMGR_PitNotify is for a channel the application programs itself.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_clkmgr.h"
+#include "NV32_flash.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+/*! @brief bypass modes reached directly from one another. */
+#define CLKMGR_FEI              0
+#define CLKMGR_FEE              1
+#define CLKMGR_FBI              2
+#define CLKMGR_FBE              3
+#define CLKMGR_BASE_MODES       4
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+typedef void ( *CLKMGR_SwitchType )( ICS_ConfigType * pConfig );
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static CLKMGR_NotifierType *CLKMGR_pNotifierList;
+
+/*! @brief ICS transition from row to column mode, NULL when already there. */
+static const CLKMGR_SwitchType CLKMGR_pfnSwitch[CLKMGR_BASE_MODES][CLKMGR_BASE_MODES] =
+{
+  /*            to FEI          to FEE          to FBI          to FBE      */
+  /* FEI */ {   NULL,           FEI_to_FEE,     FEI_to_FBI,     FEI_to_FBE  },
+  /* FEE */ {   FEE_to_FEI,     NULL,           FEE_to_FBI,     FEE_to_FBE  },
+  /* FBI */ {   FBI_to_FEI,     FBI_to_FEE,     NULL,           FBI_to_FBE  },
+  /* FBE */ {   FBE_to_FEI,     FBE_to_FEE,     FBE_to_FBI,     NULL        },
+};
+
+/*! @brief SCL divider of I2C_F ICR 0x00 ~ 0x3F. */
+static const uint16_t CLKMGR_u16I2cDivider[64] =
+{
+  20, 22, 24, 26, 28, 30, 34, 40, 28, 32, 36, 40, 44, 48, 56, 68,
+  48, 56, 64, 72, 80, 88, 104, 128, 80, 96, 112, 128, 144, 160, 192, 240,
+  160, 192, 224, 256, 288, 320, 384, 480, 320, 384, 448, 512, 576, 640, 768, 960,
+  640, 768, 896, 1024, 1152, 1280, 1536, 1920, 1280, 1536, 1792, 2048, 2304, 2560, 3072, 3840
+};
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  call every notifier.
+*
+* @param[in]    u8Event     CLKMGR_PRE_CHANGE or CLKMGR_POST_CHANGE.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CLKMGR_Notify( uint8_t u8Event )
+{
+  CLKMGR_NotifierType *pNotifier;
+
+  for ( pNotifier = CLKMGR_pNotifierList; pNotifier != NULL; pNotifier = pNotifier->pNext )
+  {
+    pNotifier->pfnNotify( pNotifier, u8Event );
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  refresh what is derived from the clock, then tell the notifiers.
+*         Called with interrupts masked.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void CLKMGR_Changed( void )
+{
+  SystemCoreClockUpdate();
+
+  if ( SystemClockGet( CLOCK_BUS ) >= 1000000L )
+  {
+    Flash_Init();
+  }
+
+  CLKMGR_Notify( CLKMGR_POST_CHANGE );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  bypass mode under a mode, FEE_OSC and FBE_OSC count as FEE and FBE.
+*
+* @param[in]    u8ClkMode   ICS_CLK_MODE_FEI ~ ICS_CLK_MODE_FBELP.
+*
+* @return CLKMGR_FEI ~ CLKMGR_FBE.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t CLKMGR_BaseMode( uint8_t u8ClkMode )
+{
+  switch ( u8ClkMode )
+  {
+    case ICS_CLK_MODE_FEE:
+    case ICS_CLK_MODE_FEE_OSC:
+      return CLKMGR_FEE;
+
+    case ICS_CLK_MODE_FBI:
+    case ICS_CLK_MODE_FBILP:
+      return CLKMGR_FBI;
+
+    case ICS_CLK_MODE_FBE:
+    case ICS_CLK_MODE_FBE_OSC:
+    case ICS_CLK_MODE_FBELP:
+      return CLKMGR_FBE;
+
+    default:
+      return CLKMGR_FEI;
+  }
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* CLKMGR api lists
+*
+*//*! @addtogroup clkmgr_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  add a notifier, called on every later clock change.
+*
+* @param[in]    pNotifier   notifier, stays owned by the caller.
+* @param[in]    pfnNotify   callback, e.g. CLKMGR_UartNotify.
+* @param[in]    pPeriph     peripheral the callback works on.
+* @param[in]    u32Rate     rate the callback keeps.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_Register( CLKMGR_NotifierType * pNotifier, CLKMGR_NotifyType pfnNotify, void * pPeriph, uint32_t u32Rate )
+{
+  __istate_t interrupt_state;
+
+  ASSERT( pfnNotify != NULL );
+
+  pNotifier->pfnNotify = pfnNotify;
+  pNotifier->pPeriph   = pPeriph;
+  pNotifier->u32Rate   = u32Rate;
+
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  pNotifier->pNext     = CLKMGR_pNotifierList;
+  CLKMGR_pNotifierList = pNotifier;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  remove a notifier.
+*
+* @param[in]    pNotifier   notifier added by CLKMGR_Register.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_Unregister( CLKMGR_NotifierType * pNotifier )
+{
+  CLKMGR_NotifierType **ppLink;
+  __istate_t          interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  for ( ppLink = &CLKMGR_pNotifierList; *ppLink != NULL; ppLink = &( *ppLink )->pNext )
+  {
+    if ( *ppLink == pNotifier )
+    {
+      *ppLink = pNotifier->pNext;
+      break;
+    }
+  }
+
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  read the ICS mode from the registers.
+*
+* @param  none.
+*
+* @return ICS_CLK_MODE_FEI, ICS_CLK_MODE_FEE, ICS_CLK_MODE_FBI,
+*         ICS_CLK_MODE_FBILP, ICS_CLK_MODE_FBE or ICS_CLK_MODE_FBELP.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t CLKMGR_GetMode( void )
+{
+  uint8_t u8LP = ICS->C2 & ICS_C2_LP_MASK;
+
+  switch ( ICS->C1 & ICS_C1_CLKS_MASK )
+  {
+    case ICS_C1_CLKS( 0 ):
+      return ( ICS->C1 & ICS_C1_IREFS_MASK ) ? ICS_CLK_MODE_FEI : ICS_CLK_MODE_FEE;
+
+    case ICS_C1_CLKS( 1 ):
+      return u8LP ? ICS_CLK_MODE_FBILP : ICS_CLK_MODE_FBI;
+
+    default:
+      return u8LP ? ICS_CLK_MODE_FBELP : ICS_CLK_MODE_FBE;
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  switch the ICS to another mode and set the bus divider.
+*
+* @param[in]    pConfig     target mode in u8ClkMode, reference frequency
+*                           and OSC setting as for ICS_Init.
+* @param[in]    u8BusDivide BDIV, ICS output divided by 2^u8BusDivide.
+*
+* @return TRUE when switched, FALSE when the ICS reads back another mode.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t CLKMGR_SetMode( ICS_ConfigType * pConfig, uint8_t u8BusDivide )
+{
+  uint8_t           u8From = CLKMGR_GetMode();
+  uint8_t           u8To   = pConfig->u8ClkMode;
+  uint8_t           u8Base = CLKMGR_BaseMode( u8From );
+  CLKMGR_SwitchType pfnSwitch;
+  __istate_t        interrupt_state;
+
+  ASSERT( ( u8To >= ICS_CLK_MODE_FEI ) && ( u8To <= ICS_CLK_MODE_FBELP ) );
+  ASSERT( u8BusDivide <= 7 );
+
+  CLKMGR_Notify( CLKMGR_PRE_CHANGE );
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  /* leave the low power bypass mode first */
+  if ( u8From == ICS_CLK_MODE_FBILP )
+  {
+    FBILP_to_FBI( pConfig );
+  }
+  else if ( u8From == ICS_CLK_MODE_FBELP )
+  {
+    FBELP_to_FBE( pConfig );
+  }
+
+  pfnSwitch = CLKMGR_pfnSwitch[u8Base][CLKMGR_BaseMode( u8To )];
+
+  if ( u8Base == CLKMGR_FEI )
+  {
+    /* an active oscillator instead of a crystal */
+    if ( u8To == ICS_CLK_MODE_FEE_OSC )
+    {
+      pfnSwitch = FEI_to_FEE_OSC;
+    }
+    else if ( u8To == ICS_CLK_MODE_FBE_OSC )
+    {
+      pfnSwitch = FEI_to_FBE_OSC;
+    }
+  }
+
+  if ( pfnSwitch != NULL )
+  {
+    pfnSwitch( pConfig );
+  }
+
+  if ( u8To == ICS_CLK_MODE_FBILP )
+  {
+    FBI_to_FBILP( pConfig );
+  }
+  else if ( u8To == ICS_CLK_MODE_FBELP )
+  {
+    FBE_to_FBELP( pConfig );
+  }
+
+  ICS_SetBusDivider( u8BusDivide );
+  CLKMGR_Changed();
+  __set_interrupt_state( interrupt_state );
+
+  return ( CLKMGR_BaseMode( CLKMGR_GetMode() ) == CLKMGR_BaseMode( u8To ) ) ? TRUE : FALSE;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  change only the bus divider, the quick way between a burst and
+*         idle in the same ICS mode.
+*
+* @param[in]    u8BusDivide BDIV, ICS output divided by 2^u8BusDivide.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_SetBusDivider( uint8_t u8BusDivide )
+{
+  __istate_t interrupt_state;
+
+  ASSERT( u8BusDivide <= 7 );
+
+  CLKMGR_Notify( CLKMGR_PRE_CHANGE );
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  ICS_SetBusDivider( u8BusDivide );
+  CLKMGR_Changed();
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  notifier keeping a UART at its baudrate. pPeriph is the UART,
+*         u32Rate the baudrate.
+*
+* @param[in]    pNotifier   notifier.
+* @param[in]    u8Event     CLKMGR_PRE_CHANGE or CLKMGR_POST_CHANGE.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_UartNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event )
+{
+  UART_Type               *pUART = ( UART_Type * )pNotifier->pPeriph;
+  UART_ConfigBaudrateType sBaudrate;
+
+  if ( u8Event == CLKMGR_PRE_CHANGE )
+  {
+    /* let the character on the line go out at the old rate */
+    if ( pUART->C2 & UART_C2_TE_MASK )
+    {
+      while ( !( pUART->S1 & UART_S1_TC_MASK ) );
+    }
+  }
+  else
+  {
+    sBaudrate.u32SysClkHz = SystemClockGet( CLOCK_BUS );
+    sBaudrate.u32Baudrate = pNotifier->u32Rate;
+    UART_SetBaudrate( pUART, &sBaudrate );
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  notifier keeping a SPI master at its bit rate. pPeriph is the
+*         SPI, u32Rate the bit rate.
+*
+* @param[in]    pNotifier   notifier.
+* @param[in]    u8Event     CLKMGR_PRE_CHANGE or CLKMGR_POST_CHANGE.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_SpiNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event )
+{
+  if ( u8Event == CLKMGR_POST_CHANGE )
+  {
+    SPI_SetBaudRate( ( SPI_Type * )pNotifier->pPeriph, SystemClockGet( CLOCK_BUS ), pNotifier->u32Rate );
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  notifier keeping an I2C master at or below its SCL rate. pPeriph
+*         is the I2C, u32Rate the SCL rate. The caller holds off transfers
+*         across the change.
+*
+* @param[in]    pNotifier   notifier.
+* @param[in]    u8Event     CLKMGR_PRE_CHANGE or CLKMGR_POST_CHANGE.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_I2cNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event )
+{
+  uint32_t u32Bus  = SystemClockGet( CLOCK_BUS );
+  uint32_t u32Best = 0xFFFFFFFF;
+  uint8_t  u8Icr   = 0x3F;
+  uint8_t  i;
+
+  if ( u8Event != CLKMGR_POST_CHANGE )
+  {
+    return;
+  }
+
+  /* the smallest divider not above the rate, MULT stays 1 */
+  for ( i = 0; i < 64; i++ )
+  {
+    if ( ( u32Bus / CLKMGR_u16I2cDivider[i] <= pNotifier->u32Rate ) &&
+         ( CLKMGR_u16I2cDivider[i] < u32Best ) )
+    {
+      u32Best = CLKMGR_u16I2cDivider[i];
+      u8Icr   = i;
+    }
+  }
+
+  I2C_SetBaudRate( ( I2C_Type * )pNotifier->pPeriph, I2C_F_MULT( 0 ) | I2C_F_ICR( u8Icr ) );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  notifier keeping a PIT channel at its period. pPeriph is the
+*         channel number, PIT_CHANNEL0 or PIT_CHANNEL1, u32Rate the period in
+*         us. The new load value takes effect at the next reload. Not for
+*         SWTMR_PIT_CHANNEL while the software timers run nor for the TSTAMP
+*         channels, their load values are not periods: register
+*         CLKMGR_SwtmrNotify or CLKMGR_TstampNotify instead.
+*
+* @param[in]    pNotifier   notifier.
+* @param[in]    u8Event     CLKMGR_PRE_CHANGE or CLKMGR_POST_CHANGE.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_PitNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event )
+{
+  uint32_t u32Load;
+
+  if ( u8Event == CLKMGR_POST_CHANGE )
+  {
+    u32Load = ( uint32_t )( ( ( uint64_t )SystemClockGet( CLOCK_BUS ) * pNotifier->u32Rate ) / 1000000L );
+    PIT_SetLoadVal( ( uint8_t )( uint32_t )pNotifier->pPeriph, u32Load ? u32Load - 1 : 0 );
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  notifier keeping the software timers at their tick, the part of
+*         the tick counted at the old rate is carried over. pPeriph and
+*         u32Rate are not used.
+*
+* @param[in]    pNotifier   notifier.
+* @param[in]    u8Event     CLKMGR_PRE_CHANGE or CLKMGR_POST_CHANGE.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_SwtmrNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event )
+{
+  if ( u8Event == CLKMGR_POST_CHANGE )
+  {
+    SWTMR_ClockUpdate();
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  notifier keeping the us count of the timestamp counter going and
+*         its conversion factors at the new bus clock. pPeriph and u32Rate
+*         are not used.
+*
+* @param[in]    pNotifier   notifier.
+* @param[in]    u8Event     CLKMGR_PRE_CHANGE or CLKMGR_POST_CHANGE.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void CLKMGR_TstampNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event )
+{
+  if ( u8Event == CLKMGR_POST_CHANGE )
+  {
+    TSTAMP_ClockUpdate();
+  }
+}
+/*! @} End of clkmgr_api_list                                                 */
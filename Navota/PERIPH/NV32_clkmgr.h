@@ -0,0 +1,96 @@
+/******************************************************************************
+* @brief header file for runtime clock manager (CLKMGR).
+*
+*******************************************************************************
+*
+* provide APIs for switching the ICS mode and bus divider at runtime and
+* notifying the peripherals whose dividers depend on the clock
+******************************************************************************/
+#ifndef __NV32_CLKMGR_H__
+#define __NV32_CLKMGR_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_ics.h"
+#include "NV32_uart.h"
+#include "NV32_spi.h"
+#include "NV32_i2c.h"
+#include "NV32_pit.h"
+#include "NV32_swtimer.h"
+#include "NV32_tstamp.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+
+/*! @brief notifier events */
+enum
+{
+  CLKMGR_PRE_CHANGE = 0,      /*!< clock about to change, finish or hold transfers */
+  CLKMGR_POST_CHANGE          /*!< clock changed, SystemCoreClock is updated, reprogram dividers */
+};
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* CLKMGR notifier struct.
+*
+*//*! @addtogroup clkmgr_notifier
+* @{
+*******************************************************************************/
+struct CLKMGR_Notifier;
+
+typedef void ( *CLKMGR_NotifyType )( struct CLKMGR_Notifier * pNotifier, uint8_t u8Event );   /*!< CLKMGR notifier callback type */
+
+/*!
+* @brief clock change notifier, owned by the caller and linked into the
+*        manager by CLKMGR_Register.
+*/
+typedef struct CLKMGR_Notifier
+{
+  struct CLKMGR_Notifier  *pNext;           /*!< next notifier */
+  CLKMGR_NotifyType       pfnNotify;        /*!< callback, CLKMGR_PRE_CHANGE and CLKMGR_POST_CHANGE */
+  void                    *pPeriph;         /*!< UART, SPI or I2C base, PIT channel number, or user data */
+  uint32_t                u32Rate;          /*!< baudrate in bps, or PIT period in us */
+} CLKMGR_NotifierType, *CLKMGR_NotifierPtr;
+/*! @} End of clkmgr_notifier                                                 */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void CLKMGR_Register( CLKMGR_NotifierType * pNotifier, CLKMGR_NotifyType pfnNotify, void * pPeriph, uint32_t u32Rate );
+void CLKMGR_Unregister( CLKMGR_NotifierType * pNotifier );
+uint8_t CLKMGR_GetMode( void );
+uint8_t CLKMGR_SetMode( ICS_ConfigType * pConfig, uint8_t u8BusDivide );
+void CLKMGR_SetBusDivider( uint8_t u8BusDivide );
+void CLKMGR_UartNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event );
+void CLKMGR_SpiNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event );
+void CLKMGR_I2cNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event );
+void CLKMGR_PitNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event );
+void CLKMGR_SwtmrNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event );
+void CLKMGR_TstampNotify( CLKMGR_NotifierType * pNotifier, uint8_t u8Event );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_CLKMGR_H__ */
@@ -146,6 +146,12 @@ FLL 
 /*ǷʹܿŹ*/
 #define WDOG_ENABLED              ( 1 )
 
+/*Ƿ뿴Źල(NV32_wdsup),  Watchdog_IRQHandler; ʹʱö ENABLE_WDOG */
+#define WDSUP_ENABLED             ( 0 )
+
+/*忴Źල(NV32_wdsup)ɵǼǵ,  32 */
+#define WDSUP_TASKS               ( 8 )
+
 /*TRIM ֵУ׼ڲIRC */
 #define ICS_TRIM_ENABLED          ( 1 )
 
@@ -153,5 +159,137 @@ FLL 
 //#define ICS_TRIM_VALUE          0x4c      /*trim IRC to 39.0625KHz and FLL output=40MHz */
 #define ICS_TRIM_VALUE            0x29      /*trim IRC to 39.0625KHz and FLL output=48MHz */
 
+/*屣ԶУ׼ TRIM ֵ Flash ַ(NV32_flltrim), SystemInit 󱣴ֵ
+ * ICS_TRIM_VALUE, б; 0:  */
+#define FLLTRIM_FLASH_ADDRESS     ( 0 )
+
+/*Ƿ紦(NV32_pwrfail),  LVD_LVW_IRQHandler */
+#define PWRFAIL_ENABLED           ( 0 )
+
+/*紦(NV32_pwrfail)Ӧ״̬ Flash ַ, б; 0:  */
+#define PWRFAIL_FLASH_ADDRESS     ( 0 )
+
+/*ʱӦ״̬, ż */
+#define PWRFAIL_STATE_WORDS       ( 6 )
+
+/*Ƿ: ICS ѴĿģʽ(δλʱٴν SystemInit,  Bootloader ת)ʱ
+ * SystemInit  ICS ʼ, SystemCoreClock ɱļʱڱʱ */
+#define FAST_BOOT_ENABLED         ( 0 )
+
+/*ʱǷƳʱл: ÿθλ SystemInit ָλʱ FEI 2 Ƶ(24MHz),
+ * ֻдֵ, ȴ FLL ;ȶ;  main  SystemClockComplete
+ * лļõģʽ */
+#define FAST_BOOT_DEFER_CLOCK     ( 0 )
+
+/*Ƿʱ: SystemInit  SysTick, main ͷ SystemBootClocks ȡںʱֹͣ SysTick */
+#define BOOT_TIME_ENABLED         ( 0 )
+
+/*ʱʹõ PIT ͨ, 0  1 */
+#define SWTMR_PIT_CHANNEL         ( 0 )
+
+/*ʱĽ, λ us */
+#define SWTMR_TICK_US             ( 1000 )
+
+/*йʹõֹͣģʽ: PmcModeStop3  PmcModeStop4(ֹͣģʽ± LVD) */
+#define IDLE_STOP_MODE            ( PmcModeStop3 )
+
+/*ֹͣģʽ̿н, 踲 FLL ʱ RTC  */
+#define IDLE_STOP_MIN_TICKS       ( 5 )
+
+/*ʱſشʱֹֹͣģʽ: SIM_SCGC λ */
+#define IDLE_STOP_BLOCK_MASK      ( SIM_SCGC_ETM0_MASK | SIM_SCGC_ETM1_MASK | SIM_SCGC_ETM2_MASK | \
+                                    SIM_SCGC_IIC_MASK | SIM_SCGC_SPI0_MASK | SIM_SCGC_SPI1_MASK | \
+                                    SIM_SCGC_UART0_MASK | SIM_SCGC_UART1_MASK | SIM_SCGC_UART2_MASK | \
+                                    SIM_SCGC_ADC_MASK )
+
+/*ֹͣģʽ¼ʱ RTC ʱ: ڲοʱ ICSIRCLK, 32 Ƶ */
+#define IDLE_RTC_CLKSRC           ( RTC_CLKSRC_IREF )
+#define IDLE_RTC_PRESCALER        ( RTC_CLK_PRESCALER_100 )   /* RTCLKS=10 ʱΪ 32 Ƶ */
+#define IDLE_RTC_CLOCK_HZ         ( 37500 )
+#define IDLE_RTC_DIVIDER          ( 32 )
+
+/*йǷ(NV32_calendar) RTC Ӽʱ, ռ RTC */
+#define IDLE_USE_CALENDAR         ( 0 )
+
+/*ʹõ RTC ʱ: ڲοʱ ICSIRCLK, 32 Ƶ
+ * ʹ 32.768KHz ʱѡ RTC_CLKSRC_EXTERNAL, 32 Ƶõ 1024Hz */
+#define CAL_RTC_CLKSRC            ( RTC_CLKSRC_IREF )
+#define CAL_RTC_PRESCALER         ( RTC_CLK_PRESCALER_100 )   /* RTCLKS=x0 ʱΪ 32 Ƶ */
+#define CAL_RTC_CLOCK_HZ          ( 37500 )
+#define CAL_RTC_DIVIDER           ( 32 )
+
+/*ɨÿе, λΪʱ */
+#define KEYPAD_SCAN_TICKS         ( 2 )
+
+/*̻֡, һ֡ɨһ */
+#define KEYPAD_DEBOUNCE_FRAMES    ( 3 )
+
+/*¼г, Ϊ 2  */
+#define KEYPAD_QUEUE_SIZE         ( 16 )
+
+/*Ƿͨλ BME ޸ĹĴ(GPIO_Init, ADC_SetChannel, UART_EnableInterrupt ),
+ * 1: װεַд, ԭ, ж; 0: ͨ--д
+ * GPIO  0x4000F000  BME, õַδ NV32 ֤, ĬϹر */
+#define BME_ENABLED               ( 0 )
+
+/*岢ߺλĴѡͨźŶⱣֵںʱ, 0 ~ 3, ĬѡͨΪ 1 ںʱ */
+#define PBUS_STROBE_STRETCH       ( 0 )
+
+/* I2C ȴӻ SCL(ʱչ)ʱ, λ us */
+#define SWBUS_I2C_STRETCH_US      ( 1000 )
+
+/*Ƿ SystemInit ажƵ RAM, 1: ûصʱֱӰѴװ */
+#define VECTOR_IN_RAM             ( 0 )
+
+/*жϵľ̬ص: ȡעͲдӦú, ֱʵֶӦ xxx_IRQHandler øú,
+ * ʱ, پصָͿָж, Ӧ xxx_SetCallback ֻ NULL ú.
+ * UART صΪ void f( UART_Type * pUART ), Ϊ void f( void ). RTC  Application е
+ * RTC_IRQHandler ͬʱʹ */
+//#define ADC_STATIC_CALLBACK       ADC_Handler
+//#define ACMP0_STATIC_CALLBACK     ACMP0_Handler
+//#define ACMP1_STATIC_CALLBACK     ACMP1_Handler
+//#define ETM0_STATIC_CALLBACK      ETM0_Handler
+//#define ETM1_STATIC_CALLBACK      ETM1_Handler
+//#define ETM2_STATIC_CALLBACK      ETM2_Handler
+//#define I2C0_STATIC_CALLBACK      I2C0_Handler
+//#define KBI0_STATIC_CALLBACK      KBI0_Handler
+//#define KBI1_STATIC_CALLBACK      KBI1_Handler
+//#define PIT_CH0_STATIC_CALLBACK   PIT_CH0_Handler
+//#define PIT_CH1_STATIC_CALLBACK   PIT_CH1_Handler
+//#define RTC_STATIC_CALLBACK       RTC_Handler
+//#define SPI0_STATIC_CALLBACK      SPI0_Handler
+//#define SPI1_STATIC_CALLBACK      SPI1_Handler
+//#define UART_STATIC_CALLBACK      UART_Handler
+
+/*׼ BENCH_RunSuite  GPIO תʹõ, ÿηת, ״̬ */
+#define BENCH_GPIO_PIN            ( GPIO_PTA0 )
+
+/*ǷͳжϷִʱӳ(NV32_isrstat), 1: ÿж϶ʮںʱ, 0:  */
+#define ISRSTAT_ENABLED           ( 0 )
+
+/*ǷƸټ¼ TRACE0 ~ TRACE3(NV32_trace), 0: Ϊ; λΪ 2  */
+#define TRACE_ENABLED             ( 0 )
+#define TRACE_RING_WORDS          ( 256 )
+
+/* A/B ̼(NV32_boot) Flash : ռ BOOT_SLOT_A_ADDRESS , һΪ
+ * ¼; Ӧò۴Сͬ,  NV32F100_Boot/SlotA/SlotB.icf һ */
+#define BOOT_CONTROL_ADDRESS      ( 0x1E00 )
+#define BOOT_SLOT_A_ADDRESS       ( 0x2000 )
+#define BOOT_SLOT_B_ADDRESS       ( 0x11000 )
+#define BOOT_SLOT_SIZE            ( 0xF000 )
+
+/*¹̼δӦȷǰ, ֮عһȷϵĹ̼ */
+#define BOOT_TRIES                ( 3 )
+
+/*λȴλʱ, λ ms */
+#define BOOT_LISTEN_MS            ( 200 )
+
+/*ʹõĲ, һ Flash ַʱ */
+#define BOOT_BAUDRATE             ( 115200 )
+
+/*λδȷϼ͵֡ÿֽ֡(8 ı),  1024 ֽڵĽջλ */
+#define BOOT_WINDOW               ( 4 )
+#define BOOT_BLOCK_SIZE           ( 128 )
+
 
 #endif /* NVxx_CONFIG_H_ */
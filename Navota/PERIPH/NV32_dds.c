@@ -0,0 +1,269 @@
+/******************************************************************************
+* @brief providing APIs for direct digital synthesis (DDS) waveform generator.
+*
+*******************************************************************************
+*
+* A 32-bit phase accumulator advances once per PWM period in the ETM overflow
+* interrupt. The upper DDS_TABLE_BITS bits index the wave table, the next 15
+* bits interpolate linearly between two samples, so the product with any
+* sample step of an int16_t table fits 32 bits. The new duty is written to
+* CnV, which the ETM loads at the end of the current period, so frequency,
+* amplitude and table changes never produce a partial pulse. The output is
+* meant to be RC filtered (actuator excitation) or drive a buzzer directly.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_dds.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * @brief one period of sine in Q15, DDS_TABLE_SIZE + 1 samples.
+ */
+const int16_t DDS_SineTable[DDS_TABLE_SIZE + 1] =
+{
+       0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+    6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+   12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+   18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+   23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+   27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+   30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+   32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+   32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+   32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+   30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+   27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+   23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+   18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+   12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+    6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+       0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+   -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+  -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+  -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+  -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+  -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+  -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+  -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+  -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+  -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+  -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+  -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+  -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+  -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+  -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+   -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804,
+       0
+};
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define DDS_FRAC_SHIFT          ( 32 - DDS_TABLE_BITS - 15 )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static void DDS_Isr( void );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static ETM_Type                   *DDS_pETM;
+static uint8_t                    DDS_u8Channel;
+static uint16_t                   DDS_u16Middle;        /*!< CnV for a zero sample */
+static uint16_t                   DDS_u16HalfPeriod;
+static uint32_t                   DDS_u32Period;        /*!< PWM period in ETM clocks */
+static uint32_t                   DDS_u32ClockHz;
+static uint32_t                   DDS_u32Phase;
+static volatile uint32_t          DDS_u32PhaseInc;
+static volatile int32_t           DDS_i32Gain;          /*!< CnV counts for a full scale sample */
+static const int16_t * volatile   DDS_pi16Table;
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  ETM overflow service: advance the phase and load the next sample.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void DDS_Isr( void )
+{
+  const int16_t *pi16Table = DDS_pi16Table;
+  uint32_t u32Phase;
+  uint32_t u32Index;
+  int32_t  i32Frac;
+  int32_t  i32Sample;
+  ETM_ClrOverFlowFlag( DDS_pETM );
+  u32Phase     = DDS_u32Phase + DDS_u32PhaseInc;
+  DDS_u32Phase = u32Phase;
+  u32Index     = u32Phase >> ( 32 - DDS_TABLE_BITS );
+  i32Frac      = ( u32Phase >> DDS_FRAC_SHIFT ) & 0x7FFF;
+  i32Sample    = pi16Table[u32Index];
+  i32Sample   += ( ( pi16Table[u32Index + 1] - i32Sample ) * i32Frac ) >> 15;
+  DDS_pETM->CONTROLS[DDS_u8Channel].CnV = DDS_u16Middle + ( ( i32Sample * DDS_i32Gain ) >> 15 );
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* DDS api lists
+*
+*//*! @addtogroup dds_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  initialize the ETM for edge aligned PWM and start generating. The
+*         ETM module is dedicated to the generator while it runs.
+*
+* @param[in]    pConfig     pointer to DDS configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void DDS_Init( DDS_ConfigType * pConfig )
+{
+  ETM_Type *pETM = pConfig->pETM;
+  ASSERT( ( ( ETM0 == pETM ) && ( pConfig->u8Channel < 2 ) ) ||
+          ( ( ETM1 == pETM ) && ( pConfig->u8Channel < 2 ) ) ||
+          ( ( ETM2 == pETM ) && ( pConfig->u8Channel < 6 ) ) );
+  ASSERT( pConfig->u16Modulo < 0xFFFF );
+  DDS_pETM          = pETM;
+  DDS_u8Channel     = pConfig->u8Channel;
+  DDS_u32Period     = ( uint32_t )pConfig->u16Modulo + 1;
+  DDS_u16HalfPeriod = DDS_u32Period >> 1;
+  DDS_u16Middle     = DDS_u16HalfPeriod;
+  /* the ETM counts the timer clock, which is the ICS output clock */
+  DDS_u32ClockHz    = SystemClockGet( CLOCK_CORE ) >> pConfig->u8ClockPrescale;
+  DDS_u32Phase      = 0;
+  DDS_pi16Table     = pConfig->pi16Table;
+  DDS_SetAmplitude( pConfig->u16Amplitude );
+  DDS_SetFrequency( pConfig->u32Frequency_mHz );
+
+  if ( ETM0 == pETM )
+  {
+    SIM->SCGC |= SIM_SCGC_ETM0_MASK;
+    NVIC_EnableIRQ( ETM0_IRQn );
+  }
+
+#if !defined(CPU_NV32M3)
+  else if ( ETM1 == pETM )
+  {
+    SIM->SCGC |= SIM_SCGC_ETM1_MASK;
+    NVIC_EnableIRQ( ETM1_IRQn );
+  }
+
+#endif
+  else
+  {
+    SIM->SCGC |= SIM_SCGC_ETM2_MASK;
+    NVIC_EnableIRQ( ETM2_IRQn );
+  }
+
+  ETM_SetCallback( pETM, DDS_Isr );
+  pETM->SC  = 0;
+  pETM->CNT = 0;
+  pETM->MOD = pConfig->u16Modulo;
+  /* edge aligned, high true pulses */
+  pETM->CONTROLS[DDS_u8Channel].CnSC = ETM_CnSC_MSB_MASK | ETM_CnSC_ELSB_MASK;
+  pETM->CONTROLS[DDS_u8Channel].CnV  = DDS_u16Middle;
+  ETM_EnableOverflowInt( pETM );
+  ETM_ClockSet( pETM, ETM_CLOCK_SYSTEMCLOCK, pConfig->u8ClockPrescale );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop generating and reset the ETM module.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void DDS_DeInit( void )
+{
+  ETM_DeInit( DDS_pETM );
+  ETM_SetCallback( DDS_pETM, ( ETM_CallbackPtr )NULL );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  set the output frequency, phase continuous.
+*
+* @param[in]    u32Frequency_mHz    output frequency in mHz, below half the
+*                                   PWM frequency.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void DDS_SetFrequency( uint32_t u32Frequency_mHz )
+{
+  uint64_t u64Num;
+  uint64_t u64Den;
+  uint64_t u64High;
+  /* increment = f * period * 2^32 / ( clock * 1000 ), in two steps to stay in 64 bits */
+  u64Num  = ( ( uint64_t )u32Frequency_mHz * DDS_u32Period ) << 20;
+  u64Den  = ( uint64_t )DDS_u32ClockHz * 1000;
+  u64High = u64Num / u64Den;
+  DDS_u32PhaseInc = ( uint32_t )( ( u64High << 12 ) + ( ( ( u64Num - u64High * u64Den ) << 12 ) / u64Den ) );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  set the output amplitude, takes effect with the next sample.
+*
+* @param[in]    u16Amplitude    amplitude in Q15, 32767 swings the duty
+*                               from 0 to the full PWM period.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void DDS_SetAmplitude( uint16_t u16Amplitude )
+{
+  ASSERT( u16Amplitude <= 0x7FFF );
+  DDS_i32Gain = ( ( int32_t )DDS_u16HalfPeriod * u16Amplitude ) >> 15;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  switch the wave table, takes effect with the next sample.
+*
+* @param[in]    pi16Table   wave table of DDS_TABLE_SIZE + 1 Q15 samples.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void DDS_SetTable( const int16_t * pi16Table )
+{
+  DDS_pi16Table = pi16Table;
+}
+
+/*! @} End of dds_api_list                                                    */
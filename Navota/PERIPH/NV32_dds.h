@@ -0,0 +1,82 @@
+/******************************************************************************
+* @brief header file for direct digital synthesis (DDS) waveform generator.
+*
+*******************************************************************************
+*
+* provide APIs for generating sine or arbitrary waveforms as PWM duty on one
+* ETM channel, one sample per PWM period
+******************************************************************************/
+#ifndef __NV32_DDS_H__
+#define __NV32_DDS_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_etm.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define DDS_TABLE_BITS          8                           /*!< log2 of the wave table length */
+#define DDS_TABLE_SIZE          ( 1 << DDS_TABLE_BITS )     /*!< samples per waveform period */
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* DDS configure struct.
+*
+*//*! @addtogroup dds_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief DDS configure struct.
+*
+* The sample rate is the edge aligned PWM frequency, ETM clock / prescaler /
+* ( u16Modulo + 1 ). Wave tables hold DDS_TABLE_SIZE + 1 signed Q15 samples,
+* the last one equal to the first so interpolation needs no wrap.
+*/
+typedef struct
+{
+  ETM_Type          *pETM;              /*!< ETM0, ETM1 or ETM2 */
+  uint8_t           u8Channel;          /*!< PWM output channel of pETM */
+  uint8_t           u8ClockPrescale;    /*!< ETM_CLOCK_PS_DIV1 ~ ETM_CLOCK_PS_DIV128 */
+  uint16_t          u16Modulo;          /*!< PWM period - 1 in ETM clocks */
+  uint16_t          u16Amplitude;       /*!< output amplitude in Q15, 32767 is full swing */
+  uint32_t          u32Frequency_mHz;   /*!< output frequency in mHz */
+  const int16_t     *pi16Table;         /*!< wave table, DDS_SineTable or user table */
+} DDS_ConfigType, *DDS_ConfigPtr;
+/*! @} End of dds_configstruct                                                */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+extern const int16_t DDS_SineTable[DDS_TABLE_SIZE + 1];
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void DDS_Init( DDS_ConfigType * pConfig );
+void DDS_DeInit( void );
+void DDS_SetFrequency( uint32_t u32Frequency_mHz );
+void DDS_SetAmplitude( uint16_t u16Amplitude );
+void DDS_SetTable( const int16_t * pi16Table );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_DDS_H__ */
@@ -8,6 +8,8 @@
 ******************************************************************************/
 #include "NV32_config.h"
 #include "NV32_ETM.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
 
 /******************************************************************************
 * Global variables
@@ -24,6 +26,21 @@
 /******************************************************************************
 * Local function prototypes
 ******************************************************************************/
+#ifdef ETM0_STATIC_CALLBACK
+void ETM0_STATIC_CALLBACK( void );
+#else
+void ETM0_Isr( void );
+#endif
+#ifdef ETM1_STATIC_CALLBACK
+void ETM1_STATIC_CALLBACK( void );
+#else
+void ETM1_Isr( void );
+#endif
+#ifdef ETM2_STATIC_CALLBACK
+void ETM2_STATIC_CALLBACK( void );
+#else
+void ETM2_Isr( void );
+#endif
 
 /******************************************************************************
 * Local variables
@@ -33,10 +50,35 @@
 * Local functions
 ******************************************************************************/
 
+/*****************************************************************************//*!
+*
+* @brief  ETM isr body, shared by the static and the dynamic handler.
+*
+* @param[in]    u8Id          ISRSTAT_ETM0 ~ ISRSTAT_ETM2.
+* @param[in]    pfnCallback   callback, a constant in the static handler.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE void ETM_Isr( uint8_t u8Id, ETM_CallbackPtr pfnCallback )
+{
+  ISRSTAT_ENTER( u8Id );
+  if ( pfnCallback )
+  {
+    pfnCallback();
+  }
+
+  ISRSTAT_EXIT( u8Id );
+}
+
 /******************************************************************************
 * Global functions
 ******************************************************************************/
+#if !defined( ETM0_STATIC_CALLBACK ) || !defined( ETM1_STATIC_CALLBACK ) || !defined( ETM2_STATIC_CALLBACK )
 ETM_CallbackPtr ETM_Callback[3] = {( ETM_CallbackPtr )NULL};
+#endif
 
 
 /******************************************************************************
@@ -878,7 +920,45 @@ void  ETM_SyncConfigDeactivate( ETM_Type * pETM, uint32_t u32ConfigValue )
 *****************************************************************************/
 void  ETM_SetCallback( ETM_Type * pETM, ETM_CallbackPtr pfnCallback )
 {
-  ETM_Callback[( ( uint32_t )pETM - ( uint32_t )ETM0_BASE ) >> 12] = pfnCallback;
+  uint32_t u32Index = ( ( uint32_t )pETM - ( uint32_t )ETM0_BASE ) >> 12;
+
+  /* ETMx_Isr only calls the callback, vector to it directly */
+  if ( u32Index == 0 )
+  {
+#ifdef ETM0_STATIC_CALLBACK
+    /* bound at link time, ETM0_IRQHandler calls ETM0_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == ETM0_STATIC_CALLBACK ) );
+#else
+    ETM_Callback[0] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( ETM0_IRQn, VECTOR_DIRECT( pfnCallback, ETM0_Isr ) );
+#endif
+#endif
+  }
+  else if ( u32Index == 1 )
+  {
+#ifdef ETM1_STATIC_CALLBACK
+    /* bound at link time, ETM1_IRQHandler calls ETM1_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == ETM1_STATIC_CALLBACK ) );
+#else
+    ETM_Callback[1] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( ETM1_IRQn, VECTOR_DIRECT( pfnCallback, ETM1_Isr ) );
+#endif
+#endif
+  }
+  else
+  {
+#ifdef ETM2_STATIC_CALLBACK
+    /* bound at link time, ETM2_IRQHandler calls ETM2_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == ETM2_STATIC_CALLBACK ) );
+#else
+    ETM_Callback[2] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( ETM2_IRQn, VECTOR_DIRECT( pfnCallback, ETM2_Isr ) );
+#endif
+#endif
+  }
 }
 
 /*! @} End of ETM_api_list                                                    */
@@ -895,13 +975,17 @@ void  ETM_SetCallback( ETM_Type * pETM, ETM_CallbackPtr pfnCallback )
 * @ Pass/ Fail criteria: none.
 *
 *****************************************************************************/
+#ifdef ETM0_STATIC_CALLBACK
+void ETM0_IRQHandler( void )
+{
+  ETM_Isr( ISRSTAT_ETM0, ETM0_STATIC_CALLBACK );
+}
+#else
 void ETM0_Isr( void )
 {
-  if ( ETM_Callback[0] )
-  {
-    ETM_Callback[0]();
-  }
+  ETM_Isr( ISRSTAT_ETM0, ETM_Callback[0] );
 }
+#endif
 
 /*****************************************************************************//*!
 *
@@ -914,13 +998,17 @@ void ETM0_Isr( void )
 * @ Pass/ Fail criteria: none.
 *
 *****************************************************************************/
+#ifdef ETM1_STATIC_CALLBACK
+void ETM1_IRQHandler( void )
+{
+  ETM_Isr( ISRSTAT_ETM1, ETM1_STATIC_CALLBACK );
+}
+#else
 void ETM1_Isr( void )
 {
-  if ( ETM_Callback[1] )
-  {
-    ETM_Callback[1]();
-  }
+  ETM_Isr( ISRSTAT_ETM1, ETM_Callback[1] );
 }
+#endif
 
 /*****************************************************************************//*!
 *
@@ -933,13 +1021,17 @@ void ETM1_Isr( void )
 * @ Pass/ Fail criteria: none.
 *
 *****************************************************************************/
+#ifdef ETM2_STATIC_CALLBACK
+void ETM2_IRQHandler( void )
+{
+  ETM_Isr( ISRSTAT_ETM2, ETM2_STATIC_CALLBACK );
+}
+#else
 void ETM2_Isr( void )
 {
-  if ( ETM_Callback[2] )
-  {
-    ETM_Callback[2]();
-  }
+  ETM_Isr( ISRSTAT_ETM2, ETM_Callback[2] );
 }
+#endif
 
 
 
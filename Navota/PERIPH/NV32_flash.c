@@ -347,6 +347,7 @@ uint16_t NVM_Unsecure( void )
 __ramfunc void EFM_LaunchCMD( uint32_t EFM_CMD )
 {
   __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
 
   if ( ( EFMCMD & EFM_DONE_MASK ) == EFM_STATUS_READY )
   {
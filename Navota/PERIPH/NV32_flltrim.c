@@ -0,0 +1,501 @@
+/******************************************************************************
+* @brief providing APIs for ICS FLL auto-trim (FLLTRIM).
+*
+*******************************************************************************
+*
+* FLLTRIM_Measure counts core clocks over a number of periods of a known
+* reference. With the 32.768 kHz crystal the RTC counts the crystal and the
+* SysTick the core clocks between two RTC steps. With a pulse on an ETM pin
+* the ETM captures its edges in bus clocks. The SysTick is started when it
+* is stopped and used at its period when it runs, so it must be polled at
+* least once per period, which the loops here do.
+*
+* The RTC counter cannot be written and restarts when MOD is written, so a
+* running RTC cannot be borrowed without losing its count. The RTC reference
+* is refused while the RTC runs, e.g. under NV32_calendar or during an
+* NV32_idle sleep; the ETM capture serves then. A stopped RTC is given back
+* with its SC, MOD and clock gate as found.
+*
+* The IRC trim is C3 SCTRIM with C4 SCFTRIM below it, 512 steps, the clock
+* getting slower as the step grows. FLLTRIM_Run binary searches the step
+* nearest to the target in eleven measurements, FLLTRIM_Track measures once
+* and moves one step, cheap enough to follow the temperature from the main
+* loop. The FLL relocks in about 1 ms after each step, the measurement
+* waits for it.
+*
+* FLLTRIM_Store appends the trim to a flash sector at FLLTRIM_FLASH_ADDRESS,
+* one word per record, and erases the sector only when it is full, so the
+* sector wears 128 times slower than when rewritten. FLLTRIM_Load returns
+* the last record, SystemInit trims with it before the FLL is used.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_flltrim.h"
+#include "NV32_flash.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define FLLTRIM_RECORDS         ( FLASH_SECTOR_SIZE / 4 )
+#define FLLTRIM_ERASED          0xFFFFFFFF
+#define FLLTRIM_RECORD(trim)    ( ( uint32_t )( trim ) | ( ( uint32_t )( uint16_t )~( trim ) << 16 ) )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static uint32_t FLLTRIM_u32Period;          /*!< SysTick period, LOAD + 1 */
+static uint32_t FLLTRIM_u32Last;            /*!< SysTick value at the last poll */
+static uint32_t FLLTRIM_u32Clocks;          /*!< core clocks since FLLTRIM_ClockStart */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  start counting core clocks with the SysTick.
+*
+* @param  none.
+*
+* @return TRUE when the SysTick was stopped and is borrowed.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t FLLTRIM_ClockStart( void )
+{
+  uint8_t bBorrowed = FALSE;
+
+  if ( !( SysTick->CTRL & SysTick_CTRL_ENABLE_Msk ) )
+  {
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    bBorrowed     = TRUE;
+  }
+
+  FLLTRIM_u32Period = SysTick->LOAD + 1;
+  FLLTRIM_u32Last   = SysTick->VAL;
+  FLLTRIM_u32Clocks = 0;
+
+  return bBorrowed;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  core clocks since FLLTRIM_ClockStart, polled at least once per
+*         SysTick period.
+*
+* @param  none.
+*
+* @return core clocks.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t FLLTRIM_Clocks( void )
+{
+  uint32_t u32Now = SysTick->VAL;
+
+  /* the SysTick counts down */
+  FLLTRIM_u32Clocks += ( FLLTRIM_u32Last >= u32Now ) ? FLLTRIM_u32Last - u32Now :
+                       FLLTRIM_u32Last + FLLTRIM_u32Period - u32Now;
+  FLLTRIM_u32Last = u32Now;
+
+  return FLLTRIM_u32Clocks;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  count core clocks over the reference periods with the RTC.
+*
+* @param[in]    pConfig     reference.
+* @param[in]    u32Timeout  core clocks to wait for one RTC step.
+*
+* @return core clocks, 0 when the crystal does not run or the RTC runs
+*         for another user.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t FLLTRIM_MeasureRtc( FLLTRIM_ConfigType * pConfig, uint32_t u32Timeout )
+{
+  uint32_t u32Gate = SIM->SCGC & SIM_SCGC_RTC_MASK;
+  uint32_t u32Sc;
+  uint32_t u32Mod;
+  uint32_t u32Start = 0;
+  uint32_t u32Clocks;
+  uint32_t u32Edge;
+  uint16_t u16Count;
+  uint16_t i;
+
+  SIM->SCGC |= SIM_SCGC_RTC_MASK;
+  u32Sc  = RTC->SC;
+  u32Mod = RTC->MOD;
+
+  if ( u32Sc & RTC_SC_RTCPS_MASK )
+  {
+    SIM->SCGC &= ~SIM_SCGC_RTC_MASK | u32Gate;
+    return 0;
+  }
+
+  RTC_SetModulo( 0xFFFF );
+  RTC_SetClock( RTC_CLKSRC_EXTERNAL, RTC_CLK_PRESCALER_128 ); /* divide by 1 for the external clock */
+
+  /* period 0 starts at the first step */
+  for ( i = 0; i <= pConfig->u16Periods; i++ )
+  {
+    u16Count = RTC->CNT;
+    u32Edge  = FLLTRIM_Clocks();
+
+    while ( ( RTC->CNT == u16Count ) && ( FLLTRIM_Clocks() - u32Edge <= u32Timeout ) );
+
+    if ( RTC->CNT == u16Count )
+    {
+      break;
+    }
+
+    if ( i == 0 )
+    {
+      u32Start = FLLTRIM_Clocks();
+    }
+  }
+
+  u32Clocks = ( i > pConfig->u16Periods ) ? FLLTRIM_Clocks() - u32Start : 0;
+
+  /* stopped first, the counter clears; RTIF is write 1 to clear */
+  RTC->SC   = u32Sc & ~RTC_SC_RTIF_MASK;
+  RTC->MOD  = u32Mod;
+  SIM->SCGC &= ~SIM_SCGC_RTC_MASK | u32Gate;
+
+  return u32Clocks;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  count core clocks over the reference periods with the ETM capture.
+*
+* @param[in]    pConfig     reference.
+* @param[in]    u32Timeout  core clocks to wait for one edge.
+*
+* @return core clocks, 0 when no pulse comes.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t FLLTRIM_MeasureEtm( FLLTRIM_ConfigType * pConfig, uint32_t u32Timeout )
+{
+  ETM_Type *pETM   = pConfig->pETM;
+  uint8_t  u8Ch    = pConfig->u8Channel;
+  uint32_t u32Sum  = 0;
+  uint16_t u16Last = 0;
+  uint16_t u16Now;
+  uint32_t u32Edge;
+  uint16_t i;
+
+  /* polled, the channel interrupt stays off */
+  ETM_InputCaptureInit( pETM, u8Ch, ETM_INPUTCAPTURE_RISINGEDGE );
+  pETM->CONTROLS[u8Ch].CnSC &= ~ETM_CnSC_CHIE_MASK;
+  ETM_ClockSet( pETM, ETM_CLOCK_SYSTEMCLOCK, ETM_CLOCK_PS_DIV1 );
+
+  for ( i = 0; i <= pConfig->u16Periods; i++ )
+  {
+    u32Edge = FLLTRIM_Clocks();
+
+    while ( !( pETM->CONTROLS[u8Ch].CnSC & ETM_CnSC_CHF_MASK ) )
+    {
+      if ( FLLTRIM_Clocks() - u32Edge > u32Timeout )
+      {
+        ETM_ClockSet( pETM, ETM_CLOCK_NOCLOCK, ETM_CLOCK_PS_DIV1 );
+        return 0;
+      }
+    }
+
+    u16Now = ( uint16_t )pETM->CONTROLS[u8Ch].CnV;
+    pETM->CONTROLS[u8Ch].CnSC &= ~ETM_CnSC_CHF_MASK;
+
+    /* period shorter than the 16-bit counter */
+    if ( i > 0 )
+    {
+      u32Sum += ( uint16_t )( u16Now - u16Last );
+    }
+
+    u16Last = u16Now;
+  }
+
+  ETM_ClockSet( pETM, ETM_CLOCK_NOCLOCK, ETM_CLOCK_PS_DIV1 );
+
+  /* the ETM counts core clocks whatever the bus divider */
+  return u32Sum;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  core clock the config trims to.
+*
+* @param[in]    pConfig     reference.
+*
+* @return Hz.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t FLLTRIM_Target( FLLTRIM_ConfigType * pConfig )
+{
+  return pConfig->u32TargetHz ? pConfig->u32TargetHz : SystemCoreClock;
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* FLLTRIM api lists
+*
+*//*! @addtogroup flltrim_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  measure the core clock against the reference, after the FLL had
+*         1 ms to settle. An interrupt taken at an RTC step adds its time
+*         to the result, the ETM captures are exact.
+*
+* @param[in]    pConfig     reference.
+*
+* @return core clock in Hz, 0 when the reference is missing or the RTC
+*         runs for another user.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t FLLTRIM_Measure( FLLTRIM_ConfigType * pConfig )
+{
+  uint32_t u32Target  = FLLTRIM_Target( pConfig );
+  uint32_t u32Timeout = u32Target / pConfig->u32RefHz * 4;  /* 4 periods at the target */
+  uint32_t u32Clocks;
+  uint8_t  bBorrowed;
+
+  ASSERT( ( uint64_t )u32Target * pConfig->u16Periods / pConfig->u32RefHz < SysTick_LOAD_RELOAD_Msk );
+
+  bBorrowed = FLLTRIM_ClockStart();
+
+  while ( FLLTRIM_Clocks() < u32Target / 1000 );
+
+  if ( pConfig->u8Source == FLLTRIM_REF_RTC )
+  {
+    u32Clocks = FLLTRIM_MeasureRtc( pConfig, u32Timeout );
+  }
+  else
+  {
+    u32Clocks = FLLTRIM_MeasureEtm( pConfig, u32Timeout );
+  }
+
+  if ( bBorrowed )
+  {
+    SysTick->CTRL = 0;
+  }
+
+  return ( uint32_t )( ( ( uint64_t )u32Clocks * pConfig->u32RefHz + pConfig->u16Periods / 2 ) / pConfig->u16Periods );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  binary search the trim step nearest to the target. The clock
+*         moves over its whole range meanwhile, run it before the
+*         communication starts or with it held.
+*
+* @param[in]    pConfig     reference.
+*
+* @return TRUE when trimmed, FALSE when the reference is missing, the trim
+*         is then left as it was.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t FLLTRIM_Run( FLLTRIM_ConfigType * pConfig )
+{
+  uint32_t u32Target = FLLTRIM_Target( pConfig );
+  uint16_t u16Saved  = FLLTRIM_GetStep();
+  uint16_t u16Low    = 0;
+  uint16_t u16High   = FLLTRIM_STEPS - 1;
+  uint16_t u16Mid;
+  uint32_t u32Error;
+  uint32_t u32Hz;
+
+  /* first step at or below the target */
+  while ( u16Low < u16High )
+  {
+    u16Mid = ( u16Low + u16High ) / 2;
+    FLLTRIM_SetStep( u16Mid );
+    u32Hz = FLLTRIM_Measure( pConfig );
+
+    if ( u32Hz == 0 )
+    {
+      FLLTRIM_SetStep( u16Saved );
+      return FALSE;
+    }
+
+    if ( u32Hz > u32Target )
+    {
+      u16Low  = u16Mid + 1;
+    }
+    else
+    {
+      u16High = u16Mid;
+    }
+  }
+
+  /* the step above may be nearer */
+  if ( u16Low > 0 )
+  {
+    FLLTRIM_SetStep( u16Low );
+    u32Hz    = FLLTRIM_Measure( pConfig );
+    u32Error = ( u32Hz > u32Target ) ? u32Hz - u32Target : u32Target - u32Hz;
+
+    FLLTRIM_SetStep( u16Low - 1 );
+    u32Hz    = FLLTRIM_Measure( pConfig );
+
+    if ( ( ( u32Hz > u32Target ) ? u32Hz - u32Target : u32Target - u32Hz ) > u32Error )
+    {
+      FLLTRIM_SetStep( u16Low );
+    }
+  }
+  else
+  {
+    FLLTRIM_SetStep( u16Low );
+  }
+
+  return TRUE;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  measure once and move the trim one step toward the target when
+*         the error is above half a step, about 0.1 %. Called from the main
+*         loop now and then, e.g. every second.
+*
+* @param[in]    pConfig     reference.
+*
+* @return TRUE when the trim moved.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t FLLTRIM_Track( FLLTRIM_ConfigType * pConfig )
+{
+  uint32_t u32Target = FLLTRIM_Target( pConfig );
+  uint32_t u32Hz     = FLLTRIM_Measure( pConfig );
+  uint32_t u32Margin = u32Target / 1000;
+  uint16_t u16Step   = FLLTRIM_GetStep();
+
+  if ( u32Hz == 0 )
+  {
+    return FALSE;
+  }
+
+  if ( ( u32Hz > u32Target + u32Margin ) && ( u16Step < FLLTRIM_STEPS - 1 ) )
+  {
+    FLLTRIM_SetStep( u16Step + 1 );
+    return TRUE;
+  }
+
+  if ( ( u32Hz + u32Margin < u32Target ) && ( u16Step > 0 ) )
+  {
+    FLLTRIM_SetStep( u16Step - 1 );
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  trim stored last, for ICS_Trim. Reads the flash only, so SystemInit
+*         may call it before the C startup.
+*
+* @param  none.
+*
+* @return the stored trim, ICS_TRIM_VALUE when none is stored.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint16_t FLLTRIM_Load( void )
+{
+#if ( FLLTRIM_FLASH_ADDRESS != 0 )
+  const uint32_t *pRecord = ( const uint32_t * )FLLTRIM_FLASH_ADDRESS;
+  uint16_t       u16Trim  = ICS_TRIM_VALUE;
+  uint32_t       i;
+
+  for ( i = 0; ( i < FLLTRIM_RECORDS ) && ( pRecord[i] != FLLTRIM_ERASED ); i++ )
+  {
+    if ( pRecord[i] == FLLTRIM_RECORD( pRecord[i] & 0xFFFF ) )
+    {
+      u16Trim = ( uint16_t )pRecord[i];
+    }
+  }
+
+  return u16Trim;
+#else
+  return ICS_TRIM_VALUE;
+#endif
+}
+
+/*****************************************************************************//*!
+*
+* @brief  append the trim now set to the flash sector when it differs from
+*         the stored one. Flash_Init must have run at the present clock.
+*
+* @param  none.
+*
+* @return FLASH_ERR_SUCCESS or the flash error.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint16_t FLLTRIM_Store( void )
+{
+#if ( FLLTRIM_FLASH_ADDRESS != 0 )
+  const uint32_t *pRecord = ( const uint32_t * )FLLTRIM_FLASH_ADDRESS;
+  uint16_t       u16Trim  = ICS->C3 | ( ( uint16_t )( ICS->C4 & ICS_C4_SCFTRIM_MASK ) << 8 );
+  uint16_t       u16Err;
+  uint32_t       i;
+
+  if ( u16Trim == FLLTRIM_Load() )
+  {
+    return FLASH_ERR_SUCCESS;
+  }
+
+  for ( i = 0; ( i < FLLTRIM_RECORDS ) && ( pRecord[i] != FLLTRIM_ERASED ); i++ );
+
+  if ( i == FLLTRIM_RECORDS )
+  {
+    u16Err = Flash_EraseSector( FLLTRIM_FLASH_ADDRESS );
+
+    if ( u16Err != FLASH_ERR_SUCCESS )
+    {
+      return u16Err;
+    }
+
+    i = 0;
+  }
+
+  return Flash_Program1LongWord( FLLTRIM_FLASH_ADDRESS + i * 4, FLLTRIM_RECORD( u16Trim ) );
+#else
+  return FLASH_ERR_INVALID_PARAM;
+#endif
+}
+/*! @} End of flltrim_api_list                                                */
@@ -0,0 +1,122 @@
+/******************************************************************************
+* @brief header file for ICS FLL auto-trim (FLLTRIM).
+*
+*******************************************************************************
+*
+* provide APIs for trimming the internal reference clock against the 32 kHz
+* crystal on the RTC or a reference pulse on an ETM capture pin, tracking
+* the trim while running and keeping it in flash for the next boot
+******************************************************************************/
+#ifndef __NV32_FLLTRIM_H__
+#define __NV32_FLLTRIM_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_ics.h"
+#include "NV32_rtc.h"
+#include "NV32_etm.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define FLLTRIM_REF_RTC         0           /*!< 32.768 kHz crystal on the OSC, counted by the RTC */
+#define FLLTRIM_REF_ETM         1           /*!< reference pulse on an ETM channel, rising edges */
+
+#define FLLTRIM_STEPS           512         /*!< C3 SCTRIM with C4 SCFTRIM as the finest bit */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* FLLTRIM configure struct.
+*
+*//*! @addtogroup flltrim_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief reference used for the trim. The RTC or the ETM channel belongs to
+*        the trim while it measures.
+*/
+typedef struct
+{
+  uint8_t       u8Source;           /*!< FLLTRIM_REF_RTC or FLLTRIM_REF_ETM */
+  ETM_Type      *pETM;              /*!< capture timer for FLLTRIM_REF_ETM, clocked by the application */
+  uint8_t       u8Channel;          /*!< capture channel, its pin routed by the application */
+  uint32_t      u32RefHz;           /*!< reference frequency, 32768 for the crystal */
+  uint16_t      u16Periods;         /*!< reference periods per measurement */
+  uint32_t      u32TargetHz;        /*!< core clock to trim to, 0 for SystemCoreClock */
+} FLLTRIM_ConfigType, *FLLTRIM_ConfigPtr;
+/*! @} End of flltrim_configstruct                                            */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+/******************************************************************************
+* FLLTRIM inline functions
+*
+*//*! @addtogroup flltrim_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  set a trim step, 0 is the fastest clock. Waits for the FLL lock.
+*
+* @param[in]    u16Step     0 ~ FLLTRIM_STEPS - 1.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE void FLLTRIM_SetStep( uint16_t u16Step )
+{
+  ICS_Trim( ( u16Step >> 1 ) | ( ( u16Step & 1 ) << 8 ) );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  trim step now set.
+*
+* @param  none.
+*
+* @return 0 ~ FLLTRIM_STEPS - 1.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE uint16_t FLLTRIM_GetStep( void )
+{
+  return ( ( uint16_t )ICS->C3 << 1 ) | ( ICS->C4 & ICS_C4_SCFTRIM_MASK );
+}
+
+/*! @} End of flltrim_api_list                                                */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+uint32_t FLLTRIM_Measure( FLLTRIM_ConfigType * pConfig );
+uint8_t FLLTRIM_Run( FLLTRIM_ConfigType * pConfig );
+uint8_t FLLTRIM_Track( FLLTRIM_ConfigType * pConfig );
+uint16_t FLLTRIM_Load( void );
+uint16_t FLLTRIM_Store( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_FLLTRIM_H__ */
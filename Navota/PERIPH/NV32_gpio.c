@@ -3,6 +3,7 @@
 *
 ******************************************************************************/
 #include "NV32_gpio.h"
+#include "NV32_BME.h"
 
 /******************************************************************************
 * Local variables
@@ -89,13 +90,13 @@ void GPIO_Init( GPIO_Type * pGPIO, uint32_t u32PinMask, GPIO_PinConfigType sGpio
   /* Config GPIO for Input or Output */
   if ( ( sGpioType == GPIO_PinOutput ) || ( sGpioType == GPIO_PinOutput_HighCurrent ) )
   {
-    pGPIO->PDDR |= u32PinMask;      /* Enable Port Data Direction Register */
-    pGPIO->PIDR |= u32PinMask;      /* Set Port Input Disable Register */
+    BME_GPIO_SET( pGPIO->PDDR, u32PinMask );      /* Enable Port Data Direction Register */
+    BME_GPIO_SET( pGPIO->PIDR, u32PinMask );      /* Set Port Input Disable Register */
   }
   else if ( ( sGpioType == GPIO_PinInput ) || ( sGpioType == GPIO_PinInput_InternalPullup ) )
   {
-    pGPIO->PDDR &= ~u32PinMask;   /* Disable Port Data Direction Register */
-    pGPIO->PIDR &= ~u32PinMask;   /* Clear Port Input Disable Register */
+    BME_GPIO_CLEAR( pGPIO->PDDR, u32PinMask );   /* Disable Port Data Direction Register */
+    BME_GPIO_CLEAR( pGPIO->PIDR, u32PinMask );   /* Clear Port Input Disable Register */
   }
 
   /* Config PORT Pull select for GPIO */
@@ -104,11 +105,11 @@ void GPIO_Init( GPIO_Type * pGPIO, uint32_t u32PinMask, GPIO_PinConfigType sGpio
   switch ( ( uint32_t )pGPIO )
   {
     case GPIOA_BASE:
-      ( sGpioType == GPIO_PinInput_InternalPullup ) ? ( PORT->PUEL |= u32PinMask ) : ( PORT->PUEL &= ~u32PinMask );
+      ( sGpioType == GPIO_PinInput_InternalPullup ) ? BME_REG_SET( PORT->PUEL, u32PinMask ) : BME_REG_CLEAR( PORT->PUEL, u32PinMask );
       break;
 
     case GPIOB_BASE:
-      ( sGpioType == GPIO_PinInput_InternalPullup ) ? ( PORT->PUEH |= u32PinMask ) : ( PORT->PUEH &= ~u32PinMask );
+      ( sGpioType == GPIO_PinInput_InternalPullup ) ? BME_REG_SET( PORT->PUEH, u32PinMask ) : BME_REG_CLEAR( PORT->PUEH, u32PinMask );
       break;
 
     default:
@@ -121,7 +122,7 @@ void GPIO_Init( GPIO_Type * pGPIO, uint32_t u32PinMask, GPIO_PinConfigType sGpio
   switch ( ( uint32_t )pGPIO )
   {
     case GPIOA_BASE:
-      ( sGpioType == GPIO_PinInput_InternalPullup ) ? ( PORT->PUEL |= u32PinMask ) : ( PORT->PUEL &= ~u32PinMask );
+      ( sGpioType == GPIO_PinInput_InternalPullup ) ? BME_REG_SET( PORT->PUEL, u32PinMask ) : BME_REG_CLEAR( PORT->PUEL, u32PinMask );
       break;
 
     default:
@@ -134,15 +135,15 @@ void GPIO_Init( GPIO_Type * pGPIO, uint32_t u32PinMask, GPIO_PinConfigType sGpio
   switch ( ( uint32_t )pGPIO )
   {
     case GPIOA_BASE:
-      ( sGpioType == GPIO_PinInput_InternalPullup ) ? ( PORT->PUE0 |= u32PinMask ) : ( PORT->PUE0 &= ~u32PinMask );
+      ( sGpioType == GPIO_PinInput_InternalPullup ) ? BME_REG_SET( PORT->PUE0, u32PinMask ) : BME_REG_CLEAR( PORT->PUE0, u32PinMask );
       break;
 
     case GPIOB_BASE:
-      ( sGpioType == GPIO_PinInput_InternalPullup ) ? ( PORT->PUE1 |= u32PinMask ) : ( PORT->PUE1 &= ~u32PinMask );
+      ( sGpioType == GPIO_PinInput_InternalPullup ) ? BME_REG_SET( PORT->PUE1, u32PinMask ) : BME_REG_CLEAR( PORT->PUE1, u32PinMask );
       break;
 
     case GPIOC_BASE:
-      ( sGpioType == GPIO_PinInput_InternalPullup ) ? ( PORT->PUE2 |= u32PinMask ) : ( PORT->PUE2 &= ~u32PinMask );
+      ( sGpioType == GPIO_PinInput_InternalPullup ) ? BME_REG_SET( PORT->PUE2, u32PinMask ) : BME_REG_CLEAR( PORT->PUE2, u32PinMask );
       break;
 
     default:
@@ -155,17 +156,17 @@ void GPIO_Init( GPIO_Type * pGPIO, uint32_t u32PinMask, GPIO_PinConfigType sGpio
 
   if ( u32PinMask & GPIO_PTC5_MASK )
   {
-    PORT->HDRVE |= PORT_HDRVE_PTC5_MASK;
+    BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTC5_MASK );
   }
 
   if ( u32PinMask & GPIO_PTC1_MASK )
   {
-    PORT->HDRVE |= PORT_HDRVE_PTC1_MASK;
+    BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTC1_MASK );
   }
 
   if ( u32PinMask & GPIO_PTB5_MASK )
   {
-    PORT->HDRVE |= PORT_HDRVE_PTB5_MASK;
+    BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTB5_MASK );
   }
 
 #endif
@@ -175,22 +176,22 @@ void GPIO_Init( GPIO_Type * pGPIO, uint32_t u32PinMask, GPIO_PinConfigType sGpio
   {
     if ( u32PinMask & GPIO_PTB4_MASK )
     {
-      PORT->HDRVE |= PORT_HDRVE_PTB4_MASK;
+      BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTB4_MASK );
     }
 
     if ( u32PinMask & GPIO_PTB5_MASK )
     {
-      PORT->HDRVE |= PORT_HDRVE_PTB5_MASK;
+      BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTB5_MASK );
     }
 
     if ( u32PinMask & GPIO_PTD0_MASK )
     {
-      PORT->HDRVE |= PORT_HDRVE_PTD0_MASK;
+      BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTD0_MASK );
     }
 
     if ( u32PinMask & GPIO_PTD1_MASK )
     {
-      PORT->HDRVE |= PORT_HDRVE_PTD1_MASK;
+      BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTD1_MASK );
     }
   }
 
@@ -198,22 +199,22 @@ void GPIO_Init( GPIO_Type * pGPIO, uint32_t u32PinMask, GPIO_PinConfigType sGpio
   {
     if ( u32PinMask & GPIO_PTE0_MASK )
     {
-      PORT->HDRVE |= PORT_HDRVE_PTE0_MASK;
+      BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTE0_MASK );
     }
 
     if ( u32PinMask & GPIO_PTE1_MASK )
     {
-      PORT->HDRVE |= PORT_HDRVE_PTE1_MASK;
+      BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTE1_MASK );
     }
 
     if ( u32PinMask & GPIO_PTH0_MASK )
     {
-      PORT->HDRVE |= PORT_HDRVE_PTH0_MASK;
+      BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTH0_MASK );
     }
 
     if ( u32PinMask & GPIO_PTH1_MASK )
     {
-      PORT->HDRVE |= PORT_HDRVE_PTH1_MASK;
+      BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTH1_MASK );
     }
   }
 
@@ -364,27 +365,27 @@ void GPIO_PinInit( GPIO_PinType GPIO_Pin, GPIO_PinConfigType GPIO_PinConfig )
     switch ( GPIO_PinConfig )
     {
       case GPIO_PinOutput:
-        GPIOA->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOA->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUEL &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOA->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOA->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEL, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput:
-        GPIOA->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOA->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUEL &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_CLEAR( GPIOA->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOA->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEL, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput_InternalPullup:
-        GPIOA->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOA->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUEL |= ( 1 << GPIO_Pin ); /* Enable Pullup */
+        BME_GPIO_CLEAR( GPIOA->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOA->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_SET( PORT->PUEL, ( 1 << GPIO_Pin ) ); /* Enable Pullup */
         break;
 
       case GPIO_PinOutput_HighCurrent:
-        GPIOA->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOA->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUEL &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOA->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOA->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEL, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
     }
   }
@@ -395,27 +396,27 @@ void GPIO_PinInit( GPIO_PinType GPIO_Pin, GPIO_PinConfigType GPIO_PinConfig )
     switch ( GPIO_PinConfig )
     {
       case GPIO_PinOutput:
-        GPIOB->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOB->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUEH &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOB->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOB->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEH, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput:
-        GPIOB->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOB->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUEH &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_CLEAR( GPIOB->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOB->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEH, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput_InternalPullup:
-        GPIOB->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOB->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUEH |= ( 1 << GPIO_Pin ); /* Enable Pullup */
+        BME_GPIO_CLEAR( GPIOB->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOB->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_SET( PORT->PUEH, ( 1 << GPIO_Pin ) ); /* Enable Pullup */
         break;
 
       case GPIO_PinOutput_HighCurrent:
-        GPIOB->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOB->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUEH &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOB->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOB->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEH, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
     }
   }
@@ -428,27 +429,27 @@ void GPIO_PinInit( GPIO_PinType GPIO_Pin, GPIO_PinConfigType GPIO_PinConfig )
     switch ( GPIO_PinConfig )
     {
       case GPIO_PinOutput:
-        GPIOA->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOA->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUEL &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOA->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOA->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEL, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput:
-        GPIOA->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOA->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUEL &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_CLEAR( GPIOA->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOA->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEL, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput_InternalPullup:
-        GPIOA->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOA->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUEL |= ( 1 << GPIO_Pin ); /* Enable Pullup */
+        BME_GPIO_CLEAR( GPIOA->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOA->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_SET( PORT->PUEL, ( 1 << GPIO_Pin ) ); /* Enable Pullup */
         break;
 
       case GPIO_PinOutput_HighCurrent:
-        GPIOA->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOA->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUEL &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOA->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOA->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUEL, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
     }
   }
@@ -461,27 +462,27 @@ void GPIO_PinInit( GPIO_PinType GPIO_Pin, GPIO_PinConfigType GPIO_PinConfig )
     switch ( GPIO_PinConfig )
     {
       case GPIO_PinOutput:
-        GPIOA->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOA->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUE0 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOA->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOA->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE0, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput:
-        GPIOA->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOA->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUE0 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_CLEAR( GPIOA->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOA->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE0, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput_InternalPullup:
-        GPIOA->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOA->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUE0 |= ( 1 << GPIO_Pin ); /* Enable Pullup */
+        BME_GPIO_CLEAR( GPIOA->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOA->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_SET( PORT->PUE0, ( 1 << GPIO_Pin ) ); /* Enable Pullup */
         break;
 
       case GPIO_PinOutput_HighCurrent:
-        GPIOA->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOA->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUE0 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOA->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOA->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE0, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
     }
   }
@@ -492,27 +493,27 @@ void GPIO_PinInit( GPIO_PinType GPIO_Pin, GPIO_PinConfigType GPIO_PinConfig )
     switch ( GPIO_PinConfig )
     {
       case GPIO_PinOutput:
-        GPIOB->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOB->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUE1 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOB->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOB->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE1, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput:
-        GPIOB->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOB->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUE1 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_CLEAR( GPIOB->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOB->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE1, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput_InternalPullup:
-        GPIOB->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOB->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUE1 |= ( 1 << GPIO_Pin ); /* Enable Pullup */
+        BME_GPIO_CLEAR( GPIOB->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOB->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_SET( PORT->PUE1, ( 1 << GPIO_Pin ) ); /* Enable Pullup */
         break;
 
       case GPIO_PinOutput_HighCurrent:
-        GPIOB->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOB->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUE1 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOB->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOB->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE1, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
     }
   }
@@ -523,27 +524,27 @@ void GPIO_PinInit( GPIO_PinType GPIO_Pin, GPIO_PinConfigType GPIO_PinConfig )
     switch ( GPIO_PinConfig )
     {
       case GPIO_PinOutput:
-        GPIOC->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOC->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUE2 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOC->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOC->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE2, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput:
-        GPIOC->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOC->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUE2 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_CLEAR( GPIOC->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOC->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE2, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
 
       case GPIO_PinInput_InternalPullup:
-        GPIOC->PDDR &= ~( 1 << GPIO_Pin ); /* Disable Port Data Direction Register */
-        GPIOC->PIDR &= ~( 1 << GPIO_Pin ); /* Clear Port Input Disable Register */
-        PORT->PUE2 |= ( 1 << GPIO_Pin ); /* Enable Pullup */
+        BME_GPIO_CLEAR( GPIOC->PDDR, ( 1 << GPIO_Pin ) ); /* Disable Port Data Direction Register */
+        BME_GPIO_CLEAR( GPIOC->PIDR, ( 1 << GPIO_Pin ) ); /* Clear Port Input Disable Register */
+        BME_REG_SET( PORT->PUE2, ( 1 << GPIO_Pin ) ); /* Enable Pullup */
         break;
 
       case GPIO_PinOutput_HighCurrent:
-        GPIOC->PDDR |= ( 1 << GPIO_Pin );  /* Enable Port Data Direction Register */
-        GPIOC->PIDR |= ( 1 << GPIO_Pin );  /* Set Port Input Disable Register */
-        PORT->PUE2 &= ~( 1 << GPIO_Pin ); /* Disable Pullup */
+        BME_GPIO_SET( GPIOC->PDDR, ( 1 << GPIO_Pin ) );  /* Enable Port Data Direction Register */
+        BME_GPIO_SET( GPIOC->PIDR, ( 1 << GPIO_Pin ) );  /* Set Port Input Disable Register */
+        BME_REG_CLEAR( PORT->PUE2, ( 1 << GPIO_Pin ) ); /* Disable Pullup */
         break;
     }
   }
@@ -558,15 +559,15 @@ void GPIO_PinInit( GPIO_PinType GPIO_Pin, GPIO_PinConfigType GPIO_PinConfig )
     switch ( GPIO_Pin )
     {
       case GPIO_PTB5:
-        PORT->HDRVE |= PORT_HDRVE_PTB5_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTB5_MASK );
         break;
 
       case GPIO_PTC1:
-        PORT->HDRVE |= PORT_HDRVE_PTC1_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTC1_MASK );
         break;
 
       case GPIO_PTC5:
-        PORT->HDRVE |= PORT_HDRVE_PTC5_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTC5_MASK );
         break;
 
       default:
@@ -579,35 +580,35 @@ void GPIO_PinInit( GPIO_PinType GPIO_Pin, GPIO_PinConfigType GPIO_PinConfig )
     switch ( GPIO_Pin )
     {
       case GPIO_PTB4:
-        PORT->HDRVE |= PORT_HDRVE_PTB4_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTB4_MASK );
         break;
 
       case GPIO_PTB5:
-        PORT->HDRVE |= PORT_HDRVE_PTB5_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTB5_MASK );
         break;
 
       case GPIO_PTD0:
-        PORT->HDRVE |= PORT_HDRVE_PTD0_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTD0_MASK );
         break;
 
       case GPIO_PTD1:
-        PORT->HDRVE |= PORT_HDRVE_PTD1_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTD1_MASK );
         break;
 
       case GPIO_PTE0:
-        PORT->HDRVE |= PORT_HDRVE_PTE0_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTE0_MASK );
         break;
 
       case GPIO_PTE1:
-        PORT->HDRVE |= PORT_HDRVE_PTE1_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTE1_MASK );
         break;
 
       case GPIO_PTH0:
-        PORT->HDRVE |= PORT_HDRVE_PTH0_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTH0_MASK );
         break;
 
       case GPIO_PTH1:
-        PORT->HDRVE |= PORT_HDRVE_PTH1_MASK;
+        BME_REG_SET( PORT->HDRVE, PORT_HDRVE_PTH1_MASK );
         break;
 
       default:
@@ -207,6 +207,64 @@ typedef enum
 } GPIO_PinConfigType;
 /*! @} End of gpio_pin_config_type_list */
 
+/******************************************************************************
+*define gpio pin descriptor macros
+*
+*//*! @addtogroup gpio_pin_macro_list
+* @{
+*******************************************************************************/
+/*
+*   . pin is a GPIO_PinType of GPIOA or GPIOB. With a constant pin the port,
+*     mask and pullup register are resolved at compile time: GPIO_PIN_SET,
+*     GPIO_PIN_CLEAR, GPIO_PIN_TOGGLE and GPIO_PIN_WRITE are one store to the
+*     single cycle FGPIO port, GPIO_PIN_READ is one load.
+*   . PTI0 ~ PTI7 are on GPIOC of the NV32M4, which has no FGPIO port: a
+*     constant PTIn does not compile with the pin operations below.
+*   . GPIO_PIN_FGPIO and GPIO_PIN_MASK also take a run time pin, the caller
+*     then has to ASSERT it is below GPIO_PTI0. Use GPIO_PinSet and friends
+*     for pin numbers only known at run time.
+*/
+#define GPIO_PIN_CHECK(pin)         ( ( void )sizeof( struct { unsigned int bNotOnFgpio : ( ( pin ) < GPIO_PTI0 ) ? 1 : -1; } ) )
+#define GPIO_PIN_FGPIO(pin)         ( ( ( pin ) < GPIO_PTE0 ) ? FGPIOA : FGPIOB )
+#define GPIO_PIN_BIT(pin)           ( ( pin ) & 0x1F )
+#define GPIO_PIN_MASK(pin)          ( 1UL << GPIO_PIN_BIT( pin ) )
+#define GPIO_PIN_PUE(pin)           ( *( ( ( pin ) < GPIO_PTE0 ) ? &PORT->PUEL : &PORT->PUEH ) )
+
+#define GPIO_PIN_SET(pin)           ( GPIO_PIN_CHECK( pin ), GPIO_PIN_FGPIO( pin )->PSOR = GPIO_PIN_MASK( pin ) )
+#define GPIO_PIN_CLEAR(pin)         ( GPIO_PIN_CHECK( pin ), GPIO_PIN_FGPIO( pin )->PCOR = GPIO_PIN_MASK( pin ) )
+#define GPIO_PIN_TOGGLE(pin)        ( GPIO_PIN_CHECK( pin ), GPIO_PIN_FGPIO( pin )->PTOR = GPIO_PIN_MASK( pin ) )
+#define GPIO_PIN_WRITE(pin, v)      ( GPIO_PIN_CHECK( pin ), *( ( v ) ? &GPIO_PIN_FGPIO( pin )->PSOR : &GPIO_PIN_FGPIO( pin )->PCOR ) = GPIO_PIN_MASK( pin ) )
+#define GPIO_PIN_READ(pin)          ( GPIO_PIN_CHECK( pin ), ( GPIO_PIN_FGPIO( pin )->PDIR >> GPIO_PIN_BIT( pin ) ) & 1 )
+
+/* same register settings as GPIO_PinInit, without its run time switch */
+#define GPIO_PIN_INIT_OUTPUT(pin)                                   \
+  do                                                                \
+  {                                                                 \
+    GPIO_PIN_CHECK( pin );                                          \
+    GPIO_PIN_FGPIO( pin )->PDDR |= GPIO_PIN_MASK( pin );            \
+    GPIO_PIN_FGPIO( pin )->PIDR |= GPIO_PIN_MASK( pin );            \
+    GPIO_PIN_PUE( pin ) &= ~GPIO_PIN_MASK( pin );                   \
+  } while ( 0 )
+
+#define GPIO_PIN_INIT_INPUT(pin)                                    \
+  do                                                                \
+  {                                                                 \
+    GPIO_PIN_CHECK( pin );                                          \
+    GPIO_PIN_FGPIO( pin )->PDDR &= ~GPIO_PIN_MASK( pin );           \
+    GPIO_PIN_FGPIO( pin )->PIDR &= ~GPIO_PIN_MASK( pin );           \
+    GPIO_PIN_PUE( pin ) &= ~GPIO_PIN_MASK( pin );                   \
+  } while ( 0 )
+
+#define GPIO_PIN_INIT_PULLUP(pin)                                   \
+  do                                                                \
+  {                                                                 \
+    GPIO_PIN_CHECK( pin );                                          \
+    GPIO_PIN_FGPIO( pin )->PDDR &= ~GPIO_PIN_MASK( pin );           \
+    GPIO_PIN_FGPIO( pin )->PIDR &= ~GPIO_PIN_MASK( pin );           \
+    GPIO_PIN_PUE( pin ) |= GPIO_PIN_MASK( pin );                    \
+  } while ( 0 )
+/*! @} End of gpio_pin_macro_list    */
+
 /******************************************************************************
 * define GPIO APIs
 *
@@ -8,6 +8,8 @@
 ******************************************************************************/
 #include "NV32_config.h"
 #include "NV32_i2c.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
 
 /******************************************************************************
 * Global variables
@@ -24,15 +26,44 @@
 /******************************************************************************
 * Local function prototypes
 ******************************************************************************/
+#ifdef I2C0_STATIC_CALLBACK
+void I2C0_STATIC_CALLBACK( void );
+#else
+void I2C0_Isr( void );
+#endif
 
 /******************************************************************************
 * Local variables
 ******************************************************************************/
-static I2C_CallbackType I2C_Callback[2] = {( I2C_CallbackType )NULL};
+#ifndef I2C0_STATIC_CALLBACK
+static I2C_CallbackType I2C0_Callback = ( I2C_CallbackType )NULL;
+#endif
+static I2C_CallbackType I2C1_Callback = ( I2C_CallbackType )NULL;
 /******************************************************************************
 * Local functions
 ******************************************************************************/
-void I2C0_Isr( void );
+
+/*****************************************************************************//*!
+   *
+   * @brief I2C isr body, shared by the static and the dynamic handler.
+   *
+   * @param[in] u8Id         ISRSTAT_I2C0.
+   * @param[in] pfnCallback  callback, a constant in the static handler.
+   *
+   * @return none
+   *
+   * @ Pass/ Fail criteria:  none
+*****************************************************************************/
+__STATIC_INLINE void I2C_Isr( uint8_t u8Id, I2C_CallbackType pfnCallback )
+{
+  ISRSTAT_ENTER( u8Id );
+  if ( pfnCallback )
+  {
+    pfnCallback();
+  }
+
+  ISRSTAT_EXIT( u8Id );
+}
 
 /******************************************************************************
 * Global functions
@@ -606,7 +637,7 @@ uint8_t I2C_MasterReadWait( I2C_Type * pI2Cx, uint16_t u16SlaveAddress, uint8_t
 
 void I2C1_SetCallBack( I2C_CallbackType pCallBack )
 {
-  I2C_Callback[1] = pCallBack;
+  I2C1_Callback = pCallBack;
 }
 
 /*****************************************************************************//*!
@@ -622,7 +653,16 @@ void I2C1_SetCallBack( I2C_CallbackType pCallBack )
 
 void I2C0_SetCallBack( I2C_CallbackType pCallBack )
 {
-  I2C_Callback[0] = pCallBack;
+#ifdef I2C0_STATIC_CALLBACK
+  /* bound at link time, I2C0_IRQHandler calls I2C0_STATIC_CALLBACK */
+  ASSERT( ( pCallBack == NULL ) || ( pCallBack == I2C0_STATIC_CALLBACK ) );
+#else
+  I2C0_Callback = pCallBack;
+#if ( VECTOR_IN_RAM > 0 )
+  /* I2C0_Isr only calls the callback, vector to it directly */
+  VECTOR_Install( I2C0_IRQn, VECTOR_DIRECT( pCallBack, I2C0_Isr ) );
+#endif
+#endif
 }
 /*! @} End of i2c_api_list                                                          */
 
@@ -637,13 +677,17 @@ void I2C0_SetCallBack( I2C_CallbackType pCallBack )
    *
    * @ Pass/ Fail criteria:  none
 *****************************************************************************/
+#ifdef I2C0_STATIC_CALLBACK
+void I2C0_IRQHandler( void )
+{
+  I2C_Isr( ISRSTAT_I2C0, I2C0_STATIC_CALLBACK );
+}
+#else
 void I2C0_Isr( void )
 {
-  if ( I2C_Callback[0] )
-  {
-    I2C_Callback[0]();
-  }
+  I2C_Isr( ISRSTAT_I2C0, I2C0_Callback );
 }
+#endif
 /*****************************************************************************//*!
    *
    * @brief I2C1 interrupt service routine.
@@ -656,9 +700,9 @@ void I2C0_Isr( void )
 *****************************************************************************/
 void I2C1_Isr( void )
 {
-  if ( I2C_Callback[1] )
+  if ( I2C1_Callback )
   {
-    I2C_Callback[1]();
+    I2C1_Callback();
   }
 }
 
@@ -0,0 +1,463 @@
+/******************************************************************************
+* @brief providing APIs for tickless low power idle manager (IDLE).
+*
+*******************************************************************************
+*
+* IDLE_Enter picks the deepest mode that is safe right now: Run when a
+* software timer is already due, Wait when the next deadline is too close
+* for Stop, Stop is inhibited or a peripheral in IDLE_STOP_BLOCK_MASK has its
+* clock gate open in SIM_SCGC, Stop otherwise.
+*
+* The PIT halts with the bus clock in Stop, so the software timer wheel is
+* suspended and the RTC, clocked from the internal reference which keeps
+* running in Stop, counts the idle time instead and wakes the CPU at the
+* deadline. On wake the elapsed RTC counts are handed back to the wheel,
+* the fraction of a tick is carried to the next Stop. With IDLE_USE_CALENDAR
+* the RTC stays with the calendar service and a calendar alarm wakes the CPU.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_idle.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+/*! @brief RTC counts per timer tick in Q16. */
+#define IDLE_COUNTS_PER_TICK_Q16    ( uint32_t )( ( ( uint64_t )IDLE_RTC_CLOCK_HZ * SWTMR_TICK_US << 16 ) / \
+                                                  ( ( uint64_t )IDLE_RTC_DIVIDER * 1000000 ) )
+
+/*! @brief timer ticks per RTC count in Q16. */
+#define IDLE_TICKS_PER_COUNT_Q16    ( uint32_t )( ( ( uint64_t )IDLE_RTC_DIVIDER * 1000000 << 16 ) / \
+                                                  ( ( uint64_t )IDLE_RTC_CLOCK_HZ * SWTMR_TICK_US ) )
+
+#define IDLE_RTC_MAX_COUNTS         0xFFFF
+
+/*! @brief timer ticks per second in Q16. */
+#define IDLE_TICKS_PER_SEC_Q16      ( uint32_t )( ( ( uint64_t )1000000 << 16 ) / SWTMR_TICK_US )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static uint8_t IDLE_SelectMode( uint32_t u32IdleTicks );
+static void IDLE_ArmWakeup( uint32_t u32IdleTicks );
+static uint64_t IDLE_TakeElapsed( void );
+static uint32_t IDLE_Stop( uint32_t u32IdleTicks );
+#if IDLE_USE_CALENDAR
+static void IDLE_WakeAlarm( void * pParam );
+#endif
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static IDLE_StatsType   IDLE_sStats;
+static uint32_t         IDLE_u32FracQ16;        /*!< tick fraction left from the last Stop */
+static uint8_t          IDLE_u8Inhibit;         /*!< IDLE_StopInhibit nesting count */
+#if IDLE_USE_CALENDAR
+static CAL_AlarmType    IDLE_sWakeAlarm;
+static uint64_t         IDLE_u64Start;          /*!< calendar time Stop was entered */
+static uint64_t         IDLE_u64Wake;           /*!< calendar time of the deadline */
+#else
+static uint32_t         IDLE_u32Counts;         /*!< RTC counts to the deadline */
+#endif
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  choose the low power mode for an idle period.
+*
+* @param[in]    u32IdleTicks    ticks to the next timer deadline.
+*
+* @return PmcModeRun, PmcModeWait or IDLE_STOP_MODE.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t IDLE_SelectMode( uint32_t u32IdleTicks )
+{
+  if ( 0 == u32IdleTicks )
+  {
+    return PmcModeRun;
+  }
+
+  if ( IDLE_u8Inhibit || ( SIM->SCGC & ( IDLE_STOP_BLOCK_MASK ) ) || ( u32IdleTicks < IDLE_STOP_MIN_TICKS ) )
+  {
+    return PmcModeWait;
+  }
+
+  return IDLE_STOP_MODE;
+}
+
+#if IDLE_USE_CALENDAR
+/*****************************************************************************//*!
+*
+* @brief  set a calendar alarm at the timer deadline.
+*
+* @param[in]    u32IdleTicks    ticks to the next timer deadline.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void IDLE_ArmWakeup( uint32_t u32IdleTicks )
+{
+  CAL_TimeType sTime;
+  uint64_t u64Us = ( uint64_t )u32IdleTicks * SWTMR_TICK_US;
+  u64Us = ( u64Us > 0xFFFFFFFF ) ? 0xFFFFFFFF : u64Us;
+  CAL_GetTime( &sTime );
+  IDLE_u64Start = ( ( uint64_t )sTime.u32Seconds << 32 ) | sTime.u32Fraction;
+  /* us to seconds in Q32, 2^48 / 10^6 rounded */
+  IDLE_u64Wake = IDLE_u64Start + ( ( u64Us * 281474977 ) >> 16 );
+  sTime.u32Seconds  = ( uint32_t )( IDLE_u64Wake >> 32 );
+  sTime.u32Fraction = ( uint32_t )IDLE_u64Wake;
+  CAL_AlarmStart( &IDLE_sWakeAlarm, &sTime, 0 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  cancel the wake up alarm and measure the time spent in Stop.
+*
+* @param  none.
+*
+* @return timer ticks in Q16.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint64_t IDLE_TakeElapsed( void )
+{
+  CAL_TimeType sTime;
+  uint64_t u64Now;
+  CAL_AlarmStop( &IDLE_sWakeAlarm );
+  CAL_GetTime( &sTime );
+  u64Now = ( ( uint64_t )sTime.u32Seconds << 32 ) | sTime.u32Fraction;
+
+  if ( ( int64_t )( u64Now - IDLE_u64Wake ) < 0 )
+  {
+    IDLE_sStats.u32EarlyWakes++;
+  }
+
+  return ( ( ( u64Now - IDLE_u64Start ) >> 16 ) * IDLE_TICKS_PER_SEC_Q16 ) >> 16;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  calendar alarm callback, the alarm only has to wake the CPU.
+*
+* @param[in]    pParam      not used.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void IDLE_WakeAlarm( void * pParam )
+{
+}
+#else
+/*****************************************************************************//*!
+*
+* @brief  start the RTC to interrupt at the timer deadline.
+*
+* @param[in]    u32IdleTicks    ticks to the next timer deadline.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void IDLE_ArmWakeup( uint32_t u32IdleTicks )
+{
+  uint64_t u64Counts;
+  /* round down, waking early only costs another short sleep */
+  u64Counts = ( ( uint64_t )u32IdleTicks * IDLE_COUNTS_PER_TICK_Q16 ) >> 16;
+  IDLE_u32Counts = ( u64Counts > IDLE_RTC_MAX_COUNTS ) ? IDLE_RTC_MAX_COUNTS : ( uint32_t )u64Counts;
+  IDLE_u32Counts = IDLE_u32Counts ? IDLE_u32Counts : 1;
+  /* writing the modulo and the prescaler restarts the counter */
+  RTC_SetClock( IDLE_RTC_CLKSRC, 0 );
+  RTC_SetModulo( IDLE_u32Counts );
+  RTC_ClrFlags();
+  RTC_EnableInt();
+  NVIC_ClearPendingIRQ( RTC_IRQn );
+  NVIC_EnableIRQ( RTC_IRQn );
+  RTC_SetClock( IDLE_RTC_CLKSRC, IDLE_RTC_PRESCALER );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop the RTC and measure the time spent in Stop.
+*
+* @param  none.
+*
+* @return timer ticks in Q16.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint64_t IDLE_TakeElapsed( void )
+{
+  uint32_t u32Elapsed = RTC_GetFlags() ? IDLE_u32Counts : RTC->CNT;
+  RTC_SetClock( IDLE_RTC_CLKSRC, 0 );
+  RTC_DisableInt();
+  RTC_ClrFlags();
+  NVIC_ClearPendingIRQ( RTC_IRQn );
+
+  if ( u32Elapsed < IDLE_u32Counts )
+  {
+    IDLE_sStats.u32EarlyWakes++;
+  }
+
+  return ( uint64_t )u32Elapsed * IDLE_TICKS_PER_COUNT_Q16;
+}
+#endif /* IDLE_USE_CALENDAR */
+
+/*****************************************************************************//*!
+*
+* @brief  enter Stop with the wheel suspended and the RTC set to wake at the
+*         deadline, then give the elapsed time back to the wheel.
+*
+* @param[in]    u32IdleTicks    ticks to the next timer deadline.
+*
+* @return ticks spent in Stop.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t IDLE_Stop( uint32_t u32IdleTicks )
+{
+  uint32_t u32Ticks;
+  uint32_t u32Latency;
+  uint64_t u64TicksQ16;
+  uint8_t  bSysTick;
+
+  IDLE_ArmWakeup( u32IdleTicks );
+  /* borrow SysTick as a cycle counter unless the application runs it */
+  bSysTick = !( SysTick->CTRL & SysTick_CTRL_ENABLE_Msk );
+
+  if ( bSysTick )
+  {
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+  }
+
+  PMC_SetMode( PMC, IDLE_STOP_MODE );
+
+  if ( 0 == ( ICS->C1 & ICS_C1_CLKS_MASK ) )
+  {
+    /* the FLL relocks after Stop, the PIT must not restart on a drifting clock */
+    while ( !( ICS->S & ICS_S_LOCK_MASK ) )
+      ;
+  }
+
+  if ( bSysTick )
+  {
+    u32Latency    = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+    SysTick->CTRL = 0;
+    IDLE_sStats.u32WakeLatencyLast = u32Latency;
+
+    if ( u32Latency > IDLE_sStats.u32WakeLatencyMax )
+    {
+      IDLE_sStats.u32WakeLatencyMax = u32Latency;
+    }
+  }
+
+  u64TicksQ16     = IDLE_TakeElapsed() + IDLE_u32FracQ16;
+  u32Ticks        = ( uint32_t )( u64TicksQ16 >> 16 );
+  IDLE_u32FracQ16 = ( uint32_t )u64TicksQ16 & 0xFFFF;
+  SWTMR_Resume( u32Ticks );
+  return u32Ticks;
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* IDLE api lists
+*
+*//*! @addtogroup idle_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  prepare the RTC and the internal reference clock for timekeeping in
+*         Stop. SWTMR_Init must have been called, the RTC is owned by the
+*         idle manager afterwards. With IDLE_USE_CALENDAR, CAL_Init must
+*         have been called instead and a calendar alarm is used.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void IDLE_Init( void )
+{
+#if IDLE_USE_CALENDAR
+  CAL_AlarmInit( &IDLE_sWakeAlarm, IDLE_WakeAlarm, NULL );
+#else
+  RTC_ConfigType sRTCConfig = {0};
+  sRTCConfig.bFlag        = 1;
+  sRTCConfig.bClockSource = IDLE_RTC_CLKSRC;
+  /* prescaler 0 keeps the counter off until Stop is entered */
+  sRTCConfig.bClockPresaler = 0;
+  RTC_Init( &sRTCConfig );
+  /* keep ICSIRCLK running in Stop for the RTC */
+  ICS->C1 |= ICS_C1_IRCLKEN_MASK | ICS_C1_IREFSTEN_MASK;
+#endif
+  IDLE_u32FracQ16 = 0;
+  IDLE_u8Inhibit  = 0;
+  IDLE_ClearStats();
+}
+
+/*****************************************************************************//*!
+*
+* @brief  sleep until the next timer deadline or any interrupt, in the
+*         deepest mode allowed. Call from the main loop when there is no
+*         work. To not miss an event, mask interrupts before checking for
+*         work: the wake up interrupt then runs when the caller unmasks them.
+*
+* @param  none.
+*
+* @return the mode used, PmcModeRun if a timer was already due.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t IDLE_Enter( void )
+{
+  uint32_t u32IdleTicks;
+  uint32_t u32Start;
+  uint32_t u32Ticks = 0;
+  uint8_t  u8Mode;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  u32IdleTicks = SWTMR_GetIdleTicks();
+  u8Mode = IDLE_SelectMode( u32IdleTicks );
+
+  if ( PmcModeWait < u8Mode )
+  {
+    u32IdleTicks = SWTMR_Suspend();
+    u8Mode = u32IdleTicks ? u8Mode : PmcModeRun;
+  }
+
+  if ( PmcModeWait == u8Mode )
+  {
+    /* the PIT keeps counting in Wait */
+    u32Start = SWTMR_GetTicks();
+    PMC_SetMode( PMC, PmcModeWait );
+    u32Ticks = SWTMR_GetTicks() - u32Start;
+  }
+  else if ( PmcModeWait < u8Mode )
+  {
+    u32Ticks = IDLE_Stop( u32IdleTicks );
+  }
+
+  IDLE_sStats.u32Entries[u8Mode]++;
+  IDLE_sStats.u32ResidencyTicks[u8Mode] += u32Ticks;
+  __set_interrupt_state( interrupt_state );
+  return u8Mode;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  forbid Stop, e.g. while a transfer clocked by the bus is in
+*         progress on a peripheral not in IDLE_STOP_BLOCK_MASK. Calls nest.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void IDLE_StopInhibit( void )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  IDLE_u8Inhibit++;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  undo one IDLE_StopInhibit.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void IDLE_StopRelease( void )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  ASSERT( IDLE_u8Inhibit );
+  IDLE_u8Inhibit--;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get a copy of the idle statistics.
+*
+* @param[out]   pStats      pointer to the statistics.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void IDLE_GetStats( IDLE_StatsType * pStats )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  *pStats = IDLE_sStats;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  reset the idle statistics.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void IDLE_ClearStats( void )
+{
+  uint8_t i;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  for ( i = 0; i < IDLE_MODES; i++ )
+  {
+    IDLE_sStats.u32Entries[i]        = 0;
+    IDLE_sStats.u32ResidencyTicks[i] = 0;
+  }
+
+  IDLE_sStats.u32EarlyWakes      = 0;
+  IDLE_sStats.u32WakeLatencyLast = 0;
+  IDLE_sStats.u32WakeLatencyMax  = 0;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*! @} End of idle_api_list                                                   */
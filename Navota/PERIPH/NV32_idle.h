@@ -0,0 +1,82 @@
+/******************************************************************************
+* @brief header file for tickless low power idle manager (IDLE).
+*
+*******************************************************************************
+*
+* provide APIs for entering the deepest low power mode allowed by the next
+* software timer deadline and the clock gated peripherals
+******************************************************************************/
+#ifndef __NV32_IDLE_H__
+#define __NV32_IDLE_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_pmc.h"
+#include "NV32_rtc.h"
+#include "NV32_calendar.h"
+#include "NV32_swtimer.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define IDLE_MODES              4           /*!< PmcModeRun ~ PmcModeStop3 */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* IDLE statistics struct.
+*
+*//*! @addtogroup idle_statsstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief idle statistics, arrays are indexed by PmcModeRun ~ PmcModeStop3.
+*
+* A Run entry is an IDLE_Enter call that found a timer already due. Wake
+* latency is counted in core clocks from the end of Stop until the FLL is
+* locked again, only while SysTick is not used by the application.
+*/
+typedef struct
+{
+  uint32_t  u32Entries[IDLE_MODES];         /*!< IDLE_Enter calls per mode chosen */
+  uint32_t  u32ResidencyTicks[IDLE_MODES];  /*!< timer ticks spent per mode */
+  uint32_t  u32EarlyWakes;                  /*!< Stop ended by an interrupt before the deadline */
+  uint32_t  u32WakeLatencyLast;             /*!< latest Stop wake latency in core clocks */
+  uint32_t  u32WakeLatencyMax;              /*!< worst Stop wake latency in core clocks */
+} IDLE_StatsType, *IDLE_StatsPtr;
+/*! @} End of idle_statsstruct                                                */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void IDLE_Init( void );
+uint8_t IDLE_Enter( void );
+void IDLE_StopInhibit( void );
+void IDLE_StopRelease( void );
+void IDLE_GetStats( IDLE_StatsType * pStats );
+void IDLE_ClearStats( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_IDLE_H__ */
@@ -0,0 +1,298 @@
+/******************************************************************************
+* @brief providing APIs for ISR latency and duration statistics (ISRSTAT).
+*
+*******************************************************************************
+*
+* With ISRSTAT_ENABLED the driver interrupt service routines read the
+* SysTick into a local on entry, one load and one store, and hand it to
+* ISRSTAT_Exit on the way out, which bins the duration in a log2 histogram
+* of the vector. The SysTick runs free on the core clock, or at the period
+* the application gave it, and a duration is taken modulo that period.
+* Durations include the routines that preempted the one measured.
+*
+* Latency, the clocks from the request to the entry, is known where the
+* hardware keeps counting after the request: the PIT routines report
+* LDVAL - CVAL in bus clocks, as counted. Other sources may feed
+* ISRSTAT_LATENCY from the application, in bus clocks too.
+*
+* ISRSTAT only reads the SysTick, it does not own it. Other users:
+* - SystemInit with BOOT_TIME_ENABLED starts it free running for
+*   SystemBootClocks, which stops it again. ISRSTAT_Init is called after
+*   that read.
+* - BENCH_Run and the measurements of IDLE, FLLTRIM, PBUS and SWBUS borrow
+*   it for a masked stretch. BENCH_Run gives a running SysTick back with
+*   its phase, the others read a running one as it is or only borrow a
+*   stopped one. Routines preempted across such a stretch get a wrong
+*   duration.
+* - The bootloader and the power-fail path take it over for good.
+*
+* All statistics sit in fixed RAM, ISRSTAT_Dump prints them as CSV lines.
+* When ISRSTAT_ENABLED is 0 the hooks are empty and nothing is linked.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_isrstat.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+ISRSTAT_VectorType ISRSTAT_sVector[ISRSTAT_VECTORS];
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define ISRSTAT_BIN0            32          /*!< clocks below the first bin bound */
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static const char * const ISRSTAT_pName[ISRSTAT_VECTORS] =
+{
+  "acmp0", "acmp1", "adc", "etm0", "etm1", "etm2", "i2c0", "kbi0", "kbi1",
+  "pit_ch0", "pit_ch1", "rtc", "spi0", "spi1", "uart0", "uart1", "uart2"
+};
+
+static uint32_t ISRSTAT_u32Period;          /*!< SysTick period, LOAD + 1 */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  add a sample to a histogram.
+*
+* @param[in]    pBin        histogram.
+* @param[in]    u32Cycles   core clocks.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void ISRSTAT_Bin( uint16_t * pBin, uint32_t u32Cycles )
+{
+  uint8_t u8Bin = 0;
+
+  while ( ( u32Cycles >= ISRSTAT_BIN0 ) && ( u8Bin < ISRSTAT_BINS - 1 ) )
+  {
+    u32Cycles >>= 1;
+    u8Bin++;
+  }
+
+  if ( pBin[u8Bin] != 0xFFFF )
+  {
+    pBin[u8Bin]++;
+  }
+}
+
+static void ISRSTAT_PutString( UART_Type * pUART, const char * pString )
+{
+  while ( *pString )
+  {
+    UART_PutChar( pUART, *pString++ );
+  }
+}
+
+static void ISRSTAT_PutDec( UART_Type * pUART, uint32_t u32Value )
+{
+  char    cDigit[10];
+  uint8_t i = 0;
+
+  UART_PutChar( pUART, ',' );
+
+  do
+  {
+    cDigit[i++] = '0' + u32Value % 10;
+    u32Value /= 10;
+  }
+  while ( u32Value );
+
+  while ( i )
+  {
+    UART_PutChar( pUART, cDigit[--i] );
+  }
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* ISRSTAT api lists
+*
+*//*! @addtogroup isrstat_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  start the statistics. A stopped SysTick is started free running
+*         without interrupt, a running one is used at its period, which
+*         then bounds the longest duration measured.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void ISRSTAT_Init( void )
+{
+  if ( !( SysTick->CTRL & SysTick_CTRL_ENABLE_Msk ) )
+  {
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+  }
+
+  ISRSTAT_u32Period = SysTick->LOAD + 1;
+  ISRSTAT_Reset();
+}
+
+/*****************************************************************************//*!
+*
+* @brief  clear the statistics.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void ISRSTAT_Reset( void )
+{
+  uint32_t   *pWord = ( uint32_t * )ISRSTAT_sVector;
+  uint32_t   i;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  for ( i = 0; i < sizeof( ISRSTAT_sVector ) / 4; i++ )
+  {
+    pWord[i] = 0;
+  }
+
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  record the duration of a routine, called by ISRSTAT_EXIT.
+*
+* @param[in]    u8Id        ISRSTAT_ACMP0 ~ ISRSTAT_UART2.
+* @param[in]    u32Entry    SysTick value at the entry.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void ISRSTAT_Exit( uint8_t u8Id, uint32_t u32Entry )
+{
+  ISRSTAT_VectorType *pVector = &ISRSTAT_sVector[u8Id];
+  uint32_t           u32Now = SysTick->VAL;
+  uint32_t           u32Cycles;
+
+  /* the SysTick counts down */
+  u32Cycles = ( u32Entry >= u32Now ) ? u32Entry - u32Now : u32Entry + ISRSTAT_u32Period - u32Now;
+
+  pVector->u32Count++;
+
+  if ( u32Cycles > pVector->u32MaxDuration )
+  {
+    pVector->u32MaxDuration = u32Cycles;
+  }
+
+  ISRSTAT_Bin( pVector->u16Duration, u32Cycles );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  record the latency of a routine, called by ISRSTAT_LATENCY.
+*
+* @param[in]    u8Id        ISRSTAT_ACMP0 ~ ISRSTAT_UART2.
+* @param[in]    u32Cycles   bus clocks from the request to the entry.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void ISRSTAT_Latency( uint8_t u8Id, uint32_t u32Cycles )
+{
+  ISRSTAT_VectorType *pVector = &ISRSTAT_sVector[u8Id];
+
+  if ( u32Cycles > pVector->u32MaxLatency )
+  {
+    pVector->u32MaxLatency = u32Cycles;
+  }
+
+  ISRSTAT_Bin( pVector->u16Latency, u32Cycles );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  print the statistics as CSV lines, vectors that never ran are
+*         left out:
+*
+*         isr,<name>,<count>,<max duration>,<8 duration bins>,<max latency>,<8 latency bins>
+*
+*         durations in core clocks, latencies in bus clocks.
+*
+* @param[in]    pUART       console.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void ISRSTAT_Dump( UART_Type * pUART )
+{
+  ISRSTAT_VectorType sVector;
+  uint8_t            i;
+  uint8_t            j;
+  __istate_t         interrupt_state;
+
+  for ( i = 0; i < ISRSTAT_VECTORS; i++ )
+  {
+    /* a consistent copy, the routine may run while printing */
+    interrupt_state = __get_interrupt_state();
+    __disable_interrupt();
+    sVector = ISRSTAT_sVector[i];
+    __set_interrupt_state( interrupt_state );
+
+    if ( sVector.u32Count == 0 )
+    {
+      continue;
+    }
+
+    ISRSTAT_PutString( pUART, "isr," );
+    ISRSTAT_PutString( pUART, ISRSTAT_pName[i] );
+    ISRSTAT_PutDec( pUART, sVector.u32Count );
+    ISRSTAT_PutDec( pUART, sVector.u32MaxDuration );
+
+    for ( j = 0; j < ISRSTAT_BINS; j++ )
+    {
+      ISRSTAT_PutDec( pUART, sVector.u16Duration[j] );
+    }
+
+    ISRSTAT_PutDec( pUART, sVector.u32MaxLatency );
+
+    for ( j = 0; j < ISRSTAT_BINS; j++ )
+    {
+      ISRSTAT_PutDec( pUART, sVector.u16Latency[j] );
+    }
+
+    ISRSTAT_PutString( pUART, "\r\n" );
+  }
+}
+/*! @} End of isrstat_api_list                                                */
@@ -0,0 +1,116 @@
+/******************************************************************************
+* @brief header file for ISR latency and duration statistics (ISRSTAT).
+*
+*******************************************************************************
+*
+* provide hooks for the driver interrupt service routines that time every
+* run with the SysTick and collect per vector histograms in RAM
+******************************************************************************/
+#ifndef __NV32_ISRSTAT_H__
+#define __NV32_ISRSTAT_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_uart.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define ISRSTAT_BINS            8           /*!< histogram bins, < 32, < 64, ... < 2048, >= 2048 core clocks */
+
+/*! @brief instrumented interrupt service routines */
+enum
+{
+  ISRSTAT_ACMP0 = 0,
+  ISRSTAT_ACMP1,
+  ISRSTAT_ADC,
+  ISRSTAT_ETM0,
+  ISRSTAT_ETM1,
+  ISRSTAT_ETM2,
+  ISRSTAT_I2C0,
+  ISRSTAT_KBI0,
+  ISRSTAT_KBI1,
+  ISRSTAT_PIT_CH0,
+  ISRSTAT_PIT_CH1,
+  ISRSTAT_RTC,
+  ISRSTAT_SPI0,
+  ISRSTAT_SPI1,
+  ISRSTAT_UART0,
+  ISRSTAT_UART1,
+  ISRSTAT_UART2,
+  ISRSTAT_VECTORS
+};
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/*!
+* @brief hooks for an interrupt service routine. ISRSTAT_ENTER declares a
+*        local holding the SysTick, so it comes first in the routine,
+*        ISRSTAT_EXIT comes last. ISRSTAT_LATENCY records the bus clocks
+*        from the request to the entry where the hardware tells them. All
+*        are empty when ISRSTAT_ENABLED is 0.
+*/
+#if ( ISRSTAT_ENABLED > 0 )
+#define ISRSTAT_ENTER(id)               uint32_t u32IsrStatEntry = SysTick->VAL
+#define ISRSTAT_EXIT(id)                ISRSTAT_Exit( id, u32IsrStatEntry )
+#define ISRSTAT_LATENCY(id, cycles)     ISRSTAT_Latency( id, cycles )
+#else
+#define ISRSTAT_ENTER(id)
+#define ISRSTAT_EXIT(id)
+#define ISRSTAT_LATENCY(id, cycles)
+#endif
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* ISRSTAT configure struct.
+*
+*//*! @addtogroup isrstat_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief statistics of one interrupt service routine, durations include
+*        the routines that preempted it.
+*/
+typedef struct
+{
+  uint32_t      u32Count;                           /*!< runs */
+  uint32_t      u32MaxDuration;                     /*!< core clocks */
+  uint32_t      u32MaxLatency;                      /*!< bus clocks */
+  uint16_t      u16Duration[ISRSTAT_BINS];          /*!< duration histogram, saturating */
+  uint16_t      u16Latency[ISRSTAT_BINS];           /*!< latency histogram in bus clocks, saturating */
+} ISRSTAT_VectorType, *ISRSTAT_VectorPtr;
+/*! @} End of isrstat_configstruct                                            */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+extern ISRSTAT_VectorType ISRSTAT_sVector[ISRSTAT_VECTORS];
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void ISRSTAT_Init( void );
+void ISRSTAT_Reset( void );
+void ISRSTAT_Exit( uint8_t u8Id, uint32_t u32Entry );
+void ISRSTAT_Latency( uint8_t u8Id, uint32_t u32Cycles );
+void ISRSTAT_Dump( UART_Type * pUART );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_ISRSTAT_H__ */
@@ -8,6 +8,8 @@
 ******************************************************************************/
 #include "NV32_config.h"
 #include "NV32_kbi.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
 /******************************************************************************
 * External objects
 ******************************************************************************/
@@ -15,7 +17,40 @@
 /******************************************************************************
 * Global variables
 ******************************************************************************/
+#if !defined( KBI0_STATIC_CALLBACK ) || !defined( KBI1_STATIC_CALLBACK )
 KBI_CallbackType KBI_Callback[KBI_MAX_NO] = {( KBI_CallbackType )NULL};
+#endif
+
+/*!
+ * @brief KBI pin positions in the GPIO register, GPIOA for both modules
+ *        except KBI1 on NV32M4, which is in GPIOB.
+ *
+ */
+const uint8_t KBI_u8PinMapping[KBI_MAX_NO][KBI_MAX_PINS_PER_PORT] =
+{
+#if defined(CPU_NV32)
+  {
+    0, 1, 2, 3, 8, 9, 10, 11            /* KBI0 pins position in GPIOA register */
+  },
+  {
+    24, 25, 26, 27, 28, 29, 30, 31      /* KBI1 pins position in GPIOA register */
+  }
+#elif defined(CPU_NV32M3)
+  {
+    0, 1, 2, 3, 8, 9, 10, 11            /* KBI0 pins position in GPIOA register */
+  },
+  {
+    20, 21, 16, 17, 18, 19, 12, 13      /* KBI1 pins position in GPIOA register */
+  }
+#elif defined(CPU_NV32M4)
+  {/* KBI0P0~KBI0P31 pins position in GPIOA register */
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+  },
+  {/* KBI1P0~KBI1P31 pins position in GPIOB register */
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+  }
+#endif
+};
 
 /******************************************************************************
 * Constants and macros
@@ -28,6 +63,16 @@ KBI_CallbackType KBI_Callback[KBI_MAX_NO] = {( KBI_CallbackType )NULL};
 /******************************************************************************
 * Local function prototypes
 ******************************************************************************/
+#ifdef KBI0_STATIC_CALLBACK
+void KBI0_STATIC_CALLBACK( void );
+#else
+void KBI0_Isr( void );
+#endif
+#ifdef KBI1_STATIC_CALLBACK
+void KBI1_STATIC_CALLBACK( void );
+#else
+void KBI1_Isr( void );
+#endif
 
 /******************************************************************************
 * Local variables
@@ -36,6 +81,33 @@ KBI_CallbackType KBI_Callback[KBI_MAX_NO] = {( KBI_CallbackType )NULL};
 /******************************************************************************
 * Local functions
 ******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief KBI isr body, shared by the static and the dynamic handler.
+*
+* @param[in] pKBI          pointer to KBI module.
+* @param[in] u8Id          ISRSTAT_KBI0 or ISRSTAT_KBI1.
+* @param[in] pfnCallback   callback, a constant in the static handler.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE void KBI_Isr( KBI_Type * pKBI, uint8_t u8Id, KBI_CallbackType pfnCallback )
+{
+  ISRSTAT_ENTER( u8Id );
+  pKBI->SC |= KBI_SC_KBACK_MASK;                        /* clear interrupt flag */
+
+  if ( pfnCallback )
+  {
+    pfnCallback();
+  }
+
+  ISRSTAT_EXIT( u8Id );
+}
+
 /******************************************************************************
 * KBI api list
 *
@@ -64,48 +136,16 @@ KBI_CallbackType KBI_Callback[KBI_MAX_NO] = {( KBI_CallbackType )NULL};
 *****************************************************************************/
 void KBI_Init( KBI_Type * pKBI, KBI_ConfigType * pConfig )
 {
-#if defined(CPU_NV32)
-  uint16_t    i;
-  uint8_t     sc = 0;
-  uint8_t     u8Port;
-  uint8_t     u8PinPos;
-  uint16_t    u16PinMapping[KBI_MAX_NO][8] =
-  {
-    {
-      0, 1, 2, 3, 8, 9, 10, 11           /* KBI0 pins position in GPIOA register */
-    },
-    {
-      24, 25, 26, 27, 28, 29, 30, 31      /* KBI1 pins position in GPIOA register */
-    }
-  };
-#elif defined(CPU_NV32M3)
+#if defined(CPU_NV32M4)
+  uint32_t    i;
+  uint32_t    sc = 0;
+  uint32_t    u8Port;
+  uint32_t    u8PinPos;
+#else
   uint16_t    i;
   uint8_t     sc = 0;
   uint8_t     u8Port;
   uint8_t     u8PinPos;
-  uint16_t    u16PinMapping[KBI_MAX_NO][8] =
-  {
-    {
-      0, 1, 2, 3, 8, 9, 10, 11           /* KBI0 pins position in GPIOA register */
-    },
-    {
-      20, 21, 16, 17, 18, 19, 12, 13      /* KBI1 pins position in GPIOA register */
-    }
-  };
-#elif defined(CPU_NV32M4)
-  uint32_t    i;
-  uint32_t     sc = 0;
-  uint32_t     u8Port;
-  uint32_t     u8PinPos;
-  uint32_t    u16PinMapping[KBI_MAX_NO][KBI_MAX_PINS_PER_PORT] =
-  {
-    {/* KBI0P0~KBI0P31 pins position in GPIOA register */
-      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
-    },
-    {/* KBI1P0~KBI1P31 pins position in GPIOB register */
-      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
-    }
-  };
 #endif
 
   if ( KBI0 == pKBI )
@@ -130,7 +170,7 @@ void KBI_Init( KBI_Type * pKBI, KBI_ConfigType * pConfig )
     {
       pKBI->PE    |= ( 1 << i );                  /* enable this KBI pin */
       pKBI->ES    = ( pKBI->ES & ~( 1 << i ) ) | ( pConfig->sPin[i].bEdge << i );
-      u8PinPos = u16PinMapping[u8Port][i];
+      u8PinPos = KBI_u8PinMapping[u8Port][i];
       ASSERT( !( u8PinPos & 0x80 ) );
 #if defined(CPU_NV32)|| defined(CPU_NV32M3)
       FGPIOA->PIDR  &= ~( 1 << u8PinPos );          /* enable GPIO input */
@@ -198,11 +238,27 @@ void KBI_SetCallback( KBI_Type * pKBI, KBI_CallbackType pfnCallback )
 {
   if ( KBI0 == pKBI )
   {
+#ifdef KBI0_STATIC_CALLBACK
+    /* bound at link time, KBI0_IRQHandler calls KBI0_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == KBI0_STATIC_CALLBACK ) );
+#else
     KBI_Callback[0] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( KBI0_IRQn, KBI0_Isr );
+#endif
+#endif
   }
   else
   {
+#ifdef KBI1_STATIC_CALLBACK
+    /* bound at link time, KBI1_IRQHandler calls KBI1_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == KBI1_STATIC_CALLBACK ) );
+#else
     KBI_Callback[1] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( KBI1_IRQn, KBI1_Isr );
+#endif
+#endif
   }
 }
 
@@ -258,15 +314,17 @@ void KBI_DeInit( KBI_Type * pKBI )
 *
 *****************************************************************************/
 
+#ifdef KBI0_STATIC_CALLBACK
+void KBI0_IRQHandler( void )
+{
+  KBI_Isr( KBI0, ISRSTAT_KBI0, KBI0_STATIC_CALLBACK );
+}
+#else
 void KBI0_Isr( void )
 {
-  KBI0->SC |= KBI_SC_KBACK_MASK;                        /* clear interrupt flag */
-
-  if ( KBI_Callback[0] )
-  {
-    KBI_Callback[0]();
-  }
+  KBI_Isr( KBI0, ISRSTAT_KBI0, KBI_Callback[0] );
 }
+#endif
 
 
 
@@ -282,13 +340,15 @@ void KBI0_Isr( void )
 *
 *****************************************************************************/
 
+#ifdef KBI1_STATIC_CALLBACK
+void KBI1_IRQHandler( void )
+{
+  KBI_Isr( KBI1, ISRSTAT_KBI1, KBI1_STATIC_CALLBACK );
+}
+#else
 void KBI1_Isr( void )
 {
-  KBI1->SC |= KBI_SC_KBACK_MASK;                        /* clear interrupt flag */
-
-  if ( KBI_Callback[1] )
-  {
-    KBI_Callback[1]();
-  }
+  KBI_Isr( KBI1, ISRSTAT_KBI1, KBI_Callback[1] );
 }
+#endif
 
@@ -132,6 +132,7 @@ typedef struct
 /******************************************************************************
 * Global variables
 ******************************************************************************/
+extern const uint8_t KBI_u8PinMapping[KBI_MAX_NO][KBI_MAX_PINS_PER_PORT];
 /*!
  * inline functions
  */
@@ -424,6 +425,7 @@ __STATIC_INLINE  void KBI_RstSP( KBI_Type * pKBI )
 
 void KBI_Init( KBI_Type * pKBI, KBI_ConfigType * pConfig );
 void KBI_SetCallback( KBI_Type * pKBI, KBI_CallbackType pfnCallback );
+void KBI_DeInit( KBI_Type * pKBI );
 
 #ifdef __cplusplus
 }
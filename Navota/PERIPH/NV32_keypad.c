@@ -0,0 +1,425 @@
+/******************************************************************************
+* @brief providing APIs for debounced matrix keypad scanner (KEYPAD).
+*
+*******************************************************************************
+*
+* While no key is down all rows are driven low and the column KBI pins wait
+* for a low level, there is no polling. The KBI interrupt masks itself
+* and starts a periodic software timer on the PIT timer wheel, which drives
+* one row per period and samples the columns of that row one period later,
+* after they have settled.
+*
+* Every key has an integrating debounce counter, counting up on frames the
+* key reads down and down otherwise; the debounced state only changes when
+* the counter reaches KEYPAD_DEBOUNCE_FRAMES or 0. When all counters are 0
+* at the end of a frame the timer stops and the KBI interrupt is armed
+* again.
+*
+* Events go through a single producer, single consumer ring: only the scan
+* writes the head and only KEYPAD_GetEvent writes the tail, so neither side
+* masks interrupts.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_keypad.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define KEYPAD_MAX_KEYS         ( KEYPAD_MAX_ROWS * KEYPAD_MAX_COLS )
+#define KEYPAD_QUEUE_MASK       ( KEYPAD_QUEUE_SIZE - 1 )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static void KEYPAD_Post( uint8_t u8Event );
+static void KEYPAD_DriveRow( uint8_t u8Row );
+static void KEYPAD_ReleaseRows( void );
+static void KEYPAD_Arm( void );
+static void KEYPAD_Scan( void * pParam );
+static void KEYPAD_KbiIsr( void );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static KBI_Type         *KEYPAD_pKBI;
+static FGPIO_Type       *KEYPAD_pRowPort[KEYPAD_MAX_ROWS];
+static uint32_t         KEYPAD_u32RowMask[KEYPAD_MAX_ROWS];
+static FGPIO_Type       *KEYPAD_pColPort;
+static uint8_t          KEYPAD_u8ColPos[KEYPAD_MAX_COLS];  /*!< column bit in KEYPAD_pColPort */
+static uint8_t          KEYPAD_u8Rows;
+static uint8_t          KEYPAD_u8Cols;
+static uint8_t          KEYPAD_u8Row;                      /*!< row driven in this period */
+static uint8_t          KEYPAD_bScanning;
+static uint16_t         KEYPAD_u16LongFrames;              /*!< frames for a long press, 0: none */
+static uint8_t          KEYPAD_u8Count[KEYPAD_MAX_KEYS];   /*!< debounce integrators */
+static uint16_t         KEYPAD_u16Hold[KEYPAD_MAX_KEYS];   /*!< frames held down */
+static uint8_t          KEYPAD_u8State[KEYPAD_MAX_ROWS];   /*!< debounced state, bit per column */
+static uint8_t          KEYPAD_u8Active;                   /*!< non-zero integrators in this frame */
+static uint32_t         KEYPAD_u32Overflows;
+static SWTMR_TimerType  KEYPAD_sTimer;
+
+static volatile uint8_t KEYPAD_u8Queue[KEYPAD_QUEUE_SIZE];
+static volatile uint8_t KEYPAD_u8Head;                     /*!< written by the scan only */
+static volatile uint8_t KEYPAD_u8Tail;                     /*!< written by KEYPAD_GetEvent only */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  put an event into the queue, dropped and counted if it is full.
+*
+* @param[in]    u8Event     event code.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void KEYPAD_Post( uint8_t u8Event )
+{
+  uint8_t u8Head = KEYPAD_u8Head;
+  uint8_t u8Next = ( u8Head + 1 ) & KEYPAD_QUEUE_MASK;
+
+  if ( u8Next == KEYPAD_u8Tail )
+  {
+    KEYPAD_u32Overflows++;
+    return;
+  }
+
+  KEYPAD_u8Queue[u8Head] = u8Event;
+  /* the slot is written before the reader can see it */
+  KEYPAD_u8Head = u8Next;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  drive one row low, the others are high impedance.
+*
+* @param[in]    u8Row       row to drive.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void KEYPAD_DriveRow( uint8_t u8Row )
+{
+  KEYPAD_ReleaseRows();
+  KEYPAD_pRowPort[u8Row]->PDDR |= KEYPAD_u32RowMask[u8Row];
+}
+
+/*****************************************************************************//*!
+*
+* @brief  turn all rows to high impedance.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void KEYPAD_ReleaseRows( void )
+{
+  uint8_t i;
+
+  for ( i = 0; i < KEYPAD_u8Rows; i++ )
+  {
+    KEYPAD_pRowPort[i]->PDDR &= ~KEYPAD_u32RowMask[i];
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  drive all rows low and wait for a key on the KBI interrupt.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void KEYPAD_Arm( void )
+{
+  uint8_t i;
+
+  for ( i = 0; i < KEYPAD_u8Rows; i++ )
+  {
+    KEYPAD_pRowPort[i]->PDDR |= KEYPAD_u32RowMask[i];
+  }
+
+  KEYPAD_bScanning = 0;
+  KEYPAD_pKBI->SC |= KBI_SC_KBACK_MASK;
+  KEYPAD_pKBI->SC |= KBI_SC_KBIE_MASK;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  scan timer callback: debounce the columns of the row driven in the
+*         last period and drive the next row.
+*
+* @param[in]    pParam      not used.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void KEYPAD_Scan( void * pParam )
+{
+  uint32_t u32Input = KEYPAD_pColPort->PDIR;
+  uint8_t  u8Row    = KEYPAD_u8Row;
+  uint8_t  u8Key    = u8Row * KEYPAD_MAX_COLS;
+  uint8_t  u8Col;
+
+  for ( u8Col = 0; u8Col < KEYPAD_u8Cols; u8Col++, u8Key++ )
+  {
+    if ( !( u32Input & ( 1UL << KEYPAD_u8ColPos[u8Col] ) ) )
+    {
+      if ( KEYPAD_u8Count[u8Key] < KEYPAD_DEBOUNCE_FRAMES )
+      {
+        KEYPAD_u8Count[u8Key]++;
+      }
+    }
+    else if ( KEYPAD_u8Count[u8Key] )
+    {
+      KEYPAD_u8Count[u8Key]--;
+    }
+
+    if ( KEYPAD_u8State[u8Row] & ( 1 << u8Col ) )
+    {
+      if ( 0 == KEYPAD_u8Count[u8Key] )
+      {
+        KEYPAD_u8State[u8Row] &= ~( 1 << u8Col );
+        KEYPAD_Post( KEYPAD_EVENT_RELEASE | u8Key );
+      }
+      else if ( KEYPAD_u16Hold[u8Key] < KEYPAD_u16LongFrames )
+      {
+        if ( ++KEYPAD_u16Hold[u8Key] == KEYPAD_u16LongFrames )
+        {
+          KEYPAD_Post( KEYPAD_EVENT_LONG | u8Key );
+        }
+      }
+    }
+    else if ( KEYPAD_DEBOUNCE_FRAMES == KEYPAD_u8Count[u8Key] )
+    {
+      KEYPAD_u8State[u8Row] |= ( 1 << u8Col );
+      KEYPAD_u16Hold[u8Key] = 0;
+      KEYPAD_Post( KEYPAD_EVENT_PRESS | u8Key );
+    }
+
+    KEYPAD_u8Active |= KEYPAD_u8Count[u8Key];
+  }
+
+  if ( ++u8Row < KEYPAD_u8Rows )
+  {
+    KEYPAD_u8Row = u8Row;
+    KEYPAD_DriveRow( u8Row );
+    return;
+  }
+
+  /* end of frame */
+  if ( !KEYPAD_u8Active )
+  {
+    SWTMR_Stop( &KEYPAD_sTimer );
+    KEYPAD_Arm();
+    return;
+  }
+
+  KEYPAD_u8Active = 0;
+  KEYPAD_u8Row    = 0;
+  KEYPAD_DriveRow( 0 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  KBI callback: a key went down while idle, start scanning.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void KEYPAD_KbiIsr( void )
+{
+  KEYPAD_pKBI->SC &= ~KBI_SC_KBIE_MASK;
+  KEYPAD_bScanning = 1;
+  KEYPAD_u8Active  = 0;
+  KEYPAD_u8Row     = 0;
+  KEYPAD_DriveRow( 0 );
+  SWTMR_Start( &KEYPAD_sTimer, KEYPAD_SCAN_TICKS, KEYPAD_SCAN_TICKS );
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* KEYPAD api lists
+*
+*//*! @addtogroup keypad_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  initialize the keypad and wait for the first key. SWTMR_Init must
+*         have been called.
+*
+* @param[in]    pConfig     pointer to the keypad configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void KEYPAD_Init( KEYPAD_ConfigType * pConfig )
+{
+  KBI_ConfigType sKBIConfig = {0};
+  uint32_t u32FrameUs;
+  uint8_t  u8Port = ( KBI0 == pConfig->pKBI ) ? 0 : 1;
+  uint8_t  i;
+  ASSERT( ( pConfig->u8Rows <= KEYPAD_MAX_ROWS ) && ( pConfig->u8Cols <= KEYPAD_MAX_COLS ) );
+  KEYPAD_pKBI   = pConfig->pKBI;
+  KEYPAD_u8Rows = pConfig->u8Rows;
+  KEYPAD_u8Cols = pConfig->u8Cols;
+  KEYPAD_u8Head = 0;
+  KEYPAD_u8Tail = 0;
+  KEYPAD_u32Overflows = 0;
+
+  for ( i = 0; i < KEYPAD_MAX_KEYS; i++ )
+  {
+    KEYPAD_u8Count[i] = 0;
+  }
+
+  for ( i = 0; i < KEYPAD_u8Rows; i++ )
+  {
+    ASSERT( pConfig->u8RowPin[i] < GPIO_PTI0 );
+    KEYPAD_pRowPort[i]   = ( pConfig->u8RowPin[i] < GPIO_PTE0 ) ? FGPIOA : FGPIOB;
+    KEYPAD_u32RowMask[i] = 1UL << ( pConfig->u8RowPin[i] & 0x1F );
+    KEYPAD_u8State[i]    = 0;
+    /* output latch low, the scan only switches the direction */
+    GPIO_PinInit( ( GPIO_PinType )pConfig->u8RowPin[i], GPIO_PinOutput );
+    KEYPAD_pRowPort[i]->PCOR = KEYPAD_u32RowMask[i];
+  }
+
+#if defined(CPU_NV32M4)
+  KEYPAD_pColPort = u8Port ? FGPIOB : FGPIOA;
+#else
+  KEYPAD_pColPort = FGPIOA;
+#endif
+
+  for ( i = 0; i < KEYPAD_u8Cols; i++ )
+  {
+    KEYPAD_u8ColPos[i] = KBI_u8PinMapping[u8Port][pConfig->u8ColPin[i]];
+    sKBIConfig.sPin[pConfig->u8ColPin[i]].bEn   = 1;
+    sKBIConfig.sPin[pConfig->u8ColPin[i]].bEdge = KBI_FALLING_EDGE_LOW_LEVEL;
+  }
+
+  /* a frame scans every row once */
+  u32FrameUs = ( uint32_t )KEYPAD_u8Rows * KEYPAD_SCAN_TICKS * SWTMR_TICK_US;
+  KEYPAD_u16LongFrames = ( uint16_t )( ( ( uint32_t )pConfig->u16LongPressMs * 1000 + u32FrameUs - 1 ) / u32FrameUs );
+  SWTMR_TimerInit( &KEYPAD_sTimer, KEYPAD_Scan, NULL );
+  /* edge and level, so a key already down when armed is not missed */
+  sKBIConfig.sBits.bMode  = KBI_MODE_EDGE_LEVEL;
+  sKBIConfig.sBits.bIntEn = 0;
+  KBI_Init( KEYPAD_pKBI, &sKBIConfig );
+  KBI_SetCallback( KEYPAD_pKBI, KEYPAD_KbiIsr );
+  NVIC_EnableIRQ( ( KBI0 == KEYPAD_pKBI ) ? KBI0_IRQn : KBI1_IRQn );
+  KEYPAD_Arm();
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop scanning and release the KBI module and the row pins.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void KEYPAD_DeInit( void )
+{
+  SWTMR_Stop( &KEYPAD_sTimer );
+  KBI_DeInit( KEYPAD_pKBI );
+  KBI_SetCallback( KEYPAD_pKBI, ( KBI_CallbackType )NULL );
+  KEYPAD_ReleaseRows();
+  KEYPAD_bScanning = 0;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  take the oldest event from the queue, from one context only.
+*
+* @param  none.
+*
+* @return event code, KEYPAD_NO_EVENT if the queue is empty.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t KEYPAD_GetEvent( void )
+{
+  uint8_t u8Tail = KEYPAD_u8Tail;
+  uint8_t u8Event;
+
+  if ( u8Tail == KEYPAD_u8Head )
+  {
+    return KEYPAD_NO_EVENT;
+  }
+
+  u8Event = KEYPAD_u8Queue[u8Tail];
+  /* the slot is read before the writer can reuse it */
+  KEYPAD_u8Tail = ( u8Tail + 1 ) & KEYPAD_QUEUE_MASK;
+  return u8Event;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  check whether the keypad is being scanned, i.e. a key is down or
+*         bouncing.
+*
+* @param  none.
+*
+* @return TRUE if scanning, FALSE if waiting on the KBI interrupt.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t KEYPAD_IsScanning( void )
+{
+  return KEYPAD_bScanning;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the number of events dropped because the queue was full.
+*
+* @param  none.
+*
+* @return dropped events.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t KEYPAD_GetOverflows( void )
+{
+  return KEYPAD_u32Overflows;
+}
+
+/*! @} End of keypad_api_list                                                 */
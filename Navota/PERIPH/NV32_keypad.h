@@ -0,0 +1,92 @@
+/******************************************************************************
+* @brief header file for debounced matrix keypad scanner (KEYPAD).
+*
+*******************************************************************************
+*
+* provide APIs for a key matrix with columns on KBI pins, scanned only while
+* keys are active and reporting press, release and long press events
+******************************************************************************/
+#ifndef __NV32_KEYPAD_H__
+#define __NV32_KEYPAD_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_gpio.h"
+#include "NV32_kbi.h"
+#include "NV32_swtimer.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define KEYPAD_MAX_ROWS         8           /*!< max number of row outputs */
+#define KEYPAD_MAX_COLS         8           /*!< max number of column inputs, one KBI */
+
+#define KEYPAD_EVENT_PRESS      0x00        /*!< key went down */
+#define KEYPAD_EVENT_RELEASE    0x40        /*!< key went up */
+#define KEYPAD_EVENT_LONG       0x80        /*!< key held for the long press time */
+#define KEYPAD_NO_EVENT         0xFF        /*!< KEYPAD_GetEvent: queue empty */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/*! @brief key number of an event, row * KEYPAD_MAX_COLS + column. */
+#define KEYPAD_EVENT_KEY(e)     ( ( e ) & 0x3F )
+
+/*! @brief type of an event, KEYPAD_EVENT_PRESS/RELEASE/LONG. */
+#define KEYPAD_EVENT_TYPE(e)    ( ( e ) & 0xC0 )
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* KEYPAD configure struct.
+*
+*//*! @addtogroup keypad_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief KEYPAD configure struct.
+*
+* Rows are GPIOA/GPIOB pins driven low one at a time, columns are pins of
+* one KBI module with pullups, a pressed key pulls its column low.
+*/
+typedef struct
+{
+  KBI_Type      *pKBI;                          /*!< KBI0 or KBI1 */
+  uint8_t       u8Rows;                         /*!< 1 ~ KEYPAD_MAX_ROWS */
+  uint8_t       u8Cols;                         /*!< 1 ~ KEYPAD_MAX_COLS */
+  uint8_t       u8RowPin[KEYPAD_MAX_ROWS];      /*!< GPIO_PTA0 ~ GPIO_PTH7 */
+  uint8_t       u8ColPin[KEYPAD_MAX_COLS];      /*!< KBI pin number 0 ~ 7 */
+  uint16_t      u16LongPressMs;                 /*!< hold time for KEYPAD_EVENT_LONG, 0: none */
+} KEYPAD_ConfigType, *KEYPAD_ConfigPtr;
+/*! @} End of keypad_configstruct                                             */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void KEYPAD_Init( KEYPAD_ConfigType * pConfig );
+void KEYPAD_DeInit( void );
+uint8_t KEYPAD_GetEvent( void );
+uint8_t KEYPAD_IsScanning( void );
+uint32_t KEYPAD_GetOverflows( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_KEYPAD_H__ */
@@ -0,0 +1,310 @@
+/******************************************************************************
+* @brief providing APIs for three-phase motor control PWM (MCPWM) on ETM2.
+*
+*******************************************************************************
+*
+* ETM2 runs center aligned with three complementary pairs (CH0/CH1, CH2/CH3,
+* CH4/CH5), hardware dead time insertion and fault shutdown. Duty and
+* commutation updates are buffered and take effect at the counter maximum.
+* A comparator based over-current trip can be used by wiring the ACMP output
+* pin to one of the ETM2 FAULTn inputs.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_mcpwm.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define MCPWM_PHASE_MASK(phase)     ( 0x03 << ( ( phase ) << 1 ) )
+
+/* force the pair of one phase to high side off, low side on */
+#define MCPWM_PHASE_SINK(phase)     ( ( 0x03 << ( ( phase ) << 1 ) ) | ( 0x02 << ( ( ( phase ) << 1 ) + 8 ) ) )
+
+#define MCPWM_FAULT_INPUT_MASK      ( ETM_FLTCTRL_FAULT0EN_MASK | ETM_FLTCTRL_FAULT1EN_MASK | \
+                                      ETM_FLTCTRL_FAULT2EN_MASK | ETM_FLTCTRL_FAULT3EN_MASK )
+
+/* sqrt(3)/2 in Q15 */
+#define MCPWM_SQRT3_BY_2_Q15        28378
+
+/*!
+ * @brief six-step commutation table, indexed by MCPWM_STEP_x.
+ *
+ * The PWM phase keeps its complementary pair running, the sink phase has its
+ * low side forced on by software output control and the floating phase is
+ * masked.
+ */
+const MCPWM_StepType MCPWM_StepTable[MCPWM_STEP_MAX] =
+{
+  { MCPWM_PHASE_MASK( MCPWM_PHASE_W ), MCPWM_PHASE_SINK( MCPWM_PHASE_V ) },   /* MCPWM_STEP_0 */
+  { MCPWM_PHASE_MASK( MCPWM_PHASE_V ), MCPWM_PHASE_SINK( MCPWM_PHASE_W ) },   /* MCPWM_STEP_1 */
+  { MCPWM_PHASE_MASK( MCPWM_PHASE_U ), MCPWM_PHASE_SINK( MCPWM_PHASE_W ) },   /* MCPWM_STEP_2 */
+  { MCPWM_PHASE_MASK( MCPWM_PHASE_W ), MCPWM_PHASE_SINK( MCPWM_PHASE_U ) },   /* MCPWM_STEP_3 */
+  { MCPWM_PHASE_MASK( MCPWM_PHASE_V ), MCPWM_PHASE_SINK( MCPWM_PHASE_U ) },   /* MCPWM_STEP_4 */
+  { MCPWM_PHASE_MASK( MCPWM_PHASE_U ), MCPWM_PHASE_SINK( MCPWM_PHASE_V ) },   /* MCPWM_STEP_5 */
+  { MCPWM_ALL_CHANNELS_MASK,           0                                 },   /* MCPWM_STEP_OFF */
+  { 0, MCPWM_PHASE_SINK( MCPWM_PHASE_U ) | MCPWM_PHASE_SINK( MCPWM_PHASE_V ) |
+       MCPWM_PHASE_SINK( MCPWM_PHASE_W )                                 },   /* MCPWM_STEP_BRAKE */
+};
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static uint16_t MCPWM_u16Modulo;          /*!< cached modulo, saves a bus read per update */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* MCPWM api lists
+*
+*//*! @addtogroup mcpwm_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  initialize ETM2 for center aligned complementary PWM. All outputs are
+*         masked on return, call MCPWM_SetCommutation or MCPWM_OutputEnable
+*         to start driving the bridge.
+*
+* @param[in]    pConfig     pointer to MCPWM configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void MCPWM_Init( MCPWM_ConfigType * pConfig )
+{
+  uint8_t  u8Channel;
+  uint32_t u32Combine;
+  uint32_t u32FaultCtrl;
+  ASSERT( pConfig->u16Modulo > 0 );
+  ASSERT( pConfig->u8DeadTimeValue < 64 );
+  ASSERT( ( MCPWM_FAULT_MANUAL_CLEAR == pConfig->u8FaultMode ) ||
+          ( MCPWM_FAULT_AUTO_CLEAR == pConfig->u8FaultMode ) ||
+          ( 0 == pConfig->u8FaultInputMask ) );
+  SIM->SCGC |= SIM_SCGC_ETM2_MASK;
+  ETM2->SC   = 0;
+  /* disable write protection and enable the enhanced features */
+  ETM2->MODE = ETM_MODE_WPDIS_MASK | ETM_MODE_ETMEN_MASK;
+  MCPWM_u16Modulo = pConfig->u16Modulo;
+  ETM2->CNTIN = 0;
+  ETM2->CNT   = 0;
+  ETM2->MOD   = pConfig->u16Modulo;
+
+  /* high-true pulses, start with 50% duty (zero voltage) on all phases */
+  for ( u8Channel = 0; u8Channel < 6; u8Channel++ )
+  {
+    ETM2->CONTROLS[u8Channel].CnSC = ETM_CnSC_ELSB_MASK;
+    ETM2->CONTROLS[u8Channel].CnV  = pConfig->u16Modulo >> 1;
+  }
+
+  u32Combine = ETM_COMBINE_COMP0_MASK | ETM_COMBINE_DTEN0_MASK | ETM_COMBINE_SYNCEN0_MASK |
+               ETM_COMBINE_COMP1_MASK | ETM_COMBINE_DTEN1_MASK | ETM_COMBINE_SYNCEN1_MASK |
+               ETM_COMBINE_COMP2_MASK | ETM_COMBINE_DTEN2_MASK | ETM_COMBINE_SYNCEN2_MASK;
+
+  if ( pConfig->u8FaultInputMask )
+  {
+    u32Combine |= ETM_COMBINE_FAULTEN0_MASK | ETM_COMBINE_FAULTEN1_MASK | ETM_COMBINE_FAULTEN2_MASK;
+  }
+
+  ETM2->COMBINE  = u32Combine;
+  ETM2->DEADETME = ETM_DEADETME_DTPS( pConfig->u8DeadTimePrescale ) |
+                   ETM_DEADETME_DTVAL( pConfig->u8DeadTimeValue );
+  ETM2->POL      = pConfig->u8Polarity;
+  /* outputs go inactive while masked, also the state after a fault */
+  ETM2->OUTINIT  = 0;
+  ETM2->OUTMASK  = MCPWM_ALL_CHANNELS_MASK;
+  ETM2->SWOCTRL  = 0;
+  ETM2->MODE    |= ETM_MODE_INIT_MASK;
+
+  /* fault control */
+  if ( pConfig->u8FaultInputMask )
+  {
+    u32FaultCtrl = pConfig->u8FaultInputMask & MCPWM_FAULT_INPUT_MASK;
+
+    if ( pConfig->u8FaultFilter )
+    {
+      u32FaultCtrl |= ( u32FaultCtrl << 4 ) | ETM_FLTCTRL_FFVAL( pConfig->u8FaultFilter );
+    }
+
+    ETM2->FLTPOL  = pConfig->u8FaultPolarity;
+    ETM2->FLTCTRL = u32FaultCtrl;
+    ETM2->MODE   |= ETM_MODE_FAULTM( pConfig->u8FaultMode );
+
+    if ( pConfig->bFaultIntEn )
+    {
+      ETM2->MODE |= ETM_MODE_FAULTIE_MASK;
+    }
+  }
+
+  /* enhanced PWM synchronization: CnV, OUTMASK and SWOCTRL are buffered and
+   * loaded at the counter maximum on software trigger or PWMLOAD[LDOK] */
+  ETM2->SYNCONF = ETM_SYNCONF_SYNCMODE_MASK | ETM_SYNCONF_SWOC_MASK | ETM_SYNCONF_SWWRBUF_MASK |
+                  ETM_SYNCONF_SWOM_MASK | ETM_SYNCONF_SWSOC_MASK;
+  ETM2->SYNC    = ETM_SYNC_CNTMAX_MASK | ETM_SYNC_SYNCHOM_MASK;
+  ETM2->PWMLOAD = MCPWM_PWMLOAD_ALL;
+
+  if ( pConfig->bOverflowIntEn )
+  {
+    ETM2->SC = ETM_SC_TOIE_MASK;
+  }
+
+  if ( pConfig->bOverflowIntEn || pConfig->bFaultIntEn )
+  {
+    NVIC_EnableIRQ( ETM2_IRQn );
+  }
+
+  /* center aligned, start the counter */
+  ETM2->SC |= ETM_SC_CPWMS_MASK | ETM_SC_CLKS( ETM_CLOCK_SYSTEMCLOCK ) |
+              ETM_SC_PS( pConfig->u8ClockPrescale );
+  ETM2->SYNC |= ETM_SYNC_SWSYNC_MASK;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop the PWM and reset ETM2.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void MCPWM_DeInit( void )
+{
+  ETM2->OUTMASK = MCPWM_ALL_CHANNELS_MASK;
+  ETM_DeInit( ETM2 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  unmask all six outputs at the next counter maximum, used for
+*         sinusoidal or SVPWM operation.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void MCPWM_OutputEnable( void )
+{
+  ETM2->SWOCTRL = 0;
+  ETM2->OUTMASK = 0;
+  ETM2->SYNC   |= ETM_SYNC_SWSYNC_MASK;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  mask all six outputs immediately, without waiting for the counter
+*         maximum.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void MCPWM_OutputDisable( void )
+{
+  ETM2->SYNC   &= ~ETM_SYNC_SYNCHOM_MASK;
+  ETM2->OUTMASK = MCPWM_ALL_CHANNELS_MASK;
+  ETM2->SYNC   |= ETM_SYNC_SYNCHOM_MASK;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  clear the fault flags after a fault shutdown. With manual fault
+*         clearing the outputs resume at the next PWM period.
+*
+* @param  none.
+*
+* @return ETM_ERR_SUCCESS if the fault is cleared, ETM_ERR_INVALID_PARAM if a
+*         fault input is still active.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t MCPWM_ClearFault( void )
+{
+  uint32_t u32Status;
+  /* FAULTF is cleared by reading FMS then writing 0 while no fault is present */
+  u32Status = ETM2->FMS;
+
+  if ( u32Status & ETM_FMS_FAULTIN_MASK )
+  {
+    return ETM_ERR_INVALID_PARAM;
+  }
+
+  ETM2->FMS = u32Status & ~( ETM_FMS_FAULTF_MASK | ETM_FMS_FAULTF0_MASK | ETM_FMS_FAULTF1_MASK |
+                             ETM_FMS_FAULTF2_MASK | ETM_FMS_FAULTF3_MASK | ETM_FMS_WPEN_MASK );
+  return ETM_ERR_SUCCESS;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  space vector PWM update from a stationary frame voltage vector.
+*         Integer inverse Clarke transform plus min/max zero sequence
+*         injection, the three duties are loaded together at the next
+*         counter maximum. Fits a 20 kHz control loop with a few dozen
+*         cycles on Cortex-M0+.
+*
+* @param[in]    i16Alpha    alpha voltage in Q15, full scale is half DC bus.
+* @param[in]    i16Beta     beta voltage in Q15, full scale is half DC bus.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void MCPWM_SVPWMUpdate( int16_t i16Alpha, int16_t i16Beta )
+{
+  int32_t  i32Va, i32Vb, i32Vc;
+  int32_t  i32Max, i32Min, i32Offset;
+  int32_t  i32HalfAlpha, i32Beta;
+  int32_t  i32Mod = ( int32_t )MCPWM_u16Modulo;
+  int32_t  i32Half = i32Mod >> 1;
+  i32HalfAlpha = -( ( int32_t )i16Alpha >> 1 );
+  i32Beta      = ( ( int32_t )i16Beta * MCPWM_SQRT3_BY_2_Q15 ) >> 15;
+  i32Va = i16Alpha;
+  i32Vb = i32HalfAlpha + i32Beta;
+  i32Vc = i32HalfAlpha - i32Beta;
+  /* zero sequence: centre the three phase voltages between min and max */
+  i32Max = ( i32Va > i32Vb ) ? i32Va : i32Vb;
+  i32Max = ( i32Max > i32Vc ) ? i32Max : i32Vc;
+  i32Min = ( i32Va < i32Vb ) ? i32Va : i32Vb;
+  i32Min = ( i32Min < i32Vc ) ? i32Min : i32Vc;
+  i32Offset = ( i32Max + i32Min ) >> 1;
+  /* centred phase voltages stay within +-40132, times the half modulo fits 31 bits */
+  i32Va = i32Half + ( ( ( i32Va - i32Offset ) * i32Half ) >> 15 );
+  i32Vb = i32Half + ( ( ( i32Vb - i32Offset ) * i32Half ) >> 15 );
+  i32Vc = i32Half + ( ( ( i32Vc - i32Offset ) * i32Half ) >> 15 );
+  i32Va = ( i32Va < 0 ) ? 0 : ( ( i32Va > i32Mod ) ? i32Mod : i32Va );
+  i32Vb = ( i32Vb < 0 ) ? 0 : ( ( i32Vb > i32Mod ) ? i32Mod : i32Vb );
+  i32Vc = ( i32Vc < 0 ) ? 0 : ( ( i32Vc > i32Mod ) ? i32Mod : i32Vc );
+  MCPWM_SetDuty( ( uint16_t )i32Va, ( uint16_t )i32Vb, ( uint16_t )i32Vc );
+}
+
+/*! @} End of mcpwm_api_list                                                  */
@@ -0,0 +1,233 @@
+/******************************************************************************
+* @brief header file for three-phase motor control PWM (MCPWM) on ETM2.
+*
+*******************************************************************************
+*
+* provide APIs for driving three complementary PWM pairs with dead time and
+* hardware fault shutdown
+******************************************************************************/
+#ifndef __NV32_MCPWM_H__
+#define __NV32_MCPWM_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_etm.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+
+/******************************************************************************
+* MCPWM phase definition
+*
+*//*! @addtogroup mcpwm_phase
+* @{
+*******************************************************************************/
+#define MCPWM_PHASE_U           0               /*!< phase U: ETM2 CH0 (high) & CH1 (low) */
+#define MCPWM_PHASE_V           1               /*!< phase V: ETM2 CH2 (high) & CH3 (low) */
+#define MCPWM_PHASE_W           2               /*!< phase W: ETM2 CH4 (high) & CH5 (low) */
+/*! @} End of mcpwm_phase                                                     */
+
+/******************************************************************************
+* MCPWM six-step commutation definition
+*
+*//*! @addtogroup mcpwm_commutation
+* @{
+*******************************************************************************/
+#define MCPWM_STEP_0            0               /*!< U+ PWM, V- on, W off */
+#define MCPWM_STEP_1            1               /*!< U+ PWM, W- on, V off */
+#define MCPWM_STEP_2            2               /*!< V+ PWM, W- on, U off */
+#define MCPWM_STEP_3            3               /*!< V+ PWM, U- on, W off */
+#define MCPWM_STEP_4            4               /*!< W+ PWM, U- on, V off */
+#define MCPWM_STEP_5            5               /*!< W+ PWM, V- on, U off */
+#define MCPWM_STEP_OFF          6               /*!< all switches off */
+#define MCPWM_STEP_BRAKE        7               /*!< all low side switches on */
+#define MCPWM_STEP_MAX          8               /*!< number of table entries */
+/*! @} End of mcpwm_commutation                                               */
+
+/******************************************************************************
+* MCPWM fault mode definition
+*
+*//*! @addtogroup mcpwm_faultmode
+* @{
+*******************************************************************************/
+#define MCPWM_FAULT_MANUAL_CLEAR  2             /*!< outputs stay off until MCPWM_ClearFault */
+#define MCPWM_FAULT_AUTO_CLEAR    3             /*!< outputs resume at the next PWM period once the fault input is gone */
+/*! @} End of mcpwm_faultmode                                                 */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/*! @brief all six ETM2 channel outputs. */
+#define MCPWM_ALL_CHANNELS_MASK   0x3F
+
+/*! @brief PWMLOAD value reloading CnV of all six channels at the next loading point. */
+#define MCPWM_PWMLOAD_ALL         ( ETM_PWMLOAD_LDOK_MASK | ETM_PWMLOAD_CH0SEL_MASK | ETM_PWMLOAD_CH1SEL_MASK | \
+                                    ETM_PWMLOAD_CH2SEL_MASK | ETM_PWMLOAD_CH3SEL_MASK | \
+                                    ETM_PWMLOAD_CH4SEL_MASK | ETM_PWMLOAD_CH5SEL_MASK )
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* MCPWM configure struct.
+*
+*//*! @addtogroup mcpwm_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief MCPWM configure struct.
+*
+* The PWM is center aligned, so the PWM period is 2 * u16Modulo ETM2 clocks.
+* Example: 24 MHz bus clock, DIV1 prescaler and 20 kHz PWM gives u16Modulo = 600.
+*/
+typedef struct
+{
+  uint16_t  u16Modulo;                /*!< half PWM period in ETM2 clocks */
+  uint8_t   u8ClockPrescale;          /*!< ETM_CLOCK_PS_DIV1 ~ ETM_CLOCK_PS_DIV128 */
+  uint8_t   u8DeadTimePrescale;       /*!< ETM_DEADETME_DTPS_DIV1/4/16 */
+  uint8_t   u8DeadTimeValue;          /*!< dead time in prescaled clocks, 0 ~ 63 */
+  uint8_t   u8Polarity;               /*!< POL register: bit n set makes CHn active low */
+  uint8_t   u8FaultInputMask;         /*!< FAULT0EN ~ FAULT3EN, 0: no hardware shutdown */
+  uint8_t   u8FaultPolarity;          /*!< FLTPOL register: bit n set makes FAULTn active low */
+  uint8_t   u8FaultFilter;            /*!< fault input filter 1 ~ 15, 0: filter disabled */
+  uint8_t   u8FaultMode;              /*!< MCPWM_FAULT_MANUAL_CLEAR or MCPWM_FAULT_AUTO_CLEAR */
+  uint8_t   bFaultIntEn     : 1;      /*!< 1: interrupt on fault detection */
+  uint8_t   bOverflowIntEn  : 1;      /*!< 1: interrupt once per PWM period (control loop tick) */
+  uint8_t   bReserved       : 6;      /*!< reserved */
+} MCPWM_ConfigType, *MCPWM_ConfigPtr;
+/*! @} End of mcpwm_configstruct                                              */
+
+/******************************************************************************
+* MCPWM commutation table entry.
+*
+*//*! @addtogroup mcpwm_steptype
+* @{
+*******************************************************************************/
+/*!
+* @brief one six-step commutation state: which outputs are masked and which
+*        are forced by software output control.
+*/
+typedef struct
+{
+  uint8_t   u8OutMask;                /*!< OUTMASK value, masked outputs go to inactive state */
+  uint16_t  u16SwOutCtrl;             /*!< SWOCTRL value, forces low side switches on */
+} MCPWM_StepType;
+/*! @} End of mcpwm_steptype                                                  */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+extern const MCPWM_StepType MCPWM_StepTable[MCPWM_STEP_MAX];
+
+/*!
+ * inline functions
+ */
+/******************************************************************************
+* MCPWM inline functions
+*
+*//*! @addtogroup mcpwm_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  update the duty of the three phases, loaded together at the next
+*         counter maximum so the phases never see a mixed update.
+*
+* @param[in]    u16DutyU    phase U high side on-time, 0 ~ modulo.
+* @param[in]    u16DutyV    phase V high side on-time, 0 ~ modulo.
+* @param[in]    u16DutyW    phase W high side on-time, 0 ~ modulo.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE void MCPWM_SetDuty( uint16_t u16DutyU, uint16_t u16DutyV, uint16_t u16DutyW )
+{
+  ETM2->CONTROLS[0].CnV = u16DutyU;
+  ETM2->CONTROLS[2].CnV = u16DutyV;
+  ETM2->CONTROLS[4].CnV = u16DutyW;
+  ETM2->PWMLOAD = MCPWM_PWMLOAD_ALL;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  apply one six-step commutation state from MCPWM_StepTable, the new
+*         output mask and software control take effect at the next counter maximum.
+*
+* @param[in]    u8Step      MCPWM_STEP_0 ~ MCPWM_STEP_BRAKE.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE void MCPWM_SetCommutation( uint8_t u8Step )
+{
+  const MCPWM_StepType * pStep = &MCPWM_StepTable[u8Step];
+
+  ETM2->OUTMASK = pStep->u8OutMask;
+  ETM2->SWOCTRL = pStep->u16SwOutCtrl;
+  ETM2->SYNC   |= ETM_SYNC_SWSYNC_MASK;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  set six-step duty: the same on-time is applied to all high sides,
+*         only the phase selected by the commutation state switches.
+*
+* @param[in]    u16Duty     high side on-time, 0 ~ modulo.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE void MCPWM_SetSixStepDuty( uint16_t u16Duty )
+{
+  MCPWM_SetDuty( u16Duty, u16Duty, u16Duty );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the fault detection flags.
+*
+* @param  none.
+*
+* @return FMS FAULTF0 ~ FAULTF3 bits, 0 if no fault was detected.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE uint8_t MCPWM_GetFaultFlags( void )
+{
+  return ( ETM2->FMS & ( ETM_FMS_FAULTF0_MASK | ETM_FMS_FAULTF1_MASK |
+                         ETM_FMS_FAULTF2_MASK | ETM_FMS_FAULTF3_MASK ) );
+}
+
+/*! @} End of mcpwm_api_list                                                  */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void MCPWM_Init( MCPWM_ConfigType * pConfig );
+void MCPWM_DeInit( void );
+void MCPWM_OutputEnable( void );
+void MCPWM_OutputDisable( void );
+uint8_t MCPWM_ClearFault( void );
+void MCPWM_SVPWMUpdate( int16_t i16Alpha, int16_t i16Beta );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_MCPWM_H__ */
@@ -0,0 +1,606 @@
+/******************************************************************************
+* @brief providing APIs for bit-banged parallel bus engine (PBUS).
+*
+*******************************************************************************
+*
+* The data pins may sit anywhere on one FGPIO port, so a byte is put on the
+* bus through a 256 entry table of pins to set. A byte costs one PCOR store
+* clearing the other data pins, one PSOR store and the strobe stores. With an
+* 8080 WR# on the data port, WR# falls in the same PCOR store and only
+* rises on its own, three stores per byte. The 6800 E strobe and a WR# on
+* the other port take a fourth store, their edges cannot be merged with
+* data changes without breaking the setup or hold time.
+*
+* Repeated 16-bit values only flip the data pins that differ between the
+* high and low byte: one PTOR store, WR# included when merged, and the
+* rising strobe, two stores per byte.
+*
+* Strobes are one core clock wide, PBUS_STROBE_STRETCH adds clocks for
+* slower devices. The table takes 1 KB RAM.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_pbus.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+
+/* keep the strobe active for PBUS_STROBE_STRETCH more core clocks */
+#define PBUS_STRETCH()                                  \
+  do                                                    \
+  {                                                     \
+    if ( PBUS_STROBE_STRETCH > 0 ) __no_operation();    \
+    if ( PBUS_STROBE_STRETCH > 1 ) __no_operation();    \
+    if ( PBUS_STROBE_STRETCH > 2 ) __no_operation();    \
+  } while ( 0 )
+
+/* one byte, 8080 WR# on the data port falls with the data clear */
+#define PBUS_PUT_MERGED(u8Byte)                         \
+  do                                                    \
+  {                                                     \
+    u32Set = PBUS_u32SetMask[u8Byte];                   \
+    pPort->PCOR = u32Set ^ u32Clr;                      \
+    pPort->PSOR = u32Set;                               \
+    PBUS_STRETCH();                                     \
+    pPort->PSOR = u32Strobe;                            \
+  } while ( 0 )
+
+/* one byte, separate strobe */
+#define PBUS_PUT(u8Byte)                                \
+  do                                                    \
+  {                                                     \
+    u32Set = PBUS_u32SetMask[u8Byte];                   \
+    pPort->PCOR = u32Set ^ u32Clr;                      \
+    pPort->PSOR = u32Set;                               \
+    *pOn = u32Strobe;                                   \
+    PBUS_STRETCH();                                     \
+    *pOff = u32Strobe;                                  \
+  } while ( 0 )
+
+/* flip the data pins to the other byte of a repeated value */
+#define PBUS_FLIP_MERGED()                              \
+  do                                                    \
+  {                                                     \
+    pPort->PTOR = u32Toggle;                            \
+    PBUS_STRETCH();                                     \
+    pPort->PSOR = u32Strobe;                            \
+  } while ( 0 )
+
+#define PBUS_FLIP()                                     \
+  do                                                    \
+  {                                                     \
+    pPort->PTOR = u32Toggle;                            \
+    *pOn = u32Strobe;                                   \
+    PBUS_STRETCH();                                     \
+    *pOff = u32Strobe;                                  \
+  } while ( 0 )
+
+/* one bit into the shift register, MSB first */
+#define PBUS_SHIFT_BIT(u8Bit)                           \
+  do                                                    \
+  {                                                     \
+    pClk->PCOR = u32Clk;                                \
+    *( ( u8Byte & ( u8Bit ) ) ? pSerSet : pSerClr ) = u32Ser; \
+    PBUS_STRETCH();                                     \
+    pClk->PSOR = u32Clk;                                \
+  } while ( 0 )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static void PBUS_Put( const uint8_t * pData, uint32_t u32Length );
+static FGPIO_Type * PBUS_PinOutput( uint8_t u8Pin, uint32_t * pMask );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static uint32_t           PBUS_u32SetMask[256];   /*!< data byte to data pins to set */
+static FGPIO_Type         *PBUS_pData;            /*!< port of D0 ~ D7 */
+static uint32_t           PBUS_u32ClrMask;        /*!< data pins, plus WR# when merged */
+static uint32_t           PBUS_u32Strobe;
+static volatile uint32_t  *PBUS_pStrobeOn;        /*!< PCOR for WR#, PSOR for E */
+static volatile uint32_t  *PBUS_pStrobeOff;
+static uint8_t            PBUS_bMerged;           /*!< WR# on the data port */
+static FGPIO_Type         *PBUS_pDc;
+static uint32_t           PBUS_u32Dc;
+static FGPIO_Type         *PBUS_pCs;
+static uint32_t           PBUS_u32Cs;             /*!< 0 without CS#, the stores do nothing */
+
+static FGPIO_Type         *PBUS_pSer;
+static uint32_t           PBUS_u32Ser;
+static FGPIO_Type         *PBUS_pClk;
+static uint32_t           PBUS_u32Clk;
+static FGPIO_Type         *PBUS_pLatch;
+static uint32_t           PBUS_u32Latch;
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  put bytes on the bus, the D/C# and CS# pins are left as they are.
+*
+* @param[in]    pData       bytes to write.
+* @param[in]    u32Length   number of bytes.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void PBUS_Put( const uint8_t * pData, uint32_t u32Length )
+{
+  FGPIO_Type *pPort = PBUS_pData;
+  uint32_t   u32Clr = PBUS_u32ClrMask;
+  uint32_t   u32Strobe = PBUS_u32Strobe;
+  uint32_t   u32Set;
+
+  if ( PBUS_bMerged )
+  {
+    for ( ; u32Length >= 4; u32Length -= 4 )
+    {
+      PBUS_PUT_MERGED( pData[0] );
+      PBUS_PUT_MERGED( pData[1] );
+      PBUS_PUT_MERGED( pData[2] );
+      PBUS_PUT_MERGED( pData[3] );
+      pData += 4;
+    }
+
+    while ( u32Length-- )
+    {
+      PBUS_PUT_MERGED( *pData++ );
+    }
+  }
+  else
+  {
+    volatile uint32_t *pOn = PBUS_pStrobeOn;
+    volatile uint32_t *pOff = PBUS_pStrobeOff;
+
+    for ( ; u32Length >= 4; u32Length -= 4 )
+    {
+      PBUS_PUT( pData[0] );
+      PBUS_PUT( pData[1] );
+      PBUS_PUT( pData[2] );
+      PBUS_PUT( pData[3] );
+      pData += 4;
+    }
+
+    while ( u32Length-- )
+    {
+      PBUS_PUT( *pData++ );
+    }
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  make a pin an output.
+*
+* @param[in]    u8Pin       GPIO_PinType, GPIOA or GPIOB.
+* @param[out]   pMask       bit mask of the pin in its port.
+*
+* @return FGPIOA or FGPIOB.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static FGPIO_Type * PBUS_PinOutput( uint8_t u8Pin, uint32_t * pMask )
+{
+  ASSERT( u8Pin < GPIO_PTI0 );
+  GPIO_PinInit( ( GPIO_PinType )u8Pin, GPIO_PinOutput );
+  *pMask = GPIO_PIN_MASK( u8Pin );
+  return GPIO_PIN_FGPIO( u8Pin );
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* define PBUS APIs
+*
+*//*! @addtogroup pbus_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  initialize the parallel bus pins and build the data table. The
+*         strobe, RD# and CS# go to their inactive levels, D/C# to data.
+*
+* @param[in]    pConfig     pointer to the bus configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_Init( PBUS_ConfigType * pConfig )
+{
+  uint32_t   u32Mask[8];
+  uint32_t   u32Rd;
+  FGPIO_Type *pStrobe;
+  FGPIO_Type *pRd;
+  uint32_t   i;
+  uint8_t    j;
+  ASSERT( pConfig->u8Mode <= PBUS_MODE_6800 );
+  PBUS_u32ClrMask = 0;
+
+  for ( j = 0; j < 8; j++ )
+  {
+    PBUS_pData = PBUS_PinOutput( pConfig->u8DataPin[j], &u32Mask[j] );
+    ASSERT( PBUS_pData == GPIO_PIN_FGPIO( pConfig->u8DataPin[0] ) );
+    PBUS_u32ClrMask |= u32Mask[j];
+  }
+
+  /* entry 2^j + i is entry i plus pin j, for all i < 2^j */
+  PBUS_u32SetMask[0] = 0;
+
+  for ( j = 0; j < 8; j++ )
+  {
+    for ( i = 0; i < ( 1UL << j ); i++ )
+    {
+      PBUS_u32SetMask[( 1UL << j ) + i] = PBUS_u32SetMask[i] | u32Mask[j];
+    }
+  }
+
+  pStrobe = PBUS_PinOutput( pConfig->u8StrobePin, &PBUS_u32Strobe );
+
+  if ( pConfig->u8Mode == PBUS_MODE_8080 )
+  {
+    pStrobe->PSOR   = PBUS_u32Strobe;
+    PBUS_pStrobeOn  = &pStrobe->PCOR;
+    PBUS_pStrobeOff = &pStrobe->PSOR;
+    PBUS_bMerged    = ( pStrobe == PBUS_pData );
+
+    if ( PBUS_bMerged )
+    {
+      PBUS_u32ClrMask |= PBUS_u32Strobe;
+    }
+  }
+  else
+  {
+    pStrobe->PCOR   = PBUS_u32Strobe;
+    PBUS_pStrobeOn  = &pStrobe->PSOR;
+    PBUS_pStrobeOff = &pStrobe->PCOR;
+    PBUS_bMerged    = FALSE;
+  }
+
+  if ( pConfig->u8RdPin != PBUS_PIN_NONE )
+  {
+    pRd = PBUS_PinOutput( pConfig->u8RdPin, &u32Rd );
+    /* RD# high, R/W low: write */
+    *( ( pConfig->u8Mode == PBUS_MODE_8080 ) ? &pRd->PSOR : &pRd->PCOR ) = u32Rd;
+  }
+
+  PBUS_pDc = PBUS_PinOutput( pConfig->u8DcPin, &PBUS_u32Dc );
+  PBUS_pDc->PSOR = PBUS_u32Dc;
+
+  if ( pConfig->u8CsPin != PBUS_PIN_NONE )
+  {
+    PBUS_pCs = PBUS_PinOutput( pConfig->u8CsPin, &PBUS_u32Cs );
+    PBUS_pCs->PSOR = PBUS_u32Cs;
+  }
+  else
+  {
+    PBUS_pCs   = FGPIOA;
+    PBUS_u32Cs = 0;
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  drive CS# low.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_Select( void )
+{
+  PBUS_pCs->PCOR = PBUS_u32Cs;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  drive CS# high.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_Deselect( void )
+{
+  PBUS_pCs->PSOR = PBUS_u32Cs;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  write one command byte with D/C# low.
+*
+* @param[in]    u8Command   command byte.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_WriteCommand( uint8_t u8Command )
+{
+  PBUS_pDc->PCOR = PBUS_u32Dc;
+  PBUS_Put( &u8Command, 1 );
+  PBUS_pDc->PSOR = PBUS_u32Dc;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  write data bytes with D/C# high.
+*
+* @param[in]    pData       bytes to write.
+* @param[in]    u32Length   number of bytes.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_WriteData( const uint8_t * pData, uint32_t u32Length )
+{
+  PBUS_Put( pData, u32Length );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  write a 16-bit value, high byte first, a number of times, such as
+*         an RGB565 color after PBUS_DCS_RAMWR.
+*
+* @param[in]    u16Value    value to repeat.
+* @param[in]    u32Count    number of values.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_WriteRepeat( uint16_t u16Value, uint32_t u32Count )
+{
+  FGPIO_Type *pPort = PBUS_pData;
+  uint32_t   u32Strobe = PBUS_u32Strobe;
+  uint32_t   u32Toggle;
+  uint32_t   u32Length;
+  uint8_t    u8High = ( uint8_t )( u16Value >> 8 );
+
+  if ( u32Count == 0 )
+  {
+    return;
+  }
+
+  PBUS_Put( &u8High, 1 );
+  /* the data pins now alternate between the two bytes */
+  u32Toggle = PBUS_u32SetMask[u8High] ^ PBUS_u32SetMask[u16Value & 0xFF];
+  u32Length = ( u32Count << 1 ) - 1;
+
+  if ( PBUS_bMerged )
+  {
+    u32Toggle |= u32Strobe;
+
+    for ( ; u32Length >= 8; u32Length -= 8 )
+    {
+      PBUS_FLIP_MERGED();
+      PBUS_FLIP_MERGED();
+      PBUS_FLIP_MERGED();
+      PBUS_FLIP_MERGED();
+      PBUS_FLIP_MERGED();
+      PBUS_FLIP_MERGED();
+      PBUS_FLIP_MERGED();
+      PBUS_FLIP_MERGED();
+    }
+
+    while ( u32Length-- )
+    {
+      PBUS_FLIP_MERGED();
+    }
+  }
+  else
+  {
+    volatile uint32_t *pOn = PBUS_pStrobeOn;
+    volatile uint32_t *pOff = PBUS_pStrobeOff;
+
+    for ( ; u32Length >= 8; u32Length -= 8 )
+    {
+      PBUS_FLIP();
+      PBUS_FLIP();
+      PBUS_FLIP();
+      PBUS_FLIP();
+      PBUS_FLIP();
+      PBUS_FLIP();
+      PBUS_FLIP();
+      PBUS_FLIP();
+    }
+
+    while ( u32Length-- )
+    {
+      PBUS_FLIP();
+    }
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  fill a rectangle of a MIPI DCS display controller (ILI9341,
+*         ST7789 ...) in RGB565, CS# is driven around the transfer.
+*
+* @param[in]    u16X        first column.
+* @param[in]    u16Y        first row.
+* @param[in]    u16Width    width in pixels, not 0.
+* @param[in]    u16Height   height in pixels, not 0.
+* @param[in]    u16Color    RGB565 color.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_FillRect( uint16_t u16X, uint16_t u16Y, uint16_t u16Width, uint16_t u16Height, uint16_t u16Color )
+{
+  uint8_t  u8Window[4];
+  uint16_t u16End;
+  ASSERT( ( u16Width != 0 ) && ( u16Height != 0 ) );
+  PBUS_Select();
+  u16End = u16X + u16Width - 1;
+  u8Window[0] = ( uint8_t )( u16X >> 8 );
+  u8Window[1] = ( uint8_t )u16X;
+  u8Window[2] = ( uint8_t )( u16End >> 8 );
+  u8Window[3] = ( uint8_t )u16End;
+  PBUS_WriteCommand( PBUS_DCS_CASET );
+  PBUS_Put( u8Window, 4 );
+  u16End = u16Y + u16Height - 1;
+  u8Window[0] = ( uint8_t )( u16Y >> 8 );
+  u8Window[1] = ( uint8_t )u16Y;
+  u8Window[2] = ( uint8_t )( u16End >> 8 );
+  u8Window[3] = ( uint8_t )u16End;
+  PBUS_WriteCommand( PBUS_DCS_PASET );
+  PBUS_Put( u8Window, 4 );
+  PBUS_WriteCommand( PBUS_DCS_RAMWR );
+  PBUS_WriteRepeat( u16Color, ( uint32_t )u16Width * u16Height );
+  PBUS_Deselect();
+}
+
+/*****************************************************************************//*!
+*
+* @brief  measure the bus throughput with the SysTick counting core clocks,
+*         interrupts are masked while it runs. The bytes go out as data with
+*         CS# high, no device should be selected without CS#.
+*
+* @param[in]    bRepeat     TRUE: PBUS_WriteRepeat, FALSE: PBUS_WriteData.
+* @param[in]    u32Length   bytes to send, even, at most 0x100000.
+*
+* @return kilobytes (1000 bytes) per second, MB/s = result / 1000,
+*         0 while the application runs the SysTick.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t PBUS_MeasureThroughput( uint8_t bRepeat, uint32_t u32Length )
+{
+  uint8_t  u8Pattern[64];
+  uint32_t u32Cycles;
+  uint32_t u32Left;
+  uint32_t i;
+  __istate_t interrupt_state;
+  ASSERT( ( u32Length != 0 ) && ( u32Length <= 0x100000 ) );
+
+  if ( SysTick->CTRL & SysTick_CTRL_ENABLE_Msk )
+  {
+    return 0;
+  }
+
+  /* all data pins change on every byte */
+  for ( i = 0; i < sizeof( u8Pattern ); i++ )
+  {
+    u8Pattern[i] = ( i & 1 ) ? 0xAA : 0x55;
+  }
+
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL  = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+  if ( bRepeat )
+  {
+    PBUS_WriteRepeat( 0x55AA, u32Length >> 1 );
+  }
+  else
+  {
+    for ( u32Left = u32Length; u32Left > sizeof( u8Pattern ); u32Left -= sizeof( u8Pattern ) )
+    {
+      PBUS_Put( u8Pattern, sizeof( u8Pattern ) );
+    }
+
+    PBUS_Put( u8Pattern, u32Left );
+  }
+
+  u32Cycles     = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+  SysTick->CTRL = 0;
+  __set_interrupt_state( interrupt_state );
+  return ( uint32_t )( ( uint64_t )u32Length * ( SystemClockGet( CLOCK_CORE ) / 1000 ) / u32Cycles );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  initialize a 74HC595 chain, all pins low.
+*
+* @param[in]    pConfig     pointer to the chain configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_ShiftInit( PBUS_ShiftConfigType * pConfig )
+{
+  PBUS_pSer   = PBUS_PinOutput( pConfig->u8SerPin, &PBUS_u32Ser );
+  PBUS_pClk   = PBUS_PinOutput( pConfig->u8ClkPin, &PBUS_u32Clk );
+  PBUS_pLatch = PBUS_PinOutput( pConfig->u8LatchPin, &PBUS_u32Latch );
+  PBUS_pSer->PCOR   = PBUS_u32Ser;
+  PBUS_pClk->PCOR   = PBUS_u32Clk;
+  PBUS_pLatch->PCOR = PBUS_u32Latch;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  shift bytes into the chain MSB first and latch them to the
+*         outputs, pData[0] ends in the register farthest from SER.
+*
+* @param[in]    pData       bytes to shift.
+* @param[in]    u32Length   number of bytes, the chain length.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PBUS_ShiftOut( const uint8_t * pData, uint32_t u32Length )
+{
+  FGPIO_Type        *pClk = PBUS_pClk;
+  uint32_t          u32Clk = PBUS_u32Clk;
+  uint32_t          u32Ser = PBUS_u32Ser;
+  volatile uint32_t *pSerSet = &PBUS_pSer->PSOR;
+  volatile uint32_t *pSerClr = &PBUS_pSer->PCOR;
+  uint8_t           u8Byte;
+
+  while ( u32Length-- )
+  {
+    u8Byte = *pData++;
+    PBUS_SHIFT_BIT( 0x80 );
+    PBUS_SHIFT_BIT( 0x40 );
+    PBUS_SHIFT_BIT( 0x20 );
+    PBUS_SHIFT_BIT( 0x10 );
+    PBUS_SHIFT_BIT( 0x08 );
+    PBUS_SHIFT_BIT( 0x04 );
+    PBUS_SHIFT_BIT( 0x02 );
+    PBUS_SHIFT_BIT( 0x01 );
+  }
+
+  pClk->PCOR = u32Clk;
+  PBUS_pLatch->PSOR = PBUS_u32Latch;
+  PBUS_STRETCH();
+  PBUS_pLatch->PCOR = PBUS_u32Latch;
+}
+/*! @} End of pbus_api_list                                                   */
@@ -0,0 +1,102 @@
+/******************************************************************************
+* @brief header file for bit-banged parallel bus engine (PBUS).
+*
+*******************************************************************************
+*
+* provide APIs for 8080 and 6800 style 8-bit parallel buses and 74HC595
+* shift register chains driven from the single cycle FGPIO ports
+******************************************************************************/
+#ifndef __NV32_PBUS_H__
+#define __NV32_PBUS_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_gpio.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define PBUS_MODE_8080          0           /*!< WR# strobe, data latched on the rising edge */
+#define PBUS_MODE_6800          1           /*!< E strobe, data latched on the falling edge */
+
+#define PBUS_PIN_NONE           0xFF        /*!< control pin not connected */
+
+/* MIPI DCS commands used by PBUS_FillRect */
+#define PBUS_DCS_CASET          0x2A        /*!< column address set */
+#define PBUS_DCS_PASET          0x2B        /*!< page (row) address set */
+#define PBUS_DCS_RAMWR          0x2C        /*!< memory write */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* PBUS configure struct.
+*
+*//*! @addtogroup pbus_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief parallel bus configure struct.
+*
+* D0 ~ D7 may be any pins in any order, but all on GPIOA (PTA0 ~ PTD7) or
+* all on GPIOB (PTE0 ~ PTH7). An 8080 WR# on that same port is cleared in
+* the same store as the data, saving one store per byte.
+*/
+typedef struct
+{
+  uint8_t       u8Mode;                 /*!< PBUS_MODE_8080 or PBUS_MODE_6800 */
+  uint8_t       u8DataPin[8];           /*!< GPIO_PinType of D0 ~ D7 */
+  uint8_t       u8StrobePin;            /*!< WR# (8080) or E (6800) */
+  uint8_t       u8RdPin;                /*!< RD# (8080) or R/W (6800), held for write, or PBUS_PIN_NONE */
+  uint8_t       u8DcPin;                /*!< D/C# or RS, low for commands */
+  uint8_t       u8CsPin;                /*!< CS#, or PBUS_PIN_NONE */
+} PBUS_ConfigType, *PBUS_ConfigPtr;
+
+/*!
+* @brief shift register chain configure struct, 74HC595 or compatible.
+*/
+typedef struct
+{
+  uint8_t       u8SerPin;               /*!< SER, serial data */
+  uint8_t       u8ClkPin;               /*!< SHCP, shift clock, rising edge */
+  uint8_t       u8LatchPin;             /*!< STCP, storage clock, rising edge */
+} PBUS_ShiftConfigType, *PBUS_ShiftConfigPtr;
+/*! @} End of pbus_configstruct                                               */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void PBUS_Init( PBUS_ConfigType * pConfig );
+void PBUS_Select( void );
+void PBUS_Deselect( void );
+void PBUS_WriteCommand( uint8_t u8Command );
+void PBUS_WriteData( const uint8_t * pData, uint32_t u32Length );
+void PBUS_WriteRepeat( uint16_t u16Value, uint32_t u32Count );
+void PBUS_FillRect( uint16_t u16X, uint16_t u16Y, uint16_t u16Width, uint16_t u16Height, uint16_t u16Color );
+uint32_t PBUS_MeasureThroughput( uint8_t bRepeat, uint32_t u32Length );
+void PBUS_ShiftInit( PBUS_ShiftConfigType * pConfig );
+void PBUS_ShiftOut( const uint8_t * pData, uint32_t u32Length );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_PBUS_H__ */
@@ -4,6 +4,8 @@
 ******************************************************************************/
 #include "NV32_config.h"
 #include "NV32_pit.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
 
 /******************************************************************************
 * Global variables
@@ -24,17 +26,52 @@
 /******************************************************************************
 * Local variables
 ******************************************************************************/
+#if !defined( PIT_CH0_STATIC_CALLBACK ) || !defined( PIT_CH1_STATIC_CALLBACK )
 /*!
  * @brief global variable to store PIT callbacks.
  *
  */
 PIT_CallbackType PIT_Callback[2] = {( PIT_CallbackType )NULL}; /*!< PIT initial callback */
+#endif
+#ifdef PIT_CH0_STATIC_CALLBACK
+void PIT_CH0_STATIC_CALLBACK( void );
+#else
+void PIT_Ch0Isr( void );
+#endif
+#ifdef PIT_CH1_STATIC_CALLBACK
+void PIT_CH1_STATIC_CALLBACK( void );
+#else
+void PIT_Ch1Isr( void );
+#endif
 
 /******************************************************************************
 * Local functions
 ******************************************************************************/
-void PIT_Ch0Isr( void );
-void PIT_Ch1Isr( void );
+
+/*****************************************************************************//*!
+*
+* @brief pit channel isr body, shared by the static and the dynamic handler.
+*
+* @param[in] u8Channel    channel number.
+* @param[in] pfnCallback  callback, a constant in the static handler.
+*
+* @return none
+*
+* @ Pass/ Fail criteria: none
+*****************************************************************************/
+__STATIC_INLINE void PIT_ChannelIsr( uint8_t u8Channel, PIT_CallbackType pfnCallback )
+{
+  ISRSTAT_ENTER( ISRSTAT_PIT_CH0 + u8Channel );
+  ISRSTAT_LATENCY( ISRSTAT_PIT_CH0 + u8Channel, ( PIT->CHANNEL[u8Channel].LDVAL - PIT->CHANNEL[u8Channel].CVAL ) );
+  PIT_ChannelClrFlags( u8Channel );
+
+  if ( pfnCallback )
+  {
+    pfnCallback();
+  }
+
+  ISRSTAT_EXIT( ISRSTAT_PIT_CH0 + u8Channel );
+}
 
 
 /******************************************************************************
@@ -136,7 +173,30 @@ void PIT_SetLoadVal( uint8_t u8Channel, uint32_t u32loadvalue )
 *****************************************************************************/
 void PIT_SetCallback( uint8_t u8Channel_No, PIT_CallbackType pfnCallback )
 {
-  PIT_Callback[u8Channel_No] = pfnCallback;
+  if ( u8Channel_No == 0 )
+  {
+#ifdef PIT_CH0_STATIC_CALLBACK
+    /* bound at link time, PIT_CH0_IRQHandler calls PIT_CH0_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == PIT_CH0_STATIC_CALLBACK ) );
+#else
+    PIT_Callback[0] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( PIT_CH0_IRQn, PIT_Ch0Isr );
+#endif
+#endif
+  }
+  else
+  {
+#ifdef PIT_CH1_STATIC_CALLBACK
+    /* bound at link time, PIT_CH1_IRQHandler calls PIT_CH1_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == PIT_CH1_STATIC_CALLBACK ) );
+#else
+    PIT_Callback[1] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( PIT_CH1_IRQn, PIT_Ch1Isr );
+#endif
+#endif
+  }
 }
 
 
@@ -181,15 +241,17 @@ void PIT_DeInit( void )
 *
 * @ Pass/ Fail criteria: none
 *****************************************************************************/
+#ifdef PIT_CH0_STATIC_CALLBACK
+void PIT_CH0_IRQHandler( void )
+{
+  PIT_ChannelIsr( 0, PIT_CH0_STATIC_CALLBACK );
+}
+#else
 void PIT_Ch0Isr( void )
 {
-  PIT_ChannelClrFlags( 0 );
-
-  if ( PIT_Callback[0] )
-  {
-    PIT_Callback[0]();
-  }
+  PIT_ChannelIsr( 0, PIT_Callback[0] );
 }
+#endif
 
 /*****************************************************************************//*!
 *
@@ -201,14 +263,16 @@ void PIT_Ch0Isr( void )
 *
 * @ Pass/ Fail criteria: none
 *****************************************************************************/
+#ifdef PIT_CH1_STATIC_CALLBACK
+void PIT_CH1_IRQHandler( void )
+{
+  PIT_ChannelIsr( 1, PIT_CH1_STATIC_CALLBACK );
+}
+#else
 void PIT_Ch1Isr( void )
 {
-  PIT_ChannelClrFlags( 1 );
-
-  if ( PIT_Callback[1] )
-  {
-    PIT_Callback[1]();
-  }
+  PIT_ChannelIsr( 1, PIT_Callback[1] );
 }
+#endif
 
 
@@ -0,0 +1,367 @@
+/******************************************************************************
+* @brief providing APIs for power-fail handler (PWRFAIL).
+*
+*******************************************************************************
+*
+* The PMC raises the low voltage warning (LVW) above the low voltage detect
+* (LVD), which resets. LVD_LVW_IRQHandler uses the hold-up time in between:
+* it calls the application to drive its outputs to safe levels, gates off
+* the peripheral clocks to cut the current, and commits PWRFAIL_STATE_WORDS
+* words of application state to flash. It then waits for the LVD reset, or
+* resets by software when the supply comes back, it never returns.
+*
+* The record goes to an already erased slot of the sector at
+* PWRFAIL_FLASH_ADDRESS, two words per program command and without any
+* erase. Its header is programmed first and its complement last, a record
+* cut short by the reset is skipped. PWRFAIL_Init restores the last record
+* and erases the sector, rewriting that record, when no slot is left, so no
+* erase is ever needed on the warning.
+*
+* EFM_LaunchCMD masks the interrupts while a command runs, so a warning
+* raised during one is taken only when it has finished, a sector erase
+* being the longest, and the rest of a write of several commands, as
+* Flash_Program or FLLTRIM_Store, is abandoned. The hold-up time must cover
+* that command, the save and the outputs, the core clocks measured from the
+* handler entry for the last two are kept over
+* the reset for PWRFAIL_Init to hand out, behind the bootloader in
+* NOINIT_region of the NV32F100_Slot*.icf files. PWRFAIL_Simulate runs the
+* handler without a power fail, to check it on the bench.
+*
+* The module, with its LVD_LVW_IRQHandler, is compiled only when
+* PWRFAIL_ENABLED is set in NV32_config.h.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_pwrfail.h"
+#include "NV32_flash.h"
+#include "NV32_sim.h"
+
+#if ( PWRFAIL_ENABLED > 0 )
+
+#if ( PWRFAIL_STATE_WORDS < 2 ) || ( PWRFAIL_STATE_WORDS & 1 )
+#error "PWRFAIL_STATE_WORDS must be even, a slot is programmed two words at a time"
+#endif
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define PWRFAIL_MAGIC           0x50574641  /*!< "PWFA" */
+#define PWRFAIL_HEADER          ( ( uint32_t )0x50460000 | PWRFAIL_STATE_WORDS )
+#define PWRFAIL_ERASED          0xFFFFFFFF
+#define PWRFAIL_SLOT_WORDS      ( PWRFAIL_STATE_WORDS + 2 )
+#define PWRFAIL_SLOTS           ( FLASH_SECTOR_SIZE / 4 / PWRFAIL_SLOT_WORDS )
+#define PWRFAIL_RECOVER_MS      10          /*!< warning gone this long: the supply is back */
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static __no_init PWRFAIL_StatsType PWRFAIL_sStats;
+
+static uint32_t             *PWRFAIL_pu32State;
+static PWRFAIL_CallbackType PWRFAIL_pfnSafeState;
+static uint32_t             PWRFAIL_u32Slot;        /*!< next erased slot */
+static uint32_t             PWRFAIL_u32Last;        /*!< SysTick value at the last poll */
+static uint32_t             PWRFAIL_u32Clocks;      /*!< core clocks since the warning */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  core clocks since the warning, polled at least once per SysTick
+*         period.
+*
+* @param  none.
+*
+* @return core clocks.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t PWRFAIL_Clocks( void )
+{
+  uint32_t u32Now = SysTick->VAL;
+
+  /* the SysTick counts down over its full 24 bits */
+  PWRFAIL_u32Clocks += ( PWRFAIL_u32Last - u32Now ) & SysTick_LOAD_RELOAD_Msk;
+  PWRFAIL_u32Last    = u32Now;
+
+  return PWRFAIL_u32Clocks;
+}
+
+#if ( PWRFAIL_FLASH_ADDRESS != 0 )
+/*****************************************************************************//*!
+*
+* @brief  program the state to an erased slot, header first, complement of
+*         the header last.
+*
+* @param[in]    u32Slot     0 ~ PWRFAIL_SLOTS - 1.
+* @param[in]    pu32State   PWRFAIL_STATE_WORDS words.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void PWRFAIL_Program( uint32_t u32Slot, const uint32_t * pu32State )
+{
+  uint32_t u32Address = PWRFAIL_FLASH_ADDRESS + u32Slot * PWRFAIL_SLOT_WORDS * 4;
+  uint8_t  i;
+
+  Flash_Program2LongWords( u32Address, PWRFAIL_HEADER, pu32State[0] );
+
+  for ( i = 1; i < PWRFAIL_STATE_WORDS - 1; i += 2 )
+  {
+    u32Address += 8;
+    Flash_Program2LongWords( u32Address, pu32State[i], pu32State[i + 1] );
+  }
+
+  Flash_Program2LongWords( u32Address + 8, pu32State[PWRFAIL_STATE_WORDS - 1], ~PWRFAIL_HEADER );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  find the last complete record and the next erased slot, and make
+*         room when the sector is full.
+*
+* @param[out]   pu32State   PWRFAIL_STATE_WORDS words, the last record.
+*
+* @return TRUE when a record was found.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t PWRFAIL_Restore( uint32_t * pu32State )
+{
+  const uint32_t *pu32Slot;
+  const uint32_t *pu32Last = NULL;
+  uint32_t       i;
+
+  PWRFAIL_u32Slot = 0;
+
+  for ( i = 0; i < PWRFAIL_SLOTS; i++ )
+  {
+    pu32Slot = ( const uint32_t * )PWRFAIL_FLASH_ADDRESS + i * PWRFAIL_SLOT_WORDS;
+
+    if ( pu32Slot[0] != PWRFAIL_ERASED )
+    {
+      PWRFAIL_u32Slot = i + 1;
+    }
+
+    if ( ( pu32Slot[0] == PWRFAIL_HEADER ) && ( pu32Slot[PWRFAIL_SLOT_WORDS - 1] == ~PWRFAIL_HEADER ) )
+    {
+      pu32Last = pu32Slot;
+    }
+  }
+
+  if ( pu32Last != NULL )
+  {
+    for ( i = 0; i < PWRFAIL_STATE_WORDS; i++ )
+    {
+      pu32State[i] = pu32Last[i + 1];
+    }
+  }
+
+  if ( PWRFAIL_u32Slot == PWRFAIL_SLOTS )
+  {
+    Flash_EraseSector( PWRFAIL_FLASH_ADDRESS );
+    PWRFAIL_u32Slot = 0;
+
+    if ( pu32Last != NULL )
+    {
+      PWRFAIL_Program( PWRFAIL_u32Slot++, pu32State );
+    }
+  }
+
+  return ( pu32Last != NULL );
+}
+#endif
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  low voltage warning, save the state and wait for the reset, does
+*         not return.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void LVD_LVW_IRQHandler( void )
+{
+  uint32_t u32Good;
+  uint32_t u32Now;
+
+  __disable_interrupt();
+
+  /* the SysTick is not given back */
+  SysTick->CTRL     = 0;
+  SysTick->LOAD     = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL      = 0;
+  SysTick->CTRL     = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+  PWRFAIL_u32Last   = SysTick->VAL;
+  PWRFAIL_u32Clocks = 0;
+
+  PWRFAIL_sStats.u32Magic       = PWRFAIL_MAGIC;
+  PWRFAIL_sStats.u32SaveClocks  = 0;
+  PWRFAIL_sStats.u32SpareClocks = 0;
+  PWRFAIL_sStats.bRecovered     = FALSE;
+  PWRFAIL_sStats.bSaved         = FALSE;
+
+  if ( PWRFAIL_pfnSafeState != NULL )
+  {
+    PWRFAIL_pfnSafeState();
+  }
+
+  /* outputs keep their levels, the peripherals stop drawing current */
+  SIM->SCGC = SIM_SCGC_FLASH_MASK | SIM_SCGC_SWD_MASK;
+
+#if ( PWRFAIL_FLASH_ADDRESS != 0 )
+  /* EFM_LaunchCMD returns with its command done, the EFM is ready here */
+  if ( PWRFAIL_u32Slot < PWRFAIL_SLOTS )
+  {
+    PWRFAIL_Program( PWRFAIL_u32Slot++, PWRFAIL_pu32State );
+    PWRFAIL_sStats.bSaved = TRUE;
+  }
+#endif
+
+  PWRFAIL_sStats.u32SaveClocks = PWRFAIL_Clocks();
+  u32Good = PWRFAIL_sStats.u32SaveClocks;
+
+  /* the flag sets again at once while the supply stays below the warning */
+  while ( 1 )
+  {
+    PMC_ClrLVWFlag( PMC );
+    u32Now = PWRFAIL_Clocks();
+    PWRFAIL_sStats.u32SpareClocks = u32Now - PWRFAIL_sStats.u32SaveClocks;
+
+    if ( PMC_GetLVWFlag( PMC ) )
+    {
+      u32Good = u32Now;
+    }
+    else if ( u32Now - u32Good > SystemCoreClock / 1000 * PWRFAIL_RECOVER_MS )
+    {
+      PWRFAIL_sStats.bRecovered = TRUE;
+      NVIC_SystemReset();
+    }
+  }
+}
+
+/******************************************************************************
+* PWRFAIL api lists
+*
+*//*! @addtogroup pwrfail_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  restore the state saved at the last power fail and arm the warning.
+*         Waits while the supply is below the warning, so a slow ramp at
+*         power on does not save and reset over and over.
+*
+* @param[in]    pConfig     trip points, state and safe state callback.
+* @param[out]   pLast       timing of the last power fail, u32Magic is 0
+*                           when there was none since power on. May be NULL.
+*
+* @return TRUE when the state was restored to pConfig->pu32State.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t PWRFAIL_Init( PWRFAIL_ConfigType * pConfig, PWRFAIL_StatsType * pLast )
+{
+  PMC_ConfigType sPmc = {
+    0 };
+  uint8_t        bRestored = FALSE;
+
+  ASSERT( pConfig->u8LvwTrip <= PmcLVWTrip_High );
+  ASSERT( pConfig->u8LvdTrip <= PmcLVDTrip_High );
+  ASSERT( pConfig->pu32State != NULL );
+
+  NVIC_DisableIRQ( LVD_LVW_IRQn );
+
+  if ( SIM_GetStatus( SIM_SRSID_POR_MASK ) )
+  {
+    PWRFAIL_sStats.u32Magic = 0;
+  }
+
+  if ( pLast != NULL )
+  {
+    *pLast = PWRFAIL_sStats;
+
+    if ( pLast->u32Magic != PWRFAIL_MAGIC )
+    {
+      pLast->u32Magic = 0;
+    }
+  }
+
+  PWRFAIL_sStats.u32Magic = 0;
+  PWRFAIL_pu32State       = pConfig->pu32State;
+  PWRFAIL_pfnSafeState    = pConfig->pfnSafeState;
+
+#if ( PWRFAIL_FLASH_ADDRESS != 0 )
+  bRestored = PWRFAIL_Restore( pConfig->pu32State );
+#endif
+
+  /* LVD enable, reset and stop enable are write once after reset */
+  sPmc.sCtrlstatus.bits.bLvdEn          = 1;
+  sPmc.sCtrlstatus.bits.bLvdRstEn       = 1;
+  sPmc.sCtrlstatus.bits.bLvdStopEn      = ( PMC->SPMSC1 & PMC_SPMSC1_LVDSE_MASK ) ? 1 : 0;
+  sPmc.sCtrlstatus.bits.bLvwAck         = 1;
+  sPmc.sDetectVoltSelect.bits.bLVWV     = pConfig->u8LvwTrip;
+  sPmc.sDetectVoltSelect.bits.bLVDV     = pConfig->u8LvdTrip;
+  PMC_Init( PMC, &sPmc );
+
+  do
+  {
+    PMC_ClrLVWFlag( PMC );
+  }
+  while ( PMC_GetLVWFlag( PMC ) );
+
+  PMC_EnableLVWInterrupt( PMC );
+  NVIC_ClearPendingIRQ( LVD_LVW_IRQn );
+  NVIC_SetPriority( LVD_LVW_IRQn, 0 );
+  NVIC_EnableIRQ( LVD_LVW_IRQn );
+
+  return bRestored;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  run the power-fail handler as if the warning came: the state is
+*         saved and the MCU resets PWRFAIL_RECOVER_MS later as on a supply
+*         coming back.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void PWRFAIL_Simulate( void )
+{
+  NVIC_SetPendingIRQ( LVD_LVW_IRQn );
+}
+/*! @} End of pwrfail_api_list                                                */
+
+#endif /* PWRFAIL_ENABLED */
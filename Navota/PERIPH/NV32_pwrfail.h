@@ -0,0 +1,83 @@
+/******************************************************************************
+* @brief header file for power-fail handler (PWRFAIL).
+*
+*******************************************************************************
+*
+* provide APIs for saving a small application state to flash on the low
+* voltage warning, putting the outputs in safe states before the low voltage
+* detect resets, and restoring the state at the next boot
+******************************************************************************/
+#ifndef __NV32_PWRFAIL_H__
+#define __NV32_PWRFAIL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_pmc.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+typedef void ( *PWRFAIL_CallbackType )( void );  /*!< safe state callback type */
+
+/******************************************************************************
+* PWRFAIL configure struct.
+*
+*//*! @addtogroup pwrfail_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief trip points and what is done on the warning.
+*/
+typedef struct
+{
+  uint8_t               u8LvwTrip;      /*!< PmcLVWTrip_Low ~ PmcLVWTrip_High */
+  uint8_t               u8LvdTrip;      /*!< PmcLVDTrip_Low or PmcLVDTrip_High, below the warning */
+  uint32_t              *pu32State;     /*!< PWRFAIL_STATE_WORDS words, saved on the warning */
+  PWRFAIL_CallbackType  pfnSafeState;   /*!< drives the outputs to safe levels, short, may be NULL */
+} PWRFAIL_ConfigType, *PWRFAIL_ConfigPtr;
+
+/*!
+* @brief timing of the last power fail, in RAM kept over the LVD reset.
+*/
+typedef struct
+{
+  uint32_t      u32Magic;           /*!< valid when PWRFAIL_MAGIC */
+  uint32_t      u32SaveClocks;      /*!< core clocks from the warning to the record committed */
+  uint32_t      u32SpareClocks;     /*!< core clocks after that until the reset */
+  uint8_t       bRecovered;         /*!< the supply came back, reset by software */
+  uint8_t       bSaved;             /*!< the record was committed */
+} PWRFAIL_StatsType, *PWRFAIL_StatsPtr;
+/*! @} End of pwrfail_configstruct                                            */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+uint8_t PWRFAIL_Init( PWRFAIL_ConfigType * pConfig, PWRFAIL_StatsType * pLast );
+void PWRFAIL_Simulate( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_PWRFAIL_H__ */
@@ -0,0 +1,441 @@
+/******************************************************************************
+* @brief providing APIs for quadrature encoder decoder (QENC) on ETM2.
+*
+*******************************************************************************
+*
+* Each encoder signal uses one ETM2 channel pair in continuous dual edge
+* capture: channel n latches the rising edge, channel n+1 the falling edge.
+* The capture channel tells the new signal level, so no pin is read in the
+* interrupt, and the capture values order edges that arrive within one
+* interrupt latency. Every edge steps a 16-entry state table indexed by the
+* old and new AB state; an edge that does not change the state means an edge
+* was missed and is counted as an error.
+*
+* Velocity is the mean of the last (up to) four same-direction edge
+* intervals, bounded by the time since the last edge so it decays to zero
+* when the shaft stops.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_qenc.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define QENC_STATE_A            0x02    /*!< AB state bit of signal A */
+#define QENC_STATE_B            0x01    /*!< AB state bit of signal B */
+
+#define QENC_STAMP_NO           8       /*!< edge timestamp history, power of 2 */
+#define QENC_VELOCITY_EDGES     5       /*!< edges used for velocity, 4 intervals */
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+typedef struct
+{
+  uint16_t  u16Age;                     /*!< counter ticks since the edge */
+  uint8_t   u8Bit;                      /*!< QENC_STATE_A or QENC_STATE_B */
+  uint8_t   u8Level;                    /*!< signal level after the edge */
+} QENC_EdgeType;
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static uint32_t QENC_Now( void );
+static void QENC_Isr( void );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+
+/*!
+ * @brief count per transition, indexed by ( old AB state << 2 ) | new AB state.
+ *
+ * A leading B (00 -> 10 -> 11 -> 01 -> 00) counts up. No change and double
+ * changes are 0.
+ */
+static const int8_t QENC_StateTable[16] =
+{
+  /* new:  00  01  10  11        old */
+           0, -1, +1,  0,     /* 00 */
+          +1,  0,  0, -1,     /* 01 */
+          -1,  0,  0, +1,     /* 10 */
+           0, +1, -1,  0,     /* 11 */
+};
+
+static uint8_t            QENC_u8ChannelA;
+static uint8_t            QENC_u8ChannelB;
+static uint8_t            QENC_u8State;
+static uint8_t            QENC_u8Known;         /*!< state bits seen at least once */
+static int8_t             QENC_i8Sign;          /*!< +1, or -1 for bReverse */
+static uint8_t            QENC_bIndexReset;
+static uint32_t           QENC_u32ClockHz;
+static uint32_t           QENC_u32TimeoutTicks;
+static volatile uint16_t  QENC_u16OverflowHigh;
+static volatile int32_t   QENC_i32Position;
+static int32_t            QENC_i32IndexPosition;
+static uint32_t           QENC_u32IndexCount;
+static uint32_t           QENC_u32ErrorCount;
+static int8_t             QENC_i8Dir;
+static uint8_t            QENC_u8Run;           /*!< consecutive edges in QENC_i8Dir */
+static uint8_t            QENC_u8StampIndex;
+static uint32_t           QENC_u32Stamp[QENC_STAMP_NO];
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  read the 32-bit extended ETM2 counter.
+*
+* @param  none.
+*
+* @return current timestamp in timer ticks.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t QENC_Now( void )
+{
+  uint16_t u16High;
+  uint16_t u16Count;
+  uint8_t  u8Overflow;
+
+  do
+  {
+    u16High    = QENC_u16OverflowHigh;
+    u16Count   = ETM2->CNT;
+    u8Overflow = ETM_GetOverFlowFlag( ETM2 );
+  }
+  while ( u16High != QENC_u16OverflowHigh );
+
+  if ( u8Overflow && ( u16Count < 0x8000 ) )
+  {
+    u16High++;
+  }
+
+  return ( ( uint32_t )u16High << 16 ) | u16Count;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  ETM2 capture and overflow service.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void QENC_Isr( void )
+{
+  QENC_EdgeType sEdge[4];
+  QENC_EdgeType sTemp;
+  const uint8_t u8Channel[4] = { QENC_u8ChannelA, QENC_u8ChannelA + 1, QENC_u8ChannelB, QENC_u8ChannelB + 1 };
+  uint8_t  u8Count = 0;
+  uint8_t  i, j;
+  uint8_t  u8NewState;
+  int8_t   i8Delta;
+  uint16_t u16Capture[4];
+  uint32_t u32Now;
+
+  for ( i = 0; i < 4; i++ )
+  {
+    if ( ETM_GetChannelFlag( ETM2, u8Channel[i] ) )
+    {
+      u16Capture[u8Count]     = ETM2->CONTROLS[u8Channel[i]].CnV;
+      ETM_ClrChannelFlag( ETM2, u8Channel[i] );
+      sEdge[u8Count].u8Bit   = ( i < 2 ) ? QENC_STATE_A : QENC_STATE_B;
+      sEdge[u8Count].u8Level = !( i & 1 );
+      u8Count++;
+    }
+  }
+
+  u32Now = QENC_Now();
+
+  /* oldest edge first */
+  for ( i = 0; i < u8Count; i++ )
+  {
+    sEdge[i].u16Age = ( uint16_t )u32Now - u16Capture[i];
+
+    for ( j = i; ( j > 0 ) && ( sEdge[j].u16Age > sEdge[j - 1].u16Age ); j-- )
+    {
+      sTemp        = sEdge[j];
+      sEdge[j]     = sEdge[j - 1];
+      sEdge[j - 1] = sTemp;
+    }
+  }
+
+  for ( i = 0; i < u8Count; i++ )
+  {
+    u8NewState = sEdge[i].u8Level ? ( QENC_u8State | sEdge[i].u8Bit ) : ( QENC_u8State & ~sEdge[i].u8Bit );
+
+    if ( QENC_u8Known != ( QENC_STATE_A | QENC_STATE_B ) )
+    {
+      /* levels are learnt from the first edge of each signal */
+      QENC_u8Known |= sEdge[i].u8Bit;
+      QENC_u8State  = u8NewState;
+      continue;
+    }
+
+    i8Delta = QENC_StateTable[( QENC_u8State << 2 ) | u8NewState];
+    QENC_u8State = u8NewState;
+
+    if ( 0 == i8Delta )
+    {
+      QENC_u32ErrorCount++;
+      QENC_u8Run = 0;
+      continue;
+    }
+
+    i8Delta *= QENC_i8Sign;
+    QENC_i32Position += i8Delta;
+
+    if ( ( i8Delta == QENC_i8Dir ) && ( QENC_u8Run < QENC_VELOCITY_EDGES ) )
+    {
+      QENC_u8Run++;
+    }
+    else if ( i8Delta != QENC_i8Dir )
+    {
+      QENC_i8Dir = i8Delta;
+      QENC_u8Run = 1;
+    }
+
+    QENC_u32Stamp[QENC_u8StampIndex++ & ( QENC_STAMP_NO - 1 )] = u32Now - sEdge[i].u16Age;
+  }
+
+  if ( ETM_GetOverFlowFlag( ETM2 ) )
+  {
+    ETM_ClrOverFlowFlag( ETM2 );
+    QENC_u16OverflowHigh++;
+  }
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* QENC api lists
+*
+*//*! @addtogroup qenc_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  initialize ETM2 for quadrature decoding. The ETM2 counter is free
+*         running, the remaining channel pair can only be used for capture.
+*
+* @param[in]    pConfig     pointer to QENC configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void QENC_Init( QENC_ConfigType * pConfig )
+{
+  uint8_t i;
+  ASSERT( pConfig->u8ChannelPairA != pConfig->u8ChannelPairB );
+  QENC_u8ChannelA       = pConfig->u8ChannelPairA;
+  QENC_u8ChannelB       = pConfig->u8ChannelPairB;
+  QENC_u8State          = 0;
+  QENC_u8Known          = 0;
+  QENC_i8Sign           = pConfig->bReverse ? -1 : 1;
+  QENC_bIndexReset      = pConfig->bIndexReset;
+  QENC_u32TimeoutTicks  = pConfig->u32TimeoutTicks;
+  /* the ETM counts the timer clock, which is the ICS output clock */
+  QENC_u32ClockHz       = SystemClockGet( CLOCK_CORE ) >> pConfig->u8ClockPrescale;
+  QENC_u16OverflowHigh  = 0;
+  QENC_i32Position      = 0;
+  QENC_i32IndexPosition = 0;
+  QENC_u32IndexCount    = 0;
+  QENC_u32ErrorCount    = 0;
+  QENC_i8Dir            = 0;
+  QENC_u8Run            = 0;
+  QENC_u8StampIndex     = 0;
+  ETM_SetCallback( ETM2, QENC_Isr );
+  ETM_DualEdgeCaptureInit( ETM2, QENC_u8ChannelA, ETM_INPUTCAPTURE_DUALEDGE_CONTINUOUS,
+                           ETM_INPUTCAPTURE_DUALEDGE_RISINGEDGE, ETM_INPUTCAPTURE_DUALEDGE_FALLInGEDGE );
+  ETM_DualEdgeCaptureInit( ETM2, QENC_u8ChannelB, ETM_INPUTCAPTURE_DUALEDGE_CONTINUOUS,
+                           ETM_INPUTCAPTURE_DUALEDGE_RISINGEDGE, ETM_INPUTCAPTURE_DUALEDGE_FALLInGEDGE );
+
+  if ( pConfig->u8FilterValue )
+  {
+    if ( QENC_u8ChannelA < 4 )
+    {
+      ETM_InputCaptureFilterSet( ETM2, QENC_u8ChannelA, pConfig->u8FilterValue );
+    }
+
+    if ( QENC_u8ChannelB < 4 )
+    {
+      ETM_InputCaptureFilterSet( ETM2, QENC_u8ChannelB, pConfig->u8FilterValue );
+    }
+  }
+
+  ETM2->CNT = 0;
+
+  for ( i = 0; i < 2; i++ )
+  {
+    ETM_ClrChannelFlag( ETM2, QENC_u8ChannelA + i );
+    ETM_ClrChannelFlag( ETM2, QENC_u8ChannelB + i );
+    ETM_EnableChannelInt( ETM2, QENC_u8ChannelA + i );
+    ETM_EnableChannelInt( ETM2, QENC_u8ChannelB + i );
+  }
+
+  ETM_ClrOverFlowFlag( ETM2 );
+  ETM_EnableOverflowInt( ETM2 );
+  NVIC_EnableIRQ( ETM2_IRQn );
+  ETM_ClockSet( ETM2, ETM_CLOCK_SYSTEMCLOCK, pConfig->u8ClockPrescale );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop decoding and reset ETM2.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void QENC_DeInit( void )
+{
+  ETM_DeInit( ETM2 );
+  ETM_SetCallback( ETM2, ( ETM_CallbackPtr )NULL );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the current position.
+*
+* @param  none.
+*
+* @return position in counts.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+int32_t QENC_GetPosition( void )
+{
+  return QENC_i32Position;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  set the current position, e.g. after homing.
+*
+* @param[in]    i32Position new position in counts.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void QENC_SetPosition( int32_t i32Position )
+{
+  QENC_i32Position = i32Position;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get a consistent snapshot of position, index and error counters.
+*
+* @param[out]   pStatus     pointer to the status.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void QENC_GetStatus( QENC_StatusType * pStatus )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  pStatus->i32Position      = QENC_i32Position;
+  pStatus->i32IndexPosition = QENC_i32IndexPosition;
+  pStatus->u32IndexCount    = QENC_u32IndexCount;
+  pStatus->u32ErrorCount    = QENC_u32ErrorCount;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the shaft velocity.
+*
+* @param  none.
+*
+* @return velocity in counts per second, positive when counting up.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+int32_t QENC_GetVelocity( void )
+{
+  uint32_t u32Now;
+  uint32_t u32Last;
+  uint32_t u32Idle;
+  uint64_t u64Span;
+  uint8_t  u8Intervals;
+  int8_t   i8Dir;
+  int32_t  i32Velocity;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  u32Now      = QENC_Now();
+  i8Dir       = QENC_i8Dir;
+  u8Intervals = ( QENC_u8Run > 0 ) ? ( QENC_u8Run - 1 ) : 0;
+  u32Last     = QENC_u32Stamp[( uint8_t )( QENC_u8StampIndex - 1 ) & ( QENC_STAMP_NO - 1 )];
+  u64Span     = u32Last - QENC_u32Stamp[( uint8_t )( QENC_u8StampIndex - 1 - u8Intervals ) & ( QENC_STAMP_NO - 1 )];
+  __set_interrupt_state( interrupt_state );
+  u32Idle = u32Now - u32Last;
+
+  if ( ( 0 == u8Intervals ) || ( u32Idle > QENC_u32TimeoutTicks ) )
+  {
+    return 0;
+  }
+
+  /* the shaft is slower than the last mean interval if no edge came since */
+  if ( ( uint64_t )u32Idle * u8Intervals > u64Span )
+  {
+    u64Span = ( uint64_t )u32Idle * u8Intervals;
+  }
+
+  i32Velocity = ( int32_t )( ( ( uint64_t )QENC_u32ClockHz * u8Intervals ) / u64Span );
+  return ( i8Dir < 0 ) ? -i32Velocity : i32Velocity;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  index pulse handler, call it from the KBI callback on the active
+*         edge of the index pin.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void QENC_IndexCallback( void )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  QENC_i32IndexPosition = QENC_i32Position;
+  QENC_u32IndexCount++;
+
+  if ( QENC_bIndexReset )
+  {
+    QENC_i32Position = 0;
+  }
+
+  __set_interrupt_state( interrupt_state );
+}
+
+/*! @} End of qenc_api_list                                                   */
@@ -0,0 +1,101 @@
+/******************************************************************************
+* @brief header file for quadrature encoder decoder (QENC) on ETM2.
+*
+*******************************************************************************
+*
+* provide APIs for decoding incremental A/B encoders with ETM2 dual edge
+* capture, with position, velocity and index pulse handling
+******************************************************************************/
+#ifndef __NV32_QENC_H__
+#define __NV32_QENC_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_etm.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* QENC configure struct.
+*
+*//*! @addtogroup qenc_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief QENC configure struct.
+*
+* Signal A drives the input of the first channel of u8ChannelPairA, signal B
+* the input of the first channel of u8ChannelPairB (route the pins with
+* SIM->PINSEL). The index pulse is taken from a KBI pin, call
+* QENC_IndexCallback from the KBI callback on its active edge.
+*/
+typedef struct
+{
+  uint8_t   u8ChannelPairA;         /*!< ETM_CHANNELPAIR0 ~ ETM_CHANNELPAIR2 for signal A */
+  uint8_t   u8ChannelPairB;         /*!< ETM_CHANNELPAIR0 ~ ETM_CHANNELPAIR2 for signal B */
+  uint8_t   u8ClockPrescale;        /*!< ETM_CLOCK_PS_DIV1 ~ ETM_CLOCK_PS_DIV128, sets velocity resolution */
+  uint8_t   u8FilterValue;          /*!< input filter 0 ~ 15, pairs 0 and 1 only */
+  uint32_t  u32TimeoutTicks;        /*!< report velocity 0 after this time without edges */
+  uint8_t   bReverse        : 1;    /*!< 1: count down when A leads B */
+  uint8_t   bIndexReset     : 1;    /*!< 1: position is reset to 0 on each index pulse */
+  uint8_t   bReserved       : 6;    /*!< reserved */
+} QENC_ConfigType, *QENC_ConfigPtr;
+/*! @} End of qenc_configstruct                                               */
+
+/******************************************************************************
+* QENC status struct.
+*
+*//*! @addtogroup qenc_statusstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief QENC status, a consistent snapshot returned by QENC_GetStatus.
+*/
+typedef struct
+{
+  int32_t   i32Position;            /*!< position in counts (4 per encoder line) */
+  int32_t   i32IndexPosition;       /*!< position latched at the last index pulse */
+  uint32_t  u32IndexCount;          /*!< number of index pulses seen */
+  uint32_t  u32ErrorCount;          /*!< missed edges detected by the state machine */
+} QENC_StatusType, *QENC_StatusPtr;
+/*! @} End of qenc_statusstruct                                               */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void QENC_Init( QENC_ConfigType * pConfig );
+void QENC_DeInit( void );
+int32_t QENC_GetPosition( void );
+void QENC_SetPosition( int32_t i32Position );
+void QENC_GetStatus( QENC_StatusType * pStatus );
+int32_t QENC_GetVelocity( void );
+void QENC_IndexCallback( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_QENC_H__ */
@@ -4,6 +4,8 @@
 ******************************************************************************/
 #include "NV32_config.h"
 #include "NV32_rtc.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
 
 /******************************************************************************
 * Global variables
@@ -28,7 +30,11 @@
  * @brief global variable to store RTC callbacks.
  *
  */
+#ifdef RTC_STATIC_CALLBACK
+void RTC_STATIC_CALLBACK( void );
+#else
 RTC_CallbackType RTC_Callback[1] = {( RTC_CallbackType )NULL};  /*!< RTC initial callback */
+#endif
 
 /******************************************************************************
 * Local functions
@@ -106,7 +112,15 @@ void RTC_Init( RTC_ConfigType * pConfig )
 *****************************************************************************/
 void RTC_SetCallback( RTC_CallbackType pfnCallback )
 {
+#ifdef RTC_STATIC_CALLBACK
+  /* bound at link time, RTC_IRQHandler calls RTC_STATIC_CALLBACK */
+  ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == RTC_STATIC_CALLBACK ) );
+#else
   RTC_Callback[0] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+  VECTOR_Install( RTC_IRQn, RTC_Isr );
+#endif
+#endif
 }
 
 
@@ -151,14 +165,27 @@ void RTC_DeInit( void )
 *
 * @ Pass/ Fail criteria: none
 *****************************************************************************/
+#ifdef RTC_STATIC_CALLBACK
+void RTC_IRQHandler( void )
+{
+  ISRSTAT_ENTER( ISRSTAT_RTC );
+  RTC_ClrFlags();
+  RTC_STATIC_CALLBACK();
+  ISRSTAT_EXIT( ISRSTAT_RTC );
+}
+#else
 void RTC_Isr( void )
 {
+  ISRSTAT_ENTER( ISRSTAT_RTC );
   RTC_ClrFlags();
 
   if ( RTC_Callback[0] )
   {
     RTC_Callback[0]();
   }
+
+  ISRSTAT_EXIT( ISRSTAT_RTC );
 }
+#endif
 
 
@@ -8,23 +8,59 @@
 ******************************************************************************/
 #include "NV32_config.h"
 #include "NV32_spi.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
 
 
 /******************************************************************************
 * Local variables
 ******************************************************************************/
 
+#if !defined( SPI0_STATIC_CALLBACK ) || !defined( SPI1_STATIC_CALLBACK )
 SPI_CallbackType SPI_Callback[MAX_SPI_NO] = {( SPI_CallbackType )NULL};
+#endif
 
 
 /******************************************************************************
 * Local function prototypes
 ******************************************************************************/
+#ifdef SPI0_STATIC_CALLBACK
+void SPI0_STATIC_CALLBACK( void );
+#else
+void SPI0_Isr( void );
+#endif
+#ifdef SPI1_STATIC_CALLBACK
+void SPI1_STATIC_CALLBACK( void );
+#else
+void SPI1_Isr( void );
+#endif
 
 /******************************************************************************
 * Local functions
 *****************************************************************************/
 
+/*****************************************************************************//*!
+   *
+   * @brief  SPI isr body, shared by the static and the dynamic handler.
+   *
+   * @param[in]  u8Id         ISRSTAT_SPI0 or ISRSTAT_SPI1.
+   * @param[in]  pfnCallback  callback, a constant in the static handler.
+   *
+   * @return none.
+   *
+   * @ Pass/ Fail criteria: none.
+*****************************************************************************/
+__STATIC_INLINE void SPI_Isr( uint8_t u8Id, SPI_CallbackType pfnCallback )
+{
+  ISRSTAT_ENTER( u8Id );
+  if ( pfnCallback )
+  {
+    pfnCallback();
+  }
+
+  ISRSTAT_EXIT( u8Id );
+}
+
 /******************************************************************************
 * Global functions
 ******************************************************************************/
@@ -303,7 +339,34 @@ void SPI_SetCallback( SPI_Type * pSPI, SPI_CallbackType pfnCallback )
 {
   uint32_t    u32Port = ( ( uint32_t )pSPI - ( uint32_t )SPI0 ) >> 12;
   ASSERT( u32Port < 2 );
-  SPI_Callback[u32Port] = pfnCallback;
+
+  /* SPIx_Isr only calls the callback, vector to it directly */
+  if ( u32Port == 0 )
+  {
+#ifdef SPI0_STATIC_CALLBACK
+    /* bound at link time, SPI0_IRQHandler calls SPI0_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == SPI0_STATIC_CALLBACK ) );
+#else
+    SPI_Callback[0] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( SPI0_IRQn, VECTOR_DIRECT( pfnCallback, SPI0_Isr ) );
+#endif
+#endif
+  }
+#ifndef CPU_NV32M3
+  else
+  {
+#ifdef SPI1_STATIC_CALLBACK
+    /* bound at link time, SPI1_IRQHandler calls SPI1_STATIC_CALLBACK */
+    ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == SPI1_STATIC_CALLBACK ) );
+#else
+    SPI_Callback[1] = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+    VECTOR_Install( SPI1_IRQn, VECTOR_DIRECT( pfnCallback, SPI1_Isr ) );
+#endif
+#endif
+  }
+#endif
 }
 
 /*! @} End of spi_api_list                                                          */
@@ -319,13 +382,17 @@ void SPI_SetCallback( SPI_Type * pSPI, SPI_CallbackType pfnCallback )
    * @ Pass/ Fail criteria: none.
    *****************************************************************************/
 
+#ifdef SPI0_STATIC_CALLBACK
+void SPI0_IRQHandler( void )
+{
+  SPI_Isr( ISRSTAT_SPI0, SPI0_STATIC_CALLBACK );
+}
+#else
 void SPI0_Isr( void )
 {
-  if ( SPI_Callback[0] )
-  {
-    SPI_Callback[0]();
-  }
+  SPI_Isr( ISRSTAT_SPI0, SPI_Callback[0] );
 }
+#endif
 #ifndef CPU_NV32M3
 /*****************************************************************************//*!
    *
@@ -337,13 +404,17 @@ void SPI0_Isr( void )
    * @ Pass/ Fail criteria: none
    *****************************************************************************/
 
+#ifdef SPI1_STATIC_CALLBACK
+void SPI1_IRQHandler( void )
+{
+  SPI_Isr( ISRSTAT_SPI1, SPI1_STATIC_CALLBACK );
+}
+#else
 void SPI1_Isr( void )
 {
-  if ( SPI_Callback[1] )
-  {
-    SPI_Callback[1]();
-  }
+  SPI_Isr( ISRSTAT_SPI1, SPI_Callback[1] );
 }
 #endif
+#endif
 
 
@@ -0,0 +1,915 @@
+/******************************************************************************
+* @brief providing APIs for software I2C, SPI and 1-Wire masters (SWBUS).
+*
+*******************************************************************************
+*
+* All bit timing goes through one delay loop. SWBUS_Calibrate times that
+* loop with the SysTick, so flash wait states and the call cost are part
+* of the measurement, and the init functions turn the wanted periods into
+* loop counts from SystemClockGet( CLOCK_CORE ), rounding up so no bus runs
+* faster than asked. The code around the I2C and SPI delays is counted in
+* the SWBUS_xxx_CYCLES constants; the 1-Wire times are minimums, their
+* loops alone cover them and the call and code only lengthen them. Call the
+* init functions again after the core clock changes.
+*
+* I2C and 1-Wire lines are open drain: the output latch stays low and the
+* pin is driven by setting its direction bit, through the BME so the update
+* is atomic with other drivers on the same port. The I2C master is not
+* timing critical and runs with interrupts enabled, 1-Wire slots mask
+* interrupts for up to 70 us.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_swbus.h"
+#include "NV32_BME.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define SWBUS_LOOP_CYCLES       4           /* delay loop cost before calibration */
+#define SWBUS_CALL_CYCLES       12          /* delay call cost before calibration */
+#define SWBUS_CAL_LOOPS         64          /* loops timed by SWBUS_Calibrate */
+
+#define SWBUS_I2C_LOW_CYCLES    24          /* code while SCL is low, two BME stores */
+#define SWBUS_I2C_HIGH_CYCLES   16          /* code while SCL is high, BME store and poll */
+#define SWBUS_I2C_POLL_CYCLES   12          /* one poll of a stretched SCL */
+#define SWBUS_SPI_HALF_CYCLES   8           /* code per half SCK period */
+
+/* I2C SCL low part of the period, 9/16 meets tLOW in standard and fast mode */
+#define SWBUS_I2C_LOW_SHARE     9
+
+#define SWBUS_SPI_CPHA          0x01
+#define SWBUS_SPI_CPOL          0x02
+
+/* 1-Wire standard speed slot timings, each the delay alone */
+#define SWBUS_OW_A              0           /* write 1 and read low time */
+#define SWBUS_OW_B              1           /* write 1 recovery */
+#define SWBUS_OW_C              2           /* write 0 low time */
+#define SWBUS_OW_D              3           /* write 0 recovery */
+#define SWBUS_OW_E              4           /* read sample point */
+#define SWBUS_OW_F              5           /* read recovery */
+#define SWBUS_OW_G              6           /* before reset */
+#define SWBUS_OW_H              7           /* reset low time */
+#define SWBUS_OW_I              8           /* presence sample point */
+#define SWBUS_OW_J              9           /* reset recovery */
+
+#define SWBUS_DRIVE_LOW(sPin)   BME_GPIO_SET( ( sPin ).pGpio->PDDR, ( sPin ).u32Mask )
+#define SWBUS_RELEASE(sPin)     BME_GPIO_CLEAR( ( sPin ).pGpio->PDDR, ( sPin ).u32Mask )
+#define SWBUS_READ(sPin)        ( ( sPin ).pFgpio->PDIR & ( sPin ).u32Mask )
+
+/* SWBUS_I2CBit, SCL stayed low */
+#define SWBUS_I2C_STRETCHED     2
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static void SWBUS_Delay( uint32_t u32Loops );
+static uint32_t SWBUS_Time( uint32_t u32Loops );
+static uint32_t SWBUS_UsToCycles( uint32_t u32Us );
+static uint32_t SWBUS_Loops( uint32_t u32Cycles, uint32_t u32CodeCycles );
+static void SWBUS_PinInit( SWBUS_PinType * pPin, uint8_t u8Pin, GPIO_PinConfigType ePinConfig );
+static uint8_t SWBUS_I2CSclHigh( SWBUS_I2CType * pI2C );
+static uint8_t SWBUS_I2CBit( SWBUS_I2CType * pI2C, uint8_t u8Bit );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static uint32_t SWBUS_u32LoopQ8 = SWBUS_LOOP_CYCLES << 8;   /*!< core clocks per delay loop, Q8 */
+static uint32_t SWBUS_u32CallCycles = SWBUS_CALL_CYCLES;    /*!< core clocks of a delay call besides its loops */
+
+static const uint16_t SWBUS_u16OWTimeUs[SWBUS_OW_DELAYS] =
+{
+  6, 64, 60, 10, 9, 55, 0, 480, 70, 410
+};
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  busy wait a number of delay loops.
+*
+* @param[in]    u32Loops    loops to wait.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWBUS_Delay( uint32_t u32Loops )
+{
+  while ( u32Loops-- )
+  {
+    __no_operation();
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  time a delay call with the running SysTick.
+*
+* @param[in]    u32Loops    loops to wait.
+*
+* @return core clocks.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t SWBUS_Time( uint32_t u32Loops )
+{
+  uint32_t u32Reload = SysTick->LOAD + 1;
+  uint32_t u32Start = SysTick->VAL;
+  SWBUS_Delay( u32Loops );
+  /* the counter runs down and wraps at most once */
+  return ( u32Start + u32Reload - SysTick->VAL ) % u32Reload;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  convert micro seconds to core clocks, rounded up.
+*
+* @param[in]    u32Us       micro seconds, up to 1000.
+*
+* @return core clocks.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t SWBUS_UsToCycles( uint32_t u32Us )
+{
+  return ( SystemClockGet( CLOCK_CORE ) / 1000 * u32Us + 999 ) / 1000;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  delay loops for a time, rounded up.
+*
+* @param[in]    u32Cycles       wanted time in core clocks.
+* @param[in]    u32CodeCycles   core clocks of the code around the delay.
+*
+* @return delay loops.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t SWBUS_Loops( uint32_t u32Cycles, uint32_t u32CodeCycles )
+{
+  u32CodeCycles += SWBUS_u32CallCycles;
+
+  if ( u32Cycles <= u32CodeCycles )
+  {
+    return 0;
+  }
+
+  return ( ( ( u32Cycles - u32CodeCycles ) << 8 ) + SWBUS_u32LoopQ8 - 1 ) / SWBUS_u32LoopQ8;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  configure a pin and resolve its ports.
+*
+* @param[out]   pPin        resolved pin.
+* @param[in]    u8Pin       GPIO_PinType, or SWBUS_PIN_NONE.
+* @param[in]    ePinConfig  GPIO pin configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWBUS_PinInit( SWBUS_PinType * pPin, uint8_t u8Pin, GPIO_PinConfigType ePinConfig )
+{
+  if ( u8Pin == SWBUS_PIN_NONE )
+  {
+    /* a zero mask makes every store and read of the pin a no-op */
+    pPin->pGpio   = GPIOA;
+    pPin->pFgpio  = FGPIOA;
+    pPin->u32Mask = 0;
+    return;
+  }
+
+  ASSERT( u8Pin < GPIO_PTI0 );
+  GPIO_PinInit( ( GPIO_PinType )u8Pin, ePinConfig );
+  pPin->pGpio   = ( u8Pin < GPIO_PTE0 ) ? GPIOA : GPIOB;
+  pPin->pFgpio  = GPIO_PIN_FGPIO( u8Pin );
+  pPin->u32Mask = GPIO_PIN_MASK( u8Pin );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  release SCL and wait while a slave stretches it.
+*
+* @param[in]    pI2C        I2C master.
+*
+* @return TRUE when SCL is high, FALSE on time out.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t SWBUS_I2CSclHigh( SWBUS_I2CType * pI2C )
+{
+  uint32_t u32Timeout = pI2C->u32Timeout;
+  SWBUS_RELEASE( pI2C->sScl );
+
+  while ( !SWBUS_READ( pI2C->sScl ) )
+  {
+    if ( u32Timeout-- == 0 )
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  clock one bit, SCL is low before and after.
+*
+* @param[in]    pI2C        I2C master.
+* @param[in]    u8Bit       bit to send, non-zero releases SDA.
+*
+* @return SDA sampled while SCL is high, or SWBUS_I2C_STRETCHED.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint8_t SWBUS_I2CBit( SWBUS_I2CType * pI2C, uint8_t u8Bit )
+{
+  uint8_t u8Read;
+
+  if ( u8Bit )
+  {
+    SWBUS_RELEASE( pI2C->sSda );
+  }
+  else
+  {
+    SWBUS_DRIVE_LOW( pI2C->sSda );
+  }
+
+  SWBUS_Delay( pI2C->u32DelayLow );
+
+  if ( !SWBUS_I2CSclHigh( pI2C ) )
+  {
+    return SWBUS_I2C_STRETCHED;
+  }
+
+  SWBUS_Delay( pI2C->u32DelayHigh );
+  u8Read = SWBUS_READ( pI2C->sSda ) ? 1 : 0;
+  SWBUS_DRIVE_LOW( pI2C->sScl );
+  return u8Read;
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* define SWBUS APIs
+*
+*//*! @addtogroup swbus_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  time the delay loop in core clocks. The SysTick is borrowed when
+*         it is stopped, a running SysTick is used as it is if it counts
+*         core clocks, otherwise the defaults stay. Interrupts are masked
+*         for a few hundred clocks.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWBUS_Calibrate( void )
+{
+  uint32_t u32Short;
+  uint32_t u32Long;
+  uint8_t  bSysTick;
+  __istate_t interrupt_state;
+  bSysTick = !( SysTick->CTRL & SysTick_CTRL_ENABLE_Msk );
+
+  if ( !bSysTick && !( SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk ) )
+  {
+    return;
+  }
+
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  if ( bSysTick )
+  {
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+  }
+
+  /* a loop count of 0 may skip the loop entry, time from 1 loop */
+  u32Short = SWBUS_Time( 1 );
+  u32Long  = SWBUS_Time( 1 + SWBUS_CAL_LOOPS );
+
+  if ( bSysTick )
+  {
+    SysTick->CTRL = 0;
+  }
+
+  __set_interrupt_state( interrupt_state );
+
+  if ( u32Long > u32Short )
+  {
+    SWBUS_u32LoopQ8     = ( ( u32Long - u32Short ) << 8 ) / SWBUS_CAL_LOOPS;
+    SWBUS_u32CallCycles = ( u32Short > ( SWBUS_u32LoopQ8 >> 8 ) ) ? u32Short - ( SWBUS_u32LoopQ8 >> 8 ) : 0;
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  busy wait at least a number of micro seconds, interrupts extend
+*         the wait.
+*
+* @param[in]    u32Us       micro seconds.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWBUS_DelayUs( uint32_t u32Us )
+{
+  if ( u32Us >= 1000 )
+  {
+    uint32_t u32Loops = SWBUS_Loops( SWBUS_UsToCycles( 1000 ), 0 );
+
+    for ( ; u32Us >= 1000; u32Us -= 1000 )
+    {
+      SWBUS_Delay( u32Loops );
+    }
+  }
+
+  SWBUS_Delay( SWBUS_Loops( SWBUS_UsToCycles( u32Us ), 0 ) );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  initialize an I2C master and free the bus: a slave left driving
+*         SDA low is clocked out with up to 9 SCL pulses and a stop.
+*
+* @param[out]   pI2C        I2C master.
+* @param[in]    pConfig     pointer to the configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWBUS_I2CInit( SWBUS_I2CType * pI2C, SWBUS_I2CConfigType * pConfig )
+{
+  GPIO_PinConfigType ePinConfig = pConfig->bPullup ? GPIO_PinInput_InternalPullup : GPIO_PinInput;
+  uint32_t u32Period;
+  uint32_t u32Low;
+  uint8_t  i;
+  ASSERT( ( pConfig->u32Hz != 0 ) && ( pConfig->u32Hz <= 400000 ) );
+  SWBUS_Calibrate();
+  SWBUS_PinInit( &pI2C->sScl, pConfig->u8SclPin, ePinConfig );
+  SWBUS_PinInit( &pI2C->sSda, pConfig->u8SdaPin, ePinConfig );
+  pI2C->sScl.pFgpio->PCOR = pI2C->sScl.u32Mask;
+  pI2C->sSda.pFgpio->PCOR = pI2C->sSda.u32Mask;
+
+  u32Period = ( SystemClockGet( CLOCK_CORE ) + pConfig->u32Hz - 1 ) / pConfig->u32Hz;
+  u32Low    = ( u32Period * SWBUS_I2C_LOW_SHARE + 15 ) >> 4;
+  pI2C->u32DelayLow  = SWBUS_Loops( u32Low, SWBUS_I2C_LOW_CYCLES );
+  pI2C->u32DelayHigh = SWBUS_Loops( u32Period - u32Low, SWBUS_I2C_HIGH_CYCLES );
+  pI2C->u32Timeout   = SWBUS_UsToCycles( SWBUS_I2C_STRETCH_US ) / SWBUS_I2C_POLL_CYCLES;
+
+  SWBUS_DRIVE_LOW( pI2C->sScl );
+
+  for ( i = 0; ( i < 9 ) && !SWBUS_READ( pI2C->sSda ); i++ )
+  {
+    SWBUS_I2CBit( pI2C, 1 );
+  }
+
+  SWBUS_I2CStop( pI2C );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  send a start, or a repeated start inside a transfer.
+*
+* @param[in]    pI2C        I2C master.
+*
+* @return SWBUS_ERROR_NULL, SWBUS_ERROR_TIMEOUT or SWBUS_ERROR_BUS_BUSY.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_I2CStart( SWBUS_I2CType * pI2C )
+{
+  SWBUS_RELEASE( pI2C->sSda );
+  SWBUS_Delay( pI2C->u32DelayLow );
+
+  if ( !SWBUS_I2CSclHigh( pI2C ) )
+  {
+    return SWBUS_ERROR_TIMEOUT;
+  }
+
+  SWBUS_Delay( pI2C->u32DelayHigh );
+
+  if ( !SWBUS_READ( pI2C->sSda ) )
+  {
+    return SWBUS_ERROR_BUS_BUSY;
+  }
+
+  SWBUS_DRIVE_LOW( pI2C->sSda );
+  SWBUS_Delay( pI2C->u32DelayHigh );
+  SWBUS_DRIVE_LOW( pI2C->sScl );
+  return SWBUS_ERROR_NULL;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  send a stop, SCL is low before.
+*
+* @param[in]    pI2C        I2C master.
+*
+* @return SWBUS_ERROR_NULL or SWBUS_ERROR_TIMEOUT.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_I2CStop( SWBUS_I2CType * pI2C )
+{
+  SWBUS_DRIVE_LOW( pI2C->sSda );
+  SWBUS_Delay( pI2C->u32DelayLow );
+
+  if ( !SWBUS_I2CSclHigh( pI2C ) )
+  {
+    return SWBUS_ERROR_TIMEOUT;
+  }
+
+  SWBUS_Delay( pI2C->u32DelayHigh );
+  SWBUS_RELEASE( pI2C->sSda );
+  SWBUS_Delay( pI2C->u32DelayLow );
+  return SWBUS_ERROR_NULL;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  send a byte MSB first and read the acknowledge.
+*
+* @param[in]    pI2C        I2C master.
+* @param[in]    u8Data      byte to send.
+*
+* @return SWBUS_ERROR_NULL, SWBUS_ERROR_TIMEOUT or SWBUS_ERROR_NO_ACK.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_I2CWriteByte( SWBUS_I2CType * pI2C, uint8_t u8Data )
+{
+  uint8_t u8Mask;
+  uint8_t u8Ack;
+
+  for ( u8Mask = 0x80; u8Mask; u8Mask >>= 1 )
+  {
+    if ( SWBUS_I2CBit( pI2C, u8Data & u8Mask ) == SWBUS_I2C_STRETCHED )
+    {
+      return SWBUS_ERROR_TIMEOUT;
+    }
+  }
+
+  u8Ack = SWBUS_I2CBit( pI2C, 1 );
+
+  if ( u8Ack == SWBUS_I2C_STRETCHED )
+  {
+    return SWBUS_ERROR_TIMEOUT;
+  }
+
+  return u8Ack ? SWBUS_ERROR_NO_ACK : SWBUS_ERROR_NULL;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  read a byte MSB first and send the acknowledge.
+*
+* @param[in]    pI2C        I2C master.
+* @param[out]   pData       byte read.
+* @param[in]    bAck        TRUE: ACK, more bytes follow, FALSE: NACK.
+*
+* @return SWBUS_ERROR_NULL or SWBUS_ERROR_TIMEOUT.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_I2CReadByte( SWBUS_I2CType * pI2C, uint8_t * pData, uint8_t bAck )
+{
+  uint8_t u8Data = 0;
+  uint8_t u8Bit;
+  uint8_t i;
+
+  for ( i = 0; i < 8; i++ )
+  {
+    u8Bit = SWBUS_I2CBit( pI2C, 1 );
+
+    if ( u8Bit == SWBUS_I2C_STRETCHED )
+    {
+      return SWBUS_ERROR_TIMEOUT;
+    }
+
+    u8Data = ( u8Data << 1 ) | u8Bit;
+  }
+
+  if ( SWBUS_I2CBit( pI2C, !bAck ) == SWBUS_I2C_STRETCHED )
+  {
+    return SWBUS_ERROR_TIMEOUT;
+  }
+
+  *pData = u8Data;
+  return SWBUS_ERROR_NULL;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  write bytes to a slave: start, address, data, stop.
+*
+* @param[in]    pI2C        I2C master.
+* @param[in]    u8Address   7-bit slave address.
+* @param[in]    pData       bytes to send.
+* @param[in]    u32Length   number of bytes.
+*
+* @return SWBUS_ERROR_NULL or the first error.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_I2CWrite( SWBUS_I2CType * pI2C, uint8_t u8Address, const uint8_t * pData, uint32_t u32Length )
+{
+  uint8_t u8Error = SWBUS_I2CStart( pI2C );
+
+  if ( u8Error != SWBUS_ERROR_NULL )
+  {
+    return u8Error;
+  }
+
+  u8Error = SWBUS_I2CWriteByte( pI2C, u8Address << 1 );
+
+  while ( ( u8Error == SWBUS_ERROR_NULL ) && u32Length-- )
+  {
+    u8Error = SWBUS_I2CWriteByte( pI2C, *pData++ );
+  }
+
+  SWBUS_I2CStop( pI2C );
+  return u8Error;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  read bytes from a slave: start, address, data, stop.
+*
+* @param[in]    pI2C        I2C master.
+* @param[in]    u8Address   7-bit slave address.
+* @param[out]   pData       bytes read.
+* @param[in]    u32Length   number of bytes.
+*
+* @return SWBUS_ERROR_NULL or the first error.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_I2CRead( SWBUS_I2CType * pI2C, uint8_t u8Address, uint8_t * pData, uint32_t u32Length )
+{
+  uint8_t u8Error = SWBUS_I2CStart( pI2C );
+
+  if ( u8Error != SWBUS_ERROR_NULL )
+  {
+    return u8Error;
+  }
+
+  u8Error = SWBUS_I2CWriteByte( pI2C, ( u8Address << 1 ) | 1 );
+
+  while ( ( u8Error == SWBUS_ERROR_NULL ) && u32Length )
+  {
+    u32Length--;
+    u8Error = SWBUS_I2CReadByte( pI2C, pData++, u32Length != 0 );
+  }
+
+  SWBUS_I2CStop( pI2C );
+  return u8Error;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  initialize an SPI master, SCK goes to its idle level.
+*
+* @param[out]   pSPI        SPI master.
+* @param[in]    pConfig     pointer to the configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWBUS_SPIInit( SWBUS_SPIType * pSPI, SWBUS_SPIConfigType * pConfig )
+{
+  uint32_t u32Half;
+  ASSERT( ( pConfig->u32Hz != 0 ) && ( pConfig->u8Mode <= 3 ) );
+  SWBUS_Calibrate();
+  SWBUS_PinInit( &pSPI->sSck, pConfig->u8SckPin, GPIO_PinOutput );
+  SWBUS_PinInit( &pSPI->sMosi, pConfig->u8MosiPin, GPIO_PinOutput );
+  SWBUS_PinInit( &pSPI->sMiso, pConfig->u8MisoPin, GPIO_PinInput );
+  pSPI->u8Mode = pConfig->u8Mode;
+  *( ( pSPI->u8Mode & SWBUS_SPI_CPOL ) ? &pSPI->sSck.pFgpio->PSOR : &pSPI->sSck.pFgpio->PCOR ) = pSPI->sSck.u32Mask;
+
+  u32Half = ( SystemClockGet( CLOCK_CORE ) + 2 * pConfig->u32Hz - 1 ) / ( 2 * pConfig->u32Hz );
+  pSPI->u32Delay = SWBUS_Loops( u32Half, SWBUS_SPI_HALF_CYCLES );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  exchange one byte MSB first, chip select is up to the caller.
+*
+* @param[in]    pSPI        SPI master.
+* @param[in]    u8Data      byte to send.
+*
+* @return byte received, 0 without MISO.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_SPITransfer( SWBUS_SPIType * pSPI, uint8_t u8Data )
+{
+  FGPIO_Type        *pSck = pSPI->sSck.pFgpio;
+  uint32_t          u32Sck = pSPI->sSck.u32Mask;
+  volatile uint32_t *pMosiSet = &pSPI->sMosi.pFgpio->PSOR;
+  volatile uint32_t *pMosiClr = &pSPI->sMosi.pFgpio->PCOR;
+  uint32_t          u32Mosi = pSPI->sMosi.u32Mask;
+  FGPIO_Type        *pMiso = pSPI->sMiso.pFgpio;
+  uint32_t          u32Miso = pSPI->sMiso.u32Mask;
+  uint32_t          u32Delay = pSPI->u32Delay;
+  uint8_t           u8Read = 0;
+  uint8_t           u8Mask;
+
+  if ( pSPI->u8Mode & SWBUS_SPI_CPHA )
+  {
+    for ( u8Mask = 0x80; u8Mask; u8Mask >>= 1 )
+    {
+      /* leading edge shifts out, trailing edge samples */
+      pSck->PTOR = u32Sck;
+      *( ( u8Data & u8Mask ) ? pMosiSet : pMosiClr ) = u32Mosi;
+      SWBUS_Delay( u32Delay );
+      pSck->PTOR = u32Sck;
+
+      if ( pMiso->PDIR & u32Miso )
+      {
+        u8Read |= u8Mask;
+      }
+
+      SWBUS_Delay( u32Delay );
+    }
+  }
+  else
+  {
+    for ( u8Mask = 0x80; u8Mask; u8Mask >>= 1 )
+    {
+      /* data before the leading edge, which samples */
+      *( ( u8Data & u8Mask ) ? pMosiSet : pMosiClr ) = u32Mosi;
+      SWBUS_Delay( u32Delay );
+      pSck->PTOR = u32Sck;
+
+      if ( pMiso->PDIR & u32Miso )
+      {
+        u8Read |= u8Mask;
+      }
+
+      SWBUS_Delay( u32Delay );
+      pSck->PTOR = u32Sck;
+    }
+  }
+
+  return u8Read;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  exchange bytes.
+*
+* @param[in]    pSPI        SPI master.
+* @param[in]    pTx         bytes to send, NULL sends 0xFF.
+* @param[out]   pRx         bytes received, or NULL.
+* @param[in]    u32Length   number of bytes.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWBUS_SPITransferBlock( SWBUS_SPIType * pSPI, const uint8_t * pTx, uint8_t * pRx, uint32_t u32Length )
+{
+  uint8_t u8Read;
+
+  while ( u32Length-- )
+  {
+    u8Read = SWBUS_SPITransfer( pSPI, pTx ? *pTx++ : 0xFF );
+
+    if ( pRx )
+    {
+      *pRx++ = u8Read;
+    }
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  initialize a 1-Wire master, DQ released.
+*
+* @param[out]   pOW         1-Wire master.
+* @param[in]    pConfig     pointer to the configuration.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWBUS_OWInit( SWBUS_OWType * pOW, SWBUS_OWConfigType * pConfig )
+{
+  uint8_t i;
+  SWBUS_Calibrate();
+  SWBUS_PinInit( &pOW->sDq, pConfig->u8Pin, pConfig->bPullup ? GPIO_PinInput_InternalPullup : GPIO_PinInput );
+  pOW->sDq.pFgpio->PCOR = pOW->sDq.u32Mask;
+
+  for ( i = 0; i < SWBUS_OW_DELAYS; i++ )
+  {
+    /* the loops alone cover the time, the calibrated call cost is an estimate */
+    pOW->u32Delay[i] = ( ( SWBUS_UsToCycles( SWBUS_u16OWTimeUs[i] ) << 8 ) + SWBUS_u32LoopQ8 - 1 ) / SWBUS_u32LoopQ8;
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  send a reset pulse and look for a presence pulse.
+*
+* @param[in]    pOW         1-Wire master.
+*
+* @return TRUE if a device answered.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_OWReset( SWBUS_OWType * pOW )
+{
+  uint8_t    bPresence;
+  __istate_t interrupt_state;
+  SWBUS_Delay( pOW->u32Delay[SWBUS_OW_G] );
+  /* an interrupt may stretch the reset pulse, which is harmless */
+  SWBUS_DRIVE_LOW( pOW->sDq );
+  SWBUS_Delay( pOW->u32Delay[SWBUS_OW_H] );
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  SWBUS_RELEASE( pOW->sDq );
+  SWBUS_Delay( pOW->u32Delay[SWBUS_OW_I] );
+  bPresence = !SWBUS_READ( pOW->sDq );
+  __set_interrupt_state( interrupt_state );
+  SWBUS_Delay( pOW->u32Delay[SWBUS_OW_J] );
+  return bPresence;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  write one bit slot.
+*
+* @param[in]    pOW         1-Wire master.
+* @param[in]    u8Bit       bit to write.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWBUS_OWWriteBit( SWBUS_OWType * pOW, uint8_t u8Bit )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  SWBUS_DRIVE_LOW( pOW->sDq );
+  SWBUS_Delay( pOW->u32Delay[u8Bit ? SWBUS_OW_A : SWBUS_OW_C] );
+  SWBUS_RELEASE( pOW->sDq );
+  __set_interrupt_state( interrupt_state );
+  SWBUS_Delay( pOW->u32Delay[u8Bit ? SWBUS_OW_B : SWBUS_OW_D] );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  read one bit slot.
+*
+* @param[in]    pOW         1-Wire master.
+*
+* @return bit read.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_OWReadBit( SWBUS_OWType * pOW )
+{
+  uint8_t    u8Bit;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  SWBUS_DRIVE_LOW( pOW->sDq );
+  SWBUS_Delay( pOW->u32Delay[SWBUS_OW_A] );
+  SWBUS_RELEASE( pOW->sDq );
+  SWBUS_Delay( pOW->u32Delay[SWBUS_OW_E] );
+  u8Bit = SWBUS_READ( pOW->sDq ) ? 1 : 0;
+  __set_interrupt_state( interrupt_state );
+  SWBUS_Delay( pOW->u32Delay[SWBUS_OW_F] );
+  return u8Bit;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  write a byte LSB first.
+*
+* @param[in]    pOW         1-Wire master.
+* @param[in]    u8Data      byte to write.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWBUS_OWWriteByte( SWBUS_OWType * pOW, uint8_t u8Data )
+{
+  uint8_t i;
+
+  for ( i = 0; i < 8; i++ )
+  {
+    SWBUS_OWWriteBit( pOW, u8Data & 1 );
+    u8Data >>= 1;
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  read a byte LSB first.
+*
+* @param[in]    pOW         1-Wire master.
+*
+* @return byte read.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_OWReadByte( SWBUS_OWType * pOW )
+{
+  uint8_t u8Data = 0;
+  uint8_t i;
+
+  for ( i = 0; i < 8; i++ )
+  {
+    u8Data = ( u8Data >> 1 ) | ( SWBUS_OWReadBit( pOW ) << 7 );
+  }
+
+  return u8Data;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  Dallas/Maxim CRC-8 (x^8 + x^5 + x^4 + 1) of ROM codes and
+*         scratchpads, 0 over data that ends with its CRC.
+*
+* @param[in]    pData       bytes.
+* @param[in]    u32Length   number of bytes.
+*
+* @return CRC-8.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t SWBUS_OWCrc8( const uint8_t * pData, uint32_t u32Length )
+{
+  uint8_t u8Crc = 0;
+  uint8_t u8Byte;
+  uint8_t i;
+
+  while ( u32Length-- )
+  {
+    u8Byte = *pData++;
+
+    for ( i = 0; i < 8; i++ )
+    {
+      u8Crc = ( ( u8Crc ^ u8Byte ) & 1 ) ? ( ( u8Crc >> 1 ) ^ 0x8C ) : ( u8Crc >> 1 );
+      u8Byte >>= 1;
+    }
+  }
+
+  return u8Crc;
+}
+/*! @} End of swbus_api_list                                                  */
@@ -0,0 +1,158 @@
+/******************************************************************************
+* @brief header file for software I2C, SPI and 1-Wire masters (SWBUS).
+*
+*******************************************************************************
+*
+* provide APIs for bit-banged I2C, SPI and 1-Wire masters on GPIO pins with
+* bit timing derived from the core clock
+******************************************************************************/
+#ifndef __NV32_SWBUS_H__
+#define __NV32_SWBUS_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_gpio.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define SWBUS_PIN_NONE              0xFF        /*!< SPI MOSI or MISO not connected */
+
+#define SWBUS_ERROR_NULL            0x00        /*!< success */
+#define SWBUS_ERROR_TIMEOUT         0x01        /*!< I2C clock stretched too long */
+#define SWBUS_ERROR_NO_ACK          0x04        /*!< I2C byte not acknowledged */
+#define SWBUS_ERROR_BUS_BUSY        0x80        /*!< I2C SDA held low at start */
+
+#define SWBUS_OW_DELAYS             10          /*!< 1-Wire slot timings A ~ J */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* SWBUS configure struct.
+*
+*//*! @addtogroup swbus_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief a pin resolved to its ports, filled in by the init functions.
+*/
+typedef struct
+{
+  GPIO_Type     *pGpio;                 /*!< GPIOA/GPIOB, direction through the BME */
+  FGPIO_Type    *pFgpio;                /*!< FGPIOA/FGPIOB, data */
+  uint32_t      u32Mask;                /*!< pin mask, 0 for SWBUS_PIN_NONE */
+} SWBUS_PinType;
+
+/*!
+* @brief I2C master configure struct, SCL and SDA are open drain.
+*/
+typedef struct
+{
+  uint8_t       u8SclPin;               /*!< GPIO_PinType of SCL */
+  uint8_t       u8SdaPin;               /*!< GPIO_PinType of SDA */
+  uint8_t       bPullup;                /*!< 1: internal pullups, 0: external */
+  uint32_t      u32Hz;                  /*!< SCL frequency, up to 400000 */
+} SWBUS_I2CConfigType, *SWBUS_I2CConfigPtr;
+
+/*!
+* @brief I2C master.
+*/
+typedef struct
+{
+  SWBUS_PinType sScl;
+  SWBUS_PinType sSda;
+  uint32_t      u32DelayLow;            /*!< delay loops while SCL is low */
+  uint32_t      u32DelayHigh;           /*!< delay loops while SCL is high */
+  uint32_t      u32Timeout;             /*!< polls of a stretched SCL */
+} SWBUS_I2CType, *SWBUS_I2CPtr;
+
+/*!
+* @brief SPI master configure struct, MSB first.
+*/
+typedef struct
+{
+  uint8_t       u8SckPin;               /*!< GPIO_PinType of SCK */
+  uint8_t       u8MosiPin;              /*!< GPIO_PinType of MOSI, or SWBUS_PIN_NONE */
+  uint8_t       u8MisoPin;              /*!< GPIO_PinType of MISO, or SWBUS_PIN_NONE */
+  uint8_t       u8Mode;                 /*!< SPI mode 0 ~ 3, CPOL << 1 | CPHA */
+  uint32_t      u32Hz;                  /*!< SCK frequency */
+} SWBUS_SPIConfigType, *SWBUS_SPIConfigPtr;
+
+/*!
+* @brief SPI master.
+*/
+typedef struct
+{
+  SWBUS_PinType sSck;
+  SWBUS_PinType sMosi;
+  SWBUS_PinType sMiso;
+  uint8_t       u8Mode;
+  uint32_t      u32Delay;               /*!< delay loops per half SCK period */
+} SWBUS_SPIType, *SWBUS_SPIPtr;
+
+/*!
+* @brief 1-Wire master configure struct, standard speed.
+*/
+typedef struct
+{
+  uint8_t       u8Pin;                  /*!< GPIO_PinType of DQ */
+  uint8_t       bPullup;                /*!< 1: internal pullup, 0: external */
+} SWBUS_OWConfigType, *SWBUS_OWConfigPtr;
+
+/*!
+* @brief 1-Wire master.
+*/
+typedef struct
+{
+  SWBUS_PinType sDq;
+  uint32_t      u32Delay[SWBUS_OW_DELAYS];  /*!< delay loops of the slot timings */
+} SWBUS_OWType, *SWBUS_OWPtr;
+/*! @} End of swbus_configstruct                                              */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void SWBUS_Calibrate( void );
+void SWBUS_DelayUs( uint32_t u32Us );
+void SWBUS_I2CInit( SWBUS_I2CType * pI2C, SWBUS_I2CConfigType * pConfig );
+uint8_t SWBUS_I2CStart( SWBUS_I2CType * pI2C );
+uint8_t SWBUS_I2CStop( SWBUS_I2CType * pI2C );
+uint8_t SWBUS_I2CWriteByte( SWBUS_I2CType * pI2C, uint8_t u8Data );
+uint8_t SWBUS_I2CReadByte( SWBUS_I2CType * pI2C, uint8_t * pData, uint8_t bAck );
+uint8_t SWBUS_I2CWrite( SWBUS_I2CType * pI2C, uint8_t u8Address, const uint8_t * pData, uint32_t u32Length );
+uint8_t SWBUS_I2CRead( SWBUS_I2CType * pI2C, uint8_t u8Address, uint8_t * pData, uint32_t u32Length );
+void SWBUS_SPIInit( SWBUS_SPIType * pSPI, SWBUS_SPIConfigType * pConfig );
+uint8_t SWBUS_SPITransfer( SWBUS_SPIType * pSPI, uint8_t u8Data );
+void SWBUS_SPITransferBlock( SWBUS_SPIType * pSPI, const uint8_t * pTx, uint8_t * pRx, uint32_t u32Length );
+void SWBUS_OWInit( SWBUS_OWType * pOW, SWBUS_OWConfigType * pConfig );
+uint8_t SWBUS_OWReset( SWBUS_OWType * pOW );
+void SWBUS_OWWriteBit( SWBUS_OWType * pOW, uint8_t u8Bit );
+uint8_t SWBUS_OWReadBit( SWBUS_OWType * pOW );
+void SWBUS_OWWriteByte( SWBUS_OWType * pOW, uint8_t u8Data );
+uint8_t SWBUS_OWReadByte( SWBUS_OWType * pOW );
+uint8_t SWBUS_OWCrc8( const uint8_t * pData, uint32_t u32Length );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_SWBUS_H__ */
@@ -0,0 +1,760 @@
+/******************************************************************************
+* @brief providing APIs for tickless software timers (SWTMR) on one PIT channel.
+*
+*******************************************************************************
+*
+* Timers live in a four level timer wheel of 16 slots per level, level n
+* covering 16^(n+1) ticks, each slot an intrusive doubly linked list, so
+* start and stop are O(1) regardless of the number of timers. Timeouts beyond
+* the wheel range are parked in the top level and cascaded again.
+*
+* The wheel does not tick: the PIT channel is reprogrammed to the next point
+* where a level 0 slot expires or a higher level slot must be cascaded, found
+* from per-level slot occupancy bitmaps. The PIT period is aligned to tick
+* boundaries and the cycles already elapsed when it is restarted are carried
+* over, so restarting does not accumulate drift.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_swtimer.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define SWTMR_LEVEL_BITS        4
+#define SWTMR_LEVEL_SLOTS       ( 1 << SWTMR_LEVEL_BITS )
+#define SWTMR_LEVEL_MASK        ( SWTMR_LEVEL_SLOTS - 1 )
+#define SWTMR_LEVELS            4
+
+#define SWTMR_CHANNEL           ( SWTMR_PIT_CHANNEL )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+static uint32_t SWTMR_FirstSlot( uint16_t u16Map, uint32_t u32From );
+static uint32_t SWTMR_NextDelta( void );
+static void SWTMR_Link( SWTMR_TimerType * pTimer );
+static void SWTMR_Unlink( SWTMR_TimerType * pTimer );
+static void SWTMR_Process( uint32_t u32Tick );
+static void SWTMR_Advance( uint32_t u32Tick );
+static void SWTMR_Program( uint32_t u32OffsetCycles );
+static uint32_t SWTMR_Elapsed( uint32_t * pu32Rem );
+static void SWTMR_SetTick( void );
+static void SWTMR_Isr( void );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static SWTMR_TimerType  *SWTMR_pSlot[SWTMR_LEVELS * SWTMR_LEVEL_SLOTS];
+static uint16_t         SWTMR_u16Map[SWTMR_LEVELS];    /*!< non-empty slots per level */
+static uint32_t         SWTMR_u32Now;                  /*!< all timers due up to here have run */
+static uint32_t         SWTMR_u32Deadline;             /*!< tick ending the current PIT period */
+static uint32_t         SWTMR_u32PeriodStart;          /*!< tick the current PIT period started in */
+static uint32_t         SWTMR_u32PeriodOffset;         /*!< cycles of that tick elapsed at restart */
+static uint32_t         SWTMR_u32TickCycles;           /*!< bus cycles per tick */
+static uint32_t         SWTMR_u32MaxTicks;             /*!< longest PIT period in ticks */
+static uint8_t          SWTMR_bInIsr;                  /*!< 1: timer callbacks are running */
+
+/*! @brief index of the lowest set bit of a nibble, 4 for none. */
+static const uint8_t SWTMR_u8Ctz4[16] = { 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  distance from u32From to the first non-empty slot, cyclic.
+*
+* @param[in]    u16Map      slot occupancy bitmap of one level.
+* @param[in]    u32From     first slot to look at.
+*
+* @return 0 ~ 15, or SWTMR_LEVEL_SLOTS if the level is empty.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t SWTMR_FirstSlot( uint16_t u16Map, uint32_t u32From )
+{
+  uint32_t u32Rot;
+  uint32_t u32Pos = 0;
+  u32From &= SWTMR_LEVEL_MASK;
+  u32Rot   = ( ( ( uint32_t )u16Map >> u32From ) | ( ( uint32_t )u16Map << ( SWTMR_LEVEL_SLOTS - u32From ) ) ) & 0xFFFF;
+
+  if ( 0 == u32Rot )
+  {
+    return SWTMR_LEVEL_SLOTS;
+  }
+
+  while ( 0 == ( u32Rot & 0xF ) )
+  {
+    u32Rot >>= 4;
+    u32Pos  += 4;
+  }
+
+  return u32Pos + SWTMR_u8Ctz4[u32Rot & 0xF];
+}
+
+/*****************************************************************************//*!
+*
+* @brief  ticks from SWTMR_u32Now to the next slot expiry or cascade.
+*
+* @param  none.
+*
+* @return ticks, SWTMR_NO_DEADLINE if no timer is running.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t SWTMR_NextDelta( void )
+{
+  uint32_t u32Best = SWTMR_NO_DEADLINE;
+  uint32_t u32Delta;
+  uint32_t u32Slot;
+  uint32_t u32Shift;
+  uint32_t u32Index;
+  uint8_t  u8Level;
+
+  for ( u8Level = 0; u8Level < SWTMR_LEVELS; u8Level++ )
+  {
+    u32Shift = u8Level * SWTMR_LEVEL_BITS;
+    u32Index = SWTMR_u32Now >> u32Shift;
+    u32Slot  = SWTMR_FirstSlot( SWTMR_u16Map[u8Level], u32Index + 1 );
+
+    if ( u32Slot < SWTMR_LEVEL_SLOTS )
+    {
+      /* level 0: the slot expires, higher levels: the slot is cascaded at its start */
+      u32Delta = ( ( u32Index + u32Slot + 1 ) << u32Shift ) - SWTMR_u32Now;
+
+      if ( u32Delta < u32Best )
+      {
+        u32Best = u32Delta;
+      }
+    }
+  }
+
+  return u32Best;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  put a timer into the slot matching its distance from SWTMR_u32Now.
+*
+* @param[in]    pTimer      pointer to a stopped timer.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWTMR_Link( SWTMR_TimerType * pTimer )
+{
+  uint32_t u32Delta = pTimer->u32Expiry - SWTMR_u32Now;
+  uint32_t u32Expiry;
+  uint8_t  u8Level;
+  uint8_t  u8Slot;
+  SWTMR_TimerType **ppHead;
+
+  if ( ( int32_t )u32Delta < 0 )
+  {
+    /* overdue, e.g. a periodic timer after a long interrupt lock. A delta of 0
+     * only comes from a cascade and lands in the level 0 slot run next. */
+    pTimer->u32Expiry = SWTMR_u32Now + 1;
+    u32Delta = 1;
+  }
+
+  u32Expiry = pTimer->u32Expiry;
+
+  for ( u8Level = 0; u8Level < SWTMR_LEVELS - 1; u8Level++ )
+  {
+    if ( u32Delta < ( 1UL << ( ( u8Level + 1 ) * SWTMR_LEVEL_BITS ) ) )
+    {
+      break;
+    }
+  }
+
+  if ( u32Delta >> ( SWTMR_LEVELS * SWTMR_LEVEL_BITS ) )
+  {
+    /* beyond the wheel: park in the furthest top level slot */
+    u32Expiry = SWTMR_u32Now + ( 1UL << ( SWTMR_LEVELS * SWTMR_LEVEL_BITS ) );
+  }
+
+  u8Slot = ( u32Expiry >> ( u8Level * SWTMR_LEVEL_BITS ) ) & SWTMR_LEVEL_MASK;
+  pTimer->u8Slot = u8Level * SWTMR_LEVEL_SLOTS + u8Slot;
+  ppHead = &SWTMR_pSlot[pTimer->u8Slot];
+  pTimer->pNext = *ppHead;
+
+  if ( pTimer->pNext )
+  {
+    pTimer->pNext->ppPrev = &pTimer->pNext;
+  }
+
+  *ppHead = pTimer;
+  pTimer->ppPrev = ppHead;
+  SWTMR_u16Map[u8Level] |= ( 1 << u8Slot );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  remove a running timer from its slot.
+*
+* @param[in]    pTimer      pointer to a running timer.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWTMR_Unlink( SWTMR_TimerType * pTimer )
+{
+  *pTimer->ppPrev = pTimer->pNext;
+
+  if ( pTimer->pNext )
+  {
+    pTimer->pNext->ppPrev = pTimer->ppPrev;
+  }
+
+  if ( NULL == SWTMR_pSlot[pTimer->u8Slot] )
+  {
+    SWTMR_u16Map[pTimer->u8Slot >> SWTMR_LEVEL_BITS] &= ~( 1 << ( pTimer->u8Slot & SWTMR_LEVEL_MASK ) );
+  }
+
+  pTimer->ppPrev = NULL;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  move the wheel to u32Tick: cascade the higher level slots starting
+*         there, then run the expired level 0 slot.
+*
+* @param[in]    u32Tick     tick to process.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWTMR_Process( uint32_t u32Tick )
+{
+  SWTMR_TimerType *pTimer;
+  SWTMR_TimerType *pNext;
+  uint8_t u8Level;
+  uint8_t u8Slot;
+  SWTMR_u32Now = u32Tick;
+
+  for ( u8Level = SWTMR_LEVELS - 1; u8Level > 0; u8Level-- )
+  {
+    if ( u32Tick & ( ( 1UL << ( u8Level * SWTMR_LEVEL_BITS ) ) - 1 ) )
+    {
+      continue;
+    }
+
+    /* no callback runs while cascading, the detached chain is relinked whole */
+    u8Slot = u8Level * SWTMR_LEVEL_SLOTS + ( ( u32Tick >> ( u8Level * SWTMR_LEVEL_BITS ) ) & SWTMR_LEVEL_MASK );
+    pTimer = SWTMR_pSlot[u8Slot];
+    SWTMR_pSlot[u8Slot] = NULL;
+    SWTMR_u16Map[u8Level] &= ~( 1 << ( u8Slot & SWTMR_LEVEL_MASK ) );
+
+    for ( ; pTimer; pTimer = pNext )
+    {
+      pNext = pTimer->pNext;
+      SWTMR_Link( pTimer );
+    }
+  }
+
+  /* a callback may stop or restart any timer still in the slot, so take them
+   * one at a time from the live head. None is relinked into this slot again. */
+  u8Slot = u32Tick & SWTMR_LEVEL_MASK;
+
+  while ( NULL != ( pTimer = SWTMR_pSlot[u8Slot] ) )
+  {
+    SWTMR_Unlink( pTimer );
+
+    if ( pTimer->u32Expiry != u32Tick )
+    {
+      SWTMR_Link( pTimer );
+      continue;
+    }
+
+    if ( pTimer->u32Period )
+    {
+      pTimer->u32Expiry += pTimer->u32Period;
+      SWTMR_Link( pTimer );
+    }
+
+    pTimer->pfnCallback( pTimer->pParam );
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  advance the wheel up to u32Tick, running everything due on the way.
+*
+* @param[in]    u32Tick     target tick.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWTMR_Advance( uint32_t u32Tick )
+{
+  uint32_t u32Delta;
+
+  while ( ( int32_t )( u32Tick - SWTMR_u32Now ) > 0 )
+  {
+    u32Delta = SWTMR_NextDelta();
+
+    if ( u32Delta > u32Tick - SWTMR_u32Now )
+    {
+      SWTMR_u32Now = u32Tick;
+      break;
+    }
+
+    SWTMR_Process( SWTMR_u32Now + u32Delta );
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief  restart the PIT channel to end at the next wheel event.
+*
+* @param[in]    u32OffsetCycles  cycles of SWTMR_u32Now already elapsed.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWTMR_Program( uint32_t u32OffsetCycles )
+{
+  uint32_t u32Delta = SWTMR_NextDelta();
+
+  if ( u32Delta > SWTMR_u32MaxTicks )
+  {
+    u32Delta = SWTMR_u32MaxTicks;
+  }
+
+  SWTMR_u32PeriodStart  = SWTMR_u32Now;
+  SWTMR_u32PeriodOffset = u32OffsetCycles;
+  SWTMR_u32Deadline     = SWTMR_u32Now + u32Delta;
+  PIT_ChannelDisable( SWTMR_CHANNEL );
+  PIT_SetLoadVal( SWTMR_CHANNEL, u32Delta * SWTMR_u32TickCycles - u32OffsetCycles - 1 );
+  PIT_ChannelEnable( SWTMR_CHANNEL );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  ticks elapsed in the current PIT period, interrupts must be masked.
+*
+* @param[out]   pu32Rem     cycles elapsed in the current tick.
+*
+* @return current tick, SWTMR_u32Deadline if the period already ended.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t SWTMR_Elapsed( uint32_t * pu32Rem )
+{
+  uint32_t u32Cycles;
+  uint8_t  u8Flag;
+
+  /* the channel may reload between reading the flag and the counter */
+  do
+  {
+    u8Flag    = PIT_ChannelGetFlags( SWTMR_CHANNEL );
+    u32Cycles = PIT->CHANNEL[SWTMR_CHANNEL].LDVAL - PIT->CHANNEL[SWTMR_CHANNEL].CVAL;
+  } while ( u8Flag != PIT_ChannelGetFlags( SWTMR_CHANNEL ) );
+
+  if ( u8Flag )
+  {
+    /* the interrupt is pending and will process the deadline */
+    *pu32Rem = 0;
+    return SWTMR_u32Deadline;
+  }
+
+  u32Cycles += SWTMR_u32PeriodOffset;
+  *pu32Rem  = u32Cycles % SWTMR_u32TickCycles;
+  return SWTMR_u32PeriodStart + u32Cycles / SWTMR_u32TickCycles;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  derive the tick length from the bus clock.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWTMR_SetTick( void )
+{
+  SWTMR_u32TickCycles = ( uint32_t )( ( ( uint64_t )SystemClockGet( CLOCK_BUS ) * SWTMR_TICK_US ) / 1000000 );
+  SWTMR_u32MaxTicks   = 0xFFFFFFFF / SWTMR_u32TickCycles - 1;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  PIT channel callback: run the expired timers and program the next
+*         deadline.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void SWTMR_Isr( void )
+{
+  uint32_t u32Late;
+  /* the channel reloaded at the deadline and kept counting */
+  u32Late = PIT->CHANNEL[SWTMR_CHANNEL].LDVAL - PIT->CHANNEL[SWTMR_CHANNEL].CVAL;
+  SWTMR_bInIsr = 1;
+  SWTMR_Advance( SWTMR_u32Deadline + u32Late / SWTMR_u32TickCycles );
+  SWTMR_bInIsr = 0;
+  SWTMR_Program( u32Late % SWTMR_u32TickCycles );
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* SWTMR api lists
+*
+*//*! @addtogroup swtmr_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  initialize the timer wheel on PIT channel SWTMR_PIT_CHANNEL with a
+*         tick of SWTMR_TICK_US.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWTMR_Init( void )
+{
+  PIT_ConfigType sPITConfig = {0};
+  uint8_t i;
+
+  for ( i = 0; i < SWTMR_LEVELS * SWTMR_LEVEL_SLOTS; i++ )
+  {
+    SWTMR_pSlot[i] = NULL;
+  }
+
+  for ( i = 0; i < SWTMR_LEVELS; i++ )
+  {
+    SWTMR_u16Map[i] = 0;
+  }
+
+  SWTMR_u32Now        = 0;
+  SWTMR_bInIsr        = 0;
+  SWTMR_SetTick( );
+  sPITConfig.bInterruptEn = 1;
+  sPITConfig.u32LoadValue = SWTMR_u32TickCycles - 1;
+  PIT_Init( SWTMR_CHANNEL, &sPITConfig );
+  PIT_SetCallback( SWTMR_CHANNEL, SWTMR_Isr );
+  SWTMR_Program( 0 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop the timer wheel channel. Running timers are dropped.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWTMR_DeInit( void )
+{
+  PIT_ChannelDisableInt( SWTMR_CHANNEL );
+  PIT_ChannelDisable( SWTMR_CHANNEL );
+  PIT_ChannelClrFlags( SWTMR_CHANNEL );
+  PIT_SetCallback( SWTMR_CHANNEL, ( PIT_CallbackType )NULL );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  initialize a timer before first use.
+*
+* @param[in]    pTimer      pointer to the timer.
+* @param[in]    pfnCallback expiry callback, runs in the PIT interrupt.
+* @param[in]    pParam      callback parameter.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWTMR_TimerInit( SWTMR_TimerType * pTimer, SWTMR_CallbackType pfnCallback, void * pParam )
+{
+  pTimer->pNext       = NULL;
+  pTimer->ppPrev      = NULL;
+  pTimer->u32Expiry   = 0;
+  pTimer->u32Period   = 0;
+  pTimer->pfnCallback = pfnCallback;
+  pTimer->pParam      = pParam;
+  pTimer->u8Slot      = 0;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  (re)start a timer, also from a timer callback.
+*
+* @param[in]    pTimer          pointer to the timer.
+* @param[in]    u32Ticks        ticks to the first expiry, at least 1.
+* @param[in]    u32PeriodTicks  ticks between later expiries, 0 for one-shot.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWTMR_Start( SWTMR_TimerType * pTimer, uint32_t u32Ticks, uint32_t u32PeriodTicks )
+{
+  uint32_t u32Now;
+  uint32_t u32Rem = 0;
+  uint8_t  bReprogram;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  if ( pTimer->ppPrev )
+  {
+    SWTMR_Unlink( pTimer );
+  }
+
+  if ( SWTMR_bInIsr )
+  {
+    /* called from a timer callback, the wheel is at the current tick */
+    u32Now  = SWTMR_u32Now;
+    bReprogram = FALSE;
+  }
+  else
+  {
+    u32Now  = SWTMR_Elapsed( &u32Rem );
+    /* with the deadline interrupt pending, it reprograms the channel itself */
+    bReprogram = !PIT_ChannelGetFlags( SWTMR_CHANNEL );
+
+    if ( bReprogram )
+    {
+      /* nothing is due before the programmed deadline, so this only moves time */
+      SWTMR_Advance( u32Now );
+    }
+  }
+
+  pTimer->u32Expiry = u32Now + ( u32Ticks ? u32Ticks : 1 );
+  pTimer->u32Period = u32PeriodTicks;
+  SWTMR_Link( pTimer );
+
+  if ( bReprogram && ( ( pTimer->u32Expiry - SWTMR_u32Now ) < ( SWTMR_u32Deadline - SWTMR_u32Now ) ) )
+  {
+    SWTMR_Program( u32Rem );
+  }
+
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop a timer, no effect if it is not running.
+*
+* @param[in]    pTimer      pointer to the timer.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWTMR_Stop( SWTMR_TimerType * pTimer )
+{
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  if ( pTimer->ppPrev )
+  {
+    SWTMR_Unlink( pTimer );
+  }
+
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the current tick count.
+*
+* @param  none.
+*
+* @return ticks since SWTMR_Init, wraps at 2^32.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t SWTMR_GetTicks( void )
+{
+  uint32_t u32Now;
+  uint32_t u32Rem;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  u32Now = SWTMR_Elapsed( &u32Rem );
+  __set_interrupt_state( interrupt_state );
+  return u32Now;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the ticks until the wheel needs the CPU again.
+*
+* @param  none.
+*
+* @return ticks to the next expiry or cascade, 0 if it is due now,
+*         SWTMR_NO_DEADLINE if no timer is running.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t SWTMR_GetIdleTicks( void )
+{
+  uint32_t u32Now;
+  uint32_t u32Rem;
+  uint32_t u32Delta;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  u32Now = SWTMR_Elapsed( &u32Rem );
+  u32Delta = SWTMR_NextDelta();
+
+  if ( SWTMR_NO_DEADLINE != u32Delta )
+  {
+    u32Delta = SWTMR_u32Now + u32Delta - u32Now;
+    u32Delta = ( ( int32_t )u32Delta < 0 ) ? 0 : u32Delta;
+  }
+
+  __set_interrupt_state( interrupt_state );
+  return u32Delta;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop the PIT channel before a low power mode that halts the bus
+*         clock. The wheel is brought up to date first, the time spent
+*         stopped is handed back with SWTMR_Resume. Call with interrupts
+*         masked.
+*
+* @param  none.
+*
+* @return ticks to the next expiry or cascade, SWTMR_NO_DEADLINE if no timer
+*         is running, 0 if it is due now: the channel then keeps running and
+*         SWTMR_Resume must not be called.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t SWTMR_Suspend( void )
+{
+  uint32_t u32Now;
+  uint32_t u32Rem;
+  uint32_t u32Delta;
+  u32Now = SWTMR_Elapsed( &u32Rem );
+
+  if ( PIT_ChannelGetFlags( SWTMR_CHANNEL ) )
+  {
+    return 0;
+  }
+
+  SWTMR_Advance( u32Now );
+  u32Delta = SWTMR_u32Deadline - SWTMR_u32Now;
+
+  if ( 0 == u32Delta )
+  {
+    return 0;
+  }
+
+  PIT_ChannelDisable( SWTMR_CHANNEL );
+  return SWTMR_NextDelta();
+}
+
+/*****************************************************************************//*!
+*
+* @brief  restart the PIT channel after SWTMR_Suspend, accounting for the
+*         time measured by another clock while it was stopped. Timers that
+*         came due meanwhile run from the PIT interrupt as soon as interrupts
+*         are unmasked. Call with interrupts masked.
+*
+* @param[in]    u32Ticks    ticks elapsed since SWTMR_Suspend.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWTMR_Resume( uint32_t u32Ticks )
+{
+  uint32_t u32Target = SWTMR_u32Now + u32Ticks;
+
+  if ( SWTMR_NextDelta() <= u32Ticks )
+  {
+    /* end a zero length period right away, the interrupt advances to the target */
+    SWTMR_u32PeriodStart  = u32Target;
+    SWTMR_u32PeriodOffset = 0;
+    SWTMR_u32Deadline     = u32Target;
+    PIT_SetLoadVal( SWTMR_CHANNEL, 0 );
+    PIT_ChannelEnable( SWTMR_CHANNEL );
+    return;
+  }
+
+  SWTMR_u32Now = u32Target;
+  SWTMR_Program( 0 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  take the new bus clock, call right after it changed, e.g. from a
+*         CLKMGR_POST_CHANGE notifier. The cycles counted so far are taken at
+*         the old rate and the part of the tick left is carried over to the
+*         new one. Call with interrupts masked.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void SWTMR_ClockUpdate( void )
+{
+  uint32_t u32Now;
+  uint32_t u32Rem;
+  uint32_t u32OldCycles = SWTMR_u32TickCycles;
+  u32Now = SWTMR_Elapsed( &u32Rem );
+  SWTMR_SetTick( );
+
+  if ( PIT_ChannelGetFlags( SWTMR_CHANNEL ) )
+  {
+    /* the interrupt programs the next period at the new rate */
+    return;
+  }
+
+  /* nothing is due before the programmed deadline, so this only moves time */
+  SWTMR_Advance( u32Now );
+  SWTMR_Program( ( uint32_t )( ( ( uint64_t )u32Rem * SWTMR_u32TickCycles ) / u32OldCycles ) );
+}
+
+/*! @} End of swtmr_api_list                                                  */
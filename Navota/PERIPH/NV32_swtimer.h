@@ -0,0 +1,118 @@
+/******************************************************************************
+* @brief header file for tickless software timers (SWTMR) on one PIT channel.
+*
+*******************************************************************************
+*
+* provide APIs for running any number of one-shot and periodic software
+* timers from a hierarchical timer wheel
+******************************************************************************/
+#ifndef __NV32_SWTIMER_H__
+#define __NV32_SWTIMER_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_pit.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define SWTMR_NO_DEADLINE       0xFFFFFFFF      /*!< SWTMR_GetIdleTicks: no timer running */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/*! @brief convert milliseconds to timer ticks, rounded up. */
+#define SWTMR_MS_TO_TICKS(ms)   ( ( ( uint32_t )( ms ) * 1000 + SWTMR_TICK_US - 1 ) / SWTMR_TICK_US )
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* SWTMR callback function declaration
+*
+*//*! @addtogroup swtmr_callback
+* @{
+*******************************************************************************/
+typedef void ( *SWTMR_CallbackType )( void * pParam );   /*!< SWTMR callback type, runs in PIT interrupt */
+/*! @} End of swtmr_callback                                                  */
+
+/******************************************************************************
+* SWTMR timer struct.
+*
+*//*! @addtogroup swtmr_timerstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief software timer, owned by the caller and linked into the wheel while
+*        running. Initialize with SWTMR_TimerInit, the fields are private.
+*/
+typedef struct SWTMR_Timer
+{
+  struct SWTMR_Timer  *pNext;               /*!< next timer in the slot */
+  struct SWTMR_Timer  **ppPrev;             /*!< link pointing to this timer, NULL if stopped */
+  uint32_t            u32Expiry;            /*!< absolute expiry tick */
+  uint32_t            u32Period;            /*!< reload in ticks, 0 for one-shot */
+  SWTMR_CallbackType  pfnCallback;          /*!< expiry callback */
+  void                *pParam;              /*!< callback parameter */
+  uint8_t             u8Slot;               /*!< wheel slot while running */
+} SWTMR_TimerType, *SWTMR_TimerPtr;
+/*! @} End of swtmr_timerstruct                                               */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+/******************************************************************************
+* SWTMR inline functions
+*
+*//*! @addtogroup swtmr_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  check whether a timer is running.
+*
+* @param[in]    pTimer      pointer to the timer.
+*
+* @return TRUE if running, FALSE otherwise.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE uint8_t SWTMR_IsActive( SWTMR_TimerType * pTimer )
+{
+  return ( pTimer->ppPrev != NULL );
+}
+
+/*! @} End of swtmr_api_list                                                  */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void SWTMR_Init( void );
+void SWTMR_DeInit( void );
+void SWTMR_TimerInit( SWTMR_TimerType * pTimer, SWTMR_CallbackType pfnCallback, void * pParam );
+void SWTMR_Start( SWTMR_TimerType * pTimer, uint32_t u32Ticks, uint32_t u32PeriodTicks );
+void SWTMR_Stop( SWTMR_TimerType * pTimer );
+uint32_t SWTMR_GetTicks( void );
+uint32_t SWTMR_GetIdleTicks( void );
+uint32_t SWTMR_Suspend( void );
+void SWTMR_Resume( uint32_t u32Ticks );
+void SWTMR_ClockUpdate( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_SWTIMER_H__ */
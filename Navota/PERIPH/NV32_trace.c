@@ -0,0 +1,209 @@
+/******************************************************************************
+* @brief providing APIs for binary trace ring (TRACE).
+*
+*******************************************************************************
+*
+* A record is the address of its format string and the raw arguments, one
+* to four words in a RAM ring of TRACE_RING_WORDS words. Nothing is
+* formatted on the target, so a record costs tens of core clocks and no
+* printf is linked.
+*
+* The M0+ has no exclusive access, so a writer reserves its words with
+* interrupts masked for a few instructions only. It fills the arguments
+* unmasked and stores the header last, which commits the record. The
+* reader, TRACE_Drain from the main loop, stops at a header that is still
+* 0 and clears each word once it is sent. A full ring drops the new record
+* and counts it, the sequence number in the headers shows where.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_trace.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+uint32_t TRACE_u32Dropped;
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define TRACE_MASK              ( TRACE_RING_WORDS - 1 )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static volatile uint32_t TRACE_u32Ring[TRACE_RING_WORDS];
+static volatile uint32_t TRACE_u32Head;     /*!< next word to reserve, free running */
+static volatile uint32_t TRACE_u32Tail;     /*!< next word to send, free running */
+static uint32_t TRACE_u32Seq;
+static uint32_t TRACE_u32Left;              /*!< words of the record being sent, 0 at a header */
+static uint8_t  TRACE_u8Byte;               /*!< byte of the word being sent */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* TRACE api lists
+*
+*//*! @addtogroup trace_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  empty the ring.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void TRACE_Init( void )
+{
+  uint32_t   i;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  for ( i = 0; i < TRACE_RING_WORDS; i++ )
+  {
+    TRACE_u32Ring[i] = 0;
+  }
+
+  TRACE_u32Head    = 0;
+  TRACE_u32Tail    = 0;
+  TRACE_u32Left    = 0;
+  TRACE_u8Byte     = 0;
+  TRACE_u32Dropped = 0;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  store a record, called by the TRACE0 ~ TRACE3 macros from any
+*         context.
+*
+* @param[in]    u32Header   format string address and argument count.
+* @param[in]    u32Arg0     first argument.
+* @param[in]    u32Arg1     second argument.
+* @param[in]    u32Arg2     third argument.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void TRACE_Put( uint32_t u32Header, uint32_t u32Arg0, uint32_t u32Arg1, uint32_t u32Arg2 )
+{
+  uint32_t   u32Args = ( u32Header & TRACE_ARGS_MASK ) >> TRACE_ARGS_SHIFT;
+  uint32_t   u32At;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  u32At      = TRACE_u32Head;
+  u32Header |= TRACE_u32Seq++ << TRACE_SEQ_SHIFT;
+
+  if ( u32At + 1 + u32Args - TRACE_u32Tail > TRACE_RING_WORDS )
+  {
+    TRACE_u32Dropped++;
+    __set_interrupt_state( interrupt_state );
+    return;
+  }
+
+  TRACE_u32Head = u32At + 1 + u32Args;
+  __set_interrupt_state( interrupt_state );
+
+  if ( u32Args > 0 )
+  {
+    TRACE_u32Ring[( u32At + 1 ) & TRACE_MASK] = u32Arg0;
+  }
+
+  if ( u32Args > 1 )
+  {
+    TRACE_u32Ring[( u32At + 2 ) & TRACE_MASK] = u32Arg1;
+  }
+
+  if ( u32Args > 2 )
+  {
+    TRACE_u32Ring[( u32At + 3 ) & TRACE_MASK] = u32Arg2;
+  }
+
+  /* the header commits the record */
+  TRACE_u32Ring[u32At & TRACE_MASK] = u32Header;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  send committed records while the UART transmitter has room, never
+*         waits. Called from the main loop.
+*
+* @param[in]    pUART       trace port, initialized by the application.
+*
+* @return words still in the ring.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint32_t TRACE_Drain( UART_Type * pUART )
+{
+  uint32_t u32Word;
+
+  while ( pUART->S1 & UART_S1_TDRE_MASK )
+  {
+    u32Word = TRACE_u32Ring[TRACE_u32Tail & TRACE_MASK];
+
+    if ( TRACE_u32Left == 0 )
+    {
+      if ( u32Word == 0 )
+      {
+        break;                              /* empty, or the writer is not done */
+      }
+
+      TRACE_u32Left = 1 + ( ( u32Word & TRACE_ARGS_MASK ) >> TRACE_ARGS_SHIFT );
+    }
+
+    pUART->D = ( uint8_t )( u32Word >> ( TRACE_u8Byte << 3 ) );
+
+    if ( ++TRACE_u8Byte == 4 )
+    {
+      TRACE_u8Byte = 0;
+      TRACE_u32Ring[TRACE_u32Tail & TRACE_MASK] = 0;
+      TRACE_u32Tail++;
+      TRACE_u32Left--;
+    }
+  }
+
+  return TRACE_u32Head - TRACE_u32Tail;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  send all records from the main loop, e.g. before a reset.
+*
+* @param[in]    pUART       trace port.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void TRACE_Flush( UART_Type * pUART )
+{
+  while ( TRACE_Drain( pUART ) );
+
+  while ( !( pUART->S1 & UART_S1_TC_MASK ) );
+}
+/*! @} End of trace_api_list                                                  */
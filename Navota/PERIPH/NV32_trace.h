@@ -0,0 +1,89 @@
+/******************************************************************************
+* @brief header file for binary trace ring (TRACE).
+*
+*******************************************************************************
+*
+* provide macros for logging a format string address and up to three raw
+* arguments into a RAM ring, drained over UART and formatted on the host
+******************************************************************************/
+#ifndef __NV32_TRACE_H__
+#define __NV32_TRACE_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_uart.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+
+/*!
+* @brief record layout, little endian words on the UART:
+*
+*   word 0      bit 23 ~ 0   format string address in flash
+*               bit 25 ~ 24  number of argument words, 0 ~ 3
+*               bit 31 ~ 26  sequence number, a gap tells records were dropped
+*   word 1 ~ 3  arguments, as 32-bit values
+*
+* Test/host/trace_decode.py looks the address up in the ELF file of the
+* build to get the format string. A %s argument must point to a string
+* constant in flash, every argument is formatted as one 32-bit word.
+*/
+#define TRACE_FMT_MASK          0x00FFFFFFu
+#define TRACE_ARGS_SHIFT        24
+#define TRACE_ARGS_MASK         0x03000000u
+#define TRACE_SEQ_SHIFT         26
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/*!
+* @brief log a record. The format string is a literal, only its address is
+*        stored, formatting is left to the host. All are empty when
+*        TRACE_ENABLED is 0.
+*/
+#if ( TRACE_ENABLED > 0 )
+#define TRACE_HEADER(fmt, n)    ( ( ( uint32_t )( fmt ) & TRACE_FMT_MASK ) | ( ( n ) << TRACE_ARGS_SHIFT ) )
+#define TRACE0(fmt)             TRACE_Put( TRACE_HEADER( fmt, 0 ), 0, 0, 0 )
+#define TRACE1(fmt, a)          TRACE_Put( TRACE_HEADER( fmt, 1 ), ( uint32_t )( a ), 0, 0 )
+#define TRACE2(fmt, a, b)       TRACE_Put( TRACE_HEADER( fmt, 2 ), ( uint32_t )( a ), ( uint32_t )( b ), 0 )
+#define TRACE3(fmt, a, b, c)    TRACE_Put( TRACE_HEADER( fmt, 3 ), ( uint32_t )( a ), ( uint32_t )( b ), ( uint32_t )( c ) )
+#else
+#define TRACE0(fmt)
+#define TRACE1(fmt, a)
+#define TRACE2(fmt, a, b)
+#define TRACE3(fmt, a, b, c)
+#endif
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+extern uint32_t TRACE_u32Dropped;           /*!< records lost to a full ring */
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void TRACE_Init( void );
+void TRACE_Put( uint32_t u32Header, uint32_t u32Arg0, uint32_t u32Arg1, uint32_t u32Arg2 );
+uint32_t TRACE_Drain( UART_Type * pUART );
+void TRACE_Flush( UART_Type * pUART );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_TRACE_H__ */
@@ -0,0 +1,174 @@
+/******************************************************************************
+* @brief providing APIs for 64-bit timestamp counter (TSTAMP) on chained PIT.
+*
+*******************************************************************************
+*
+* PIT channel 0 free runs over the full 32-bit range and channel 1, in chain
+* mode, counts its expiries, together a 64-bit down counter of bus cycles.
+* Both PIT channels are used, so this service cannot run together with the
+* software timer wheel (NV32_swtimer) or other PIT users.
+*
+* The counter keeps counting bus cycles over a bus clock change, so a cycle
+* difference spanning one mixes both rates. TSTAMP_ClockUpdate, e.g. from the
+* CLKMGR_TstampNotify notifier, takes the us count up to the change at the
+* old rate and the conversion factors over to the new one, TSTAMP_GetUs then
+* keeps counting on within 1 us per change.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_tstamp.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+uint32_t TSTAMP_u32NsMulQ16;
+uint32_t TSTAMP_u32UsMulQ32;
+uint32_t TSTAMP_u32CyclesPerUs;
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static uint32_t TSTAMP_u32BusClock;         /* bus clock of the conversion */
+static uint64_t TSTAMP_u64BaseCycles;       /* timestamp of the last clock change */
+static uint64_t TSTAMP_u64BaseUs;           /* us up to the last clock change */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  precompute the conversion factors for the current bus clock.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void TSTAMP_SetRate( void )
+{
+  uint32_t u32BusClock = SystemClockGet( CLOCK_BUS );
+  TSTAMP_u32BusClock    = u32BusClock;
+  TSTAMP_u32NsMulQ16    = ( uint32_t )( ( ( ( uint64_t )1000000000 << 16 ) + ( u32BusClock >> 1 ) ) / u32BusClock );
+  TSTAMP_u32UsMulQ32    = ( uint32_t )( ( ( ( uint64_t )1000000 << 32 ) + ( u32BusClock >> 1 ) ) / u32BusClock );
+  TSTAMP_u32CyclesPerUs = u32BusClock / 1000000;
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* TSTAMP api lists
+*
+*//*! @addtogroup tstamp_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  start the 64-bit counter and precompute the conversion factors for
+*         the current bus clock.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void TSTAMP_Init( void )
+{
+  PIT_ConfigType sPITConfig = {0};
+  TSTAMP_SetRate();
+  TSTAMP_u64BaseCycles  = 0;
+  TSTAMP_u64BaseUs      = 0;
+  sPITConfig.u32LoadValue = 0xFFFFFFFF;
+  /* upper half first, so it is counting when the lower half starts */
+  sPITConfig.bChainMode = 1;
+  sPITConfig.bETMerEn   = 1;
+  PIT_Init( PIT_CHANNEL1, &sPITConfig );
+  sPITConfig.bChainMode = 0;
+  PIT_Init( PIT_CHANNEL0, &sPITConfig );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  stop the counter and release the PIT.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void TSTAMP_DeInit( void )
+{
+  PIT_DeInit();
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the time since TSTAMP_Init in us.
+*
+* @param  none.
+*
+* @return us.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint64_t TSTAMP_GetUs( void )
+{
+  uint64_t   u64Cycles;
+  uint64_t   u64Us;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  u64Cycles = TSTAMP_Get64() - TSTAMP_u64BaseCycles;
+  u64Us     = TSTAMP_u64BaseUs;
+  __set_interrupt_state( interrupt_state );
+
+  /* split, so neither the product overflows nor a bus clock below 1 MHz rounds to 0 */
+  return u64Us + ( u64Cycles / TSTAMP_u32BusClock ) * 1000000 +
+         ( ( u64Cycles % TSTAMP_u32BusClock ) * 1000000 ) / TSTAMP_u32BusClock;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  take the new bus clock, call right after it changed, e.g. from a
+*         CLKMGR_POST_CHANGE notifier. The time so far is taken at the old
+*         rate. Call with interrupts masked.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void TSTAMP_ClockUpdate( void )
+{
+  uint64_t u64Now    = TSTAMP_Get64();
+  uint64_t u64Cycles = u64Now - TSTAMP_u64BaseCycles;
+
+  TSTAMP_u64BaseUs    += ( u64Cycles / TSTAMP_u32BusClock ) * 1000000 +
+                         ( ( u64Cycles % TSTAMP_u32BusClock ) * 1000000 ) / TSTAMP_u32BusClock;
+  TSTAMP_u64BaseCycles = u64Now;
+  TSTAMP_SetRate();
+}
+
+/*! @} End of tstamp_api_list                                                 */
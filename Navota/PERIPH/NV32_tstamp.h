@@ -0,0 +1,149 @@
+/******************************************************************************
+* @brief header file for 64-bit timestamp counter (TSTAMP) on chained PIT.
+*
+*******************************************************************************
+*
+* provide APIs and macros for reading a free running 64-bit bus clock
+* counter and converting cycle counts to us/ns
+******************************************************************************/
+#ifndef __NV32_TSTAMP_H__
+#define __NV32_TSTAMP_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_pit.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/*! @brief 32-bit bus cycle timestamp, one register load, wraps every 2^32 cycles. */
+#define TIMESTAMP()             TSTAMP_Get32()
+
+/*! @brief 64-bit bus cycle timestamp, never wraps in practice. */
+#define TIMESTAMP64()           TSTAMP_Get64()
+
+/*! @brief bus cycles elapsed since a TIMESTAMP() value. */
+#define TIMESTAMP_ELAPSED(t)    ( TSTAMP_Get32() - ( uint32_t )( t ) )
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+extern uint32_t TSTAMP_u32NsMulQ16;       /*!< ns per cycle in Q16 */
+extern uint32_t TSTAMP_u32UsMulQ32;       /*!< us per cycle in Q32 */
+extern uint32_t TSTAMP_u32CyclesPerUs;    /*!< bus cycles per us */
+
+/*!
+ * inline functions
+ */
+/******************************************************************************
+* TSTAMP inline functions
+*
+*//*! @addtogroup tstamp_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  read the lower 32 bits of the timestamp. The PIT counts down, the
+*         complement counts up.
+*
+* @param  none.
+*
+* @return bus cycles since TSTAMP_Init, modulo 2^32.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE uint32_t TSTAMP_Get32( void )
+{
+  return ~PIT->CHANNEL[PIT_CHANNEL0].CVAL;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  read the 64-bit timestamp, safe from any context without masking
+*         interrupts: the upper half is read again to detect a carry.
+*
+* @param  none.
+*
+* @return bus cycles since TSTAMP_Init.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE uint64_t TSTAMP_Get64( void )
+{
+  uint32_t u32High;
+  uint32_t u32Low;
+
+  do
+  {
+    u32High = PIT->CHANNEL[PIT_CHANNEL1].CVAL;
+    u32Low  = PIT->CHANNEL[PIT_CHANNEL0].CVAL;
+  }
+  while ( u32High != PIT->CHANNEL[PIT_CHANNEL1].CVAL );
+
+  return ~( ( ( uint64_t )u32High << 32 ) | u32Low );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  convert a cycle count to ns with the precomputed multiplier.
+*
+* @param[in]    u32Cycles   bus cycles, e.g. a TIMESTAMP() difference.
+*
+* @return ns.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE uint64_t TSTAMP_CyclesToNs( uint32_t u32Cycles )
+{
+  return ( ( uint64_t )u32Cycles * TSTAMP_u32NsMulQ16 ) >> 16;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  convert a cycle count to us with the precomputed multiplier.
+*
+* @param[in]    u32Cycles   bus cycles, e.g. a TIMESTAMP() difference.
+*
+* @return us.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+__STATIC_INLINE uint32_t TSTAMP_CyclesToUs( uint32_t u32Cycles )
+{
+  return ( uint32_t )( ( ( uint64_t )u32Cycles * TSTAMP_u32UsMulQ32 ) >> 32 );
+}
+
+/*! @} End of tstamp_api_list                                                 */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void TSTAMP_Init( void );
+void TSTAMP_DeInit( void );
+uint64_t TSTAMP_GetUs( void );
+void TSTAMP_ClockUpdate( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_TSTAMP_H__ */
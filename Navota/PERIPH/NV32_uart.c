@@ -3,12 +3,19 @@
 *
 ******************************************************************************/
 #include "NV32_uart.h"
+#include "NV32_vector.h"
+#include "NV32_isrstat.h"
 #include "NV32_wdog.h"
+#include "NV32_BME.h"
 
 /******************************************************************************
 * Local variables
 ******************************************************************************/
+#ifdef UART_STATIC_CALLBACK
+void UART_STATIC_CALLBACK( UART_Type * pUART );
+#else
 UART_CallbackType UART_Callback = NULL;
+#endif
 /******************************************************************************
 * Local function prototypes
 ******************************************************************************/
@@ -167,35 +174,35 @@ void UART_EnableInterrupt( UART_Type * pUART, UART_InterruptType InterruptType )
 
   if ( InterruptType == UART_TxBuffEmptyInt )
   {
-    pUART->C2 |= UART_C2_TIE_MASK;
+    BME_REG_SET_8b( pUART->C2, UART_C2_TIE_MASK );
   }
   else if ( InterruptType == UART_TxCompleteInt )
   {
-    pUART->C2 |= UART_C2_TCIE_MASK;
+    BME_REG_SET_8b( pUART->C2, UART_C2_TCIE_MASK );
   }
   else if ( InterruptType == UART_RxBuffFullInt )
   {
-    pUART->C2 |= UART_C2_RIE_MASK;
+    BME_REG_SET_8b( pUART->C2, UART_C2_RIE_MASK );
   }
   else if ( InterruptType == UART_IdleLineInt )
   {
-    pUART->C2 |= UART_C2_ILIE_MASK;
+    BME_REG_SET_8b( pUART->C2, UART_C2_ILIE_MASK );
   }
   else if ( InterruptType == UART_RxOverrunInt )
   {
-    pUART->C3 |= UART_C3_ORIE_MASK;
+    BME_REG_SET_8b( pUART->C3, UART_C3_ORIE_MASK );
   }
   else if ( InterruptType == UART_NoiseErrorInt )
   {
-    pUART->C3 |= UART_C3_NEIE_MASK;
+    BME_REG_SET_8b( pUART->C3, UART_C3_NEIE_MASK );
   }
   else if ( InterruptType == UART_FramingErrorInt )
   {
-    pUART->C3 |= UART_C3_FEIE_MASK;
+    BME_REG_SET_8b( pUART->C3, UART_C3_FEIE_MASK );
   }
   else if ( InterruptType == UART_ParityErrorInt )
   {
-    pUART->C3 |= UART_C3_FEIE_MASK;
+    BME_REG_SET_8b( pUART->C3, UART_C3_FEIE_MASK );
   }
   else
   {
@@ -221,35 +228,35 @@ void UART_DisableInterrupt( UART_Type * pUART, UART_InterruptType InterruptType
 
   if ( InterruptType == UART_TxBuffEmptyInt )
   {
-    pUART->C2 &= ( ~UART_C2_TIE_MASK );
+    BME_REG_CLEAR_8b( pUART->C2, UART_C2_TIE_MASK );
   }
   else if ( InterruptType == UART_TxCompleteInt )
   {
-    pUART->C2 &= ( ~UART_C2_TCIE_MASK );
+    BME_REG_CLEAR_8b( pUART->C2, UART_C2_TCIE_MASK );
   }
   else if ( InterruptType == UART_RxBuffFullInt )
   {
-    pUART->C2 &= ( ~UART_C2_RIE_MASK );
+    BME_REG_CLEAR_8b( pUART->C2, UART_C2_RIE_MASK );
   }
   else if ( InterruptType == UART_IdleLineInt )
   {
-    pUART->C2 &= ( ~UART_C2_ILIE_MASK );
+    BME_REG_CLEAR_8b( pUART->C2, UART_C2_ILIE_MASK );
   }
   else if ( InterruptType == UART_RxOverrunInt )
   {
-    pUART->C3 &= ( ~UART_C3_ORIE_MASK );
+    BME_REG_CLEAR_8b( pUART->C3, UART_C3_ORIE_MASK );
   }
   else if ( InterruptType == UART_NoiseErrorInt )
   {
-    pUART->C3 &= ( ~UART_C3_NEIE_MASK );
+    BME_REG_CLEAR_8b( pUART->C3, UART_C3_NEIE_MASK );
   }
   else if ( InterruptType == UART_FramingErrorInt )
   {
-    pUART->C3 &= ( ~UART_C3_FEIE_MASK );
+    BME_REG_CLEAR_8b( pUART->C3, UART_C3_FEIE_MASK );
   }
   else if ( InterruptType == UART_ParityErrorInt )
   {
-    pUART->C3 &= ( ~UART_C3_FEIE_MASK );
+    BME_REG_CLEAR_8b( pUART->C3, UART_C3_FEIE_MASK );
   }
   else
   {
@@ -386,7 +393,19 @@ void UART_WaitTxComplete( UART_Type * pUART )
 void UART_SetCallback( UART_CallbackType pfnCallback )
 {
   //uint8_t    u8Port = ((uint32_t)pUART-(uint32_t)UART0)>>12;
+#ifdef UART_STATIC_CALLBACK
+  /* bound at link time, UARTx_IRQHandler calls UART_STATIC_CALLBACK */
+  ASSERT( ( pfnCallback == NULL ) || ( pfnCallback == UART_STATIC_CALLBACK ) );
+#else
   UART_Callback = pfnCallback;
+#if ( VECTOR_IN_RAM > 0 )
+  VECTOR_Install( UART0_IRQn, UART0_Isr );
+#if defined(CPU_NV32) | defined(CPU_NV326)
+  VECTOR_Install( UART1_IRQn, UART1_Isr );
+  VECTOR_Install( UART2_IRQn, UART2_Isr );
+#endif
+#endif
+#endif
 }
 
 
@@ -403,10 +422,21 @@ void UART_SetCallback( UART_CallbackType pfnCallback )
 *
 * @ Pass/ Fail criteria:
 *****************************************************************************/
+#ifdef UART_STATIC_CALLBACK
+void UART0_IRQHandler( void )
+{
+  ISRSTAT_ENTER( ISRSTAT_UART0 );
+  UART_STATIC_CALLBACK( UART0 );
+  ISRSTAT_EXIT( ISRSTAT_UART0 );
+}
+#else
 void UART0_Isr( void )
 {
+  ISRSTAT_ENTER( ISRSTAT_UART0 );
   UART_Callback( UART0 );
+  ISRSTAT_EXIT( ISRSTAT_UART0 );
 }
+#endif
 
 
 #if defined(CPU_NV32) | defined(CPU_NV326)
@@ -420,10 +450,21 @@ void UART0_Isr( void )
 *
 * @ Pass/ Fail criteria:
 *****************************************************************************/
+#ifdef UART_STATIC_CALLBACK
+void UART1_IRQHandler( void )
+{
+  ISRSTAT_ENTER( ISRSTAT_UART1 );
+  UART_STATIC_CALLBACK( UART1 );
+  ISRSTAT_EXIT( ISRSTAT_UART1 );
+}
+#else
 void UART1_Isr( void )
 {
+  ISRSTAT_ENTER( ISRSTAT_UART1 );
   UART_Callback( UART1 );
+  ISRSTAT_EXIT( ISRSTAT_UART1 );
 }
+#endif
 /*****************************************************************************//*!
 *
 * @brief uart2 interrupt service routine.
@@ -434,10 +475,21 @@ void UART1_Isr( void )
 *
 * @ Pass/ Fail criteria:
 *****************************************************************************/
+#ifdef UART_STATIC_CALLBACK
+void UART2_IRQHandler( void )
+{
+  ISRSTAT_ENTER( ISRSTAT_UART2 );
+  UART_STATIC_CALLBACK( UART2 );
+  ISRSTAT_EXIT( ISRSTAT_UART2 );
+}
+#else
 void UART2_Isr( void )
 {
+  ISRSTAT_ENTER( ISRSTAT_UART2 );
   UART_Callback( UART2 );
+  ISRSTAT_EXIT( ISRSTAT_UART2 );
 }
+#endif
 
 
 #endif
@@ -0,0 +1,158 @@
+/******************************************************************************
+* @brief providing APIs for RAM vector table (VECTOR).
+*
+*******************************************************************************
+*
+* VECTOR_Init copies the active vector table to RAM and points SCB->VTOR at
+* the copy. Drivers then install their handlers, or a callback that is all
+* their handler would call, straight into the table: no IRQHandler glue to
+* the driver _Isr functions and no callback array lookup in between.
+*
+* The table is __no_init, so SystemInit may call VECTOR_Init before the C
+* start up code initializes RAM. It takes 192 bytes, aligned to 256 as
+* VTOR needs for 48 entries.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_vector.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+#pragma data_alignment = 256
+static __no_init uint32_t VECTOR_u32Table[VECTOR_ENTRIES];
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/******************************************************************************
+* VECTOR api lists
+*
+*//*! @addtogroup vector_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  copy the active vector table to RAM and switch to it, nothing is
+*         done if the RAM table is active already.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void VECTOR_Init( void )
+{
+  uint32_t   *pSource = ( uint32_t * )SCB->VTOR;
+  uint8_t    i;
+  __istate_t interrupt_state;
+
+  if ( pSource == VECTOR_u32Table )
+  {
+    return;
+  }
+
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+
+  for ( i = 0; i < VECTOR_ENTRIES; i++ )
+  {
+    VECTOR_u32Table[i] = pSource[i];
+  }
+
+  SCB->VTOR = ( uint32_t )VECTOR_u32Table;
+  __DSB();
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  install an interrupt handler in the RAM table, the change takes
+*         effect with the next interrupt.
+*
+* @param[in]    eIRQ        interrupt, or a system exception such as
+*                           SysTick_IRQn.
+* @param[in]    pfnHandler  handler, NULL puts back the handler of the ROM
+*                           vector table.
+*
+* @return handler installed before.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+VECTOR_HandlerType VECTOR_Install( IRQn_Type eIRQ, VECTOR_HandlerType pfnHandler )
+{
+  extern uint32_t __vector_table[];
+  uint32_t u32Entry = VECTOR_EXCEPTIONS + eIRQ;
+  uint32_t u32Last;
+  ASSERT( ( u32Entry > 1 ) && ( u32Entry < VECTOR_ENTRIES ) );
+  ASSERT( VECTOR_IsInRam() );
+
+  if ( pfnHandler == NULL )
+  {
+    pfnHandler = ( VECTOR_HandlerType )__vector_table[u32Entry];
+  }
+
+  /* an aligned word store, an interrupt sees the old or the new handler */
+  u32Last = VECTOR_u32Table[u32Entry];
+  VECTOR_u32Table[u32Entry] = ( uint32_t )pfnHandler;
+  return ( VECTOR_HandlerType )u32Last;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  get the handler of an interrupt from the active vector table.
+*
+* @param[in]    eIRQ        interrupt or system exception.
+*
+* @return handler.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+VECTOR_HandlerType VECTOR_GetHandler( IRQn_Type eIRQ )
+{
+  uint32_t u32Entry = VECTOR_EXCEPTIONS + eIRQ;
+  ASSERT( ( u32Entry > 1 ) && ( u32Entry < VECTOR_ENTRIES ) );
+  return ( VECTOR_HandlerType )( ( uint32_t * )SCB->VTOR )[u32Entry];
+}
+
+/*****************************************************************************//*!
+*
+* @brief  check whether the RAM vector table is active.
+*
+* @param  none.
+*
+* @return TRUE or FALSE.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t VECTOR_IsInRam( void )
+{
+  return ( SCB->VTOR == ( uint32_t )VECTOR_u32Table );
+}
+/*! @} End of vector_api_list                                                 */
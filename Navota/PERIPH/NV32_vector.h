@@ -0,0 +1,65 @@
+/******************************************************************************
+* @brief header file for RAM vector table (VECTOR).
+*
+*******************************************************************************
+*
+* provide APIs for moving the vector table to RAM and installing interrupt
+* handlers in it at run time
+******************************************************************************/
+#ifndef __NV32_VECTOR_H__
+#define __NV32_VECTOR_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define VECTOR_EXCEPTIONS       16          /*!< system exceptions, IRQn_Type starts after them */
+#define VECTOR_ENTRIES          48          /*!< initial SP, 15 exceptions and 32 interrupts */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/*!
+* @brief vector of a routine that only calls its callback: the callback
+*        itself, or the routine when there is no callback or the routine
+*        is instrumented by ISRSTAT.
+*/
+#define VECTOR_DIRECT(pfnCallback, pfnIsr)  \
+    ( ( ( pfnCallback ) && !ISRSTAT_ENABLED ) ? ( VECTOR_HandlerType )( pfnCallback ) : ( pfnIsr ) )
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/*! @brief interrupt handler */
+typedef void ( *VECTOR_HandlerType )( void );
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void VECTOR_Init( void );
+VECTOR_HandlerType VECTOR_Install( IRQn_Type eIRQ, VECTOR_HandlerType pfnHandler );
+VECTOR_HandlerType VECTOR_GetHandler( IRQn_Type eIRQ );
+uint8_t VECTOR_IsInRam( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_VECTOR_H__ */
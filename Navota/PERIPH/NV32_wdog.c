@@ -243,6 +243,7 @@ void WDOG_DeInit( void )
 void WDOG_Feed( void )
 {
   __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
   WDOG->CNT = 0x02A6;
   WDOG->CNT = 0x80B4;
   __set_interrupt_state(interrupt_state);
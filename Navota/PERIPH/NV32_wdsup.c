@@ -0,0 +1,316 @@
+/******************************************************************************
+* @brief providing APIs for watchdog supervisor (WDSUP).
+*
+*******************************************************************************
+*
+* Every supervised task or interrupt service routine registers with a
+* deadline, in supervisor periods, and a token. It calls WDSUP_CheckIn with
+* the token when it has done its work. WDSUP_Service, called once per
+* period, e.g. from a software timer, refreshes the watchdog only when no
+* task is later than its deadline. A late task, or one checking in with a
+* token not its own, which tells that the code jumped where it should not,
+* resets at once through an invalid refresh.
+*
+* The watchdog runs from the 1 kHz LPO in window mode, a refresh earlier
+* than the window resets too, so a loop running away around WDSUP_Service
+* does not keep the watchdog alive. Its interrupt notes what was missing
+* in the 128 bus clocks left before a timeout or window reset.
+*
+* The cause and the task are kept in RAM the C startup does not clear,
+* WDSUP_Init hands them to the application after the reset. Behind the
+* bootloader that is NOINIT_region of the NV32F100_Slot*.icf files, which
+* the bootloader leaves alone. Blind
+* refreshes, as UART_SendWait does with ENABLE_WDOG, defeat the supervisor
+* and the window, so ENABLE_WDOG must not be defined with it.
+*
+* The module, with its Watchdog_IRQHandler, is compiled only when
+* WDSUP_ENABLED is set in NV32_config.h, an application with a watchdog
+* handler of its own leaves it 0.
+******************************************************************************/
+#include "NV32_config.h"
+#include "NV32_wdsup.h"
+
+#if ( WDSUP_ENABLED > 0 )
+
+#if defined(ENABLE_WDOG)
+#error "ENABLE_WDOG refreshes the watchdog from UART loops, remove it when using WDSUP"
+#endif
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define WDSUP_MAGIC             0x57445355  /*!< "WDSU" */
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static __no_init WDSUP_RecordType WDSUP_sRecord;
+
+static uint32_t WDSUP_u32Token[WDSUP_TASKS];
+static uint16_t WDSUP_u16Deadline[WDSUP_TASKS];
+static uint16_t WDSUP_u16Age[WDSUP_TASKS];     /*!< periods since the last check in */
+static uint32_t WDSUP_u32Registered;
+static volatile uint32_t WDSUP_u32Arrived;      /*!< checked in this period */
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  tasks late at this moment.
+*
+* @param  none.
+*
+* @return bit per task.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static uint32_t WDSUP_Missing( void )
+{
+  uint32_t u32Missing = 0;
+  uint8_t  i;
+
+  for ( i = 0; i < WDSUP_TASKS; i++ )
+  {
+    if ( WDSUP_u16Age[i] > 0 )
+    {
+      u32Missing |= 1UL << i;
+    }
+  }
+
+  return u32Missing & WDSUP_u32Registered & ~WDSUP_u32Arrived;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  record the fault and reset, does not return.
+*
+* @param[in]    u8Cause     WDSUP_CAUSE_DEADLINE or WDSUP_CAUSE_TOKEN.
+* @param[in]    u8Task      offending task.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+static void WDSUP_Fail( uint8_t u8Cause, uint8_t u8Task )
+{
+  __disable_interrupt();
+
+  WDSUP_sRecord.u8Cause    = u8Cause;
+  WDSUP_sRecord.u8Task     = u8Task;
+  WDSUP_sRecord.u32Missing = WDSUP_Missing();
+  WDSUP_sRecord.u16Resets++;
+
+  /* a wrong refresh sequence resets at once */
+  WDOG->CNT = 0;
+  NVIC_SystemReset();
+}
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  watchdog interrupt, 128 bus clocks before the watchdog resets.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void Watchdog_IRQHandler( void )
+{
+  WDSUP_sRecord.u8Cause    = WDSUP_CAUSE_WATCHDOG;
+  WDSUP_sRecord.u8Task     = WDSUP_NONE;
+  WDSUP_sRecord.u32Missing = WDSUP_Missing();
+  WDSUP_sRecord.u16Resets++;
+
+  while ( 1 );
+}
+
+/******************************************************************************
+* WDSUP api lists
+*
+*//*! @addtogroup wdsup_api_list
+* @{
+*******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief  start the watchdog under the supervisor. The watchdog control is
+*         locked until the next reset, so SystemInit must have left it
+*         updatable (WDOG_ENABLED).
+*
+* @param[in]    pConfig     watchdog timing.
+* @param[out]   pLast       fault recorded before the last reset.
+*
+* @return TRUE when the last reset was the supervisor's, pLast is then
+*         filled.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+uint8_t WDSUP_Init( WDSUP_ConfigType * pConfig, WDSUP_RecordType * pLast )
+{
+  WDOG_ConfigType sWdog = {
+    0 };
+  uint8_t         bFault = FALSE;
+  uint8_t         i;
+
+  ASSERT( WDOG->CS1 & WDOG_CS1_UPDATE_MASK );
+  ASSERT( pConfig->u16WindowMs < pConfig->u16TimeoutMs );
+
+  if ( ( WDSUP_sRecord.u32Magic != WDSUP_MAGIC ) || SIM_GetStatus( SIM_SRSID_POR_MASK ) )
+  {
+    WDSUP_sRecord.u32Magic  = WDSUP_MAGIC;
+    WDSUP_sRecord.u16Resets = 0;
+    WDSUP_sRecord.u8Cause   = WDSUP_CAUSE_NONE;
+  }
+
+  if ( ( WDSUP_sRecord.u8Cause != WDSUP_CAUSE_NONE ) &&
+       SIM_GetStatus( SIM_SRSID_WDOG_MASK | SIM_SRSID_SW_MASK ) )
+  {
+    *pLast = WDSUP_sRecord;
+    bFault = TRUE;
+  }
+
+  WDSUP_sRecord.u8Cause = WDSUP_CAUSE_NONE;
+
+  for ( i = 0; i < WDSUP_TASKS; i++ )
+  {
+    WDSUP_u16Age[i] = 0;
+  }
+
+  WDSUP_u32Registered = 0;
+  WDSUP_u32Arrived    = 0;
+
+  sWdog.sBits.bIntEnable = 1;
+  sWdog.sBits.bWinEnable = ( pConfig->u16WindowMs > 0 );
+  sWdog.sBits.bClkSrc    = WDOG_CLK_INTERNAL_1KHZ;
+  sWdog.u16ETMeOut       = pConfig->u16TimeoutMs;
+  sWdog.u16WinETMe       = pConfig->u16WindowMs;
+  WDOG_Init( &sWdog );
+  NVIC_EnableIRQ( Watchdog_IRQn );
+
+  return bFault;
+}
+
+/*****************************************************************************//*!
+*
+* @brief  add a task to the supervision.
+*
+* @param[in]    u8Task      0 ~ WDSUP_TASKS - 1.
+* @param[in]    u16Deadline supervisor periods within which it checks in.
+* @param[in]    u32Token    value it checks in with.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void WDSUP_Register( uint8_t u8Task, uint16_t u16Deadline, uint32_t u32Token )
+{
+  __istate_t interrupt_state;
+
+  ASSERT( u8Task < WDSUP_TASKS );
+  ASSERT( u16Deadline > 0 );
+
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  WDSUP_u32Token[u8Task]    = u32Token;
+  WDSUP_u16Deadline[u8Task] = u16Deadline;
+  WDSUP_u16Age[u8Task]      = 0;
+  WDSUP_u32Registered      |= 1UL << u8Task;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  check in, from a task or an interrupt service routine.
+*
+* @param[in]    u8Task      registered task.
+* @param[in]    u32Token    its token, a wrong one resets.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void WDSUP_CheckIn( uint8_t u8Task, uint32_t u32Token )
+{
+  __istate_t interrupt_state;
+
+  if ( ( u8Task >= WDSUP_TASKS ) || !( WDSUP_u32Registered & ( 1UL << u8Task ) ) ||
+       ( u32Token != WDSUP_u32Token[u8Task] ) )
+  {
+    WDSUP_Fail( WDSUP_CAUSE_TOKEN, u8Task );
+  }
+
+  interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  WDSUP_u32Arrived |= 1UL << u8Task;
+  __set_interrupt_state( interrupt_state );
+}
+
+/*****************************************************************************//*!
+*
+* @brief  age the tasks not checked in and refresh the watchdog when none is
+*         late. Called once per period, after the window opened.
+*
+* @param  none.
+*
+* @return none.
+*
+* @ Pass/ Fail criteria: none.
+*
+*****************************************************************************/
+void WDSUP_Service( void )
+{
+  uint32_t   u32Arrived;
+  uint8_t    i;
+  __istate_t interrupt_state = __get_interrupt_state();
+  __disable_interrupt();
+  u32Arrived       = WDSUP_u32Arrived;
+  WDSUP_u32Arrived = 0;
+  __set_interrupt_state( interrupt_state );
+
+  for ( i = 0; i < WDSUP_TASKS; i++ )
+  {
+    if ( !( WDSUP_u32Registered & ( 1UL << i ) ) )
+    {
+      continue;
+    }
+
+    if ( u32Arrived & ( 1UL << i ) )
+    {
+      WDSUP_u16Age[i] = 0;
+    }
+    else if ( ++WDSUP_u16Age[i] >= WDSUP_u16Deadline[i] )
+    {
+      WDSUP_Fail( WDSUP_CAUSE_DEADLINE, i );
+    }
+  }
+
+  WDOG_Feed();
+}
+/*! @} End of wdsup_api_list                                                  */
+
+#endif /* WDSUP_ENABLED */
@@ -0,0 +1,93 @@
+/******************************************************************************
+* @brief header file for watchdog supervisor (WDSUP).
+*
+*******************************************************************************
+*
+* provide APIs for tasks and interrupt service routines to check in with
+* the supervisor, which refreshes the windowed watchdog only when all of
+* them arrived within their deadlines
+******************************************************************************/
+#ifndef __NV32_WDSUP_H__
+#define __NV32_WDSUP_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include "NV32.h"
+#include "NV32_wdog.h"
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define WDSUP_NONE              0xFF        /*!< no task */
+
+/*! @brief cause of a supervisor reset */
+enum
+{
+  WDSUP_CAUSE_NONE = 0,
+  WDSUP_CAUSE_DEADLINE,       /*!< a task missed its deadline */
+  WDSUP_CAUSE_TOKEN,          /*!< a task checked in with a wrong token */
+  WDSUP_CAUSE_WATCHDOG        /*!< watchdog interrupt, WDSUP_Service stopped or ran before the window */
+};
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/******************************************************************************
+* Types
+******************************************************************************/
+
+/******************************************************************************
+* WDSUP configure struct.
+*
+*//*! @addtogroup wdsup_configstruct
+* @{
+*******************************************************************************/
+/*!
+* @brief watchdog timing, in ms of the 1 kHz LPO. WDSUP_Service is called
+*        once per period, which falls between the window and the timeout.
+*/
+typedef struct
+{
+  uint16_t      u16TimeoutMs;       /*!< reset when not refreshed for this long */
+  uint16_t      u16WindowMs;        /*!< reset when refreshed earlier than this, 0: no window */
+} WDSUP_ConfigType, *WDSUP_ConfigPtr;
+
+/*!
+* @brief what the supervisor left before resetting, in RAM kept over reset.
+*/
+typedef struct
+{
+  uint32_t      u32Magic;           /*!< valid when WDSUP_MAGIC */
+  uint8_t       u8Cause;            /*!< WDSUP_CAUSE_DEADLINE ~ WDSUP_CAUSE_WATCHDOG */
+  uint8_t       u8Task;             /*!< offending task, WDSUP_NONE for the watchdog interrupt */
+  uint16_t      u16Resets;          /*!< supervisor resets since power on */
+  uint32_t      u32Missing;         /*!< tasks not checked in at the time, bit per task */
+} WDSUP_RecordType, *WDSUP_RecordPtr;
+/*! @} End of wdsup_configstruct                                              */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+
+/*!
+ * inline functions
+ */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+uint8_t WDSUP_Init( WDSUP_ConfigType * pConfig, WDSUP_RecordType * pLast );
+void WDSUP_Register( uint8_t u8Task, uint16_t u16Deadline, uint32_t u32Token );
+void WDSUP_CheckIn( uint8_t u8Task, uint32_t u32Token );
+void WDSUP_Service( void );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __NV32_WDSUP_H__ */
@@ -0,0 +1,75 @@
+#!/bin/sh
+#
+# build the drivers of Navota/PERIPH with gcc against the register model of
+# Test/host and run the tests:
+#
+#   Test/build.sh                   every Test/test_*.c
+#   Test/build.sh Test/test_qenc.c  the ones named
+#
+# Each test gets its own copy of the sources in Test/_build/<test>/src, with
+# USE_FULL_ASSERT on and the NV32_config.h lines a test asks for in its
+# comments with
+#
+#   HOST_CONFIG: NAME value
+#
+# A line commented out there, as the *_STATIC_CALLBACK ones, is turned on.
+#
+# The host build links every driver like the IAR project does, at addresses
+# under 4 GB (-no-pie) so the pointer casts to uint32_t of the drivers hold.
+#
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=$ROOT/Test/_build
+CC=${CC:-gcc}
+CFLAGS="-std=gnu99 -O1 -g -fno-strict-aliasing -Wno-unknown-pragmas \
+ -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast -Wno-main"
+
+if [ $# -eq 0 ]; then
+  set -- "$ROOT"/Test/test_*.c
+fi
+
+failed=0
+
+for test in "$@"; do
+  name=$(basename "$test" .c)
+  src=$OUT/$name/src
+  rm -rf "$OUT/$name"
+  mkdir -p "$src"
+
+  cp "$ROOT"/Navota/PERIPH/* "$src"
+  cp "$ROOT"/Navota/CMSIS/NV32.h "$ROOT"/Navota/CMSIS/system_nv32.h "$ROOT"/Navota/CMSIS/system_NV32.c "$src"
+  # IAR on Windows does not mind the case of these names
+  cp "$src/system_nv32.h" "$src/system_NV32.h"
+  cp "$src/NV32_etm.h" "$src/NV32_ETM.h"
+
+  sed -i 's|^//#define USE_FULL_ASSERT|#define USE_FULL_ASSERT|' "$src/NV32_config.h"
+  sed -n 's|.*HOST_CONFIG: *\([A-Za-z0-9_]*\) *\([^*]*[^* ]\).*|\1 \2|p' "$test" |
+  while read -r macro value; do
+    if grep -q "^\(//\)\?#define $macro[ (]" "$src/NV32_config.h"; then
+      LC_ALL=C sed -i "s|^\(//\)\?#define $macro\([ (].*\)\?$|#define $macro              ( $value )|" "$src/NV32_config.h"
+    else
+      echo "$name: $macro is not in NV32_config.h" >&2
+      exit 1
+    fi
+  done
+
+  objs=
+  for c in "$src"/*.c "$ROOT/Test/host/host.c" "$test"; do
+    o=$OUT/$name/$(basename "$c" .c).o
+    case $c in
+      "$src"/*) warn= ;;
+      *) warn=-Wall ;;
+    esac
+    $CC $CFLAGS $warn -I "$ROOT/Test/host" -I "$src" -c "$c" -o "$o"
+    objs="$objs $o"
+  done
+  $CC -no-pie -o "$OUT/$name/$name" $objs
+
+  echo "== $name"
+  if ! "$OUT/$name/$name"; then
+    failed=1
+  fi
+done
+
+exit $failed
@@ -0,0 +1,225 @@
+/******************************************************************************
+* @brief Cortex-M0+ core peripherals for the host build of the drivers.
+*
+*******************************************************************************
+*
+* SCB, SysTick and NVIC sit at their target addresses in the register model,
+* the functions CMSIS implements with instructions call into the model
+******************************************************************************/
+#ifndef __HOST_CORE_CM0PLUS_H__
+#define __HOST_CORE_CM0PLUS_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define __I                     volatile const
+#define __O                     volatile
+#define __IO                    volatile
+#define __ASM                   __asm__
+#define __INLINE                inline
+#define __STATIC_INLINE         static inline
+
+#define __CM0PLUS_REV           0x0000
+#define __NVIC_PRIO_BITS        2
+
+typedef struct
+{
+  __I  uint32_t CPUID;
+  __IO uint32_t ICSR;
+  __IO uint32_t VTOR;
+  __IO uint32_t AIRCR;
+  __IO uint32_t SCR;
+  __IO uint32_t CCR;
+       uint32_t RESERVED0;
+  __IO uint32_t SHP[2];
+  __IO uint32_t SHCSR;
+} SCB_Type;
+
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+  __I  uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+  __IO uint32_t ISER[1];
+       uint32_t RESERVED0[31];
+  __IO uint32_t ICER[1];
+       uint32_t RSERVED1[31];
+  __IO uint32_t ISPR[1];
+       uint32_t RESERVED2[31];
+  __IO uint32_t ICPR[1];
+       uint32_t RESERVED3[31];
+       uint32_t RESERVED4[64];
+  __IO uint32_t IP[8];
+} NVIC_Type;
+
+#define SCS_BASE                ( 0xE000E000UL )
+#define SysTick_BASE            ( SCS_BASE +  0x0010UL )
+#define NVIC_BASE               ( SCS_BASE +  0x0100UL )
+#define SCB_BASE                ( SCS_BASE +  0x0D00UL )
+
+#define SCB                     ( ( SCB_Type * )SCB_BASE )
+#define SysTick                 ( ( SysTick_Type * )SysTick_BASE )
+#define NVIC                    ( ( NVIC_Type * )NVIC_BASE )
+
+#define SCB_ICSR_PENDSTSET_Msk      ( 1UL << 26 )
+#define SCB_ICSR_PENDSTCLR_Msk      ( 1UL << 25 )
+#define SCB_ICSR_VECTACTIVE_Msk     ( 0x1FFUL )
+#define SCB_AIRCR_VECTKEY_Pos       16
+#define SCB_AIRCR_VECTKEY_Msk       ( 0xFFFFUL << SCB_AIRCR_VECTKEY_Pos )
+#define SCB_AIRCR_SYSRESETREQ_Msk   ( 1UL << 2 )
+#define SCB_SCR_SEVONPEND_Msk       ( 1UL << 4 )
+#define SCB_SCR_SLEEPDEEP_Msk       ( 1UL << 2 )
+#define SCB_SCR_SLEEPONEXIT_Msk     ( 1UL << 1 )
+
+#define SysTick_CTRL_COUNTFLAG_Msk  ( 1UL << 16 )
+#define SysTick_CTRL_CLKSOURCE_Msk  ( 1UL << 2 )
+#define SysTick_CTRL_TICKINT_Msk    ( 1UL << 1 )
+#define SysTick_CTRL_ENABLE_Msk     ( 1UL << 0 )
+#define SysTick_LOAD_RELOAD_Msk     ( 0xFFFFFFUL )
+#define SysTick_VAL_CURRENT_Msk     ( 0xFFFFFFUL )
+
+void HOST_Reset( uint32_t u32Cause );
+uint32_t HOST_Ipsr( void );
+
+#define _BIT_SHIFT( IRQn )      ( ( ( ( uint32_t )( IRQn ) ) & 0x03 ) * 8 )
+#define _SHP_IDX( IRQn )        ( ( ( ( ( uint32_t )( IRQn ) & 0x0F ) - 8 ) >> 2 ) )
+#define _IP_IDX( IRQn )         ( ( ( uint32_t )( IRQn ) >> 2 ) )
+
+static inline void NVIC_EnableIRQ( int IRQn )
+{
+  NVIC->ISER[0] = ( 1UL << ( ( uint32_t )IRQn & 0x1F ) );
+}
+
+static inline void NVIC_DisableIRQ( int IRQn )
+{
+  NVIC->ICER[0] = ( 1UL << ( ( uint32_t )IRQn & 0x1F ) );
+}
+
+static inline uint32_t NVIC_GetPendingIRQ( int IRQn )
+{
+  return ( ( NVIC->ISPR[0] & ( 1UL << ( ( uint32_t )IRQn & 0x1F ) ) ) ? 1 : 0 );
+}
+
+static inline void NVIC_SetPendingIRQ( int IRQn )
+{
+  NVIC->ISPR[0] = ( 1UL << ( ( uint32_t )IRQn & 0x1F ) );
+}
+
+static inline void NVIC_ClearPendingIRQ( int IRQn )
+{
+  NVIC->ICPR[0] = ( 1UL << ( ( uint32_t )IRQn & 0x1F ) );
+}
+
+static inline void NVIC_SetPriority( int IRQn, uint32_t priority )
+{
+  if ( IRQn < 0 )
+  {
+    SCB->SHP[_SHP_IDX( IRQn )] = ( SCB->SHP[_SHP_IDX( IRQn )] & ~( 0xFFUL << _BIT_SHIFT( IRQn ) ) ) |
+                                 ( ( ( priority << ( 8 - __NVIC_PRIO_BITS ) ) & 0xFF ) << _BIT_SHIFT( IRQn ) );
+  }
+  else
+  {
+    NVIC->IP[_IP_IDX( IRQn )] = ( NVIC->IP[_IP_IDX( IRQn )] & ~( 0xFFUL << _BIT_SHIFT( IRQn ) ) ) |
+                                ( ( ( priority << ( 8 - __NVIC_PRIO_BITS ) ) & 0xFF ) << _BIT_SHIFT( IRQn ) );
+  }
+}
+
+static inline uint32_t NVIC_GetPriority( int IRQn )
+{
+  if ( IRQn < 0 )
+    return ( ( SCB->SHP[_SHP_IDX( IRQn )] >> _BIT_SHIFT( IRQn ) ) & 0xFF ) >> ( 8 - __NVIC_PRIO_BITS );
+
+  return ( ( NVIC->IP[_IP_IDX( IRQn )] >> _BIT_SHIFT( IRQn ) ) & 0xFF ) >> ( 8 - __NVIC_PRIO_BITS );
+}
+
+static inline void NVIC_SystemReset( void )
+{
+  HOST_Reset( 0 );
+}
+
+static inline uint32_t SysTick_Config( uint32_t ticks )
+{
+  if ( ticks > SysTick_LOAD_RELOAD_Msk )
+    return 1;
+
+  SysTick->LOAD = ( ticks & SysTick_LOAD_RELOAD_Msk ) - 1;
+  SysTick->VAL  = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+  return 0;
+}
+
+static inline uint32_t __get_PRIMASK( void )
+{
+  extern volatile uint32_t HOST_u32Primask;
+
+  return HOST_u32Primask;
+}
+
+static inline void __set_PRIMASK( uint32_t priMask )
+{
+  extern void HOST_SetPrimask( uint32_t u32Primask );
+
+  HOST_SetPrimask( priMask );
+}
+
+static inline uint32_t __get_IPSR( void )
+{
+  return HOST_Ipsr( );
+}
+
+static inline void __enable_irq( void )
+{
+  __set_PRIMASK( 0 );
+}
+
+static inline void __disable_irq( void )
+{
+  extern volatile uint32_t HOST_u32Primask;
+
+  HOST_u32Primask = 1;
+}
+
+static inline uint32_t __get_MSP( void )
+{
+  return 0;
+}
+
+static inline void __set_MSP( uint32_t topOfMainStack )
+{
+  ( void )topOfMainStack;
+}
+
+static inline void __NOP( void )
+{
+}
+
+static inline void __DSB( void )
+{
+}
+
+static inline void __ISB( void )
+{
+}
+
+static inline void __DMB( void )
+{
+}
+
+static inline void __WFI( void )
+{
+  extern void HOST_Asm( const char * pInstruction );
+
+  HOST_Asm( "WFI" );
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __HOST_CORE_CM0PLUS_H__ */
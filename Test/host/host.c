@@ -0,0 +1,2616 @@
+/******************************************************************************
+******************************************************************************
+*
+* @file host.c
+*
+* @brief register model running the drivers on a Linux host.
+*
+*******************************************************************************
+*
+* The peripheral blocks, the core peripherals, MCM and FGPIO are one shared
+* memory object mapped twice: at the NV32.h addresses with no access, and
+* anywhere with full access for the models. A driver access faults, the
+* SIGSEGV handler lets the model time pass and refreshes the registers,
+* opens the page and single steps the instruction; the SIGTRAP handler closes
+* the page again and hands what was written to the model. The flash is
+* mapped read only, a store to it is latched for the EFM as on the target.
+*
+* The model clock counts core clocks: HOST_u32AccessClocks per peripheral
+* access, 1 per instruction between HOST_StepBegin and HOST_StepEnd, and the
+* exception entry and return. One instruction polling a register that does
+* not change skips ahead to the next model event. Interrupts the models raise
+* are pended in the NVIC model and taken at the next access, HOST_IrqEntry
+* returning with iretq to the interrupted instruction and stack, or when
+* PRIMASK is cleared. The handlers are those of the vector table at SCB->VTOR, which
+* after reset is __vector_table built from the handler names of
+* startup_NV32.s.
+*
+* Timing of the models, the numbers the datasheet gives as typical:
+* ETM counting ICSOUT or the TCLK edges of HOST_EtmClock, UART 10 or 11 bits of 16 x SBR bus clocks, SPI 8 bits
+* at the BR divider, ADC 20 ADCK (+20 long sample) + 5 bus clocks, program
+* 10 us a longword, erase 4.5 ms a sector and 35 ms all, crystal start up
+* 1 ms, FLL lock 1 ms.
+* The RAM of the host process is kept over a model reset like the target RAM
+* is, the code has to initialise what it relies on.
+*
+******************************************************************************/
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "NV32.h"
+#include "NV32_flash.h"
+#include "host.h"
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+volatile uint32_t HOST_u32Primask;
+volatile uint64_t HOST_u64Clock;
+volatile uint64_t HOST_u64Ps;
+uint32_t HOST_u32AccessClocks = 3;
+uint32_t HOST_u32ExtalHz = EXTAL_CLK_FREQ_KHZ * 1000UL;
+uint32_t HOST_u32RtcExtHz = 32768;
+uint32_t HOST_u32OscStartUs = 1000;
+uint32_t HOST_u32FllLockUs = 1000;
+uint32_t HOST_u32Failures;
+
+uint32_t __vector_table[48];
+
+/******************************************************************************
+* Constants and macros
+******************************************************************************/
+#define HOST_PAGE               0x1000UL
+#define HOST_PERIPH_BASE        0x40000000UL
+#define HOST_PERIPH_SIZE        0x00100000UL
+#define HOST_GPIO_PAGE          0x400FF000UL
+#define HOST_SCS_PAGE           0xE000E000UL
+#define HOST_MCM_PAGE           0xF0003000UL
+#define HOST_FGPIO_PAGE         0xF8000000UL
+#define HOST_REGS_SIZE          ( HOST_PERIPH_SIZE + 2 * HOST_PAGE )
+
+/* page 0 can not be mapped on Linux, flash addresses under 0x1000 fault */
+#define HOST_FLASH_SIZE         0x20000UL
+#define HOST_FLASH_MAPPED       HOST_PAGE
+
+#define HOST_TF                 0x100       /* x86 trap flag */
+#define HOST_THREAD             0x100       /* priority of thread mode */
+#define HOST_ENTRY_CLOCKS       15          /* Cortex-M0+ exception entry */
+#define HOST_RETURN_CLOCKS      13          /* Cortex-M0+ exception return */
+#define HOST_EVENTS             64
+#define HOST_UART_QUEUE         8192
+#define HOST_NONE               0xFFFFFFFFFFFFFFFFULL
+
+#define HOST_PROGRAM_US         10
+#define HOST_ERASE_SECTOR_US    4500
+#define HOST_ERASE_ALL_US       35000
+
+/* backdoor access to a register, by its NV32.h lvalue */
+#define HOST_R8( reg )          ( *( volatile uint8_t * )HOST_Reg( ( uint32_t )( uintptr_t )&( reg ) ) )
+#define HOST_R16( reg )         ( *( volatile uint16_t * )HOST_Reg( ( uint32_t )( uintptr_t )&( reg ) ) )
+#define HOST_R32( reg )         ( *( volatile uint32_t * )HOST_Reg( ( uint32_t )( uintptr_t )&( reg ) ) )
+#define HOST_AT( reg )          ( ( uint32_t )( uintptr_t )&( reg ) )
+
+#define HOST_HANDLERS( X ) \
+  X( NMI_Handler ) X( HardFault_Handler ) X( SVC_Handler ) X( PendSV_Handler ) X( SysTick_Handler ) \
+  X( ETMRH_IRQHandler ) X( LVD_LVW_IRQHandler ) X( IRQ_IRQHandler ) X( I2C0_IRQHandler ) \
+  X( SPI0_IRQHandler ) X( SPI1_IRQHandler ) X( UART0_IRQHandler ) X( UART1_IRQHandler ) \
+  X( UART2_IRQHandler ) X( ADC0_IRQHandler ) X( ACMP0_IRQHandler ) X( ETM0_IRQHandler ) \
+  X( ETM1_IRQHandler ) X( ETM2_IRQHandler ) X( RTC_IRQHandler ) X( ACMP1_IRQHandler ) \
+  X( PIT_CH0_IRQHandler ) X( PIT_CH1_IRQHandler ) X( KBI0_IRQHandler ) X( KBI1_IRQHandler ) \
+  X( ICS_IRQHandler ) X( Watchdog_IRQHandler )
+
+#define HOST_WEAK( name )       void name( void ) __attribute__( ( weak ) );
+HOST_HANDLERS( HOST_WEAK )
+
+/******************************************************************************
+* Local types
+******************************************************************************/
+typedef struct
+{
+  uint32_t      u32Address;         /* faulting address */
+  uint8_t       u8Width;            /* bytes accessed */
+  uint8_t       bWrite;             /* a store */
+  uint8_t       bFlash;             /* to the flash */
+  uint8_t       au8Old[8];          /* contents before */
+} HOST_AccessType;
+
+typedef struct
+{
+  uint64_t        u64Clock;
+  HOST_EventType  pfnEvent;
+  void            *pArg;
+} HOST_TimedType;
+
+typedef struct
+{
+  uint8_t         u8S1;             /* TDRE, TC, RDRF and OR */
+  uint8_t         u8Rx;
+  uint8_t         bShift;
+  uint8_t         u8Shift;
+  uint8_t         bHold;
+  uint8_t         u8Hold;
+  uint64_t        u64TxEnd;         /* bus clock the shifter is done */
+  uint64_t        u64RxAt;          /* bus clock the next byte is in, 0 idle */
+  uint32_t        u32Head;
+  uint32_t        u32Tail;
+  uint8_t         au8Queue[HOST_UART_QUEUE];
+  HOST_UartTxType pfnTx;
+} HOST_UartType;
+
+typedef struct
+{
+  uint8_t           u8S;
+  uint8_t           u8Rx;
+  uint8_t           bBusy;
+  uint8_t           u8Tx;
+  uint8_t           bHold;
+  uint8_t           u8Hold;
+  uint64_t          u64End;
+  HOST_SpiSlaveType pfnSlave;
+} HOST_SpiType;
+
+typedef struct
+{
+  uint8_t       au8Channel[8];      /* FIFO of channels to convert */
+  uint8_t       u8Channels;
+  uint16_t      au16Result[8];
+  uint8_t       u8Results;
+  uint8_t       bBusy;
+  uint8_t       u8Current;
+  uint8_t       bCoco;
+  uint64_t      u64End;
+} HOST_AdcType;
+
+typedef struct
+{
+  uint32_t      u32Pos;             /* position in the counting period */
+  uint64_t      u64Last;            /* core clock of the last update */
+  uint64_t      u64Rem;             /* clocks or TCLK edges short of the next count */
+} HOST_EtmType;
+
+/******************************************************************************
+* Local function prototypes
+******************************************************************************/
+void HOST_Dispatch( void );
+void HOST_IrqEntry( void );
+void HOST_Asm( const char * pInstruction );
+void HOST_SetPrimask( uint32_t u32Primask );
+static void HOST_Update( void );
+static void HOST_PowerOn( uint32_t u32Cause );
+
+/******************************************************************************
+* Local variables
+******************************************************************************/
+static uint8_t          *HOST_pu8Regs;          /* backdoor of the registers */
+static uint8_t          *HOST_pu8Flash;         /* backdoor of the flash */
+static sigjmp_buf       HOST_sBoot;
+static volatile int     HOST_bArmed;
+static volatile int     HOST_iInModel;          /* model code running in the main context */
+static volatile int     HOST_bStepping;
+static uint64_t         HOST_u64Steps;
+static int              HOST_bUpdating;
+static uint32_t         HOST_u32Checks;
+
+static HOST_AccessType  HOST_asAccess[4];
+static volatile int     HOST_iAccesses;
+static uint32_t         HOST_u32PollAddress;
+static uint64_t         HOST_u64PollCode;
+static uint64_t         HOST_u64PollValue;
+static uint32_t         HOST_u32Polls;
+
+static uint32_t         HOST_u32PsPerClock;
+static uint8_t          HOST_bBusDiv;
+static uint32_t         HOST_u32BusOdd;
+static uint64_t         HOST_u64Bus;
+static uint32_t         HOST_u32Cause;
+
+static HOST_TimedType   HOST_asTimed[HOST_EVENTS];
+static int              HOST_iTimed;
+
+/* NVIC */
+static uint32_t         HOST_u32Enabled;
+static uint32_t         HOST_u32Pending;
+static uint8_t          HOST_bSysTickPending;
+static int              HOST_aiActive[40];
+static uint32_t         HOST_au32ActivePrio[40];
+static int              HOST_iDepth;
+
+/* SysTick */
+static uint8_t          HOST_bTickOn;
+static uint32_t         HOST_u32TickVal;
+static uint64_t         HOST_u64TickStart;
+static uint64_t         HOST_u64TickZeros;
+static uint8_t          HOST_bCountFlag;
+
+/* peripherals */
+static HOST_UartType    HOST_asUart[3];
+static HOST_SpiType     HOST_asSpi[2];
+static HOST_AdcType     HOST_sAdc;
+static HOST_AdcSampleType HOST_pfnSample;
+static uint32_t         HOST_u32Crc;
+static uint32_t         HOST_au32PitVal[2];
+static uint8_t          HOST_au8PitTif[2];
+static uint64_t         HOST_u64PitLast;
+static uint32_t         HOST_u32RtcCnt;
+static uint8_t          HOST_bRtif;
+static uint64_t         HOST_u64RtcLast;
+static uint64_t         HOST_u64RtcAcc;
+static HOST_EtmType     HOST_asEtm[3];
+static uint32_t         HOST_u32EfmStatus;
+static uint32_t         HOST_u32EfmOp;
+static uint64_t         HOST_u64EfmEnd;
+static uint32_t         HOST_u32LatchAddress;
+static uint32_t         HOST_u32LatchData;
+static uint8_t          HOST_bLatch;
+static uint64_t         HOST_u64OscReady;
+static uint64_t         HOST_u64FllLock;
+static uint32_t         HOST_u32Supply = 5000;
+static uint8_t          HOST_bLvwf;
+static uint8_t          HOST_bLvdReset;
+static uint32_t         HOST_au32External[3] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
+static uint32_t         HOST_au32Level[3];
+static HOST_GpioEdgeType HOST_pfnEdge;
+
+static UART_Type * const HOST_apUart[3] = { UART0, UART1, UART2 };
+static SPI_Type * const HOST_apSpi[2] = { SPI0, SPI1 };
+static ETM_Type * const HOST_apEtm[3] = { ETM0, ETM1, ETM2 };
+static KBI_Type * const HOST_apKbi[2] = { KBI0, KBI1 };
+static GPIO_Type * const HOST_apGpio[3] = { GPIOA, GPIOB, ( GPIO_Type * )( GPIOB_BASE + 0x40 ) };
+
+/******************************************************************************
+* Local functions
+******************************************************************************/
+static void HOST_Fatal( const char * pFormat, ... )
+{
+  va_list args;
+
+  va_start( args, pFormat );
+  fputs( "host: ", stderr );
+  vfprintf( stderr, pFormat, args );
+  fputc( '\n', stderr );
+  va_end( args );
+  _exit( 2 );
+}
+
+/* backdoor pointer of a register address, NULL when not modelled */
+static uint8_t * HOST_Reg( uint32_t u32Address )
+{
+  if ( u32Address - HOST_PERIPH_BASE < HOST_PERIPH_SIZE )
+    return HOST_pu8Regs + ( u32Address - HOST_PERIPH_BASE );
+
+  if ( u32Address - HOST_SCS_PAGE < HOST_PAGE )
+    return HOST_pu8Regs + HOST_PERIPH_SIZE + ( u32Address - HOST_SCS_PAGE );
+
+  if ( u32Address - HOST_MCM_PAGE < HOST_PAGE )
+    return HOST_pu8Regs + HOST_PERIPH_SIZE + HOST_PAGE + ( u32Address - HOST_MCM_PAGE );
+
+  if ( u32Address - HOST_FGPIO_PAGE < HOST_PAGE )
+    return HOST_pu8Regs + ( HOST_GPIO_PAGE - HOST_PERIPH_BASE ) + ( u32Address - HOST_FGPIO_PAGE );
+
+  return NULL;
+}
+
+/* FGPIO is the same block as GPIO */
+static uint32_t HOST_Canonical( uint32_t u32Address )
+{
+  if ( u32Address - HOST_FGPIO_PAGE < HOST_PAGE )
+    return HOST_GPIO_PAGE + ( u32Address - HOST_FGPIO_PAGE );
+
+  return u32Address;
+}
+
+static void HOST_Protect( int bOpen )
+{
+  if ( mprotect( ( void * )HOST_PERIPH_BASE, HOST_PERIPH_SIZE, bOpen ? PROT_READ | PROT_WRITE : PROT_NONE ) ||
+       mprotect( ( void * )HOST_SCS_PAGE, HOST_PAGE, bOpen ? PROT_READ | PROT_WRITE : PROT_NONE ) ||
+       mprotect( ( void * )HOST_MCM_PAGE, HOST_PAGE, bOpen ? PROT_READ | PROT_WRITE : PROT_NONE ) ||
+       mprotect( ( void * )HOST_FGPIO_PAGE, HOST_PAGE, bOpen ? PROT_READ | PROT_WRITE : PROT_NONE ) ||
+       mprotect( ( void * )HOST_FLASH_MAPPED, HOST_FLASH_SIZE - HOST_FLASH_MAPPED,
+                 bOpen ? PROT_READ | PROT_WRITE : PROT_READ ) )
+    HOST_Fatal( "mprotect failed" );
+}
+
+/* bytes accessed by the x86 instruction, for the CRC lanes */
+static uint8_t HOST_Width( const uint8_t * pCode )
+{
+  uint8_t bOpSize = 0, bRexW = 0, u8Op;
+
+  for ( ;; pCode++ )
+  {
+    if ( *pCode == 0x66 )
+      bOpSize = 1;
+    else if ( *pCode == 0x67 || *pCode == 0xF0 || *pCode == 0xF2 || *pCode == 0xF3 ||
+              *pCode == 0x2E || *pCode == 0x3E || *pCode == 0x26 || *pCode == 0x36 ||
+              *pCode == 0x64 || *pCode == 0x65 )
+      ;
+    else
+      break;
+  }
+
+  if ( ( *pCode & 0xF0 ) == 0x40 )
+  {
+    bRexW = ( *pCode & 0x08 ) != 0;
+    pCode++;
+  }
+
+  u8Op = *pCode;
+
+  if ( u8Op == 0x0F )
+  {
+    u8Op = pCode[1];
+
+    if ( u8Op == 0xB6 || u8Op == 0xBE )
+      return 1;
+
+    if ( u8Op == 0xB7 || u8Op == 0xBF )
+      return 2;
+
+    return 4;
+  }
+
+  if ( ( u8Op < 0x40 && ( u8Op & 0x07 ) <= 0x03 && !( u8Op & 0x01 ) ) ||
+       u8Op == 0x88 || u8Op == 0x8A || u8Op == 0xC6 || u8Op == 0x80 || u8Op == 0x84 ||
+       u8Op == 0xF6 || u8Op == 0x86 || u8Op == 0xA4 || u8Op == 0xFE )
+    return 1;
+
+  return bRexW ? 8 : bOpSize ? 2 : 4;
+}
+
+static uint64_t HOST_Bytes( const uint8_t * pData, uint8_t u8Width )
+{
+  uint64_t u64Value = 0;
+
+  memcpy( &u64Value, pData, u8Width );
+  return u64Value;
+}
+
+/******************************************************************************
+* clocks
+******************************************************************************/
+static uint64_t HOST_UsToPs( uint32_t u32Us )
+{
+  return ( uint64_t )u32Us * 1000000ULL;
+}
+
+static void HOST_Clocks( void )
+{
+  HOST_u32PsPerClock = ( uint32_t )( 1000000000000ULL / HOST_CoreHz( ) );
+  HOST_bBusDiv = HOST_R32( SIM->BUSDIV ) & SIM_BUSDIV_BUSDIV_MASK;
+}
+
+static void HOST_Tick( uint64_t u64Clocks )
+{
+  HOST_u64Clock += u64Clocks;
+  HOST_u64Ps += u64Clocks * HOST_u32PsPerClock;
+
+  if ( HOST_bBusDiv )
+  {
+    u64Clocks += HOST_u32BusOdd;
+    HOST_u32BusOdd = u64Clocks & 1;
+    u64Clocks >>= 1;
+  }
+
+  HOST_u64Bus += u64Clocks;
+}
+
+/* core clocks until a bus clock or a time */
+static uint64_t HOST_FromBus( uint64_t u64Bus )
+{
+  if ( u64Bus <= HOST_u64Bus )
+    return 1;
+
+  return ( u64Bus - HOST_u64Bus ) << HOST_bBusDiv;
+}
+
+static uint64_t HOST_FromPs( uint64_t u64Ps )
+{
+  if ( u64Ps <= HOST_u64Ps )
+    return 1;
+
+  return ( u64Ps - HOST_u64Ps + HOST_u32PsPerClock - 1 ) / HOST_u32PsPerClock;
+}
+
+static uint64_t HOST_Min( uint64_t u64A, uint64_t u64B )
+{
+  return u64A < u64B ? u64A : u64B;
+}
+
+/******************************************************************************
+* SysTick
+******************************************************************************/
+static uint32_t HOST_TickLoad( void )
+{
+  return HOST_R32( SysTick->LOAD ) & SysTick_LOAD_RELOAD_Msk;
+}
+
+static uint64_t HOST_TickFirst( void )
+{
+  return HOST_u32TickVal ? HOST_u32TickVal : ( uint64_t )HOST_TickLoad( ) + 1;
+}
+
+static uint32_t HOST_TickValue( void )
+{
+  uint64_t u64Elapsed, u64Period = ( uint64_t )HOST_TickLoad( ) + 1;
+
+  if ( !HOST_bTickOn )
+    return HOST_u32TickVal;
+
+  u64Elapsed = HOST_u64Clock - HOST_u64TickStart;
+
+  if ( u64Elapsed <= HOST_u32TickVal )
+    return HOST_u32TickVal - ( uint32_t )u64Elapsed;
+
+  return HOST_TickLoad( ) - ( uint32_t )( ( u64Elapsed - HOST_u32TickVal - 1 ) % u64Period );
+}
+
+static uint64_t HOST_TickZeros( void )
+{
+  uint64_t u64Elapsed = HOST_u64Clock - HOST_u64TickStart, u64First = HOST_TickFirst( );
+
+  if ( !HOST_bTickOn || u64Elapsed < u64First )
+    return 0;
+
+  return 1 + ( u64Elapsed - u64First ) / ( ( uint64_t )HOST_TickLoad( ) + 1 );
+}
+
+/* restart the count from the current value, before LOAD or the enable changes */
+static void HOST_TickRebase( void )
+{
+  HOST_u32TickVal = HOST_TickValue( );
+  HOST_u64TickStart = HOST_u64Clock;
+  HOST_u64TickZeros = 0;
+}
+
+static void HOST_TickUpdate( void )
+{
+  uint64_t u64Zeros = HOST_TickZeros( );
+
+  if ( u64Zeros > HOST_u64TickZeros )
+  {
+    HOST_u64TickZeros = u64Zeros;
+    HOST_bCountFlag = 1;
+
+    if ( HOST_R32( SysTick->CTRL ) & SysTick_CTRL_TICKINT_Msk )
+      HOST_bSysTickPending = 1;
+  }
+}
+
+static uint64_t HOST_TickNext( void )
+{
+  uint64_t u64Zero;
+
+  if ( !HOST_bTickOn || !( HOST_R32( SysTick->CTRL ) & SysTick_CTRL_TICKINT_Msk ) )
+    return HOST_NONE;
+
+  u64Zero = HOST_u64TickStart + HOST_TickFirst( ) + HOST_u64TickZeros * ( ( uint64_t )HOST_TickLoad( ) + 1 );
+  return u64Zero > HOST_u64Clock ? u64Zero - HOST_u64Clock : 1;
+}
+
+/******************************************************************************
+* UART
+******************************************************************************/
+static uint64_t HOST_UartFrame( uint8_t u8Port )
+{
+  UART_Type *pUART = HOST_apUart[u8Port];
+  uint32_t u32Sbr = ( ( HOST_R8( pUART->BDH ) & 0x1F ) << 8 ) | HOST_R8( pUART->BDL );
+  uint32_t u32Bits = ( HOST_R8( pUART->C1 ) & UART_C1_M_MASK ) ? 11 : 10;
+
+  return ( uint64_t )u32Bits * 16 * ( u32Sbr ? u32Sbr : 1 );
+}
+
+static void HOST_UartUpdate( uint8_t u8Port )
+{
+  HOST_UartType *pModel = &HOST_asUart[u8Port];
+  UART_Type *pUART = HOST_apUart[u8Port];
+
+  while ( pModel->bShift && HOST_u64Bus >= pModel->u64TxEnd )
+  {
+    if ( pModel->pfnTx )
+      pModel->pfnTx( u8Port, pModel->u8Shift );
+
+    if ( pModel->bHold )
+    {
+      pModel->u8Shift = pModel->u8Hold;
+      pModel->bHold = 0;
+      pModel->u8S1 |= UART_S1_TDRE_MASK;
+      pModel->u64TxEnd += HOST_UartFrame( u8Port );
+    }
+    else
+    {
+      pModel->bShift = 0;
+      pModel->u8S1 |= UART_S1_TC_MASK;
+    }
+  }
+
+  while ( pModel->u64RxAt && HOST_u64Bus >= pModel->u64RxAt )
+  {
+    uint8_t u8Data = pModel->au8Queue[pModel->u32Tail++ % HOST_UART_QUEUE];
+
+    if ( HOST_R8( pUART->C2 ) & UART_C2_RE_MASK )
+    {
+      if ( pModel->u8S1 & UART_S1_RDRF_MASK )
+      {
+        pModel->u8S1 |= UART_S1_OR_MASK;
+      }
+      else
+      {
+        pModel->u8Rx = u8Data;
+        pModel->u8S1 |= UART_S1_RDRF_MASK;
+      }
+    }
+
+    pModel->u64RxAt = ( pModel->u32Tail != pModel->u32Head ) ? pModel->u64RxAt + HOST_UartFrame( u8Port ) : 0;
+  }
+}
+
+static uint64_t HOST_UartNext( uint8_t u8Port )
+{
+  HOST_UartType *pModel = &HOST_asUart[u8Port];
+  uint64_t u64Next = HOST_NONE;
+
+  if ( pModel->bShift )
+    u64Next = HOST_FromBus( pModel->u64TxEnd );
+
+  if ( pModel->u64RxAt )
+    u64Next = HOST_Min( u64Next, HOST_FromBus( pModel->u64RxAt ) );
+
+  return u64Next;
+}
+
+static uint8_t HOST_UartLine( uint8_t u8Port )
+{
+  uint8_t u8C2 = HOST_R8( HOST_apUart[u8Port]->C2 ), u8S1 = HOST_asUart[u8Port].u8S1;
+
+  return ( ( u8C2 & UART_C2_TIE_MASK ) && ( u8S1 & UART_S1_TDRE_MASK ) ) ||
+         ( ( u8C2 & UART_C2_TCIE_MASK ) && ( u8S1 & UART_S1_TC_MASK ) ) ||
+         ( ( u8C2 & UART_C2_RIE_MASK ) && ( u8S1 & ( UART_S1_RDRF_MASK | UART_S1_OR_MASK ) ) );
+}
+
+static void HOST_UartRefresh( uint8_t u8Port )
+{
+  HOST_R8( HOST_apUart[u8Port]->S1 ) = HOST_asUart[u8Port].u8S1;
+  HOST_R8( HOST_apUart[u8Port]->D ) = HOST_asUart[u8Port].u8Rx;
+}
+
+static void HOST_UartWrite( uint8_t u8Port, uint32_t u32Address )
+{
+  HOST_UartType *pModel = &HOST_asUart[u8Port];
+  UART_Type *pUART = HOST_apUart[u8Port];
+  uint8_t u8Data = HOST_R8( pUART->D );
+
+  if ( u32Address != HOST_AT( pUART->D ) || !( HOST_R8( pUART->C2 ) & UART_C2_TE_MASK ) )
+    return;
+
+  pModel->u8S1 &= ~UART_S1_TC_MASK;
+
+  if ( !pModel->bShift )
+  {
+    pModel->bShift = 1;
+    pModel->u8Shift = u8Data;
+    pModel->u64TxEnd = HOST_u64Bus + HOST_UartFrame( u8Port );
+  }
+  else if ( !pModel->bHold )
+  {
+    pModel->bHold = 1;
+    pModel->u8Hold = u8Data;
+    pModel->u8S1 &= ~UART_S1_TDRE_MASK;
+  }
+}
+
+static void HOST_UartRead( uint8_t u8Port, uint32_t u32Address )
+{
+  if ( u32Address == HOST_AT( HOST_apUart[u8Port]->D ) )
+    HOST_asUart[u8Port].u8S1 &= ~( UART_S1_RDRF_MASK | UART_S1_OR_MASK );
+}
+
+/******************************************************************************
+* SPI
+******************************************************************************/
+static uint64_t HOST_SpiTime( uint8_t u8Port )
+{
+  uint8_t u8Br = HOST_R8( HOST_apSpi[u8Port]->BR );
+  uint32_t u32Sppr = ( ( u8Br & SPI_BR_SPPR_MASK ) >> SPI_BR_SPPR_SHIFT ) + 1;
+  uint32_t u32Spr = u8Br & SPI_BR_SPR_MASK;
+
+  return 8ULL * u32Sppr * ( 2ULL << u32Spr );
+}
+
+static void HOST_SpiUpdate( uint8_t u8Port )
+{
+  HOST_SpiType *pModel = &HOST_asSpi[u8Port];
+
+  while ( pModel->bBusy && HOST_u64Bus >= pModel->u64End )
+  {
+    uint8_t u8Miso = pModel->pfnSlave ? pModel->pfnSlave( u8Port, pModel->u8Tx ) : pModel->u8Tx;
+
+    /* the new byte is lost when the last one was not read */
+    if ( !( pModel->u8S & SPI_S_SPRF_MASK ) )
+    {
+      pModel->u8Rx = u8Miso;
+      pModel->u8S |= SPI_S_SPRF_MASK;
+    }
+
+    if ( pModel->bHold )
+    {
+      pModel->u8Tx = pModel->u8Hold;
+      pModel->bHold = 0;
+      pModel->u8S |= SPI_S_SPTEF_MASK;
+      pModel->u64End += HOST_SpiTime( u8Port );
+    }
+    else
+    {
+      pModel->bBusy = 0;
+    }
+  }
+}
+
+static uint8_t HOST_SpiLine( uint8_t u8Port )
+{
+  uint8_t u8C1 = HOST_R8( HOST_apSpi[u8Port]->C1 ), u8S = HOST_asSpi[u8Port].u8S;
+
+  if ( !( u8C1 & SPI_C1_SPE_MASK ) )
+    return 0;
+
+  return ( ( u8C1 & SPI_C1_SPIE_MASK ) && ( u8S & SPI_S_SPRF_MASK ) ) ||
+         ( ( u8C1 & SPI_C1_SPTIE_MASK ) && ( u8S & SPI_S_SPTEF_MASK ) );
+}
+
+static void HOST_SpiRefresh( uint8_t u8Port )
+{
+  HOST_R8( HOST_apSpi[u8Port]->S ) = HOST_asSpi[u8Port].u8S;
+  HOST_R8( HOST_apSpi[u8Port]->D ) = HOST_asSpi[u8Port].u8Rx;
+}
+
+static void HOST_SpiWrite( uint8_t u8Port, uint32_t u32Address )
+{
+  HOST_SpiType *pModel = &HOST_asSpi[u8Port];
+  SPI_Type *pSPI = HOST_apSpi[u8Port];
+
+  if ( u32Address != HOST_AT( pSPI->D ) || !( HOST_R8( pSPI->C1 ) & SPI_C1_SPE_MASK ) )
+    return;
+
+  if ( !pModel->bBusy )
+  {
+    pModel->bBusy = 1;
+    pModel->u8Tx = HOST_R8( pSPI->D );
+    pModel->u64End = HOST_u64Bus + HOST_SpiTime( u8Port );
+  }
+  else if ( !pModel->bHold )
+  {
+    pModel->bHold = 1;
+    pModel->u8Hold = HOST_R8( pSPI->D );
+    pModel->u8S &= ~SPI_S_SPTEF_MASK;
+  }
+}
+
+static void HOST_SpiRead( uint8_t u8Port, uint32_t u32Address )
+{
+  if ( u32Address == HOST_AT( HOST_apSpi[u8Port]->D ) )
+    HOST_asSpi[u8Port].u8S &= ~SPI_S_SPRF_MASK;
+}
+
+/******************************************************************************
+* ADC
+******************************************************************************/
+static uint64_t HOST_AdcTime( void )
+{
+  uint32_t u32Sc3 = HOST_R32( ADC->SC3 );
+  uint32_t u32Adck = 20 + ( ( u32Sc3 & ADC_SC3_ADLSMP_MASK ) ? 20 : 0 );
+
+  return ( ( uint64_t )u32Adck << ( ( u32Sc3 & ADC_SC3_ADIV_MASK ) >> ADC_SC3_ADIV_SHIFT ) ) + 5;
+}
+
+static void HOST_AdcStart( void )
+{
+  HOST_sAdc.bBusy = 1;
+  HOST_sAdc.u8Current = HOST_sAdc.au8Channel[0];
+  HOST_sAdc.u64End = HOST_u64Bus + HOST_AdcTime( );
+}
+
+static void HOST_AdcUpdate( void )
+{
+  uint8_t u8Depth = ( HOST_R32( ADC->SC4 ) & ADC_SC4_AFDEP_MASK ) + 1;
+  uint16_t u16Result;
+
+  while ( HOST_sAdc.bBusy && HOST_u64Bus >= HOST_sAdc.u64End )
+  {
+    u16Result = HOST_pfnSample ? HOST_pfnSample( HOST_sAdc.u8Current ) : ( uint16_t )( HOST_sAdc.u8Current * 100 );
+
+    if ( HOST_sAdc.u8Results < 8 )
+      HOST_sAdc.au16Result[HOST_sAdc.u8Results++] = u16Result & 0xFFF;
+
+    /* next channel of the FIFO, or again in continuous mode */
+    memmove( HOST_sAdc.au8Channel, HOST_sAdc.au8Channel + 1, 7 );
+    HOST_sAdc.u8Channels--;
+    HOST_sAdc.bBusy = 0;
+
+    if ( HOST_sAdc.u8Channels )
+    {
+      HOST_AdcStart( );
+      HOST_sAdc.u64End = HOST_sAdc.u64End - HOST_u64Bus + HOST_sAdc.u64End - HOST_AdcTime( );
+      continue;
+    }
+
+    if ( HOST_sAdc.u8Results >= ( u8Depth > 1 ? u8Depth : 1 ) || u8Depth == 1 )
+      HOST_sAdc.bCoco = 1;
+
+    if ( HOST_R32( ADC->SC1 ) & ADC_SC1_ADCO_MASK )
+    {
+      HOST_sAdc.au8Channel[0] = HOST_R32( ADC->SC1 ) & ADC_SC1_ADCH_MASK;
+      HOST_sAdc.u8Channels = 1;
+      HOST_AdcStart( );
+    }
+  }
+}
+
+static void HOST_AdcRefresh( void )
+{
+  uint32_t u32Sc1 = HOST_R32( ADC->SC1 ) & ~ADC_SC1_COCO_MASK;
+  uint32_t u32Sc2 = HOST_R32( ADC->SC2 ) & ~( ADC_SC2_FEMPTY_MASK | ADC_SC2_FFULL_MASK | ADC_SC2_ADACT_MASK );
+
+  HOST_R32( ADC->SC1 ) = u32Sc1 | ( HOST_sAdc.bCoco ? ADC_SC1_COCO_MASK : 0 );
+  HOST_R32( ADC->SC2 ) = u32Sc2 | ( HOST_sAdc.u8Results ? 0 : ADC_SC2_FEMPTY_MASK ) |
+                         ( HOST_sAdc.u8Results >= 8 ? ADC_SC2_FFULL_MASK : 0 ) |
+                         ( HOST_sAdc.bBusy ? ADC_SC2_ADACT_MASK : 0 );
+  HOST_R32( ADC->R ) = HOST_sAdc.u8Results ? HOST_sAdc.au16Result[0] : 0;
+}
+
+static void HOST_AdcWrite( uint32_t u32Address )
+{
+  uint8_t u8Channel = HOST_R32( ADC->SC1 ) & ADC_SC1_ADCH_MASK;
+  uint8_t u8Depth = ( HOST_R32( ADC->SC4 ) & ADC_SC4_AFDEP_MASK ) + 1;
+
+  if ( u32Address != HOST_AT( ADC->SC1 ) )
+    return;
+
+  if ( u8Channel == ADC_SC1_ADCH_MASK )
+  {
+    /* module disabled, the FIFO is flushed */
+    memset( &HOST_sAdc, 0, sizeof( HOST_sAdc ) );
+    return;
+  }
+
+  if ( u8Depth == 1 )
+  {
+    HOST_sAdc.u8Results = 0;
+    HOST_sAdc.u8Channels = 0;
+  }
+
+  HOST_sAdc.bCoco = 0;
+
+  if ( HOST_sAdc.u8Channels < 8 )
+    HOST_sAdc.au8Channel[HOST_sAdc.u8Channels++] = u8Channel;
+
+  /* a FIFO converts once all its channels are written */
+  if ( !HOST_sAdc.bBusy && HOST_sAdc.u8Channels >= u8Depth )
+    HOST_AdcStart( );
+}
+
+static void HOST_AdcRead( uint32_t u32Address )
+{
+  if ( u32Address != HOST_AT( ADC->R ) || !HOST_sAdc.u8Results )
+    return;
+
+  memmove( HOST_sAdc.au16Result, HOST_sAdc.au16Result + 1, 7 * sizeof( uint16_t ) );
+
+  if ( !--HOST_sAdc.u8Results )
+    HOST_sAdc.bCoco = 0;
+}
+
+/******************************************************************************
+* CRC
+******************************************************************************/
+static uint8_t HOST_Reflect8( uint8_t u8Byte )
+{
+  uint8_t u8Out = 0;
+  int i;
+
+  for ( i = 0; i < 8; i++ )
+    if ( u8Byte & ( 1 << i ) )
+      u8Out |= 0x80 >> i;
+
+  return u8Out;
+}
+
+/* TOT and TOTR: 1 bits in bytes, 2 bits and bytes, 3 bytes */
+static void HOST_Transpose( uint8_t * pBytes, uint8_t u8Width, uint8_t u8Type )
+{
+  uint8_t au8Copy[4];
+  int i;
+
+  if ( u8Type == 1 || u8Type == 2 )
+    for ( i = 0; i < u8Width; i++ )
+      pBytes[i] = HOST_Reflect8( pBytes[i] );
+
+  if ( u8Type == 2 || u8Type == 3 )
+  {
+    memcpy( au8Copy, pBytes, u8Width );
+
+    for ( i = 0; i < u8Width; i++ )
+      pBytes[i] = au8Copy[u8Width - 1 - i];
+  }
+}
+
+static uint32_t HOST_CrcResult( void )
+{
+  uint32_t u32Ctrl = HOST_R32( CRC0->CTRL ), u32Result = HOST_u32Crc;
+  uint8_t au8Bytes[4];
+
+  if ( !( u32Ctrl & CRC_CTRL_TCRC_MASK ) )
+    u32Result &= 0xFFFF;
+
+  memcpy( au8Bytes, &u32Result, 4 );
+  HOST_Transpose( au8Bytes, 4, ( u32Ctrl & CRC_CTRL_TOTR_MASK ) >> CRC_CTRL_TOTR_SHIFT );
+  memcpy( &u32Result, au8Bytes, 4 );
+
+  if ( u32Ctrl & CRC_CTRL_FXOR_MASK )
+    u32Result ^= ( u32Ctrl & CRC_CTRL_TCRC_MASK ) ? 0xFFFFFFFF : 0xFFFF;
+
+  return u32Result;
+}
+
+static void HOST_CrcWrite( uint32_t u32Address, uint8_t u8Width )
+{
+  uint32_t u32Ctrl = HOST_R32( CRC0->CTRL ), u32Poly = HOST_R32( CRC0->GPOLY );
+  uint32_t u32Lane = u32Address - CRC_BASE;
+  uint8_t au8Bytes[4];
+  int iLane, iBit;
+
+  if ( u32Lane >= 4 )
+    return;
+
+  if ( u32Lane + u8Width > 4 )
+    u8Width = 4 - u32Lane;
+
+  memcpy( au8Bytes, HOST_Reg( u32Address ), u8Width );
+  HOST_Transpose( au8Bytes, u8Width, ( u32Ctrl & CRC_CTRL_TOT_MASK ) >> CRC_CTRL_TOT_SHIFT );
+
+  if ( u32Ctrl & CRC_CTRL_WAS_MASK )
+  {
+    memcpy( ( uint8_t * )&HOST_u32Crc + u32Lane, au8Bytes, u8Width );
+    return;
+  }
+
+  /* the most significant lane first, each byte MSB first */
+  for ( iLane = u8Width - 1; iLane >= 0; iLane-- )
+  {
+    for ( iBit = 7; iBit >= 0; iBit-- )
+    {
+      uint32_t u32In = ( au8Bytes[iLane] >> iBit ) & 1;
+
+      if ( u32Ctrl & CRC_CTRL_TCRC_MASK )
+      {
+        uint32_t u32Feedback = ( HOST_u32Crc >> 31 ) ^ u32In;
+
+        HOST_u32Crc <<= 1;
+
+        if ( u32Feedback )
+          HOST_u32Crc ^= u32Poly;
+      }
+      else
+      {
+        uint32_t u32Feedback = ( ( HOST_u32Crc >> 15 ) & 1 ) ^ u32In;
+
+        HOST_u32Crc = ( HOST_u32Crc << 1 ) & 0xFFFF;
+
+        if ( u32Feedback )
+          HOST_u32Crc ^= u32Poly & 0xFFFF;
+      }
+    }
+  }
+}
+
+/******************************************************************************
+* PIT
+******************************************************************************/
+/* count a channel down by u64Clocks, returns the underflows */
+static uint64_t HOST_PitCount( uint8_t u8Channel, uint64_t u64Clocks )
+{
+  uint64_t u64Load = ( uint64_t )HOST_R32( PIT->CHANNEL[u8Channel].LDVAL ) + 1, u64Under;
+
+  if ( u64Clocks <= HOST_au32PitVal[u8Channel] )
+  {
+    HOST_au32PitVal[u8Channel] -= ( uint32_t )u64Clocks;
+    return 0;
+  }
+
+  u64Clocks -= ( uint64_t )HOST_au32PitVal[u8Channel] + 1;
+  u64Under = 1 + u64Clocks / u64Load;
+  HOST_au32PitVal[u8Channel] = ( uint32_t )( u64Load - 1 - u64Clocks % u64Load );
+  HOST_au8PitTif[u8Channel] = 1;
+  return u64Under;
+}
+
+static void HOST_PitUpdate( void )
+{
+  uint64_t u64Clocks = HOST_u64Bus - HOST_u64PitLast, u64Under = 0;
+
+  HOST_u64PitLast = HOST_u64Bus;
+
+  if ( HOST_R32( PIT->MCR ) & PIT_MCR_MDIS_MASK )
+    return;
+
+  if ( HOST_R32( PIT->CHANNEL[0].TCTRL ) & PIT_TCTRL_TEN_MASK )
+    u64Under = HOST_PitCount( 0, u64Clocks );
+
+  if ( HOST_R32( PIT->CHANNEL[1].TCTRL ) & PIT_TCTRL_TEN_MASK )
+  {
+    if ( HOST_R32( PIT->CHANNEL[1].TCTRL ) & PIT_TCTRL_CHN_MASK )
+      HOST_PitCount( 1, u64Under );
+    else
+      HOST_PitCount( 1, u64Clocks );
+  }
+}
+
+static uint64_t HOST_PitNext( void )
+{
+  uint64_t u64Next = HOST_NONE;
+  int i;
+
+  if ( HOST_R32( PIT->MCR ) & PIT_MCR_MDIS_MASK )
+    return HOST_NONE;
+
+  for ( i = 0; i < 2; i++ )
+  {
+    uint32_t u32Ctrl = HOST_R32( PIT->CHANNEL[i].TCTRL );
+
+    if ( ( u32Ctrl & PIT_TCTRL_TEN_MASK ) && !( u32Ctrl & PIT_TCTRL_CHN_MASK ) )
+      u64Next = HOST_Min( u64Next, HOST_FromBus( HOST_u64Bus + HOST_au32PitVal[i] + 1 ) );
+  }
+
+  return u64Next;
+}
+
+static void HOST_PitRefresh( void )
+{
+  int i;
+
+  for ( i = 0; i < 2; i++ )
+  {
+    HOST_R32( PIT->CHANNEL[i].CVAL ) = HOST_au32PitVal[i];
+    HOST_R32( PIT->CHANNEL[i].TFLG ) = HOST_au8PitTif[i];
+  }
+}
+
+static void HOST_PitWrite( uint32_t u32Address, uint64_t u64Old )
+{
+  int i;
+
+  for ( i = 0; i < 2; i++ )
+  {
+    if ( u32Address == HOST_AT( PIT->CHANNEL[i].TCTRL ) &&
+         !( u64Old & PIT_TCTRL_TEN_MASK ) && ( HOST_R32( PIT->CHANNEL[i].TCTRL ) & PIT_TCTRL_TEN_MASK ) )
+      HOST_au32PitVal[i] = HOST_R32( PIT->CHANNEL[i].LDVAL );
+
+    if ( u32Address == HOST_AT( PIT->CHANNEL[i].TFLG ) && ( HOST_R32( PIT->CHANNEL[i].TFLG ) & PIT_TFLG_TIF_MASK ) )
+      HOST_au8PitTif[i] = 0;
+  }
+}
+
+/******************************************************************************
+* RTC
+******************************************************************************/
+static uint64_t HOST_RtcPeriod( void )
+{
+  static const uint16_t au16High[7] = { 128, 256, 512, 1024, 2048, 100, 1000 };
+  uint32_t u32Sc = HOST_R32( RTC->SC );
+  uint32_t u32Clks = ( u32Sc & RTC_SC_RTCLKS_MASK ) >> RTC_SC_RTCLKS_SHIFT;
+  uint32_t u32Ps = ( u32Sc & RTC_SC_RTCPS_MASK ) >> RTC_SC_RTCPS_SHIFT;
+  uint32_t u32Hz = u32Clks == 0 ? HOST_u32RtcExtHz : u32Clks == 1 ? 1000 : u32Clks == 2 ? 37500 : HOST_BusHz( );
+  uint32_t u32Div;
+
+  if ( !u32Ps )
+    return 0;
+
+  u32Div = ( u32Clks & 1 ) ? au16High[u32Ps - 1] : 1U << ( u32Ps - 1 );
+  return 1000000000000ULL / u32Hz * u32Div;
+}
+
+static void HOST_RtcUpdate( void )
+{
+  uint64_t u64Period = HOST_RtcPeriod( ), u64Ticks, u64Mod;
+
+  HOST_u64RtcAcc += HOST_u64Ps - HOST_u64RtcLast;
+  HOST_u64RtcLast = HOST_u64Ps;
+
+  if ( !u64Period )
+  {
+    HOST_u64RtcAcc = 0;
+    return;
+  }
+
+  u64Ticks = HOST_u64RtcAcc / u64Period;
+  HOST_u64RtcAcc %= u64Period;
+  u64Mod = HOST_R32( RTC->MOD ) & 0xFFFF;
+
+  if ( u64Ticks <= u64Mod - HOST_u32RtcCnt )
+  {
+    HOST_u32RtcCnt += ( uint32_t )u64Ticks;
+    return;
+  }
+
+  u64Ticks -= u64Mod - HOST_u32RtcCnt + 1;
+  HOST_u32RtcCnt = ( uint32_t )( u64Ticks % ( u64Mod + 1 ) );
+  HOST_bRtif = 1;
+}
+
+static uint64_t HOST_RtcNext( void )
+{
+  uint64_t u64Period = HOST_RtcPeriod( );
+  uint64_t u64Ticks = ( HOST_R32( RTC->MOD ) & 0xFFFF ) - HOST_u32RtcCnt + 1;
+
+  if ( !u64Period || !( HOST_R32( RTC->SC ) & RTC_SC_RTIE_MASK ) )
+    return HOST_NONE;
+
+  return HOST_FromPs( HOST_u64Ps + u64Ticks * u64Period - HOST_u64RtcAcc );
+}
+
+static void HOST_RtcRefresh( void )
+{
+  HOST_R32( RTC->SC ) = ( HOST_R32( RTC->SC ) & ~RTC_SC_RTIF_MASK ) | ( HOST_bRtif ? RTC_SC_RTIF_MASK : 0 );
+  HOST_R32( RTC->CNT ) = HOST_u32RtcCnt;
+}
+
+static void HOST_RtcWrite( uint32_t u32Address, uint64_t u64Old )
+{
+  uint32_t u32Sc = HOST_R32( RTC->SC );
+
+  if ( u32Address == HOST_AT( RTC->SC ) )
+  {
+    if ( u32Sc & RTC_SC_RTIF_MASK )
+      HOST_bRtif = 0;
+
+    /* a new clock or prescaler clears the counter */
+    if ( ( u32Sc ^ ( uint32_t )u64Old ) & ( RTC_SC_RTCLKS_MASK | RTC_SC_RTCPS_MASK ) )
+    {
+      HOST_u32RtcCnt = 0;
+      HOST_u64RtcAcc = 0;
+    }
+  }
+  else if ( u32Address == HOST_AT( RTC->MOD ) )
+  {
+    HOST_u32RtcCnt = 0;
+    HOST_u64RtcAcc = 0;
+  }
+}
+
+/******************************************************************************
+* ETM
+******************************************************************************/
+static uint8_t HOST_EtmChannels( uint8_t u8Etm )
+{
+  return u8Etm == 2 ? 6 : 2;
+}
+
+/* the clock the ETM counts: 1 the timer clock, ICSOUT, 3 TCLK */
+static uint32_t HOST_EtmClks( uint8_t u8Etm )
+{
+  return ( HOST_R32( HOST_apEtm[u8Etm]->SC ) & ETM_SC_CLKS_MASK ) >> ETM_SC_CLKS_SHIFT;
+}
+
+/* counting period in counts, 0 when stopped */
+static uint32_t HOST_EtmPeriod( uint8_t u8Etm )
+{
+  ETM_Type *pETM = HOST_apEtm[u8Etm];
+  uint32_t u32Sc = HOST_R32( pETM->SC );
+  uint32_t u32Span = ( HOST_R32( pETM->MOD ) - HOST_R32( pETM->CNTIN ) ) & 0xFFFF;
+
+  if ( HOST_EtmClks( u8Etm ) != 1 && HOST_EtmClks( u8Etm ) != 3 )
+    return 0;
+
+  return ( u32Sc & ETM_SC_CPWMS_MASK ) ? ( u32Span ? 2 * u32Span : 1 ) : u32Span + 1;
+}
+
+/* u64Clocks more of the clock counted, before the prescaler */
+static void HOST_EtmAdvance( uint8_t u8Etm, uint64_t u64Clocks )
+{
+  HOST_EtmType *pModel = &HOST_asEtm[u8Etm];
+  ETM_Type *pETM = HOST_apEtm[u8Etm];
+  uint32_t u32Period = HOST_EtmPeriod( u8Etm );
+  uint32_t u32Shift = HOST_R32( pETM->SC ) & ETM_SC_PS_MASK;
+  uint64_t u64Counts;
+
+  pModel->u64Rem += u64Clocks;
+
+  if ( !u32Period )
+  {
+    pModel->u64Rem = 0;
+    return;
+  }
+
+  u64Counts = pModel->u64Rem >> u32Shift;
+  pModel->u64Rem &= ( 1ULL << u32Shift ) - 1;
+
+  if ( pModel->u32Pos + u64Counts >= u32Period )
+    HOST_R32( pETM->SC ) |= ETM_SC_TOF_MASK;
+
+  pModel->u32Pos = ( uint32_t )( ( pModel->u32Pos + u64Counts ) % u32Period );
+}
+
+static void HOST_EtmUpdate( uint8_t u8Etm )
+{
+  HOST_EtmType *pModel = &HOST_asEtm[u8Etm];
+  uint64_t u64Clocks = HOST_u64Clock - pModel->u64Last;
+
+  pModel->u64Last = HOST_u64Clock;
+
+  if ( HOST_EtmClks( u8Etm ) == 1 )
+    HOST_EtmAdvance( u8Etm, u64Clocks );
+  else if ( HOST_EtmClks( u8Etm ) != 3 )
+    pModel->u64Rem = 0;
+}
+
+static uint64_t HOST_EtmNext( uint8_t u8Etm )
+{
+  HOST_EtmType *pModel = &HOST_asEtm[u8Etm];
+  ETM_Type *pETM = HOST_apEtm[u8Etm];
+  uint32_t u32Period = HOST_EtmPeriod( u8Etm );
+  uint32_t u32Shift = HOST_R32( pETM->SC ) & ETM_SC_PS_MASK;
+
+  if ( !u32Period || HOST_EtmClks( u8Etm ) != 1 || !( HOST_R32( pETM->SC ) & ETM_SC_TOIE_MASK ) )
+    return HOST_NONE;
+
+  return ( ( ( uint64_t )( u32Period - pModel->u32Pos ) ) << u32Shift ) - pModel->u64Rem;
+}
+
+static uint32_t HOST_EtmCount( uint8_t u8Etm )
+{
+  ETM_Type *pETM = HOST_apEtm[u8Etm];
+  uint32_t u32In = HOST_R32( pETM->CNTIN ) & 0xFFFF, u32Mod = HOST_R32( pETM->MOD ) & 0xFFFF;
+  uint32_t u32Pos = HOST_asEtm[u8Etm].u32Pos;
+
+  if ( ( HOST_R32( pETM->SC ) & ETM_SC_CPWMS_MASK ) && u32Pos > u32Mod - u32In )
+    return u32Mod - ( u32Pos - ( u32Mod - u32In ) );
+
+  return ( u32In + u32Pos ) & 0xFFFF;
+}
+
+static uint8_t HOST_EtmLine( uint8_t u8Etm )
+{
+  ETM_Type *pETM = HOST_apEtm[u8Etm];
+  int i;
+
+  if ( ( HOST_R32( pETM->SC ) & ETM_SC_TOIE_MASK ) && ( HOST_R32( pETM->SC ) & ETM_SC_TOF_MASK ) )
+    return 1;
+
+  for ( i = 0; i < HOST_EtmChannels( u8Etm ); i++ )
+  {
+    uint32_t u32CnSC = HOST_R32( pETM->CONTROLS[i].CnSC );
+
+    if ( ( u32CnSC & ETM_CnSC_CHIE_MASK ) && ( u32CnSC & ETM_CnSC_CHF_MASK ) )
+      return 1;
+  }
+
+  return 0;
+}
+
+static void HOST_EtmRefresh( uint8_t u8Etm )
+{
+  ETM_Type *pETM = HOST_apEtm[u8Etm];
+  uint32_t u32Status = 0;
+  int i;
+
+  HOST_R32( pETM->CNT ) = HOST_EtmCount( u8Etm );
+
+  for ( i = 0; i < HOST_EtmChannels( u8Etm ); i++ )
+    if ( HOST_R32( pETM->CONTROLS[i].CnSC ) & ETM_CnSC_CHF_MASK )
+      u32Status |= 1U << i;
+
+  HOST_R32( pETM->STATUS ) = u32Status;
+}
+
+static void HOST_EtmWrite( uint8_t u8Etm, uint32_t u32Address, uint64_t u64Old )
+{
+  ETM_Type *pETM = HOST_apEtm[u8Etm];
+  int i;
+
+  /* the flags are cleared by writing 0, a 1 written leaves them */
+  if ( u32Address == HOST_AT( pETM->SC ) && !( u64Old & ETM_SC_TOF_MASK ) )
+    HOST_R32( pETM->SC ) &= ~ETM_SC_TOF_MASK;
+
+  if ( u32Address == HOST_AT( pETM->CNT ) )
+  {
+    HOST_asEtm[u8Etm].u32Pos = 0;
+    HOST_asEtm[u8Etm].u64Rem = 0;
+  }
+
+  for ( i = 0; i < HOST_EtmChannels( u8Etm ); i++ )
+    if ( u32Address == HOST_AT( pETM->CONTROLS[i].CnSC ) && !( u64Old & ETM_CnSC_CHF_MASK ) )
+      HOST_R32( pETM->CONTROLS[i].CnSC ) &= ~ETM_CnSC_CHF_MASK;
+}
+
+/******************************************************************************
+* KBI
+******************************************************************************/
+static uint8_t HOST_KbiLine( uint8_t u8Kbi )
+{
+  uint8_t u8Sc = HOST_R8( HOST_apKbi[u8Kbi]->SC );
+
+  return ( u8Sc & KBI_SC_KBIE_MASK ) && ( u8Sc & KBI_SC_KBF_MASK );
+}
+
+static void HOST_KbiWrite( uint8_t u8Kbi, uint32_t u32Address, uint64_t u64Old )
+{
+  KBI_Type *pKBI = HOST_apKbi[u8Kbi];
+  uint8_t u8Sc = HOST_R8( pKBI->SC );
+
+  if ( u32Address != HOST_AT( pKBI->SC ) )
+    return;
+
+  /* KBF is read only, KBACK clears it and reads 0 */
+  u8Sc = ( u8Sc & ~KBI_SC_KBF_MASK ) | ( ( uint8_t )u64Old & KBI_SC_KBF_MASK );
+
+  if ( u8Sc & KBI_SC_KBACK_MASK )
+    u8Sc &= ~( KBI_SC_KBACK_MASK | KBI_SC_KBF_MASK );
+
+  HOST_R8( pKBI->SC ) = u8Sc;
+}
+
+/******************************************************************************
+* EFM and flash
+******************************************************************************/
+static void HOST_EfmUpdate( void )
+{
+  uint32_t u32Address = HOST_u32LatchAddress;
+
+  if ( !HOST_u32EfmOp || HOST_u64Ps < HOST_u64EfmEnd )
+    return;
+
+  if ( HOST_u32EfmOp == FLASH_CMD_PROGRAM && HOST_bLatch && u32Address < HOST_FLASH_SIZE )
+  {
+    *( uint32_t * )( HOST_pu8Flash + u32Address ) &= HOST_u32LatchData;
+  }
+  else if ( HOST_u32EfmOp == FLASH_CMD_ERASE_SECTOR && u32Address < HOST_FLASH_SIZE )
+  {
+    memset( HOST_pu8Flash + ( u32Address & ~( FLASH_SECTOR_SIZE - 1UL ) ), 0xFF, FLASH_SECTOR_SIZE );
+  }
+  else if ( HOST_u32EfmOp == FLASH_CMD_ERASE_ALL )
+  {
+    memset( HOST_pu8Flash, 0xFF, HOST_FLASH_SIZE );
+  }
+
+  HOST_bLatch = 0;
+  HOST_u32EfmOp = 0;
+  HOST_u32EfmStatus = EFM_STATUS_DONE;
+}
+
+static void HOST_EfmWrite( uint32_t u32Address )
+{
+  uint32_t u32Cmd = HOST_R32( EFMCMD );
+
+  if ( u32Address != HOST_AT( EFMCMD ) || HOST_u32EfmOp )
+    return;
+
+  if ( u32Cmd == FLASH_CMD_CLEAR )
+  {
+    HOST_u32EfmStatus = EFM_STATUS_READY;
+    return;
+  }
+
+  u32Cmd &= 0xFF000000;
+
+  if ( u32Cmd == FLASH_CMD_PROGRAM || u32Cmd == FLASH_CMD_ERASE_SECTOR || u32Cmd == FLASH_CMD_ERASE_ALL )
+  {
+    HOST_u32EfmOp = u32Cmd;
+    HOST_u32EfmStatus = 0;
+    HOST_u64EfmEnd = HOST_u64Ps + HOST_UsToPs( u32Cmd == FLASH_CMD_PROGRAM ? HOST_PROGRAM_US :
+                                               u32Cmd == FLASH_CMD_ERASE_SECTOR ? HOST_ERASE_SECTOR_US :
+                                               HOST_ERASE_ALL_US );
+  }
+}
+
+/******************************************************************************
+* ICS, OSC, SIM and PMC
+******************************************************************************/
+static uint8_t HOST_OscReady( void )
+{
+  return ( HOST_R8( OSC->CR ) & OSC_CR_OSCEN_MASK ) && HOST_u64Ps >= HOST_u64OscReady;
+}
+
+static void HOST_IcsRefresh( void )
+{
+  uint8_t u8C1 = HOST_R8( ICS->C1 ), u8S = 0;
+
+  u8S |= ICS_S_CLKST( ( u8C1 & ICS_C1_CLKS_MASK ) >> ICS_C1_CLKS_SHIFT );
+
+  if ( u8C1 & ICS_C1_IREFS_MASK )
+    u8S |= ICS_S_IREFST_MASK;
+
+  if ( HOST_u64Ps >= HOST_u64FllLock && ( ( u8C1 & ICS_C1_IREFS_MASK ) || HOST_OscReady( ) ) )
+    u8S |= ICS_S_LOCK_MASK;
+
+  HOST_R8( ICS->S ) = u8S;
+  HOST_R8( OSC->CR ) = ( HOST_R8( OSC->CR ) & ~OSC_CR_OSCINIT_MASK ) | ( HOST_OscReady( ) ? OSC_CR_OSCINIT_MASK : 0 );
+}
+
+static uint32_t HOST_LvwTrip( void )
+{
+  static const uint16_t au16Low[4] = { 2700, 2800, 2900, 3000 };
+  static const uint16_t au16High[4] = { 4400, 4500, 4600, 4700 };
+  uint8_t u8Spmsc2 = HOST_R8( PMC->SPMSC2 );
+  uint8_t u8Lvwv = ( u8Spmsc2 & PMC_SPMSC2_LVWV_MASK ) >> PMC_SPMSC2_LVWV_SHIFT;
+
+  return ( u8Spmsc2 & PMC_SPMSC2_LVDV_MASK ) ? au16High[u8Lvwv] : au16Low[u8Lvwv];
+}
+
+static uint32_t HOST_LvdTrip( void )
+{
+  return ( HOST_R8( PMC->SPMSC2 ) & PMC_SPMSC2_LVDV_MASK ) ? 4300 : 2560;
+}
+
+static void HOST_PmcUpdate( void )
+{
+  if ( HOST_u32Supply < HOST_LvwTrip( ) )
+    HOST_bLvwf = 1;
+}
+
+/******************************************************************************
+* NVIC and SCB
+******************************************************************************/
+static uint32_t HOST_Priority( int iIrq )
+{
+  if ( iIrq < 0 )
+    return HOST_pu8Regs[HOST_PERIPH_SIZE + ( SCB_BASE - HOST_SCS_PAGE ) + 0x1F];
+
+  return HOST_pu8Regs[HOST_PERIPH_SIZE + ( NVIC_BASE - HOST_SCS_PAGE ) + 0x300 + iIrq];
+}
+
+/* the exception to take now: -1 SysTick, 0 ~ 31 an IRQ, -2 none */
+static int HOST_Select( void )
+{
+  uint32_t u32Best = HOST_iDepth ? HOST_au32ActivePrio[HOST_iDepth - 1] : HOST_THREAD;
+  uint32_t u32Ready = HOST_u32Pending & HOST_u32Enabled;
+  int iBest = -2, i;
+
+  if ( HOST_u32Primask )
+    return -2;
+
+  if ( HOST_bSysTickPending && HOST_Priority( -1 ) < u32Best )
+  {
+    iBest = -1;
+    u32Best = HOST_Priority( -1 );
+  }
+
+  for ( i = 0; i < 32; i++ )
+  {
+    if ( ( u32Ready & ( 1U << i ) ) && HOST_Priority( i ) < u32Best )
+    {
+      iBest = i;
+      u32Best = HOST_Priority( i );
+    }
+  }
+
+  return iBest;
+}
+
+static void HOST_ScsRefresh( void )
+{
+  uint32_t u32Ctrl = HOST_R32( SysTick->CTRL ) & ~SysTick_CTRL_COUNTFLAG_Msk;
+
+  HOST_R32( SysTick->CTRL ) = u32Ctrl | ( HOST_bCountFlag ? SysTick_CTRL_COUNTFLAG_Msk : 0 );
+  HOST_R32( SysTick->VAL ) = HOST_TickValue( );
+  HOST_R32( NVIC->ISER[0] ) = HOST_u32Enabled;
+  HOST_R32( NVIC->ICER[0] ) = HOST_u32Enabled;
+  HOST_R32( NVIC->ISPR[0] ) = HOST_u32Pending;
+  HOST_R32( NVIC->ICPR[0] ) = HOST_u32Pending;
+  HOST_R32( SCB->ICSR ) = HOST_Ipsr( ) | ( HOST_bSysTickPending ? SCB_ICSR_PENDSTSET_Msk : 0 );
+  HOST_R32( SCB->CPUID ) = 0x410CC601;
+}
+
+static void HOST_ScsWrite( uint32_t u32Address, uint64_t u64Old )
+{
+  uint32_t u32Value = HOST_R32( *( volatile uint32_t * )( uintptr_t )( u32Address & ~3U ) );
+
+  if ( u32Address == HOST_AT( SysTick->CTRL ) )
+  {
+    uint8_t bOn = ( u32Value & SysTick_CTRL_ENABLE_Msk ) != 0;
+
+    if ( bOn != HOST_bTickOn )
+    {
+      HOST_TickRebase( );
+      HOST_bTickOn = bOn;
+    }
+  }
+  else if ( u32Address == HOST_AT( SysTick->LOAD ) )
+  {
+    HOST_R32( SysTick->LOAD ) = ( uint32_t )u64Old;
+    HOST_TickRebase( );
+    HOST_R32( SysTick->LOAD ) = u32Value;
+  }
+  else if ( u32Address == HOST_AT( SysTick->VAL ) )
+  {
+    HOST_u32TickVal = 0;
+    HOST_u64TickStart = HOST_u64Clock;
+    HOST_u64TickZeros = 0;
+    HOST_bCountFlag = 0;
+  }
+  else if ( u32Address == HOST_AT( NVIC->ISER[0] ) )
+  {
+    HOST_u32Enabled |= u32Value;
+  }
+  else if ( u32Address == HOST_AT( NVIC->ICER[0] ) )
+  {
+    HOST_u32Enabled &= ~u32Value;
+  }
+  else if ( u32Address == HOST_AT( NVIC->ISPR[0] ) )
+  {
+    HOST_u32Pending |= u32Value;
+  }
+  else if ( u32Address == HOST_AT( NVIC->ICPR[0] ) )
+  {
+    HOST_u32Pending &= ~u32Value;
+  }
+  else if ( u32Address == HOST_AT( SCB->ICSR ) )
+  {
+    if ( u32Value & SCB_ICSR_PENDSTSET_Msk )
+      HOST_bSysTickPending = 1;
+
+    if ( u32Value & SCB_ICSR_PENDSTCLR_Msk )
+      HOST_bSysTickPending = 0;
+  }
+  else if ( u32Address == HOST_AT( SCB->AIRCR ) )
+  {
+    if ( ( u32Value & SCB_AIRCR_VECTKEY_Msk ) == ( 0x05FAUL << SCB_AIRCR_VECTKEY_Pos ) &&
+         ( u32Value & SCB_AIRCR_SYSRESETREQ_Msk ) )
+      HOST_Reset( SIM_SRSID_SW_MASK );
+  }
+}
+
+/******************************************************************************
+* GPIO
+******************************************************************************/
+static void HOST_GpioLevels( void )
+{
+  int i;
+
+  for ( i = 0; i < 3; i++ )
+  {
+    uint32_t u32Dir = HOST_R32( HOST_apGpio[i]->PDDR );
+    uint32_t u32Level = ( HOST_R32( HOST_apGpio[i]->PDOR ) & u32Dir ) | ( HOST_au32External[i] & ~u32Dir );
+
+    if ( u32Level != HOST_au32Level[i] )
+    {
+      uint32_t u32Old = HOST_au32Level[i];
+
+      HOST_au32Level[i] = u32Level;
+
+      if ( HOST_pfnEdge )
+        HOST_pfnEdge( i, u32Old, u32Level );
+    }
+  }
+}
+
+static void HOST_GpioRefresh( void )
+{
+  int i;
+
+  for ( i = 0; i < 3; i++ )
+  {
+    HOST_R32( HOST_apGpio[i]->PDIR ) = HOST_au32Level[i] & ~HOST_R32( HOST_apGpio[i]->PIDR );
+    HOST_R32( HOST_apGpio[i]->PSOR ) = 0;
+    HOST_R32( HOST_apGpio[i]->PCOR ) = 0;
+    HOST_R32( HOST_apGpio[i]->PTOR ) = 0;
+  }
+}
+
+static void HOST_GpioWrite( uint32_t u32Address )
+{
+  int i;
+
+  for ( i = 0; i < 3; i++ )
+  {
+    GPIO_Type *pGPIO = HOST_apGpio[i];
+
+    if ( u32Address == HOST_AT( pGPIO->PSOR ) )
+      HOST_R32( pGPIO->PDOR ) |= HOST_R32( pGPIO->PSOR );
+    else if ( u32Address == HOST_AT( pGPIO->PCOR ) )
+      HOST_R32( pGPIO->PDOR ) &= ~HOST_R32( pGPIO->PCOR );
+    else if ( u32Address == HOST_AT( pGPIO->PTOR ) )
+      HOST_R32( pGPIO->PDOR ) ^= HOST_R32( pGPIO->PTOR );
+  }
+
+  HOST_GpioLevels( );
+}
+
+/******************************************************************************
+* access dispatch
+******************************************************************************/
+static void HOST_Refresh( uint32_t u32Address )
+{
+  uint32_t u32Page = HOST_Canonical( u32Address ) & ~( HOST_PAGE - 1 );
+  int i;
+
+  for ( i = 0; i < 3; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apUart[i] )
+      HOST_UartRefresh( i );
+
+  for ( i = 0; i < 2; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apSpi[i] )
+      HOST_SpiRefresh( i );
+
+  for ( i = 0; i < 3; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apEtm[i] )
+      HOST_EtmRefresh( i );
+
+  if ( u32Page == ADC_BASE )
+    HOST_AdcRefresh( );
+  else if ( u32Page == CRC_BASE )
+    HOST_R32( CRC0->DATA ) = HOST_CrcResult( );
+  else if ( u32Page == PIT_BASE )
+    HOST_PitRefresh( );
+  else if ( u32Page == RTC_BASE )
+    HOST_RtcRefresh( );
+  else if ( u32Page == ICS_BASE || u32Page == OSC_BASE )
+    HOST_IcsRefresh( );
+  else if ( u32Page == SIM_BASE )
+    HOST_R32( SIM->SRSID ) = HOST_u32Cause;
+  else if ( u32Page == PMC_BASE )
+    HOST_R8( PMC->SPMSC1 ) = ( HOST_R8( PMC->SPMSC1 ) & ~PMC_SPMSC1_LVWF_MASK ) | ( HOST_bLvwf ? PMC_SPMSC1_LVWF_MASK : 0 );
+  else if ( u32Page == ( HOST_AT( EFMCMD ) & ~( HOST_PAGE - 1 ) ) )
+    *( uint64_t * )HOST_Reg( HOST_AT( EFMCMD ) ) = HOST_u32EfmStatus;
+  else if ( u32Page == HOST_SCS_PAGE )
+    HOST_ScsRefresh( );
+  else if ( u32Page == HOST_GPIO_PAGE )
+    HOST_GpioRefresh( );
+}
+
+static void HOST_Write( uint32_t u32Address, uint8_t u8Width, uint64_t u64Old )
+{
+  uint32_t u32Page;
+  int i;
+
+  u32Address = HOST_Canonical( u32Address );
+  u32Page = u32Address & ~( HOST_PAGE - 1 );
+
+  for ( i = 0; i < 3; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apUart[i] )
+      HOST_UartWrite( i, u32Address );
+
+  for ( i = 0; i < 2; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apSpi[i] )
+      HOST_SpiWrite( i, u32Address );
+
+  for ( i = 0; i < 3; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apEtm[i] )
+      HOST_EtmWrite( i, u32Address, u64Old );
+
+  for ( i = 0; i < 2; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apKbi[i] )
+      HOST_KbiWrite( i, u32Address, u64Old );
+
+  if ( u32Page == ADC_BASE )
+  {
+    HOST_AdcWrite( u32Address );
+  }
+  else if ( u32Page == CRC_BASE )
+  {
+    HOST_CrcWrite( u32Address, u8Width );
+  }
+  else if ( u32Page == PIT_BASE )
+  {
+    HOST_PitWrite( u32Address, u64Old );
+  }
+  else if ( u32Page == RTC_BASE )
+  {
+    HOST_RtcWrite( u32Address, u64Old );
+  }
+  else if ( u32Page == ICS_BASE || u32Page == OSC_BASE || u32Page == SIM_BASE )
+  {
+    if ( u32Address == HOST_AT( OSC->CR ) && !( u64Old & OSC_CR_OSCEN_MASK ) &&
+         ( HOST_R8( OSC->CR ) & OSC_CR_OSCEN_MASK ) )
+      HOST_u64OscReady = HOST_u64Ps + ( ( HOST_R8( OSC->CR ) & OSC_CR_OSCOS_MASK ) ? HOST_UsToPs( HOST_u32OscStartUs ) : 0 );
+
+    /* the FLL locks again to a new reference */
+    if ( u32Address == HOST_AT( ICS->C1 ) &&
+         ( ( HOST_R8( ICS->C1 ) ^ ( uint8_t )u64Old ) & ( ICS_C1_IREFS_MASK | ICS_C1_RDIV_MASK ) ) )
+      HOST_u64FllLock = HOST_u64Ps + HOST_UsToPs( HOST_u32FllLockUs );
+
+    if ( u32Address == HOST_AT( SIM->SRSID ) )
+      HOST_R32( SIM->SRSID ) = HOST_u32Cause;
+
+    HOST_Clocks( );
+  }
+  else if ( u32Page == PMC_BASE )
+  {
+    if ( u32Address == HOST_AT( PMC->SPMSC1 ) && ( HOST_R8( PMC->SPMSC1 ) & PMC_SPMSC1_LVWACK_MASK ) &&
+         HOST_u32Supply >= HOST_LvwTrip( ) )
+      HOST_bLvwf = 0;
+
+    HOST_R8( PMC->SPMSC1 ) &= ~PMC_SPMSC1_LVWACK_MASK;
+  }
+  else if ( u32Page == ( HOST_AT( EFMCMD ) & ~( HOST_PAGE - 1 ) ) )
+  {
+    HOST_EfmWrite( u32Address );
+  }
+  else if ( u32Page == HOST_SCS_PAGE )
+  {
+    HOST_ScsWrite( u32Address, u64Old );
+  }
+  else if ( u32Page == HOST_GPIO_PAGE )
+  {
+    HOST_GpioWrite( u32Address );
+  }
+}
+
+static void HOST_Read( uint32_t u32Address )
+{
+  uint32_t u32Page = u32Address & ~( HOST_PAGE - 1 );
+  int i;
+
+  for ( i = 0; i < 3; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apUart[i] )
+      HOST_UartRead( i, u32Address );
+
+  for ( i = 0; i < 2; i++ )
+    if ( u32Page == ( uint32_t )( uintptr_t )HOST_apSpi[i] )
+      HOST_SpiRead( i, u32Address );
+
+  if ( u32Page == ADC_BASE )
+    HOST_AdcRead( u32Address );
+  else if ( u32Address == HOST_AT( SysTick->CTRL ) )
+    HOST_bCountFlag = 0;
+}
+
+/* core clocks to the next model event, 0 when none */
+static uint64_t HOST_NextEvent( void )
+{
+  uint64_t u64Next = HOST_NONE;
+  int i;
+
+  for ( i = 0; i < 3; i++ )
+    u64Next = HOST_Min( u64Next, HOST_UartNext( i ) );
+
+  for ( i = 0; i < 2; i++ )
+    if ( HOST_asSpi[i].bBusy )
+      u64Next = HOST_Min( u64Next, HOST_FromBus( HOST_asSpi[i].u64End ) );
+
+  for ( i = 0; i < 3; i++ )
+    u64Next = HOST_Min( u64Next, HOST_EtmNext( i ) );
+
+  if ( HOST_sAdc.bBusy )
+    u64Next = HOST_Min( u64Next, HOST_FromBus( HOST_sAdc.u64End ) );
+
+  if ( HOST_u32EfmOp )
+    u64Next = HOST_Min( u64Next, HOST_FromPs( HOST_u64EfmEnd ) );
+
+  if ( HOST_u64Ps < HOST_u64OscReady )
+    u64Next = HOST_Min( u64Next, HOST_FromPs( HOST_u64OscReady ) );
+
+  if ( HOST_u64Ps < HOST_u64FllLock )
+    u64Next = HOST_Min( u64Next, HOST_FromPs( HOST_u64FllLock ) );
+
+  for ( i = 0; i < HOST_iTimed; i++ )
+    u64Next = HOST_Min( u64Next, HOST_asTimed[i].u64Clock > HOST_u64Clock ?
+                        HOST_asTimed[i].u64Clock - HOST_u64Clock : 1 );
+
+  u64Next = HOST_Min( u64Next, HOST_PitNext( ) );
+  u64Next = HOST_Min( u64Next, HOST_TickNext( ) );
+  u64Next = HOST_Min( u64Next, HOST_RtcNext( ) );
+
+  return u64Next == HOST_NONE ? 0 : u64Next;
+}
+
+/* bring every model to the model clock and pend the interrupts raised */
+static void HOST_Update( void )
+{
+  uint32_t u32Lines = 0;
+  int i;
+
+  if ( HOST_bUpdating )
+    return;
+
+  HOST_bUpdating = 1;
+
+  for ( i = 0; i < HOST_iTimed; )
+  {
+    if ( HOST_asTimed[i].u64Clock <= HOST_u64Clock )
+    {
+      HOST_TimedType sTimed = HOST_asTimed[i];
+
+      HOST_asTimed[i] = HOST_asTimed[--HOST_iTimed];
+      sTimed.pfnEvent( sTimed.pArg );
+      i = 0;
+    }
+    else
+    {
+      i++;
+    }
+  }
+
+  for ( i = 0; i < 3; i++ )
+  {
+    HOST_UartUpdate( i );
+    HOST_EtmUpdate( i );
+
+    if ( HOST_UartLine( i ) )
+      u32Lines |= 1U << ( UART0_IRQn + i );
+
+    if ( HOST_EtmLine( i ) )
+      u32Lines |= 1U << ( ETM0_IRQn + i );
+  }
+
+  for ( i = 0; i < 2; i++ )
+  {
+    HOST_SpiUpdate( i );
+
+    if ( HOST_SpiLine( i ) )
+      u32Lines |= 1U << ( SPI0_IRQn + i );
+
+    if ( HOST_KbiLine( i ) )
+      u32Lines |= 1U << ( KBI0_IRQn + i );
+  }
+
+  HOST_AdcUpdate( );
+  HOST_PitUpdate( );
+  HOST_RtcUpdate( );
+  HOST_EfmUpdate( );
+  HOST_PmcUpdate( );
+  HOST_TickUpdate( );
+
+  if ( ( HOST_R32( ADC->SC1 ) & ADC_SC1_AIEN_MASK ) && HOST_sAdc.bCoco )
+    u32Lines |= 1U << ADC0_IRQn;
+
+  for ( i = 0; i < 2; i++ )
+    if ( ( HOST_R32( PIT->CHANNEL[i].TCTRL ) & PIT_TCTRL_TIE_MASK ) && HOST_au8PitTif[i] )
+      u32Lines |= 1U << ( PIT_CH0_IRQn + i );
+
+  if ( ( HOST_R32( RTC->SC ) & RTC_SC_RTIE_MASK ) && HOST_bRtif )
+    u32Lines |= 1U << RTC_IRQn;
+
+  if ( ( HOST_R8( PMC->SPMSC1 ) & PMC_SPMSC1_LVWIE_MASK ) && HOST_bLvwf )
+    u32Lines |= 1U << LVD_LVW_IRQn;
+
+  /* a level still asserted pends again at the return of its handler */
+  for ( i = 0; i < HOST_iDepth; i++ )
+    if ( HOST_aiActive[i] >= 0 )
+      u32Lines &= ~( 1U << HOST_aiActive[i] );
+
+  HOST_u32Pending |= u32Lines;
+  HOST_bUpdating = 0;
+
+  if ( HOST_bLvdReset )
+  {
+    HOST_bLvdReset = 0;
+    HOST_Reset( SIM_SRSID_LVD_MASK );
+  }
+}
+
+/* exceptions taken at an access or an instruction, from the SIGTRAP handler */
+static void HOST_Preempt( ucontext_t * pContext )
+{
+  greg_t *pRegs = pContext->uc_mcontext.gregs;
+  uint64_t *pu64Frame;
+  uint64_t u64Sp;
+  uint16_t u16Ss;
+
+  if ( HOST_iInModel || HOST_Select( ) == -2 )
+    return;
+
+  /* an iretq frame below the red zone and below this signal frame, which
+     sigreturn still reads: the return gives back rip, rflags and rsp */
+  u64Sp = HOST_Min( ( uint64_t )( uintptr_t )&u64Sp - 512, ( uint64_t )pRegs[REG_RSP] - 128 ) & ~15ULL;
+  __asm__( "movw %%ss, %0" : "=r"( u16Ss ) );
+  pu64Frame = ( uint64_t * )( uintptr_t )u64Sp;
+  pu64Frame[0] = ( uint64_t )pRegs[REG_RIP];
+  pu64Frame[1] = ( uint64_t )pRegs[REG_CSGSFS] & 0xFFFF;
+  pu64Frame[2] = ( uint64_t )pRegs[REG_EFL];
+  pu64Frame[3] = ( uint64_t )pRegs[REG_RSP];
+  pu64Frame[4] = u16Ss;
+  pRegs[REG_RSP] = ( greg_t )u64Sp;
+  pRegs[REG_RIP] = ( greg_t )( uintptr_t )HOST_IrqEntry;
+}
+
+static void HOST_Segv( int iSignal, siginfo_t * pInfo, void * pVoid )
+{
+  ucontext_t *pContext = pVoid;
+  greg_t *pRegs = pContext->uc_mcontext.gregs;
+  uintptr_t uAddress = ( uintptr_t )pInfo->si_addr;
+  HOST_AccessType *pAccess;
+  uint8_t *pBackdoor;
+  uint64_t u64Value;
+
+  ( void )iSignal;
+
+  if ( uAddress >= HOST_FLASH_MAPPED && uAddress < HOST_FLASH_SIZE && ( pRegs[REG_ERR] & 2 ) )
+    pBackdoor = HOST_pu8Flash + uAddress;
+  else if ( uAddress > 0xFFFFFFFFUL || !( pBackdoor = HOST_Reg( ( uint32_t )uAddress ) ) )
+    HOST_Fatal( "access to 0x%lx not modelled, at %p", ( unsigned long )uAddress, ( void * )pRegs[REG_RIP] );
+
+  if ( HOST_iAccesses == 4 )
+    HOST_Fatal( "instruction at %p accesses too many registers", ( void * )pRegs[REG_RIP] );
+
+  pAccess = &HOST_asAccess[HOST_iAccesses++];
+  pAccess->u32Address = ( uint32_t )uAddress;
+  pAccess->bWrite = ( pRegs[REG_ERR] & 2 ) != 0;
+  pAccess->bFlash = uAddress < HOST_FLASH_SIZE;
+  pAccess->u8Width = HOST_Width( ( const uint8_t * )pRegs[REG_RIP] );
+
+  HOST_Tick( HOST_u32AccessClocks );
+  HOST_Update( );
+
+  if ( !pAccess->bFlash )
+  {
+    HOST_Refresh( pAccess->u32Address );
+    u64Value = HOST_Bytes( pBackdoor, pAccess->u8Width );
+
+    /* one instruction polling a register that does not change, skip to what changes it */
+    if ( !pAccess->bWrite && pAccess->u32Address == HOST_u32PollAddress &&
+         ( uint64_t )pRegs[REG_RIP] == HOST_u64PollCode && u64Value == HOST_u64PollValue )
+    {
+      if ( ++HOST_u32Polls >= 2 && HOST_NextEvent( ) > HOST_u32AccessClocks )
+      {
+        HOST_Tick( HOST_NextEvent( ) );
+        HOST_Update( );
+        HOST_Refresh( pAccess->u32Address );
+      }
+    }
+    else
+    {
+      HOST_u32PollAddress = pAccess->bWrite ? 0 : pAccess->u32Address;
+      HOST_u64PollCode = ( uint64_t )pRegs[REG_RIP];
+      HOST_u64PollValue = u64Value;
+      HOST_u32Polls = 0;
+    }
+  }
+
+  memcpy( pAccess->au8Old, pBackdoor, 8 );
+  HOST_Protect( 1 );
+  pRegs[REG_EFL] |= HOST_TF;
+}
+
+static void HOST_Trap( int iSignal, siginfo_t * pInfo, void * pVoid )
+{
+  ucontext_t *pContext = pVoid;
+  greg_t *pRegs = pContext->uc_mcontext.gregs;
+  int i;
+
+  ( void )iSignal;
+  ( void )pInfo;
+
+  if ( HOST_iAccesses )
+  {
+    HOST_Protect( 0 );
+
+    for ( i = 0; i < HOST_iAccesses; i++ )
+    {
+      HOST_AccessType *pAccess = &HOST_asAccess[i];
+
+      if ( pAccess->bFlash )
+      {
+        /* the EFM latches the word, the array changes only by command */
+        HOST_u32LatchAddress = pAccess->u32Address;
+        memcpy( &HOST_u32LatchData, HOST_pu8Flash + pAccess->u32Address, 4 );
+        HOST_bLatch = 1;
+        memcpy( HOST_pu8Flash + pAccess->u32Address, pAccess->au8Old,
+                HOST_Min( 8, HOST_FLASH_SIZE - pAccess->u32Address ) );
+        continue;
+      }
+
+      if ( pAccess->bWrite || memcmp( pAccess->au8Old, HOST_Reg( pAccess->u32Address ), pAccess->u8Width ) )
+        HOST_Write( pAccess->u32Address, pAccess->u8Width, HOST_Bytes( pAccess->au8Old, 8 ) );
+      else
+        HOST_Read( HOST_Canonical( pAccess->u32Address ) );
+    }
+
+    HOST_iAccesses = 0;
+    HOST_Update( );
+  }
+
+  if ( HOST_bStepping && !HOST_iInModel )
+  {
+    HOST_u64Steps++;
+    HOST_Tick( 1 );
+    HOST_Update( );
+  }
+
+  if ( !HOST_bStepping )
+    pRegs[REG_EFL] &= ~HOST_TF;
+
+  HOST_Preempt( pContext );
+}
+
+static void HOST_PowerOn( uint32_t u32Cause )
+{
+  int i;
+
+  HOST_Protect( 0 );
+  HOST_iAccesses = 0;
+  HOST_u32PollAddress = 0;
+  HOST_bStepping = 0;
+  HOST_iInModel = 0;
+  HOST_bUpdating = 0;
+  HOST_u32Primask = 0;
+  HOST_iDepth = 0;
+  HOST_u32Enabled = 0;
+  HOST_u32Pending = 0;
+  HOST_bSysTickPending = 0;
+  HOST_u32Cause = u32Cause;
+
+  memset( HOST_pu8Regs, 0, HOST_REGS_SIZE );
+
+  for ( i = 0; i < 3; i++ )
+  {
+    HOST_UartTxType pfnTx = HOST_asUart[i].pfnTx;
+    uint32_t u32Head = HOST_asUart[i].u32Head, u32Tail = HOST_asUart[i].u32Tail;
+
+    /* what the host sends meanwhile is lost, the line keeps its timing */
+    memset( &HOST_asUart[i], 0, sizeof( HOST_UartType ) - HOST_UART_QUEUE - sizeof( HOST_UartTxType ) - 8 );
+    HOST_asUart[i].pfnTx = pfnTx;
+    HOST_asUart[i].u32Head = u32Head;
+    HOST_asUart[i].u32Tail = u32Tail;
+    HOST_asUart[i].u8S1 = UART_S1_TDRE_MASK | UART_S1_TC_MASK;
+
+    if ( u32Head != u32Tail )
+      HOST_asUart[i].u64RxAt = HOST_u64Bus + 160;
+  }
+
+  for ( i = 0; i < 2; i++ )
+  {
+    HOST_SpiSlaveType pfnSlave = HOST_asSpi[i].pfnSlave;
+
+    memset( &HOST_asSpi[i], 0, sizeof( HOST_SpiType ) );
+    HOST_asSpi[i].pfnSlave = pfnSlave;
+    HOST_asSpi[i].u8S = SPI_S_SPTEF_MASK;
+    HOST_R8( HOST_apSpi[i]->S ) = SPI_S_SPTEF_MASK;
+  }
+
+  for ( i = 0; i < 3; i++ )
+  {
+    memset( &HOST_asEtm[i], 0, sizeof( HOST_EtmType ) );
+    HOST_asEtm[i].u64Last = HOST_u64Clock;
+  }
+
+  memset( &HOST_sAdc, 0, sizeof( HOST_sAdc ) );
+  HOST_R32( ADC->SC1 ) = ADC_SC1_ADCH_MASK;
+  HOST_R32( ADC->SC2 ) = ADC_SC2_FEMPTY_MASK;
+
+  HOST_u32Crc = 0xFFFFFFFF;
+  HOST_R32( CRC0->DATA ) = 0xFFFFFFFF;
+  HOST_R32( CRC0->GPOLY ) = 0x1021;
+
+  HOST_R32( PIT->MCR ) = PIT_MCR_MDIS_MASK;
+  HOST_au32PitVal[0] = HOST_au32PitVal[1] = 0;
+  HOST_au8PitTif[0] = HOST_au8PitTif[1] = 0;
+  HOST_u64PitLast = HOST_u64Bus;
+
+  HOST_u32RtcCnt = 0;
+  HOST_bRtif = 0;
+  HOST_u64RtcLast = HOST_u64Ps;
+  HOST_u64RtcAcc = 0;
+
+  HOST_u32EfmOp = 0;
+  HOST_u32EfmStatus = EFM_STATUS_READY;
+  HOST_bLatch = 0;
+
+  /* FEI with the output divided by 2, the FLL locks after the reset */
+  HOST_R8( ICS->C1 ) = ICS_C1_IREFS_MASK;
+  HOST_R8( ICS->C2 ) = ICS_C2_BDIV( 1 );
+  HOST_R8( ICS->C3 ) = 0x50;
+  HOST_u64FllLock = HOST_u64Ps + HOST_UsToPs( HOST_u32FllLockUs );
+  HOST_u64OscReady = 0;
+
+  HOST_R32( SIM->SOPT ) = SIM_SOPT_NMIE_MASK | SIM_SOPT_RSTPE_MASK | SIM_SOPT_SWDE_MASK;
+  HOST_R32( SIM->SCGC ) = SIM_SCGC_SWD_MASK | SIM_SCGC_FLASH_MASK;
+  HOST_R32( SIM->UUIDL ) = 0x4E563332;
+  HOST_R32( SIM->UUIDM ) = 0x484F5354;
+  HOST_R32( SIM->UUIDH ) = 0x00000001;
+  HOST_R8( WDOG->CS1 ) = WDOG_CS1_EN_MASK;
+  HOST_R8( PMC->SPMSC1 ) = PMC_SPMSC1_LVDE_MASK | PMC_SPMSC1_LVDRE_MASK | PMC_SPMSC1_LVDSE_MASK;
+  HOST_bLvwf = 0;
+  HOST_bLvdReset = 0;
+
+  HOST_bTickOn = 0;
+  HOST_u32TickVal = 0;
+  HOST_u64TickStart = HOST_u64Clock;
+  HOST_u64TickZeros = 0;
+  HOST_bCountFlag = 0;
+  HOST_R32( SCB->AIRCR ) = 0xFA050000;
+  HOST_R32( SCB->VTOR ) = ( uint32_t )( uintptr_t )__vector_table;
+
+  for ( i = 0; i < 3; i++ )
+    HOST_au32Level[i] = HOST_au32External[i];
+
+  HOST_Clocks( );
+}
+
+static void HOST_Unhandled( void )
+{
+  HOST_Fatal( "exception %u has no handler", ( unsigned )HOST_Ipsr( ) );
+}
+
+/* exception entry from HOST_Preempt, the interrupted registers kept */
+__asm__(
+  "  .text\n"
+  "  .globl HOST_IrqEntry\n"
+  "HOST_IrqEntry:\n"
+  "  pushq %rax\n"
+  "  pushq %rcx\n"
+  "  pushq %rdx\n"
+  "  pushq %rsi\n"
+  "  pushq %rdi\n"
+  "  pushq %r8\n"
+  "  pushq %r9\n"
+  "  pushq %r10\n"
+  "  pushq %r11\n"
+  "  subq $520, %rsp\n"
+  "  fxsave (%rsp)\n"
+  "  cld\n"
+  "  call HOST_Dispatch\n"
+  "  fxrstor (%rsp)\n"
+  "  addq $520, %rsp\n"
+  "  popq %r11\n"
+  "  popq %r10\n"
+  "  popq %r9\n"
+  "  popq %r8\n"
+  "  popq %rdi\n"
+  "  popq %rsi\n"
+  "  popq %rdx\n"
+  "  popq %rcx\n"
+  "  popq %rax\n"
+  "  iretq\n" );
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+
+/*****************************************************************************//*!
+*
+* @brief map the register model and the flash, power on reset.
+*
+* @return none
+*
+*****************************************************************************/
+void HOST_Init( void )
+{
+  struct sigaction sAction;
+  int iRegs = memfd_create( "nv32-regs", 0 ), iFlash = memfd_create( "nv32-flash", 0 );
+  void *pFixed;
+
+  if ( iRegs < 0 || iFlash < 0 || ftruncate( iRegs, HOST_REGS_SIZE ) || ftruncate( iFlash, HOST_FLASH_SIZE ) )
+    HOST_Fatal( "no memory for the model" );
+
+  HOST_pu8Regs = mmap( NULL, HOST_REGS_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, iRegs, 0 );
+  HOST_pu8Flash = mmap( NULL, HOST_FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, iFlash, 0 );
+
+  if ( HOST_pu8Regs == MAP_FAILED || HOST_pu8Flash == MAP_FAILED )
+    HOST_Fatal( "backdoor mapping failed" );
+
+  pFixed = mmap( ( void * )HOST_PERIPH_BASE, HOST_PERIPH_SIZE, PROT_NONE, MAP_SHARED | MAP_FIXED_NOREPLACE, iRegs, 0 );
+  pFixed = pFixed == MAP_FAILED ? pFixed :
+           mmap( ( void * )HOST_SCS_PAGE, HOST_PAGE, PROT_NONE, MAP_SHARED | MAP_FIXED_NOREPLACE, iRegs, HOST_PERIPH_SIZE );
+  pFixed = pFixed == MAP_FAILED ? pFixed :
+           mmap( ( void * )HOST_MCM_PAGE, HOST_PAGE, PROT_NONE, MAP_SHARED | MAP_FIXED_NOREPLACE, iRegs, HOST_PERIPH_SIZE + HOST_PAGE );
+  pFixed = pFixed == MAP_FAILED ? pFixed :
+           mmap( ( void * )HOST_FGPIO_PAGE, HOST_PAGE, PROT_NONE, MAP_SHARED | MAP_FIXED_NOREPLACE, iRegs,
+                 HOST_GPIO_PAGE - HOST_PERIPH_BASE );
+  pFixed = pFixed == MAP_FAILED ? pFixed :
+           mmap( ( void * )HOST_FLASH_MAPPED, HOST_FLASH_SIZE - HOST_FLASH_MAPPED, PROT_READ,
+                 MAP_SHARED | MAP_FIXED_NOREPLACE, iFlash, HOST_FLASH_MAPPED );
+
+  if ( pFixed == MAP_FAILED )
+    HOST_Fatal( "the NV32 addresses can not be mapped, link with -no-pie" );
+
+  memset( HOST_pu8Flash, 0xFF, HOST_FLASH_SIZE );
+
+  memset( &sAction, 0, sizeof( sAction ) );
+  sAction.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sAction.sa_sigaction = HOST_Segv;
+  sigaction( SIGSEGV, &sAction, NULL );
+  sAction.sa_sigaction = HOST_Trap;
+  sigaction( SIGTRAP, &sAction, NULL );
+
+  {
+    static void ( * const apHandlers[48] )( void ) = {
+      [2] = NMI_Handler, [3] = HardFault_Handler, [11] = SVC_Handler, [14] = PendSV_Handler,
+      [15] = SysTick_Handler, [21] = ETMRH_IRQHandler, [22] = LVD_LVW_IRQHandler,
+      [23] = IRQ_IRQHandler, [24] = I2C0_IRQHandler, [26] = SPI0_IRQHandler,
+      [27] = SPI1_IRQHandler, [28] = UART0_IRQHandler, [29] = UART1_IRQHandler,
+      [30] = UART2_IRQHandler, [31] = ADC0_IRQHandler, [32] = ACMP0_IRQHandler,
+      [33] = ETM0_IRQHandler, [34] = ETM1_IRQHandler, [35] = ETM2_IRQHandler,
+      [36] = RTC_IRQHandler, [37] = ACMP1_IRQHandler, [38] = PIT_CH0_IRQHandler,
+      [39] = PIT_CH1_IRQHandler, [40] = KBI0_IRQHandler, [41] = KBI1_IRQHandler,
+      [43] = ICS_IRQHandler, [44] = Watchdog_IRQHandler };
+    int i;
+
+    for ( i = 2; i < 48; i++ )
+      __vector_table[i] = ( uint32_t )( uintptr_t )( apHandlers[i] ? apHandlers[i] : HOST_Unhandled );
+  }
+
+  HOST_PowerOn( SIM_SRSID_POR_MASK );
+}
+
+/*****************************************************************************//*!
+*
+* @brief arm the reset point of HOST_BOOT.
+*
+* @return the jump buffer
+*
+*****************************************************************************/
+sigjmp_buf * HOST_Arm( void )
+{
+  HOST_bArmed = 1;
+  return &HOST_sBoot;
+}
+
+/*****************************************************************************//*!
+*
+* @brief reset the registers and the models, the flash and the RAM are kept,
+*        continue at HOST_BOOT.
+*
+* @param[in] u32Cause  SIM_SRSID reset source, 0 for a software reset
+*
+* @return none
+*
+*****************************************************************************/
+void HOST_Reset( uint32_t u32Cause )
+{
+  if ( !u32Cause )
+    u32Cause = SIM_SRSID_SW_MASK;
+
+  if ( !HOST_bArmed )
+    HOST_Fatal( "reset 0x%x without HOST_BOOT", ( unsigned )u32Cause );
+
+  HOST_PowerOn( u32Cause );
+  siglongjmp( HOST_sBoot, ( int )u32Cause );
+}
+
+/*****************************************************************************//*!
+*
+* @brief record a check of a test.
+*
+* @return none
+*
+*****************************************************************************/
+void HOST_Check( int bPass, const char * pExpr, const char * pFile, int iLine )
+{
+  HOST_u32Checks++;
+
+  if ( !bPass )
+  {
+    HOST_u32Failures++;
+    printf( "FAIL %s:%d: %s\n", pFile, iLine, pExpr );
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief report the checks.
+*
+* @return exit status of the test
+*
+*****************************************************************************/
+int HOST_Exit( void )
+{
+  printf( "%u checks, %u failed\n", ( unsigned )HOST_u32Checks, ( unsigned )HOST_u32Failures );
+  return HOST_u32Failures ? 1 : 0;
+}
+
+/*****************************************************************************//*!
+*
+* @brief core clock of the ICS and OSC registers.
+*
+* @return Hz
+*
+*****************************************************************************/
+uint32_t HOST_CoreHz( void )
+{
+  uint8_t u8C1 = HOST_R8( ICS->C1 ), u8C2 = HOST_R8( ICS->C2 ), u8Cr = HOST_R8( OSC->CR );
+  uint8_t u8Clks = ( u8C1 & ICS_C1_CLKS_MASK ) >> ICS_C1_CLKS_SHIFT;
+  uint8_t u8Rdiv = ( u8C1 & ICS_C1_RDIV_MASK ) >> ICS_C1_RDIV_SHIFT;
+  uint64_t u64Hz;
+
+  if ( u8Clks == 0 )
+  {
+    if ( u8C1 & ICS_C1_IREFS_MASK )
+      u64Hz = 37500ULL * 1280;
+    else
+      u64Hz = ( uint64_t )HOST_u32ExtalHz * 1280 / ( ( u8Cr & OSC_CR_RANGE_MASK ) ? 32U << u8Rdiv : 1U << u8Rdiv );
+  }
+  else if ( u8Clks == 1 )
+  {
+    u64Hz = 37500;
+  }
+  else
+  {
+    u64Hz = HOST_u32ExtalHz;
+  }
+
+  u64Hz >>= ( u8C2 & ICS_C2_BDIV_MASK ) >> ICS_C2_BDIV_SHIFT;
+  return u64Hz ? ( uint32_t )u64Hz : 1;
+}
+
+/*****************************************************************************//*!
+*
+* @brief bus clock.
+*
+* @return Hz
+*
+*****************************************************************************/
+uint32_t HOST_BusHz( void )
+{
+  return HOST_CoreHz( ) >> HOST_bBusDiv;
+}
+
+/*****************************************************************************//*!
+*
+* @brief let model time pass in the main context, taking the interrupts.
+*
+* @param[in] u64Clocks  core clocks
+*
+* @return none
+*
+*****************************************************************************/
+void HOST_Advance( uint64_t u64Clocks )
+{
+  uint64_t u64End = HOST_u64Clock + u64Clocks;
+
+  while ( HOST_u64Clock < u64End )
+  {
+    uint64_t u64Step = HOST_NextEvent( );
+
+    if ( !u64Step || u64Step > u64End - HOST_u64Clock )
+      u64Step = u64End - HOST_u64Clock;
+
+    HOST_iInModel++;
+    HOST_Tick( u64Step );
+    HOST_Update( );
+    HOST_iInModel--;
+    HOST_Dispatch( );
+  }
+}
+
+/*****************************************************************************//*!
+*
+* @brief let model time pass.
+*
+* @param[in] u32Us  microseconds at the current core clock
+*
+* @return none
+*
+*****************************************************************************/
+void HOST_AdvanceUs( uint32_t u32Us )
+{
+  HOST_Advance( ( uint64_t )u32Us * HOST_CoreHz( ) / 1000000 );
+}
+
+/*****************************************************************************//*!
+*
+* @brief call an event function at a model clock, with the model state. It
+*        may drive inputs, send on a UART or change the supply.
+*
+* @return none
+*
+*****************************************************************************/
+void HOST_Schedule( uint64_t u64Clock, HOST_EventType pfnEvent, void * pArg )
+{
+  if ( HOST_iTimed == HOST_EVENTS )
+    HOST_Fatal( "too many events" );
+
+  HOST_asTimed[HOST_iTimed].u64Clock = u64Clock;
+  HOST_asTimed[HOST_iTimed].pfnEvent = pfnEvent;
+  HOST_asTimed[HOST_iTimed].pArg = pArg;
+  HOST_iTimed++;
+}
+
+/*****************************************************************************//*!
+*
+* @brief count host instructions as core clocks until HOST_StepEnd.
+*
+* @return none
+*
+*****************************************************************************/
+void HOST_StepBegin( void )
+{
+  HOST_u64Steps = 0;
+  HOST_bStepping = 1;
+  __asm__ volatile( "pushfq\n orq $0x100, (%%rsp)\n popfq" ::: "memory", "cc" );
+}
+
+/*****************************************************************************//*!
+*
+* @brief stop counting instructions.
+*
+* @return instructions counted
+*
+*****************************************************************************/
+uint64_t HOST_StepEnd( void )
+{
+  HOST_bStepping = 0;
+  return HOST_u64Steps;
+}
+
+/*****************************************************************************//*!
+*
+* @brief read or write a register without the model.
+*
+*****************************************************************************/
+uint32_t HOST_Peek( uint32_t u32Address )
+{
+  return *( volatile uint32_t * )HOST_Reg( u32Address );
+}
+
+void HOST_Poke( uint32_t u32Address, uint32_t u32Value )
+{
+  *( volatile uint32_t * )HOST_Reg( u32Address ) = u32Value;
+}
+
+/*****************************************************************************//*!
+*
+* @brief flash contents, writable by the test.
+*
+* @return backdoor pointer of the address
+*
+*****************************************************************************/
+uint8_t * HOST_Flash( uint32_t u32Address )
+{
+  return HOST_pu8Flash + u32Address;
+}
+
+/*****************************************************************************//*!
+*
+* @brief pend an exception, as a peripheral line would.
+*
+* @param[in] iIrq  IRQ number, HOST_EXCEPTION_SYSTICK for the SysTick
+*
+* @return none
+*
+*****************************************************************************/
+void HOST_Irq( int iIrq )
+{
+  if ( iIrq < 0 )
+    HOST_bSysTickPending = 1;
+  else
+    HOST_u32Pending |= 1U << iIrq;
+}
+
+/*****************************************************************************//*!
+*
+* @brief exception number running, 0 in thread mode.
+*
+*****************************************************************************/
+uint32_t HOST_Ipsr( void )
+{
+  if ( !HOST_iDepth )
+    return 0;
+
+  return HOST_aiActive[HOST_iDepth - 1] < 0 ? 15 : 16 + HOST_aiActive[HOST_iDepth - 1];
+}
+
+/*****************************************************************************//*!
+*
+* @brief take the exceptions pending above the running priority.
+*
+*****************************************************************************/
+void HOST_Dispatch( void )
+{
+  int iIrq, iInModel = HOST_iInModel;
+
+  HOST_iInModel = 0;
+
+  while ( ( iIrq = HOST_Select( ) ) != -2 )
+  {
+    uint32_t *pVector = ( uint32_t * )( uintptr_t )HOST_R32( SCB->VTOR );
+    void ( *pfnHandler )( void );
+
+    if ( iIrq < 0 )
+      HOST_bSysTickPending = 0;
+    else
+      HOST_u32Pending &= ~( 1U << iIrq );
+
+    HOST_aiActive[HOST_iDepth] = iIrq;
+    HOST_au32ActivePrio[HOST_iDepth] = HOST_Priority( iIrq );
+    HOST_iDepth++;
+
+    HOST_iInModel++;
+    HOST_Tick( HOST_ENTRY_CLOCKS );
+    HOST_Update( );
+    HOST_iInModel--;
+
+    pfnHandler = ( void ( * )( void ) )( uintptr_t )pVector[iIrq < 0 ? 15 : 16 + iIrq];
+    ( pfnHandler ? pfnHandler : HOST_Unhandled )( );
+
+    HOST_iInModel++;
+    HOST_Tick( HOST_RETURN_CLOCKS );
+    HOST_iDepth--;
+    HOST_Update( );
+    HOST_iInModel--;
+  }
+
+  HOST_iInModel = iInModel;
+}
+
+/*****************************************************************************//*!
+*
+* @brief PRIMASK, the pending interrupts are taken when it is cleared.
+*
+*****************************************************************************/
+void HOST_SetPrimask( uint32_t u32Primask )
+{
+  HOST_u32Primask = u32Primask & 1;
+
+  if ( !HOST_u32Primask )
+    HOST_Dispatch( );
+}
+
+/*****************************************************************************//*!
+*
+* @brief the instructions the drivers write in assembler.
+*
+*****************************************************************************/
+void HOST_Asm( const char * pInstruction )
+{
+  uint64_t u64Next;
+
+  /* one clock for the instruction, however long the model takes over it */
+  HOST_iInModel++;
+
+  if ( !strcmp( pInstruction, "NOP" ) )
+  {
+    HOST_Tick( 1 );
+    HOST_iInModel--;
+    return;
+  }
+
+  if ( strcmp( pInstruction, "WFI" ) )
+  {
+    HOST_iInModel--;
+    return;
+  }
+
+  /* sleep to the next event, woken by a pending interrupt even when masked */
+  while ( !( ( HOST_u32Pending & HOST_u32Enabled ) || HOST_bSysTickPending ) )
+  {
+    u64Next = HOST_NextEvent( );
+
+    if ( !u64Next )
+      HOST_Fatal( "WFI with no event to wake up" );
+
+    HOST_Tick( u64Next );
+    HOST_Update( );
+  }
+
+  HOST_iInModel--;
+  HOST_Dispatch( );
+}
+
+/*****************************************************************************//*!
+*
+* @brief the UART side of the host.
+*
+*****************************************************************************/
+void HOST_UartSetTx( uint8_t u8Port, HOST_UartTxType pfnTx )
+{
+  HOST_asUart[u8Port].pfnTx = pfnTx;
+}
+
+void HOST_UartSend( uint8_t u8Port, const uint8_t * pData, uint32_t u32Length )
+{
+  HOST_UartType *pModel = &HOST_asUart[u8Port];
+
+  while ( u32Length-- )
+    pModel->au8Queue[pModel->u32Head++ % HOST_UART_QUEUE] = *pData++;
+
+  if ( !pModel->u64RxAt && pModel->u32Head != pModel->u32Tail )
+    pModel->u64RxAt = HOST_u64Bus + HOST_UartFrame( u8Port );
+}
+
+uint32_t HOST_UartPending( uint8_t u8Port )
+{
+  return HOST_asUart[u8Port].u32Head - HOST_asUart[u8Port].u32Tail;
+}
+
+/*****************************************************************************//*!
+*
+* @brief the SPI slave, the master reads back what it sends without one.
+*
+*****************************************************************************/
+void HOST_SpiSetSlave( uint8_t u8Port, HOST_SpiSlaveType pfnSlave )
+{
+  HOST_asSpi[u8Port].pfnSlave = pfnSlave;
+}
+
+/*****************************************************************************//*!
+*
+* @brief the analog inputs, channel x 100 without one.
+*
+*****************************************************************************/
+void HOST_AdcSetSample( HOST_AdcSampleType pfnSample )
+{
+  HOST_pfnSample = pfnSample;
+}
+
+/*****************************************************************************//*!
+*
+* @brief the pins: edges seen, levels driven from outside.
+*
+*****************************************************************************/
+void HOST_GpioSetEdge( HOST_GpioEdgeType pfnEdge )
+{
+  HOST_pfnEdge = pfnEdge;
+}
+
+void HOST_GpioDrive( uint8_t u8Port, uint32_t u32Mask, uint32_t u32Level )
+{
+  HOST_au32External[u8Port] = ( HOST_au32External[u8Port] & ~u32Mask ) | ( u32Level & u32Mask );
+  HOST_GpioLevels( );
+}
+
+uint32_t HOST_GpioLevel( uint8_t u8Port )
+{
+  return HOST_au32Level[u8Port];
+}
+
+/*****************************************************************************//*!
+*
+* @brief an input capture edge on an ETM channel: CnV takes the counter.
+*
+*****************************************************************************/
+void HOST_EtmCapture( uint8_t u8Etm, uint8_t u8Channel )
+{
+  ETM_Type *pETM = HOST_apEtm[u8Etm];
+
+  HOST_EtmUpdate( u8Etm );
+  HOST_R32( pETM->CONTROLS[u8Channel].CnV ) = HOST_EtmCount( u8Etm );
+  HOST_R32( pETM->CONTROLS[u8Channel].CnSC ) |= ETM_CnSC_CHF_MASK;
+}
+
+/*****************************************************************************//*!
+*
+* @brief edges on the TCLK pin of an ETM, counted when it counts the external
+*        clock (CLKS 3).
+*
+*****************************************************************************/
+void HOST_EtmClock( uint8_t u8Etm, uint32_t u32Edges )
+{
+  HOST_EtmUpdate( u8Etm );
+
+  if ( HOST_EtmClks( u8Etm ) == 3 )
+    HOST_EtmAdvance( u8Etm, u32Edges );
+}
+
+/*****************************************************************************//*!
+*
+* @brief a keyboard interrupt edge on an enabled pin.
+*
+*****************************************************************************/
+void HOST_KbiTrigger( uint8_t u8Kbi, uint8_t u8Pin )
+{
+  KBI_Type *pKBI = HOST_apKbi[u8Kbi];
+
+  if ( HOST_R8( pKBI->PE ) & ( 1 << u8Pin ) )
+    HOST_R8( pKBI->SC ) |= KBI_SC_KBF_MASK;
+}
+
+/*****************************************************************************//*!
+*
+* @brief the supply voltage, under the LVD trip point it resets the model.
+*
+*****************************************************************************/
+void HOST_SetSupply( uint32_t u32Millivolts )
+{
+  uint8_t u8Spmsc1 = HOST_R8( PMC->SPMSC1 );
+
+  if ( u32Millivolts < HOST_LvdTrip( ) && HOST_u32Supply >= HOST_LvdTrip( ) &&
+       ( u8Spmsc1 & PMC_SPMSC1_LVDE_MASK ) && ( u8Spmsc1 & PMC_SPMSC1_LVDRE_MASK ) )
+    HOST_bLvdReset = 1;
+
+  HOST_u32Supply = u32Millivolts;
+}
+
+/*****************************************************************************//*!
+*
+* @brief ASSERT of the drivers with USE_FULL_ASSERT.
+*
+*****************************************************************************/
+void assert_failed( uint8_t * file, uint32_t line )
+{
+  HOST_Fatal( "ASSERT failed at %s:%u", ( const char * )file, ( unsigned )line );
+}
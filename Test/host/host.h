@@ -0,0 +1,105 @@
+/******************************************************************************
+* @brief header file for the host register model (HOST).
+*
+*******************************************************************************
+*
+* provide APIs for running the drivers of Navota/PERIPH on Linux: the
+* peripheral blocks are mapped at their NV32.h addresses, every driver access
+* to them traps into behavioural models, a model clock counts core clocks and
+* the interrupts the models raise are taken like the NVIC does
+******************************************************************************/
+#ifndef __HOST_H__
+#define __HOST_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************
+* Includes
+******************************************************************************/
+
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/******************************************************************************
+* Constants
+******************************************************************************/
+#define HOST_EXCEPTION_SYSTICK  ( -1 )      /*!< HOST_Schedule/HOST_Irq index of the SysTick */
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+
+/*!
+* @brief reset point, 0 after HOST_Init, the SIM_SRSID reset cause after a
+*        reset of the model. Locals of the caller are not kept over a reset.
+*/
+#define HOST_BOOT()             sigsetjmp( *HOST_Arm( ), 1 )
+
+/*!
+* @brief check a condition of a test, the test fails at HOST_Exit if any did.
+*/
+#define HOST_CHECK( expr )      HOST_Check( ( expr ) != 0, #expr, __FILE__, __LINE__ )
+
+/******************************************************************************
+* Types
+******************************************************************************/
+typedef void ( *HOST_EventType )( void * pArg );                             /*!< scheduled event */
+typedef void ( *HOST_UartTxType )( uint8_t u8Port, uint8_t u8Data );          /*!< byte sent by the target */
+typedef uint8_t ( *HOST_SpiSlaveType )( uint8_t u8Port, uint8_t u8Mosi );     /*!< byte returned to the master */
+typedef uint16_t ( *HOST_AdcSampleType )( uint8_t u8Channel );                /*!< conversion result */
+typedef void ( *HOST_GpioEdgeType )( uint8_t u8Port, uint32_t u32Old, uint32_t u32New ); /*!< pin levels changed */
+
+/******************************************************************************
+* Global variables
+******************************************************************************/
+extern volatile uint64_t HOST_u64Clock;       /*!< core clocks since power up */
+extern volatile uint64_t HOST_u64Ps;          /*!< picoseconds since power up */
+extern uint32_t HOST_u32AccessClocks;         /*!< core clocks charged per peripheral access */
+extern uint32_t HOST_u32ExtalHz;              /*!< OSC input */
+extern uint32_t HOST_u32RtcExtHz;             /*!< RTC external clock */
+extern uint32_t HOST_u32OscStartUs;           /*!< crystal start up */
+extern uint32_t HOST_u32FllLockUs;            /*!< FLL acquisition */
+extern uint32_t HOST_u32Failures;             /*!< failed HOST_CHECKs */
+
+/******************************************************************************
+* Global functions
+******************************************************************************/
+void HOST_Init( void );
+sigjmp_buf * HOST_Arm( void );
+void HOST_Reset( uint32_t u32Cause );
+int HOST_Exit( void );
+void HOST_Check( int bPass, const char * pExpr, const char * pFile, int iLine );
+
+uint32_t HOST_CoreHz( void );
+uint32_t HOST_BusHz( void );
+void HOST_Advance( uint64_t u64Clocks );
+void HOST_AdvanceUs( uint32_t u32Us );
+void HOST_Schedule( uint64_t u64Clock, HOST_EventType pfnEvent, void * pArg );
+void HOST_StepBegin( void );
+uint64_t HOST_StepEnd( void );
+
+uint32_t HOST_Peek( uint32_t u32Address );
+void HOST_Poke( uint32_t u32Address, uint32_t u32Value );
+uint8_t * HOST_Flash( uint32_t u32Address );
+void HOST_Irq( int iIrq );
+uint32_t HOST_Ipsr( void );
+
+void HOST_UartSetTx( uint8_t u8Port, HOST_UartTxType pfnTx );
+void HOST_UartSend( uint8_t u8Port, const uint8_t * pData, uint32_t u32Length );
+uint32_t HOST_UartPending( uint8_t u8Port );
+void HOST_SpiSetSlave( uint8_t u8Port, HOST_SpiSlaveType pfnSlave );
+void HOST_AdcSetSample( HOST_AdcSampleType pfnSample );
+void HOST_GpioSetEdge( HOST_GpioEdgeType pfnEdge );
+void HOST_GpioDrive( uint8_t u8Port, uint32_t u32Mask, uint32_t u32Level );
+uint32_t HOST_GpioLevel( uint8_t u8Port );
+void HOST_EtmCapture( uint8_t u8Etm, uint8_t u8Channel );
+void HOST_EtmClock( uint8_t u8Etm, uint32_t u32Edges );
+void HOST_KbiTrigger( uint8_t u8Kbi, uint8_t u8Pin );
+void HOST_SetSupply( uint32_t u32Millivolts );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __HOST_H__ */
@@ -0,0 +1,57 @@
+/******************************************************************************
+* @brief IAR intrinsics for the host build of the drivers.
+*
+*******************************************************************************
+*
+* the interrupt mask is a variable of the register model, unmasking it
+* takes the interrupts pending meanwhile, as PRIMASK does on the target
+******************************************************************************/
+#ifndef __HOST_INTRINSICS_H__
+#define __HOST_INTRINSICS_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+typedef uint32_t __istate_t;
+
+extern volatile uint32_t HOST_u32Primask;
+
+void HOST_SetPrimask( uint32_t u32Primask );
+void HOST_Asm( const char * pInstruction );
+
+#define __ramfunc
+#define __root
+#define __no_init
+#define asm( x )                HOST_Asm( x )
+
+static inline __istate_t __get_interrupt_state( void )
+{
+  return HOST_u32Primask;
+}
+
+static inline void __set_interrupt_state( __istate_t state )
+{
+  HOST_SetPrimask( state );
+}
+
+static inline void __disable_interrupt( void )
+{
+  HOST_u32Primask = 1;
+}
+
+static inline void __enable_interrupt( void )
+{
+  HOST_SetPrimask( 0 );
+}
+
+static inline void __no_operation( void )
+{
+  HOST_Asm( "NOP" );
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __HOST_INTRINSICS_H__ */
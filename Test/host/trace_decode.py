@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+#
+# decode the binary trace of NV32_trace.c: the bytes TRACE_Drain sent over
+# the UART, from the first record after TRACE_Init, with the ELF file of the
+# same build for the format strings
+#
+#   trace_decode.py firmware.elf capture.bin
+#
+# One line per record. A gap in the sequence numbers of the headers prints
+# as "<n records lost>", n modulo 64 as the headers carry 6 bits.
+#
+import struct
+import sys
+
+TRACE_FMT_MASK = 0x00FFFFFF
+TRACE_ARGS_SHIFT = 24
+TRACE_SEQ_SHIFT = 26
+TRACE_SEQ_MASK = 0x3F
+
+PT_LOAD = 1
+
+
+class Elf:
+    """the loadable segments of a little endian ELF file, 32 or 64 bit"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+
+        if self.data[:4] != b'\x7fELF' or self.data[5] != 1:
+            raise ValueError('%s: not a little endian ELF file' % path)
+
+        self.segments = []
+
+        if self.data[4] == 1:
+            phoff, = struct.unpack_from('<I', self.data, 0x1C)
+            phentsize, phnum = struct.unpack_from('<HH', self.data, 0x2A)
+            layout, fields = '<IIIIIIII', (0, 1, 2, 4)
+        else:
+            phoff, = struct.unpack_from('<Q', self.data, 0x20)
+            phentsize, phnum = struct.unpack_from('<HH', self.data, 0x36)
+            layout, fields = '<IIQQQQQQ', (0, 2, 3, 5)
+
+        for i in range(phnum):
+            header = struct.unpack_from(layout, self.data, phoff + i * phentsize)
+            kind, offset, vaddr, filesz = (header[j] for j in fields)
+
+            if kind == PT_LOAD and filesz:
+                self.segments.append((vaddr, offset, filesz))
+
+    def offset(self, address):
+        # the header keeps 24 bits of the address, the flash of a NV32 is below
+        for vaddr, offset, filesz in self.segments:
+            if vaddr & TRACE_FMT_MASK <= address < (vaddr & TRACE_FMT_MASK) + filesz:
+                return offset + address - (vaddr & TRACE_FMT_MASK)
+
+        raise KeyError('0x%x is in no loadable segment' % address)
+
+    def string(self, address):
+        start = self.offset(address & TRACE_FMT_MASK)
+        end = self.data.index(b'\0', start)
+        return self.data[start:end].decode('latin-1')
+
+
+def signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def format_record(elf, fmt, args):
+    """printf of a record, the arguments are raw 32-bit words"""
+    out = []
+    i = 0
+    args = list(args)
+
+    while i < len(fmt):
+        if fmt[i] != '%':
+            out.append(fmt[i])
+            i += 1
+            continue
+
+        j = i + 1
+
+        while j < len(fmt) and fmt[j] in '-+ #0123456789.':
+            j += 1
+
+        flags = fmt[i + 1:j]
+
+        # the target passes every argument as one 32-bit word
+        while j < len(fmt) and fmt[j] in 'hlzjt':
+            j += 1
+
+        if j >= len(fmt):
+            out.append(fmt[i:])
+            break
+
+        conv = fmt[j]
+        i = j + 1
+
+        if conv == '%':
+            out.append('%')
+            continue
+
+        value = args.pop(0) if args else 0
+
+        if conv in 'di':
+            out.append(('%' + flags + 'd') % signed(value))
+        elif conv in 'uxXo':
+            out.append(('%' + flags + conv) % value)
+        elif conv == 'c':
+            out.append(('%' + flags + 'c') % chr(value & 0xFF))
+        elif conv == 's':
+            out.append(('%' + flags + 's') % elf.string(value))
+        elif conv == 'p':
+            out.append('0x%08x' % value)
+        else:
+            out.append('%' + flags + conv)
+
+    return ''.join(out)
+
+
+def decode(elf, stream):
+    """the lines of a captured stream, a cut off last record is left out"""
+    lines = []
+    seq = None
+    at = 0
+
+    while at + 4 <= len(stream):
+        header, = struct.unpack_from('<I', stream, at)
+        count = (header >> TRACE_ARGS_SHIFT) & 3
+
+        if at + 4 + 4 * count > len(stream):
+            break
+
+        args = struct.unpack_from('<%dI' % count, stream, at + 4)
+        at += 4 + 4 * count
+        now = (header >> TRACE_SEQ_SHIFT) & TRACE_SEQ_MASK
+
+        if seq is not None and now != (seq + 1) & TRACE_SEQ_MASK:
+            lines.append('<%d records lost>' % ((now - seq - 1) & TRACE_SEQ_MASK))
+
+        seq = now
+        lines.append(format_record(elf, elf.string(header & TRACE_FMT_MASK), args))
+
+    return lines
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write('usage: %s firmware.elf capture.bin\n' % argv[0])
+        return 2
+
+    elf = Elf(argv[1])
+
+    with open(argv[2], 'rb') as f:
+        stream = f.read()
+
+    for line in decode(elf, stream):
+        print(line)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
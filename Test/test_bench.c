@@ -0,0 +1,129 @@
+/******************************************************************************
+*
+* @brief host test of the benchmark harness: BENCH_Run takes out its own
+*        overhead, gives a running SysTick back without losing its phase,
+*        and BENCH_Report prints the CSV line.
+*
+* The counts printed are model clocks, HOST_u32AccessClocks per peripheral
+* access, not cycles measured on a NV32; no target counts were produced.
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_bench.h"
+#include "NV32_crc.h"
+#include "NV32_gpio.h"
+#include "NV32_uart.h"
+#include "host.h"
+
+#define TEST_TICK_CLOCKS        ( HOST_CoreHz( ) / 1000 )
+
+static volatile uint32_t TEST_u32Ticks;
+static volatile uint64_t TEST_u64TickClock;
+static char TEST_acLine[256];
+static uint32_t TEST_u32Line;
+static uint8_t TEST_au8Block[64];
+
+void SysTick_Handler( void )
+{
+  TEST_u32Ticks++;
+  TEST_u64TickClock = HOST_u64Clock;
+}
+
+static void TEST_UartTx( uint8_t u8Port, uint8_t u8Data )
+{
+  if ( u8Port == 1 && TEST_u32Line < sizeof( TEST_acLine ) - 1 )
+    TEST_acLine[TEST_u32Line++] = ( char )u8Data;
+}
+
+static void TEST_Wait( void * pParam )
+{
+  HOST_AdvanceUs( ( uint32_t )( uintptr_t )pParam );
+}
+
+static void TEST_ToggleFunction( void * pParam )
+{
+  GPIO_PinToggle( GPIO_PTA0 );
+  GPIO_PinToggle( GPIO_PTA0 );
+}
+
+static void TEST_ToggleMacro( void * pParam )
+{
+  GPIO_PIN_TOGGLE( GPIO_PTA0 );
+  GPIO_PIN_TOGGLE( GPIO_PTA0 );
+}
+
+static void TEST_Crc32( void * pParam )
+{
+  CRC_Cal32( 0xFFFFFFFF, TEST_au8Block, sizeof( TEST_au8Block ) );
+}
+
+static void TEST_Report( const char * pName, BENCH_FuncType pfnCase, uint32_t u32Bytes )
+{
+  BENCH_ResultType sResult;
+
+  BENCH_Run( pfnCase, NULL, u32Bytes, 8, &sResult );
+  TEST_u32Line = 0;
+  BENCH_Report( UART1, pName, &sResult );
+  UART_WaitTxComplete( UART1 );
+  TEST_acLine[TEST_u32Line] = 0;
+  HOST_CHECK( !strncmp( TEST_acLine, "bench,", 6 ) && strstr( TEST_acLine, pName ) );
+  HOST_CHECK( sResult.u32Min <= sResult.u32Median && sResult.u32Median <= sResult.u32Max );
+  printf( "%s", TEST_acLine );
+}
+
+int main( void )
+{
+  UART_ConfigType sUart = { { 0 } };
+  CRC_ConfigType sCrc = { 0 };
+  BENCH_ResultType sResult;
+  uint64_t u64Start;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+
+  /* a stopped SysTick is left stopped, LOAD as it was */
+  SysTick->LOAD = 1234;
+  BENCH_Run( TEST_Wait, ( void * )100, 0, 4, &sResult );
+  HOST_CHECK( sResult.u32Runs == 4 );
+  HOST_CHECK( sResult.u32Min == HOST_CoreHz( ) / 10000 && sResult.u32Max == sResult.u32Min );
+  HOST_CHECK( !( SysTick->CTRL & SysTick_CTRL_ENABLE_Msk ) && SysTick->LOAD == 1234 );
+
+  /* a 1 ms tick keeps its phase, the tick due during the runs comes late */
+  SysTick->LOAD = TEST_TICK_CLOCKS - 1;
+  SysTick->VAL  = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+  u64Start = HOST_u64Clock;
+  HOST_AdvanceUs( 700 );
+  BENCH_Run( TEST_Wait, ( void * )100, 0, 4, &sResult );
+  HOST_CHECK( TEST_u32Ticks == 1 && TEST_u64TickClock - u64Start > TEST_TICK_CLOCKS );
+  HOST_CHECK( SysTick->LOAD == TEST_TICK_CLOCKS - 1 );
+  HOST_Advance( u64Start + 5 * TEST_TICK_CLOCKS + 100 - HOST_u64Clock );
+  HOST_CHECK( TEST_u32Ticks == 5 );
+  /* within the clocks between reading VAL and restarting the SysTick */
+  HOST_CHECK( TEST_u64TickClock - u64Start - 5 * TEST_TICK_CLOCKS + 50 <= 100 );
+  printf( "tick 5 at %lld clocks from its phase\n",
+          ( long long )( TEST_u64TickClock - u64Start ) - 5 * ( long long )TEST_TICK_CLOCKS );
+  SysTick->CTRL = 0;
+
+  sUart.u32SysClkHz = HOST_BusHz( );
+  sUart.u32Baudrate = 115200;
+  UART_Init( UART1, &sUart );
+  HOST_UartSetTx( 1, TEST_UartTx );
+  GPIO_PinInit( GPIO_PTA0, GPIO_PinOutput );
+  sCrc.bWidth              = CRC_WIDTH_32BIT;
+  sCrc.bTransposeReadType  = CRC_READ_TRANSPOSE_ALL;
+  sCrc.bTransposeWriteType = CRC_WRITE_TRANSPOSE_BIT;
+  sCrc.bFinalXOR           = CRC_READ_COMPLETE;
+  sCrc.u32PolyData         = 0x04C11DB7;
+  CRC_Init( &sCrc );
+
+  TEST_Report( "gpio_toggle_x2_function", TEST_ToggleFunction, 0 );
+  TEST_Report( "gpio_toggle_x2_macro", TEST_ToggleMacro, 0 );
+  TEST_Report( "crc_cal32", TEST_Crc32, sizeof( TEST_au8Block ) );
+
+  return HOST_Exit( );
+}
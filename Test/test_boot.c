@@ -0,0 +1,75 @@
+/******************************************************************************
+*
+* @brief host test of the fast boot: from a reset SystemInit leaves the ICS
+*        as the reset did and only starts the crystal, SystemBootClocks
+*        reads the clocks and gives the SysTick back, SystemClockComplete
+*        reaches the configured FEE mode. The ICS sequence of the full path
+*        is timed after a second reset for comparison.
+*
+* The times are model time: SystemInit in host code, FLL lock and crystal
+* start up as in host.c, the C startup between SystemInit and main is not
+* modelled. No reset to main time was measured on a NV32.
+*
+* HOST_CONFIG: FAST_BOOT_ENABLED 1
+* HOST_CONFIG: FAST_BOOT_DEFER_CLOCK 1
+* HOST_CONFIG: BOOT_TIME_ENABLED 1
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_clkmgr.h"
+#include "NV32_flltrim.h"
+#include "host.h"
+
+static uint64_t TEST_u64FastPs;
+
+int main( void )
+{
+  ICS_ConfigType sConfig = { 0 };
+  uint64_t u64Start;
+  uint64_t u64Clock;
+  uint32_t u32Clocks;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+  {
+    /* the ICS part of the full path, from the same reset state */
+    sConfig.u32ClkFreq         = EXTAL_CLK_FREQ_KHZ;
+    sConfig.oscConfig.bEnable  = 1;
+    sConfig.oscConfig.bIsCryst = 1;
+    sConfig.oscConfig.bRange   = 1;
+    sConfig.u8ClkMode          = ICS_CLK_MODE_FEE;
+    u64Start = HOST_u64Ps;
+    ICS_DeInit( );
+    ICS_Trim( FLLTRIM_Load( ) );
+    ICS_Init( &sConfig );
+    HOST_CHECK( HOST_CoreHz( ) == EXTAL_CLK_FREQ_KHZ * 1000 * 10 / 256 * 128 );
+    printf( "reset to main: fast %llu us, full ICS path %llu us\n",
+            ( unsigned long long )( TEST_u64FastPs / 1000000 ),
+            ( unsigned long long )( ( HOST_u64Ps - u64Start ) / 1000000 ) );
+    HOST_CHECK( HOST_u64Ps - u64Start > 100 * TEST_u64FastPs );
+    return HOST_Exit( );
+  }
+
+  /* the reset state, FEI with the output divided by 2 */
+  u64Start = HOST_u64Ps;
+  u64Clock = HOST_u64Clock;
+  SystemInit( );
+  TEST_u64FastPs = HOST_u64Ps - u64Start;
+  u32Clocks = SystemBootClocks( );
+  /* all of SystemInit but the SysTick set up before it runs */
+  HOST_CHECK( HOST_u64Clock - u64Clock - u32Clocks < 32 );
+  HOST_CHECK( SysTick->CTRL == 0 && SysTick->LOAD == 0 );
+  HOST_CHECK( TEST_u64FastPs < HOST_u32FllLockUs * 1000000ULL / 10 );
+
+  /* the value main sees, the initializer */
+  HOST_CHECK( SystemCoreClock == HOST_CoreHz( ) && !( ICS->S & ICS_S_LOCK_MASK ) );
+  HOST_CHECK( ICS->C3 == ( uint8_t )FLLTRIM_Load( ) && ( OSC->CR & OSC_CR_OSCEN_MASK ) );
+
+  SystemClockComplete( );
+  HOST_CHECK( CLKMGR_GetMode( ) == ICS_CLK_MODE_FEE && SystemCoreClock == HOST_CoreHz( ) );
+  HOST_CHECK( SystemCoreClock == EXTAL_CLK_FREQ_KHZ * 1000 * 10 / 256 * 128 );
+
+  HOST_Reset( SIM_SRSID_SW_MASK );
+  return HOST_Exit( );
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+*
+* @brief host test of the static callbacks: every driver built with its
+*        *_STATIC_CALLBACK set keeps neither the callback RAM nor the
+*        dynamic _Isr, a static and a dynamic PIT channel side by side
+*        both reach their callbacks, and the static KBI0 handler clears
+*        the flag as KBI0_Isr does.
+*
+* PIT_CH1 and ETM0 stay dynamic, so PIT_Callback and ETM_Callback are kept.
+*
+* HOST_CONFIG: VECTOR_IN_RAM 1
+* HOST_CONFIG: ADC_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: ACMP0_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: ACMP1_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: ETM1_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: ETM2_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: I2C0_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: KBI0_STATIC_CALLBACK TEST_Kbi0
+* HOST_CONFIG: KBI1_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: PIT_CH0_STATIC_CALLBACK TEST_Pit0
+* HOST_CONFIG: RTC_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: SPI0_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: SPI1_STATIC_CALLBACK TEST_Callback
+* HOST_CONFIG: UART_STATIC_CALLBACK TEST_Uart
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_pit.h"
+#include "host.h"
+
+/* resolve to NULL when the driver does not define them */
+extern void *ADC_Callback[] __attribute__( ( weak ) );
+extern void *ACMP_Callback[] __attribute__( ( weak ) );
+extern void *KBI_Callback[] __attribute__( ( weak ) );
+extern void *PIT_Callback[] __attribute__( ( weak ) );
+extern void *RTC_Callback[] __attribute__( ( weak ) );
+extern void *SPI_Callback[] __attribute__( ( weak ) );
+extern void *ETM_Callback[] __attribute__( ( weak ) );
+void ADC_Isr( void ) __attribute__( ( weak ) );
+void ACMP0_Isr( void ) __attribute__( ( weak ) );
+void ETM2_Isr( void ) __attribute__( ( weak ) );
+void I2C0_Isr( void ) __attribute__( ( weak ) );
+void KBI0_Isr( void ) __attribute__( ( weak ) );
+void PIT_Ch0Isr( void ) __attribute__( ( weak ) );
+void PIT_Ch1Isr( void ) __attribute__( ( weak ) );
+void RTC_Isr( void ) __attribute__( ( weak ) );
+void SPI0_Isr( void ) __attribute__( ( weak ) );
+void UART0_Isr( void ) __attribute__( ( weak ) );
+
+static uint32_t TEST_au32Ticks[2];
+static uint32_t TEST_u32Kbi0;
+
+void TEST_Callback( void )
+{
+}
+
+void TEST_Uart( UART_Type * pUART )
+{
+  ( void )pUART;
+}
+
+void TEST_Pit0( void )
+{
+  TEST_au32Ticks[0]++;
+}
+
+static void TEST_Pit1( void )
+{
+  TEST_au32Ticks[1]++;
+}
+
+void TEST_Kbi0( void )
+{
+  TEST_u32Kbi0++;
+}
+
+int main( void )
+{
+  PIT_ConfigType sConfig = { 0 };
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+
+  HOST_CHECK( !ADC_Callback && !ACMP_Callback && !KBI_Callback && !RTC_Callback && !SPI_Callback );
+  HOST_CHECK( !ADC_Isr && !ACMP0_Isr && !ETM2_Isr && !I2C0_Isr && !KBI0_Isr && !PIT_Ch0Isr && !RTC_Isr &&
+              !SPI0_Isr && !UART0_Isr );
+  HOST_CHECK( PIT_Callback && ETM_Callback && PIT_Ch1Isr );
+
+  /* channel 0 bound at link time, channel 1 installed in the RAM vectors */
+  PIT_SetCallback( PIT_CHANNEL0, TEST_Pit0 );
+  PIT_SetCallback( PIT_CHANNEL1, TEST_Pit1 );
+  sConfig.bETMerEn     = 1;
+  sConfig.bInterruptEn = 1;
+  sConfig.u32LoadValue = 999;
+  PIT_Init( PIT_CHANNEL0, &sConfig );
+  sConfig.u32LoadValue = 1999;
+  PIT_Init( PIT_CHANNEL1, &sConfig );
+  HOST_Advance( 10000ULL * ( HOST_CoreHz( ) / HOST_BusHz( ) ) );
+  PIT_DeInit( );
+  HOST_CHECK( TEST_au32Ticks[0] >= 9 && TEST_au32Ticks[0] <= 10 );
+  HOST_CHECK( TEST_au32Ticks[1] >= 4 && TEST_au32Ticks[1] <= 5 );
+  printf( "pit: %u static, %u dynamic ticks\n", ( unsigned )TEST_au32Ticks[0], ( unsigned )TEST_au32Ticks[1] );
+
+  /* one keyboard edge, the flag acknowledged by the static handler */
+  SIM->SCGC |= SIM_SCGC_KBI0_MASK;
+  KBI0->PE   = 1;
+  KBI0->SC   = KBI_SC_KBIE_MASK;
+  NVIC_EnableIRQ( KBI0_IRQn );
+  HOST_KbiTrigger( 0, 0 );
+  HOST_Advance( 10 );
+  HOST_CHECK( TEST_u32Kbi0 == 1 && !( KBI0->SC & KBI_SC_KBF_MASK ) );
+
+  return HOST_Exit( );
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+*
+* @brief host test of the capture meter on ETM2 channel 0, gated by PIT
+*        channel 0: a slow input is timestamped per edge, a fast one counted
+*        on the external clock with only the gate interrupting, a slow one
+*        again goes back to the capture and a lost input times out.
+*
+* HOST_CONFIG: VECTOR_IN_RAM 1
+* HOST_CONFIG: ISRSTAT_ENABLED 1
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_capmeter.h"
+#include "NV32_isrstat.h"
+#include "NV32_pit.h"
+#include "host.h"
+
+/* DIV8 of the 50 MHz core, 6.25 MHz */
+#define TEST_CLOCK_HZ           6250000UL
+#define TEST_RANGE_TICKS        62500UL         /* 100 Hz */
+#define TEST_GATE_TICKS         625000UL        /* 100 ms */
+#define TEST_TIMEOUT_TICKS      6250000UL       /* 1 s */
+
+static uint32_t TEST_u32Period;
+static uint64_t TEST_u64Edge;
+
+/* one rising edge on the capture channel and TCLK, the next one scheduled */
+static void TEST_Edge( void * pArg )
+{
+  ( void )pArg;
+
+  if ( !TEST_u32Period )
+    return;
+
+  HOST_EtmCapture( 2, 0 );
+  HOST_EtmClock( 2, 1 );
+  TEST_u64Edge += TEST_u32Period;
+  HOST_Schedule( TEST_u64Edge, TEST_Edge, NULL );
+}
+
+/* input at u32Hz from now on, 0 stops it */
+static void TEST_Input( uint32_t u32Hz )
+{
+  uint32_t u32Running = TEST_u32Period;
+
+  TEST_u32Period = u32Hz ? HOST_CoreHz( ) / u32Hz : 0;
+
+  if ( TEST_u32Period && !u32Running )
+  {
+    TEST_u64Edge = HOST_u64Clock + TEST_u32Period;
+    HOST_Schedule( TEST_u64Edge, TEST_Edge, NULL );
+  }
+}
+
+int main( void )
+{
+  CAPMETER_ConfigType sConfig = { 0 };
+  CAPMETER_ResultType sResult;
+  uint32_t u32Isr;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  ISRSTAT_Init( );
+
+  sConfig.pETM            = ETM2;
+  sConfig.u8Channel       = 0;
+  sConfig.u8CaptureEdge   = ETM_INPUTCAPTURE_RISINGEDGE;
+  sConfig.u8ClockPrescale = ETM_CLOCK_PS_DIV8;
+  sConfig.u8AvgEdges      = 4;
+  sConfig.u8GateChannel   = PIT_CHANNEL0;
+  sConfig.u32RangeTicks   = TEST_RANGE_TICKS;
+  sConfig.u32GateTicks    = TEST_GATE_TICKS;
+  sConfig.u32TimeoutTicks = TEST_TIMEOUT_TICKS;
+  CAPMETER_Init( &sConfig );
+  HOST_CHECK( !CAPMETER_GetResult( ETM2, &sResult ) && !sResult.u32Periods );
+
+  /* 50 Hz: four periods timestamped */
+  TEST_Input( 50 );
+  HOST_AdvanceUs( 110000 );
+  HOST_CHECK( CAPMETER_GetResult( ETM2, &sResult ) && CAPMETER_MODE_RECIPROCAL == sResult.u8Mode );
+  HOST_CHECK( 4 == sResult.u32Periods && 4 * TEST_CLOCK_HZ / 50 == sResult.u32Ticks );
+  HOST_CHECK( 50000 == CAPMETER_GetFrequency_mHz( ETM2, &sResult ) );
+  HOST_CHECK( 20000 == CAPMETER_GetPeriod_us( ETM2, &sResult ) );
+
+  /* 100 kHz: one reciprocal result, then counted over the gate */
+  TEST_Input( 100000 );
+  HOST_AdvanceUs( 100000 );
+  u32Isr = ISRSTAT_sVector[ISRSTAT_ETM2].u32Count;
+  HOST_AdvanceUs( 300000 );
+  HOST_CHECK( CAPMETER_GetResult( ETM2, &sResult ) && CAPMETER_MODE_GATED == sResult.u8Mode );
+  HOST_CHECK( TEST_GATE_TICKS == sResult.u32Ticks );
+  HOST_CHECK( sResult.u32Periods >= 9999 && sResult.u32Periods <= 10001 );
+  HOST_CHECK( CAPMETER_GetFrequency_mHz( ETM2, &sResult ) / 10000 == 10000 );
+  HOST_CHECK( CAPMETER_GetPeriod_us( ETM2, &sResult ) == 10 );
+  /* 30000 edges, the counter wraps at most once */
+  HOST_CHECK( ISRSTAT_sVector[ISRSTAT_ETM2].u32Count - u32Isr <= 1 );
+  printf( "gated: %u periods, %u ETM interrupts in 300 ms\n", ( unsigned )sResult.u32Periods,
+          ( unsigned )( ISRSTAT_sVector[ISRSTAT_ETM2].u32Count - u32Isr ) );
+
+  /* 25 Hz: a gate under the range, back to the capture */
+  TEST_Input( 25 );
+  HOST_AdvanceUs( 400000 );
+  HOST_CHECK( CAPMETER_GetResult( ETM2, &sResult ) && CAPMETER_MODE_RECIPROCAL == sResult.u8Mode );
+  HOST_CHECK( 25000 == CAPMETER_GetFrequency_mHz( ETM2, &sResult ) );
+  HOST_CHECK( 40000 == CAPMETER_GetPeriod_us( ETM2, &sResult ) );
+
+  /* input lost: frequency 0 after the timeout */
+  TEST_Input( 0 );
+  HOST_AdvanceUs( 1200000 );
+  HOST_CHECK( CAPMETER_GetResult( ETM2, &sResult ) && CAPMETER_MODE_TIMEOUT == sResult.u8Mode );
+  HOST_CHECK( !sResult.u32Periods && !CAPMETER_GetFrequency_mHz( ETM2, &sResult ) );
+
+  CAPMETER_DeInit( ETM2 );
+
+  return HOST_Exit( );
+}
@@ -0,0 +1,82 @@
+/******************************************************************************
+*
+* @brief host test of the clock manager notifiers of the PIT owners: a
+*        software timer keeps its expiry time and the timestamp counter its
+*        us count over a change of the ICS bus divider.
+*
+* The times are model time, SWTMR_TICK_US is 1000.
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_clkmgr.h"
+#include "host.h"
+
+#define TEST_PS_PER_TICK        ( SWTMR_TICK_US * 1000000ULL )
+
+static SWTMR_TimerType TEST_sTimer;
+static uint32_t TEST_u32Runs;
+static uint64_t TEST_u64Ps;
+static CLKMGR_NotifierType TEST_sNotifier;
+
+void PIT_Ch0Isr( void );
+
+/* the application glue of startup_NV32.s, as in Application/main.c */
+void PIT_CH0_IRQHandler( void )
+{
+  PIT_Ch0Isr( );
+}
+
+static void TEST_Expired( void * pParam )
+{
+  TEST_u32Runs++;
+  TEST_u64Ps = HOST_u64Ps;
+}
+
+int main( void )
+{
+  uint32_t u32Bus;
+  uint64_t u64Start;
+  uint64_t u64Us;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  SystemCoreClockUpdate( );
+  u32Bus = HOST_BusHz( );
+  HOST_CHECK( SystemClockGet( CLOCK_BUS ) == u32Bus );
+
+  /* the bus clock halves 20 ticks into a 50 tick timer */
+  SWTMR_Init( );
+  SWTMR_TimerInit( &TEST_sTimer, TEST_Expired, NULL );
+  CLKMGR_Register( &TEST_sNotifier, CLKMGR_SwtmrNotify, NULL, 0 );
+  u64Start = HOST_u64Ps;
+  SWTMR_Start( &TEST_sTimer, 50, 0 );
+  HOST_AdvanceUs( 20 * SWTMR_TICK_US + SWTMR_TICK_US / 2 );
+  CLKMGR_SetBusDivider( 1 );
+  HOST_CHECK( HOST_BusHz( ) == u32Bus / 2 && SystemClockGet( CLOCK_BUS ) == u32Bus / 2 );
+  HOST_AdvanceUs( 40 * SWTMR_TICK_US );
+  HOST_CHECK( TEST_u32Runs == 1 );
+  HOST_CHECK( TEST_u64Ps - u64Start > 49 * TEST_PS_PER_TICK && TEST_u64Ps - u64Start < 51 * TEST_PS_PER_TICK );
+  printf( "50 ticks over a BDIV change: %llu us\n", ( unsigned long long )( ( TEST_u64Ps - u64Start ) / 1000000 ) );
+  CLKMGR_Unregister( &TEST_sNotifier );
+  SWTMR_DeInit( );
+
+  /* 1 ms at half the bus clock, then 1 ms at the full one */
+  TSTAMP_Init( );
+  CLKMGR_Register( &TEST_sNotifier, CLKMGR_TstampNotify, NULL, 0 );
+  HOST_AdvanceUs( 1000 );
+  CLKMGR_SetBusDivider( 0 );
+  HOST_CHECK( HOST_BusHz( ) == u32Bus && TSTAMP_u32CyclesPerUs == u32Bus / 1000000 );
+  HOST_AdvanceUs( 1000 );
+  u64Us = TSTAMP_GetUs( );
+  /* the driver code between the steps adds a few us */
+  HOST_CHECK( u64Us >= 2000 && u64Us < 2010 );
+  printf( "2 ms over a BDIV change: %llu us\n", ( unsigned long long )u64Us );
+  CLKMGR_Unregister( &TEST_sNotifier );
+  TSTAMP_DeInit( );
+
+  return HOST_Exit( );
+}
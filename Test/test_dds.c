@@ -0,0 +1,102 @@
+/******************************************************************************
+*
+* @brief host test of the DDS generator on ETM0 channel 0: the duty is
+*        sampled once per PWM period, the output frequency is taken from its
+*        rising crossings of the middle duty and the swing from its extremes.
+*
+* HOST_CONFIG: VECTOR_IN_RAM 1
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_dds.h"
+#include "host.h"
+
+/* 50 kHz samples at the 50 MHz core */
+#define TEST_MODULO             999
+#define TEST_MIDDLE             ( ( TEST_MODULO + 1 ) / 2 )
+
+static uint32_t TEST_u32Period;
+static uint64_t TEST_u64Probe;
+static uint32_t TEST_u32Crossings;
+static uint16_t TEST_u16Last;
+static uint16_t TEST_u16Min;
+static uint16_t TEST_u16Max;
+
+/* the duty of the running PWM period, half a period after its sample */
+static void TEST_Probe( void * pArg )
+{
+  uint16_t u16Duty = ( uint16_t )ETM0->CONTROLS[0].CnV;
+
+  ( void )pArg;
+
+  if ( TEST_u16Last < TEST_MIDDLE && u16Duty >= TEST_MIDDLE )
+    TEST_u32Crossings++;
+
+  TEST_u16Last = u16Duty;
+  TEST_u16Min  = ( u16Duty < TEST_u16Min ) ? u16Duty : TEST_u16Min;
+  TEST_u16Max  = ( u16Duty > TEST_u16Max ) ? u16Duty : TEST_u16Max;
+  TEST_u64Probe += TEST_u32Period;
+  HOST_Schedule( TEST_u64Probe, TEST_Probe, NULL );
+}
+
+/* probe the output over u32Us */
+static void TEST_Run( uint32_t u32Us )
+{
+  TEST_u32Crossings = 0;
+  TEST_u16Min       = 0xFFFF;
+  TEST_u16Max       = 0;
+  HOST_AdvanceUs( u32Us );
+}
+
+int main( void )
+{
+  DDS_ConfigType sConfig = { 0 };
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+
+  sConfig.pETM             = ETM0;
+  sConfig.u8Channel        = 0;
+  sConfig.u8ClockPrescale  = ETM_CLOCK_PS_DIV1;
+  sConfig.u16Modulo        = TEST_MODULO;
+  sConfig.u16Amplitude     = 32767;
+  sConfig.u32Frequency_mHz = 1000000;
+  sConfig.pi16Table        = DDS_SineTable;
+  DDS_Init( &sConfig );
+  HOST_CHECK( TEST_MIDDLE == ETM0->CONTROLS[0].CnV );
+
+  TEST_u32Period = TEST_MODULO + 1;
+  TEST_u16Last   = TEST_MIDDLE;
+  TEST_u64Probe  = HOST_u64Clock + TEST_u32Period / 2;
+  HOST_Schedule( TEST_u64Probe, TEST_Probe, NULL );
+
+  /* 1 kHz, full swing */
+  TEST_Run( 100000 );
+  HOST_CHECK( TEST_u32Crossings >= 99 && TEST_u32Crossings <= 101 );
+  HOST_CHECK( TEST_u16Max >= TEST_MODULO - 2 && TEST_u16Min <= 2 );
+  printf( "1 kHz: %u crossings in 100 ms, duty %u ~ %u\n", ( unsigned )TEST_u32Crossings,
+          ( unsigned )TEST_u16Min, ( unsigned )TEST_u16Max );
+
+  /* 123.456 Hz, half swing */
+  DDS_SetFrequency( 123456 );
+  DDS_SetAmplitude( 16384 );
+  HOST_AdvanceUs( 10000 );
+  TEST_Run( 1000000 );
+  HOST_CHECK( TEST_u32Crossings >= 122 && TEST_u32Crossings <= 124 );
+  HOST_CHECK( TEST_u16Max >= TEST_MIDDLE + 248 && TEST_u16Max <= TEST_MIDDLE + 250 );
+  HOST_CHECK( TEST_u16Min >= TEST_MIDDLE - 251 && TEST_u16Min <= TEST_MIDDLE - 249 );
+
+  /* zero frequency holds the phase */
+  DDS_SetFrequency( 0 );
+  HOST_AdvanceUs( 1000 );
+  TEST_Run( 10000 );
+  HOST_CHECK( !TEST_u32Crossings && TEST_u16Min == TEST_u16Max );
+
+  DDS_DeInit( );
+
+  return HOST_Exit( );
+}
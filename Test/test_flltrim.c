@@ -0,0 +1,101 @@
+/******************************************************************************
+*
+* @brief host test of the FLL trim measurement against the RTC: a stopped
+*        RTC is borrowed and given back as found, a running one, as the
+*        calendar keeps it, is refused and keeps counting. Against a 1 kHz
+*        pulse on an ETM channel too, with the bus at half the core clock
+*        and at the core clock.
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_flltrim.h"
+#include "host.h"
+
+#define TEST_REF_HZ             1000
+
+static uint8_t  TEST_bPulse;
+static uint64_t TEST_u64Pulse;
+
+static void TEST_Pulse( void * pArg )
+{
+  if ( !TEST_bPulse )
+    return;
+
+  HOST_EtmCapture( 2, 0 );
+  TEST_u64Pulse += HOST_CoreHz( ) / TEST_REF_HZ;
+  HOST_Schedule( TEST_u64Pulse, TEST_Pulse, pArg );
+}
+
+static uint8_t TEST_Near( uint32_t u32Hz )
+{
+  return u32Hz > HOST_CoreHz( ) - HOST_CoreHz( ) / 1000 && u32Hz < HOST_CoreHz( ) + HOST_CoreHz( ) / 1000;
+}
+
+int main( void )
+{
+  FLLTRIM_ConfigType sConfig = { 0 };
+  uint32_t u32Hz;
+  uint32_t u32Sc;
+  uint16_t u16Count;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  SystemCoreClockUpdate( );
+  sConfig.u8Source   = FLLTRIM_REF_RTC;
+  sConfig.u32RefHz   = HOST_u32RtcExtHz;
+  sConfig.u16Periods = 64;
+
+  /* stopped and gated off, left so */
+  SIM->SCGC &= ~SIM_SCGC_RTC_MASK;
+  u32Hz = FLLTRIM_Measure( &sConfig );
+  HOST_CHECK( TEST_Near( u32Hz ) );
+  HOST_CHECK( !( SIM->SCGC & SIM_SCGC_RTC_MASK ) );
+  SIM->SCGC |= SIM_SCGC_RTC_MASK;
+  HOST_CHECK( RTC->SC == 0 && RTC->MOD == 0 && RTC->CNT == 0 );
+  printf( "core clock %u Hz, measured %u Hz\n", ( unsigned )HOST_CoreHz( ), ( unsigned )u32Hz );
+
+  /* a 1 s period on the crystal, as the calendar runs it */
+  RTC_SetModulo( 32767 );
+  RTC_SetClock( RTC_CLKSRC_EXTERNAL, RTC_CLK_PRESCALER_128 );
+  RTC_EnableInt( );
+  u32Sc = RTC->SC;
+  HOST_AdvanceUs( 100000 );
+  u16Count = RTC->CNT;
+  HOST_CHECK( u16Count > 3000 );
+  HOST_CHECK( FLLTRIM_Measure( &sConfig ) == 0 );
+  HOST_CHECK( RTC->SC == u32Sc && RTC->MOD == 32767 && RTC->CNT >= u16Count );
+  RTC_SetClock( RTC_CLKSRC_EXTERNAL, 0 );
+
+  /* the ETM counts core clocks, the bus divider does not scale them */
+  sConfig.u8Source  = FLLTRIM_REF_ETM;
+  sConfig.pETM      = ETM2;
+  sConfig.u8Channel = 0;
+  sConfig.u32RefHz  = TEST_REF_HZ;
+  TEST_bPulse       = 1;
+  TEST_u64Pulse     = HOST_u64Clock;
+  TEST_Pulse( NULL );
+  HOST_CHECK( HOST_BusHz( ) == HOST_CoreHz( ) / 2 );
+  u32Hz = FLLTRIM_Measure( &sConfig );
+  HOST_CHECK( TEST_Near( u32Hz ) );
+  printf( "ETM reference, bus at core / 2: measured %u Hz\n", ( unsigned )u32Hz );
+
+  /* ICS output halved to 25 MHz, the bus at the core clock */
+  ICS->C2     = ( ICS->C2 & ~ICS_C2_BDIV_MASK ) | ICS_C2_BDIV( 1 );
+  SIM->BUSDIV = 0;
+  SystemCoreClockUpdate( );
+  HOST_CHECK( HOST_BusHz( ) == HOST_CoreHz( ) && SystemClockGet( CLOCK_BUS ) == SystemCoreClock );
+  u32Hz = FLLTRIM_Measure( &sConfig );
+  HOST_CHECK( TEST_Near( u32Hz ) );
+  printf( "ETM reference, bus at core: measured %u Hz\n", ( unsigned )u32Hz );
+  TEST_bPulse = 0;
+
+  /* no pulse */
+  HOST_Advance( HOST_CoreHz( ) / TEST_REF_HZ * 2 );
+  HOST_CHECK( FLLTRIM_Measure( &sConfig ) == 0 );
+
+  return HOST_Exit( );
+}
@@ -0,0 +1,78 @@
+/******************************************************************************
+*
+* @brief host test of the GPIO pin macros: every constant pin of GPIOA and
+*        GPIOB reaches its own bit, and the peripheral accesses one pin
+*        operation takes against the GPIO_Pin functions.
+*
+* The register model charges accesses, not the instructions around them, so
+* the counts say nothing about the cycles on a NV32. The model has no bit
+* manipulation engine for GPIO_PinInit to go through.
+*
+* HOST_CONFIG: BME_ENABLED 0
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_gpio.h"
+#include "host.h"
+
+/* peripheral accesses of a statement */
+#define TEST_ACCESSES(count, stmt)                                  \
+  do                                                                \
+  {                                                                 \
+    uint64_t u64Start = HOST_u64Clock;                              \
+    stmt;                                                           \
+    count = ( HOST_u64Clock - u64Start ) / HOST_u32AccessClocks;    \
+  } while ( 0 )
+
+#define TEST_PIN(pin)                                               \
+  do                                                                \
+  {                                                                 \
+    uint8_t u8Port = ( pin ) >= GPIO_PTE0;                          \
+    GPIO_PIN_INIT_OUTPUT( pin );                                    \
+    GPIO_PIN_SET( pin );                                            \
+    HOST_CHECK( HOST_GpioLevel( u8Port ) & GPIO_PIN_MASK( pin ) );  \
+    GPIO_PIN_TOGGLE( pin );                                         \
+    HOST_CHECK( !( HOST_GpioLevel( u8Port ) & GPIO_PIN_MASK( pin ) ) ); \
+    GPIO_PIN_WRITE( pin, 1 );                                       \
+    HOST_CHECK( GPIO_PIN_READ( pin ) == 0 );                        \
+    GPIO_PIN_INIT_INPUT( pin );                                     \
+    HOST_GpioDrive( u8Port, GPIO_PIN_MASK( pin ), 0xFFFFFFFF );     \
+    HOST_CHECK( GPIO_PIN_READ( pin ) == 1 );                        \
+    HOST_GpioDrive( u8Port, GPIO_PIN_MASK( pin ), 0 );              \
+    HOST_CHECK( GPIO_PIN_READ( pin ) == 0 );                        \
+    GPIO_PIN_INIT_PULLUP( pin );                                    \
+    HOST_CHECK( GPIO_PIN_PUE( pin ) == GPIO_PIN_MASK( pin ) );      \
+    PORT->PUEL = 0;                                                 \
+    PORT->PUEH = 0;                                                 \
+  } while ( 0 )
+
+int main( void )
+{
+  uint64_t u64Macro, u64Function;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+
+  TEST_PIN( GPIO_PTA0 );
+  TEST_PIN( GPIO_PTC5 );
+  TEST_PIN( GPIO_PTD7 );
+  TEST_PIN( GPIO_PTE0 );
+  TEST_PIN( GPIO_PTG3 );
+  TEST_PIN( GPIO_PTH7 );
+
+  TEST_ACCESSES( u64Macro, GPIO_PIN_TOGGLE( GPIO_PTH2 ) );
+  TEST_ACCESSES( u64Function, GPIO_PinToggle( GPIO_PTH2 ) );
+  HOST_CHECK( u64Macro == 1 && u64Function == 1 );
+  printf( "toggle: macro %u access, function %u access\n", ( unsigned )u64Macro, ( unsigned )u64Function );
+
+  TEST_ACCESSES( u64Macro, GPIO_PIN_INIT_OUTPUT( GPIO_PTH2 ) );
+  TEST_ACCESSES( u64Function, GPIO_PinInit( GPIO_PTH2, GPIO_PinOutput ) );
+  HOST_CHECK( u64Macro == u64Function );
+  printf( "init output: macro %u accesses, function %u accesses\n", ( unsigned )u64Macro, ( unsigned )u64Function );
+
+  return HOST_Exit( );
+}
@@ -0,0 +1,201 @@
+/******************************************************************************
+*
+* @brief host test of the register model with the stock drivers: UART, SPI,
+*        ADC, CRC, flash and PIT behave and take the time the model says.
+*
+* The figures printed are model clocks, not cycles measured on a NV32.
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_adc.h"
+#include "NV32_crc.h"
+#include "NV32_flash.h"
+#include "NV32_pit.h"
+#include "NV32_spi.h"
+#include "NV32_uart.h"
+#include "host.h"
+
+#define TEST_FLASH_SECTOR       0x1F000UL
+
+static uint8_t TEST_au8Sent[64];
+static uint32_t TEST_u32Sent;
+static volatile uint32_t TEST_u32Ticks;
+static volatile uint64_t TEST_u64TickClock;
+
+void PIT_Ch0Isr( void );
+
+/* the application glue of startup_NV32.s, as in Application/main.c */
+void PIT_CH0_IRQHandler( void )
+{
+  PIT_Ch0Isr( );
+}
+
+static void TEST_UartTx( uint8_t u8Port, uint8_t u8Data )
+{
+  if ( u8Port == 1 && TEST_u32Sent < sizeof( TEST_au8Sent ) )
+    TEST_au8Sent[TEST_u32Sent++] = u8Data;
+}
+
+static void TEST_PitTick( void )
+{
+  if ( !TEST_u32Ticks++ )
+    TEST_u64TickClock = HOST_u64Clock;
+}
+
+static uint16_t TEST_Crc16( const uint8_t * pData, uint32_t u32Length )
+{
+  uint16_t u16Crc = 0xFFFF;
+  int i;
+
+  while ( u32Length-- )
+  {
+    u16Crc ^= ( uint16_t )( *pData++ << 8 );
+
+    for ( i = 0; i < 8; i++ )
+      u16Crc = ( u16Crc & 0x8000 ) ? ( uint16_t )( ( u16Crc << 1 ) ^ 0x1021 ) : ( uint16_t )( u16Crc << 1 );
+  }
+
+  return u16Crc;
+}
+
+static void TEST_Uart( void )
+{
+  UART_ConfigType sConfig = { { 0 } };
+  uint8_t au8Message[] = "0123456789";
+  uint8_t au8Received[4];
+  uint64_t u64Start, u64Clocks;
+
+  sConfig.u32SysClkHz = HOST_BusHz( );
+  sConfig.u32Baudrate = 115200;
+  UART_Init( UART1, &sConfig );
+  HOST_UartSetTx( 1, TEST_UartTx );
+
+  u64Start = HOST_u64Clock;
+  UART_SendWait( UART1, au8Message, 10 );
+  UART_WaitTxComplete( UART1 );
+  u64Clocks = HOST_u64Clock - u64Start;
+
+  HOST_CHECK( TEST_u32Sent == 10 && !memcmp( TEST_au8Sent, au8Message, 10 ) );
+  /* 10 frames of 10 bits at the SBR rounded baud rate */
+  HOST_CHECK( u64Clocks >= 10ULL * 160 * UART1->BDL * ( HOST_CoreHz( ) / HOST_BusHz( ) ) );
+  printf( "uart  10 bytes at 115200: %llu clocks, %llu bytes/s\n", ( unsigned long long )u64Clocks,
+          ( unsigned long long )( 10ULL * HOST_CoreHz( ) / u64Clocks ) );
+
+  HOST_UartSend( 1, ( const uint8_t * )"abcd", 4 );
+  UART_ReceiveWait( UART1, au8Received, 4 );
+  HOST_CHECK( !memcmp( au8Received, "abcd", 4 ) );
+}
+
+static void TEST_Spi( void )
+{
+  SPI_ConfigType sConfig = { { 0 } };
+  SPI_WidthType au8Tx[16], au8Rx[16];
+  uint64_t u64Start, u64Clocks;
+  int i;
+
+  for ( i = 0; i < 16; i++ )
+    au8Tx[i] = ( SPI_WidthType )( 0xA0 + i );
+
+  sConfig.sSettings.bModuleEn = 1;
+  sConfig.sSettings.bMasterMode = 1;
+  sConfig.u32BitRate = 1000000;
+  sConfig.u32BusClkHz = HOST_BusHz( );
+  SPI_Init( SPI0, &sConfig );
+
+  u64Start = HOST_u64Clock;
+  SPI_TransferWait( SPI0, au8Rx, au8Tx, 16 );
+  u64Clocks = HOST_u64Clock - u64Start;
+
+  HOST_CHECK( !memcmp( au8Rx, au8Tx, 16 ) );
+  HOST_CHECK( u64Clocks >= 16ULL * 8 * HOST_CoreHz( ) / 1000000 * 9 / 10 );
+  printf( "spi   16 bytes at 1 MHz: %llu clocks\n", ( unsigned long long )u64Clocks );
+}
+
+static void TEST_Adc( void )
+{
+  uint64_t u64Start;
+
+  SIM->SCGC |= SIM_SCGC_ADC_MASK;
+  ADC->SC3 = 0;
+  ADC->SC4 = 0;
+  u64Start = HOST_u64Clock;
+  ADC->SC1 = 5;
+
+  while ( !( ADC->SC1 & ADC_SC1_COCO_MASK ) );
+
+  HOST_CHECK( ADC->R == 500 );
+  HOST_CHECK( !( ADC->SC1 & ADC_SC1_COCO_MASK ) );
+  printf( "adc   one conversion: %llu clocks\n", ( unsigned long long )( HOST_u64Clock - u64Start ) );
+}
+
+static void TEST_Crc( void )
+{
+  CRC_ConfigType sConfig = { 0 };
+  uint8_t au8Message[] = "123456789";
+
+  sConfig.u32PolyData = 0x1021;
+  CRC_Init( &sConfig );
+
+  /* CRC-16/CCITT-FALSE of the check string */
+  HOST_CHECK( CRC_Cal16( 0xFFFF, au8Message, 9 ) == 0x29B1 );
+  HOST_CHECK( CRC_Cal16( 0xFFFF, au8Message, 8 ) == TEST_Crc16( au8Message, 8 ) );
+}
+
+static void TEST_Flash( void )
+{
+  uint64_t u64Start;
+
+  Flash_Init( );
+  HOST_CHECK( Flash_EraseSector( TEST_FLASH_SECTOR ) == FLASH_ERR_SUCCESS );
+  HOST_CHECK( *( volatile uint32_t * )TEST_FLASH_SECTOR == 0xFFFFFFFF );
+
+  u64Start = HOST_u64Ps;
+  HOST_CHECK( Flash_Program1LongWord( TEST_FLASH_SECTOR + 4, 0x12345678 ) == FLASH_ERR_SUCCESS );
+  HOST_CHECK( HOST_u64Ps - u64Start >= 10000000ULL );
+  HOST_CHECK( *( volatile uint32_t * )( TEST_FLASH_SECTOR + 4 ) == 0x12345678 );
+  HOST_CHECK( *( volatile uint32_t * )( TEST_FLASH_SECTOR + 8 ) == 0xFFFFFFFF );
+
+  Flash_EraseSector( TEST_FLASH_SECTOR );
+  HOST_CHECK( *( volatile uint32_t * )( TEST_FLASH_SECTOR + 4 ) == 0xFFFFFFFF );
+}
+
+static void TEST_Pit( void )
+{
+  PIT_ConfigType sConfig = { 0 };
+  uint64_t u64Start;
+
+  sConfig.bETMerEn = 1;
+  sConfig.bInterruptEn = 1;
+  sConfig.u32LoadValue = 999;
+  PIT_SetCallback( PIT_CHANNEL0, TEST_PitTick );
+
+  u64Start = HOST_u64Clock;
+  PIT_Init( PIT_CHANNEL0, &sConfig );
+  HOST_Advance( 10000ULL << ( HOST_CoreHz( ) != HOST_BusHz( ) ) );
+  PIT_DeInit( );
+
+  HOST_CHECK( TEST_u32Ticks >= 9 && TEST_u32Ticks <= 10 );
+  printf( "pit   first tick %llu clocks after the start, %u ticks\n",
+          ( unsigned long long )( TEST_u64TickClock - u64Start ), ( unsigned )TEST_u32Ticks );
+}
+
+int main( void )
+{
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  printf( "core %u Hz, bus %u Hz\n", ( unsigned )HOST_CoreHz( ), ( unsigned )HOST_BusHz( ) );
+  HOST_CHECK( HOST_CoreHz( ) == SystemCoreClock );
+
+  TEST_Uart( );
+  TEST_Spi( );
+  TEST_Adc( );
+  TEST_Crc( );
+  TEST_Flash( );
+  TEST_Pit( );
+
+  return HOST_Exit( );
+}
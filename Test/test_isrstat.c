@@ -0,0 +1,75 @@
+/******************************************************************************
+*
+* @brief host test of the interrupt statistics: the entry hook is one
+*        SysTick read, and a PIT routine of a known length lands in its
+*        bins with the latency in bus clocks.
+*
+* HOST_CONFIG: ISRSTAT_ENABLED 1
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_isrstat.h"
+#include "NV32_pit.h"
+#include "host.h"
+
+#define TEST_BODY_CLOCKS        200
+
+static uint32_t TEST_u32Ticks;
+
+void PIT_Ch0Isr( void );
+
+/* the application glue of startup_NV32.s, as in Application/main.c */
+void PIT_CH0_IRQHandler( void )
+{
+  PIT_Ch0Isr( );
+}
+
+static void TEST_PitTick( void )
+{
+  TEST_u32Ticks++;
+  HOST_Advance( TEST_BODY_CLOCKS );
+}
+
+int main( void )
+{
+  PIT_ConfigType sConfig = { 0 };
+  ISRSTAT_VectorType *pVector = &ISRSTAT_sVector[ISRSTAT_PIT_CH0];
+  uint64_t u64Start;
+  uint64_t u64Enter;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  ISRSTAT_Init( );
+
+  /* the hot path: one peripheral access, nothing else the model charges */
+  u64Start = HOST_u64Clock;
+  {
+    ISRSTAT_ENTER( ISRSTAT_PIT_CH1 );
+    u64Enter = HOST_u64Clock - u64Start;
+    ( void )u32IsrStatEntry;
+  }
+  HOST_CHECK( u64Enter == HOST_u32AccessClocks );
+
+  sConfig.bETMerEn = 1;
+  sConfig.bInterruptEn = 1;
+  sConfig.u32LoadValue = 999;
+  PIT_SetCallback( PIT_CHANNEL0, TEST_PitTick );
+  PIT_Init( PIT_CHANNEL0, &sConfig );
+  HOST_Advance( 10000ULL * ( HOST_CoreHz( ) / HOST_BusHz( ) ) );
+  PIT_DeInit( );
+
+  HOST_CHECK( TEST_u32Ticks >= 9 && pVector->u32Count == TEST_u32Ticks );
+  /* 200 clocks of body: bin [128, 256) or [256, 512) with the hooks */
+  HOST_CHECK( pVector->u32MaxDuration >= TEST_BODY_CLOCKS && pVector->u32MaxDuration < 512 );
+  HOST_CHECK( pVector->u16Duration[3] + pVector->u16Duration[4] == pVector->u32Count );
+  /* taken within the first bin of bus clocks */
+  HOST_CHECK( pVector->u32MaxLatency < 32 && pVector->u16Latency[0] == pVector->u32Count );
+  printf( "pit_ch0: %u runs, max %u core clocks, max latency %u bus clocks\n", ( unsigned )pVector->u32Count,
+          ( unsigned )pVector->u32MaxDuration, ( unsigned )pVector->u32MaxLatency );
+
+  return HOST_Exit( );
+}
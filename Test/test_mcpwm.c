@@ -0,0 +1,81 @@
+/******************************************************************************
+*
+* @brief host test of the motor control PWM on ETM2: the center aligned
+*        period from the control loop tick, the six-step commutation masks
+*        and the space vector duties.
+*
+* HOST_CONFIG: VECTOR_IN_RAM 1
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_mcpwm.h"
+#include "host.h"
+
+/* 20 kHz center aligned at the 50 MHz core */
+#define TEST_MODULO             1250
+
+static uint32_t TEST_u32Ticks;
+
+/* control loop tick, once per PWM period */
+static void TEST_Tick( void )
+{
+  ETM_ClrOverFlowFlag( ETM2 );
+  TEST_u32Ticks++;
+}
+
+int main( void )
+{
+  MCPWM_ConfigType sConfig = { 0 };
+  uint32_t u32Sum;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+
+  ETM_SetCallback( ETM2, TEST_Tick );
+  sConfig.u16Modulo          = TEST_MODULO;
+  sConfig.u8ClockPrescale    = ETM_CLOCK_PS_DIV1;
+  sConfig.u8DeadTimePrescale = ETM_DEADETME_DTPS_DIV1;
+  sConfig.u8DeadTimeValue    = 50;
+  sConfig.bOverflowIntEn     = 1;
+  MCPWM_Init( &sConfig );
+  HOST_CHECK( MCPWM_ALL_CHANNELS_MASK == ETM2->OUTMASK && ( ETM2->SC & ETM_SC_CPWMS_MASK ) );
+  HOST_CHECK( TEST_MODULO / 2 == ETM2->CONTROLS[0].CnV && TEST_MODULO / 2 == ETM2->CONTROLS[4].CnV );
+
+  /* 2 * modulo clocks per period */
+  HOST_AdvanceUs( 10000 );
+  HOST_CHECK( TEST_u32Ticks >= 199 && TEST_u32Ticks <= 201 );
+  printf( "pwm: %u periods in 10 ms\n", ( unsigned )TEST_u32Ticks );
+
+  /* step 0: U PWM, V sinks, W floats */
+  MCPWM_SetCommutation( MCPWM_STEP_0 );
+  HOST_CHECK( 0x30 == ETM2->OUTMASK && 0x080C == ETM2->SWOCTRL );
+  MCPWM_SetCommutation( MCPWM_STEP_BRAKE );
+  HOST_CHECK( 0 == ETM2->OUTMASK && 0x2A3F == ETM2->SWOCTRL );
+  MCPWM_OutputEnable( );
+  HOST_CHECK( 0 == ETM2->OUTMASK && 0 == ETM2->SWOCTRL );
+
+  /* zero vector: all phases at half duty */
+  MCPWM_SVPWMUpdate( 0, 0 );
+  HOST_CHECK( TEST_MODULO / 2 == ETM2->CONTROLS[0].CnV && TEST_MODULO / 2 == ETM2->CONTROLS[2].CnV &&
+              TEST_MODULO / 2 == ETM2->CONTROLS[4].CnV );
+
+  /* half alpha: U up, V and W down alike, the extremes centred on half duty */
+  MCPWM_SVPWMUpdate( 16384, 0 );
+  u32Sum = ETM2->CONTROLS[0].CnV + ETM2->CONTROLS[2].CnV;
+  HOST_CHECK( ETM2->CONTROLS[0].CnV > TEST_MODULO / 2 && ETM2->CONTROLS[2].CnV == ETM2->CONTROLS[4].CnV );
+  HOST_CHECK( ETM2->CONTROLS[0].CnV - TEST_MODULO / 2 >= 233 && ETM2->CONTROLS[0].CnV - TEST_MODULO / 2 <= 235 );
+  HOST_CHECK( u32Sum >= TEST_MODULO - 1 && u32Sum <= TEST_MODULO + 1 );
+
+  /* full scale beta stays within the modulo */
+  MCPWM_SVPWMUpdate( 0, 32767 );
+  HOST_CHECK( ETM2->CONTROLS[0].CnV <= TEST_MODULO && ETM2->CONTROLS[2].CnV <= TEST_MODULO &&
+              ETM2->CONTROLS[4].CnV <= TEST_MODULO && ETM2->CONTROLS[2].CnV > ETM2->CONTROLS[4].CnV );
+
+  MCPWM_DeInit( );
+
+  return HOST_Exit( );
+}
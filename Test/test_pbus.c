@@ -0,0 +1,197 @@
+/******************************************************************************
+*
+* @brief host test of the parallel bus engine: an 8080 and a 6800 display and
+*        a 74HC595 chain are modelled on the pin edges, they have to latch
+*        what PBUS sends, and the stores per byte are counted.
+*
+* The register model charges peripheral accesses, not the instructions
+* between them, so the store counts are exact and the MB/s on a NV32 is not
+* known from this test; PBUS_MeasureThroughput gives it on the target.
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_pbus.h"
+#include "host.h"
+
+/* scattered over GPIOA, WR# on the same port */
+static const uint8_t TEST_au8Data[8] =
+{
+  GPIO_PTA0, GPIO_PTA3, GPIO_PTB1, GPIO_PTB2, GPIO_PTC0, GPIO_PTC7, GPIO_PTD4, GPIO_PTD6
+};
+#define TEST_WR                 GPIO_PTA1
+#define TEST_RD                 GPIO_PTA2
+#define TEST_DC                 GPIO_PTB0
+#define TEST_CS                 GPIO_PTB3
+#define TEST_E                  GPIO_PTE5
+#define TEST_SER                GPIO_PTF0
+#define TEST_CLK                GPIO_PTF1
+#define TEST_LATCH              GPIO_PTF2
+
+#define TEST_BIT(pin)           ( 1UL << ( ( pin ) & 0x1F ) )
+
+static uint8_t  TEST_au8Bus[64];
+static uint8_t  TEST_abCommand[64];
+static uint32_t TEST_u32Bytes;
+static uint32_t TEST_u32Deselected;
+static uint8_t  TEST_u8Mode;
+static uint32_t TEST_u32Shift;
+static uint32_t TEST_u32Outputs;
+
+static uint8_t TEST_Byte( uint32_t u32Levels )
+{
+  uint8_t u8Byte = 0;
+  int i;
+
+  for ( i = 0; i < 8; i++ )
+    if ( u32Levels & TEST_BIT( TEST_au8Data[i] ) )
+      u8Byte |= ( uint8_t )( 1 << i );
+
+  return u8Byte;
+}
+
+static void TEST_Latch( uint32_t u32Levels )
+{
+  if ( u32Levels & TEST_BIT( TEST_CS ) )
+  {
+    TEST_u32Deselected++;
+    return;
+  }
+
+  if ( TEST_u32Bytes < sizeof( TEST_au8Bus ) )
+  {
+    TEST_abCommand[TEST_u32Bytes] = !( u32Levels & TEST_BIT( TEST_DC ) );
+    TEST_au8Bus[TEST_u32Bytes] = TEST_Byte( u32Levels );
+  }
+
+  TEST_u32Bytes++;
+}
+
+/* the devices on the bus */
+static void TEST_Edge( uint8_t u8Port, uint32_t u32Old, uint32_t u32New )
+{
+  uint32_t u32Rising = ~u32Old & u32New;
+  uint32_t u32Falling = u32Old & ~u32New;
+
+  if ( u8Port == 0 && TEST_u8Mode == PBUS_MODE_8080 && ( u32Rising & TEST_BIT( TEST_WR ) ) )
+    TEST_Latch( u32New );
+
+  if ( u8Port == 1 && TEST_u8Mode == PBUS_MODE_6800 && ( u32Falling & TEST_BIT( TEST_E ) ) )
+    TEST_Latch( HOST_GpioLevel( 0 ) );
+
+  if ( u8Port == 1 && ( u32Rising & TEST_BIT( TEST_CLK ) ) )
+    TEST_u32Shift = ( TEST_u32Shift << 1 ) | !!( u32New & TEST_BIT( TEST_SER ) );
+
+  if ( u8Port == 1 && ( u32Rising & TEST_BIT( TEST_LATCH ) ) )
+    TEST_u32Outputs = TEST_u32Shift;
+}
+
+static void TEST_Init( uint8_t u8Mode )
+{
+  PBUS_ConfigType sConfig;
+
+  memcpy( sConfig.u8DataPin, TEST_au8Data, 8 );
+  sConfig.u8Mode = u8Mode;
+  sConfig.u8StrobePin = ( u8Mode == PBUS_MODE_8080 ) ? TEST_WR : TEST_E;
+  sConfig.u8RdPin = TEST_RD;
+  sConfig.u8DcPin = TEST_DC;
+  sConfig.u8CsPin = TEST_CS;
+  TEST_u8Mode = u8Mode;
+  PBUS_Init( &sConfig );
+  TEST_u32Bytes = 0;
+  TEST_u32Deselected = 0;
+}
+
+/* peripheral stores of sending u32Length bytes */
+static uint32_t TEST_Stores( uint8_t bRepeat, uint32_t u32Length )
+{
+  static uint8_t au8Data[256];
+  uint64_t u64Start = HOST_u64Clock;
+
+  if ( bRepeat )
+    PBUS_WriteRepeat( 0x55AA, u32Length / 2 );
+  else
+    PBUS_WriteData( au8Data, u32Length );
+
+  return ( uint32_t )( ( HOST_u64Clock - u64Start ) / HOST_u32AccessClocks );
+}
+
+int main( void )
+{
+  static const uint8_t au8Data[] = { 0x00, 0xFF, 0x5A, 0xA5, 0x81, 0x7E };
+  static const uint8_t au8Rect[] =
+  {
+    PBUS_DCS_CASET, 0x00, 0x10, 0x00, 0x12, PBUS_DCS_PASET, 0x01, 0x00, 0x01, 0x01,
+    PBUS_DCS_RAMWR, 0xF8, 0x1F, 0xF8, 0x1F, 0xF8, 0x1F, 0xF8, 0x1F, 0xF8, 0x1F, 0xF8, 0x1F
+  };
+  PBUS_ShiftConfigType sShift;
+  uint32_t u32Stores;
+  uint8_t au8Chain[3] = { 0x12, 0x34, 0x56 };
+  int i;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  HOST_GpioSetEdge( TEST_Edge );
+
+  TEST_Init( PBUS_MODE_8080 );
+  HOST_CHECK( ( HOST_GpioLevel( 0 ) & ( TEST_BIT( TEST_WR ) | TEST_BIT( TEST_RD ) | TEST_BIT( TEST_CS ) ) ) ==
+              ( TEST_BIT( TEST_WR ) | TEST_BIT( TEST_RD ) | TEST_BIT( TEST_CS ) ) );
+
+  /* no strobe reaches a device without CS# */
+  PBUS_WriteData( au8Data, 2 );
+  HOST_CHECK( TEST_u32Bytes == 0 && TEST_u32Deselected == 2 );
+
+  PBUS_Select( );
+  PBUS_WriteCommand( 0x3A );
+  PBUS_WriteData( au8Data, sizeof( au8Data ) );
+  HOST_CHECK( TEST_u32Bytes == 1 + sizeof( au8Data ) );
+  HOST_CHECK( TEST_au8Bus[0] == 0x3A && TEST_abCommand[0] && !TEST_abCommand[1] );
+  HOST_CHECK( !memcmp( TEST_au8Bus + 1, au8Data, sizeof( au8Data ) ) );
+
+  TEST_u32Bytes = 0;
+  PBUS_WriteRepeat( 0x1234, 20 );
+  HOST_CHECK( TEST_u32Bytes == 40 );
+
+  for ( i = 0; i < 40; i++ )
+    HOST_CHECK( TEST_au8Bus[i] == ( ( i & 1 ) ? 0x34 : 0x12 ) );
+
+  u32Stores = TEST_Stores( 0, 256 );
+  HOST_CHECK( u32Stores == 3 * 256 );
+  printf( "8080 data:   %u stores for 256 bytes\n", ( unsigned )u32Stores );
+  u32Stores = TEST_Stores( 1, 256 );
+  /* the first byte goes out whole, then the pins flip */
+  HOST_CHECK( u32Stores == 3 + 2 * 255 );
+  printf( "8080 repeat: %u stores for 256 bytes\n", ( unsigned )u32Stores );
+  PBUS_Deselect( );
+
+  TEST_u32Bytes = 0;
+  PBUS_FillRect( 0x10, 0x100, 3, 2, 0xF81F );
+  HOST_CHECK( TEST_u32Bytes == sizeof( au8Rect ) && !memcmp( TEST_au8Bus, au8Rect, sizeof( au8Rect ) ) );
+  HOST_CHECK( TEST_abCommand[0] && TEST_abCommand[5] && TEST_abCommand[10] && !TEST_abCommand[11] );
+  HOST_CHECK( HOST_GpioLevel( 0 ) & TEST_BIT( TEST_CS ) );
+
+  /* E on the other port */
+  TEST_Init( PBUS_MODE_6800 );
+  PBUS_Select( );
+  PBUS_WriteData( au8Data, sizeof( au8Data ) );
+  HOST_CHECK( TEST_u32Bytes == sizeof( au8Data ) && !memcmp( TEST_au8Bus, au8Data, sizeof( au8Data ) ) );
+  TEST_u32Bytes = 0;
+  PBUS_WriteRepeat( 0xA55A, 4 );
+  HOST_CHECK( TEST_u32Bytes == 8 && TEST_au8Bus[6] == 0xA5 && TEST_au8Bus[7] == 0x5A );
+  u32Stores = TEST_Stores( 0, 256 );
+  HOST_CHECK( u32Stores == 4 * 256 );
+  printf( "6800 data:   %u stores for 256 bytes\n", ( unsigned )u32Stores );
+  PBUS_Deselect( );
+
+  sShift.u8SerPin = TEST_SER;
+  sShift.u8ClkPin = TEST_CLK;
+  sShift.u8LatchPin = TEST_LATCH;
+  PBUS_ShiftInit( &sShift );
+  PBUS_ShiftOut( au8Chain, 3 );
+  HOST_CHECK( TEST_u32Outputs == 0x123456 );
+
+  return HOST_Exit( );
+}
@@ -0,0 +1,155 @@
+/******************************************************************************
+*
+* @brief host test of the power-fail handler: a supply falling through the
+*        warning to the LVD reset, a dip which comes back, and a warning in
+*        the middle of a sector erase of the application, held off until
+*        the erase has returned. Each time the state is saved and restored
+*        over the reset.
+*
+* The times are model time, flash commands as long as in host.c. The
+* hold-up times of a board were not measured.
+*
+* HOST_CONFIG: PWRFAIL_ENABLED 1
+* HOST_CONFIG: PWRFAIL_FLASH_ADDRESS 0x1F000
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_pwrfail.h"
+#include "NV32_flash.h"
+#include "host.h"
+
+#define TEST_SUPPLY_MV          5000
+#define TEST_WARNING_MV         2800        /* below the 3.0 V warning */
+#define TEST_OFF_MV             2000        /* below the 2.56 V LVD */
+#define TEST_ERASED_ADDRESS     0x1E000
+
+/* kept over the resets as the RAM is */
+static uint32_t TEST_u32Phase;
+static uint32_t TEST_u32SafeCalls;
+static uint32_t TEST_au32State[PWRFAIL_STATE_WORDS];
+static uint64_t TEST_u64EraseClock;
+static uint64_t TEST_u64SafeClock;
+
+static void TEST_SafeState( void )
+{
+  TEST_u32SafeCalls++;
+  TEST_u64SafeClock = HOST_u64Clock;
+}
+
+static void TEST_Supply( void * pArg )
+{
+  HOST_SetSupply( ( uint32_t )( uintptr_t )pArg );
+}
+
+static void TEST_At( uint32_t u32Us, uint32_t u32Millivolts )
+{
+  HOST_Schedule( HOST_u64Clock + ( uint64_t )u32Us * ( HOST_CoreHz( ) / 1000000 ), TEST_Supply,
+                 ( void * )( uintptr_t )u32Millivolts );
+}
+
+static uint8_t TEST_Restored( uint32_t u32First )
+{
+  uint32_t i;
+
+  for ( i = 0; i < PWRFAIL_STATE_WORDS; i++ )
+    if ( TEST_au32State[i] != u32First + i )
+      return 0;
+
+  return 1;
+}
+
+static void TEST_Fill( uint32_t u32First )
+{
+  uint32_t i;
+
+  for ( i = 0; i < PWRFAIL_STATE_WORDS; i++ )
+    TEST_au32State[i] = u32First + i;
+}
+
+int main( void )
+{
+  PWRFAIL_ConfigType sConfig = { 0 };
+  PWRFAIL_StatsType sLast;
+  uint8_t bRestored;
+  uint32_t u32Cause;
+  uint32_t i;
+
+  HOST_Init( );
+  u32Cause = ( uint32_t )HOST_BOOT( );
+
+  /* the supply is up again at every start */
+  HOST_SetSupply( TEST_SUPPLY_MV );
+  SystemInit( );
+  SystemCoreClockUpdate( );
+  Flash_Init( );
+  memset( TEST_au32State, 0, sizeof( TEST_au32State ) );
+  sConfig.u8LvwTrip    = PmcLVWTrip_High;
+  sConfig.u8LvdTrip    = PmcLVDTrip_Low;
+  sConfig.pu32State    = TEST_au32State;
+  sConfig.pfnSafeState = TEST_SafeState;
+  bRestored = PWRFAIL_Init( &sConfig, &sLast );
+
+  switch ( TEST_u32Phase++ )
+  {
+    case 0:
+      HOST_CHECK( u32Cause == 0 && !bRestored && sLast.u32Magic == 0 );
+
+      /* through the warning to the LVD reset 2 ms later */
+      TEST_Fill( 100 );
+      TEST_At( 100, TEST_WARNING_MV );
+      TEST_At( 2100, TEST_OFF_MV );
+      HOST_AdvanceUs( 10000 );
+      break;
+
+    case 1:
+      HOST_CHECK( u32Cause == SIM_SRSID_LVD_MASK && bRestored && TEST_Restored( 100 ) );
+      HOST_CHECK( sLast.u32Magic != 0 && sLast.bSaved && !sLast.bRecovered && TEST_u32SafeCalls == 1 );
+      /* four program commands, the rest of the 2 ms spare */
+      HOST_CHECK( sLast.u32SaveClocks > 4 * 10 * ( HOST_CoreHz( ) / 1000000 ) );
+      HOST_CHECK( sLast.u32SaveClocks + sLast.u32SpareClocks < 2000 * ( HOST_CoreHz( ) / 1000000 ) );
+      printf( "LVD: saved in %u us, %u us spare\n", ( unsigned )( sLast.u32SaveClocks / ( HOST_CoreHz( ) / 1000000 ) ),
+              ( unsigned )( sLast.u32SpareClocks / ( HOST_CoreHz( ) / 1000000 ) ) );
+
+      /* a 1 ms dip, reset by software once the supply is back */
+      TEST_Fill( 200 );
+      TEST_At( 100, TEST_WARNING_MV );
+      TEST_At( 1100, TEST_SUPPLY_MV );
+      HOST_AdvanceUs( 50000 );
+      break;
+
+    case 2:
+      HOST_CHECK( u32Cause == SIM_SRSID_SW_MASK && bRestored && TEST_Restored( 200 ) );
+      HOST_CHECK( sLast.bSaved && sLast.bRecovered && TEST_u32SafeCalls == 2 );
+
+      /* the warning 1 ms into an erase, taken when EFM_LaunchCMD unmasks */
+      Flash_Program1LongWord( TEST_ERASED_ADDRESS, 0x12345678 );
+      TEST_Fill( 300 );
+      TEST_At( 1000, TEST_WARNING_MV );
+      TEST_At( 8000, TEST_OFF_MV );
+      TEST_u64EraseClock = HOST_u64Clock;
+      Flash_EraseSector( TEST_ERASED_ADDRESS );
+      HOST_AdvanceUs( 10000 );
+      break;
+
+    case 3:
+      HOST_CHECK( u32Cause == SIM_SRSID_LVD_MASK && bRestored && TEST_Restored( 300 ) );
+      HOST_CHECK( sLast.bSaved && TEST_u32SafeCalls == 3 );
+
+      for ( i = 0; i < FLASH_SECTOR_SIZE; i += 4 )
+        if ( *( uint32_t * )( TEST_ERASED_ADDRESS + i ) != 0xFFFFFFFF )
+          break;
+
+      HOST_CHECK( i == FLASH_SECTOR_SIZE );
+      /* the handler ran after the 4.5 ms erase, the save as short as above */
+      HOST_CHECK( TEST_u64SafeClock - TEST_u64EraseClock > 4500 * ( HOST_CoreHz( ) / 1000000 ) );
+      HOST_CHECK( sLast.u32SaveClocks < 1000 * ( HOST_CoreHz( ) / 1000000 ) );
+      printf( "LVW during an erase: taken after %u us, saved in %u us\n",
+              ( unsigned )( ( TEST_u64SafeClock - TEST_u64EraseClock ) / ( HOST_CoreHz( ) / 1000000 ) ),
+              ( unsigned )( sLast.u32SaveClocks / ( HOST_CoreHz( ) / 1000000 ) ) );
+      return HOST_Exit( );
+  }
+
+  /* every phase but the last ends in a reset */
+  HOST_CHECK( 0 );
+  return HOST_Exit( );
+}
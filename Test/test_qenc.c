@@ -0,0 +1,112 @@
+/******************************************************************************
+*
+* @brief host test of the quadrature decoder: A/B edges are captured on ETM2
+*        by the register model, QENC counts them through its interrupt.
+*
+* HOST_CONFIG: VECTOR_IN_RAM 1
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_qenc.h"
+#include "host.h"
+
+#define TEST_TIMEOUT_TICKS      2000000UL
+
+static uint8_t TEST_au8Level[2];
+static uint8_t TEST_u8State;
+
+/* one edge of signal A (0) or B (1), the capture channel of its level */
+static void TEST_Edge( void * pArg )
+{
+  uint8_t u8Signal = ( uint8_t )( uintptr_t )pArg;
+  uint8_t u8Pair = u8Signal ? ETM_CHANNELPAIR1 : ETM_CHANNELPAIR0;
+
+  TEST_au8Level[u8Signal] ^= 1;
+  HOST_EtmCapture( 2, u8Pair + !TEST_au8Level[u8Signal] );
+}
+
+/* the signal of the next quarter period, A leading B when forward */
+static uint8_t TEST_NextSignal( int bForward )
+{
+  /* A rises, B rises, A falls, B falls; backward undoes the last one */
+  static const uint8_t au8Signal[4] = { 0, 1, 0, 1 };
+  uint8_t u8Signal = au8Signal[bForward ? TEST_u8State : ( TEST_u8State + 3 ) & 3];
+
+  TEST_u8State = bForward ? ( TEST_u8State + 1 ) & 3 : ( TEST_u8State + 3 ) & 3;
+  return u8Signal;
+}
+
+/* edges every u32Spacing core clocks, then run until the last is served */
+static void TEST_Run( uint32_t u32Edges, uint32_t u32Spacing, int bForward )
+{
+  uint64_t u64At = HOST_u64Clock;
+  uint32_t i;
+
+  for ( i = 0; i < u32Edges; i++ )
+  {
+    u64At += u32Spacing;
+    HOST_Schedule( u64At, TEST_Edge, ( void * )( uintptr_t )TEST_NextSignal( bForward ) );
+
+    /* the scheduler holds a limited number of events */
+    if ( ( i & 31 ) == 31 )
+      HOST_Advance( u64At - HOST_u64Clock );
+  }
+
+  HOST_Advance( u64At - HOST_u64Clock + 200 );
+}
+
+int main( void )
+{
+  QENC_ConfigType sConfig = { 0 };
+  QENC_StatusType sStatus;
+  int32_t i32Velocity;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+
+  sConfig.u8ChannelPairA = ETM_CHANNELPAIR0;
+  sConfig.u8ChannelPairB = ETM_CHANNELPAIR1;
+  sConfig.u8ClockPrescale = ETM_CLOCK_PS_DIV1;
+  sConfig.u32TimeoutTicks = TEST_TIMEOUT_TICKS;
+  QENC_Init( &sConfig );
+
+  /* the first edge of each signal only gives its level */
+  TEST_Run( 102, 5000, 1 );
+  HOST_CHECK( QENC_GetPosition( ) == 100 );
+
+  /* 5000 clocks an edge */
+  i32Velocity = QENC_GetVelocity( );
+  HOST_CHECK( i32Velocity == ( int32_t )( SystemCoreClock / 5000 ) );
+  printf( "forward at %u counts/s: %d\n", ( unsigned )( SystemCoreClock / 5000 ), ( int )i32Velocity );
+
+  TEST_Run( 40, 20000, 0 );
+  HOST_CHECK( QENC_GetPosition( ) == 60 );
+  HOST_CHECK( QENC_GetVelocity( ) == -( int32_t )( SystemCoreClock / 20000 ) );
+
+  /* slower than an ETM2 period, the extended counter spans it */
+  TEST_Run( 8, 150000, 1 );
+  HOST_CHECK( QENC_GetPosition( ) == 68 );
+  HOST_CHECK( QENC_GetVelocity( ) == ( int32_t )( SystemCoreClock / 150000 ) );
+
+  /* no edge for longer than the timeout */
+  HOST_Advance( TEST_TIMEOUT_TICKS + 1000 );
+  HOST_CHECK( QENC_GetVelocity( ) == 0 );
+
+  /* a lost B edge: A changes with B stale, the state machine sees a double change */
+  TEST_NextSignal( 1 );
+  TEST_au8Level[1] ^= 1;
+  TEST_Run( 4, 5000, 1 );
+  QENC_GetStatus( &sStatus );
+  HOST_CHECK( sStatus.u32ErrorCount == 1 );
+
+  QENC_IndexCallback( );
+  QENC_GetStatus( &sStatus );
+  HOST_CHECK( sStatus.u32IndexCount == 1 && sStatus.i32IndexPosition == sStatus.i32Position );
+
+  QENC_DeInit( );
+  return HOST_Exit( );
+}
@@ -0,0 +1,450 @@
+/******************************************************************************
+*
+* @brief host test of the software I2C, SPI and 1-Wire masters: slaves are
+*        modelled on the pin edges, and the edge times are checked against
+*        the bus timing asked for.
+*
+* The masters run single stepped, one model clock per host instruction, so
+* SWBUS_Calibrate times the delay loop as the host compiles it. The delays
+* are therefore checked the way the target derives them, from the core
+* clock and the calibrated loop. The SWBUS_xxx_CYCLES estimates of the code
+* between the delays are M0+ figures, the host code differs, and the M0+
+* figures are not verified by this test.
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_swbus.h"
+#include "host.h"
+
+#define TEST_SCL                GPIO_PTE0
+#define TEST_SDA                GPIO_PTE1
+#define TEST_SCK                GPIO_PTF0
+#define TEST_MOSI               GPIO_PTF1
+#define TEST_MISO               GPIO_PTF2
+#define TEST_DQ                 GPIO_PTG0
+
+#define TEST_BIT(pin)           ( 1UL << ( ( pin ) & 0x1F ) )
+#define TEST_EDGES              2048
+
+#define TEST_I2C_ADDRESS        0x50
+
+typedef struct
+{
+  uint64_t u64Clock;
+  uint32_t u32Rising;
+  uint32_t u32Falling;
+} TEST_EdgeType;
+
+static TEST_EdgeType TEST_asEdge[TEST_EDGES];
+static uint32_t TEST_u32Edges;
+
+/* I2C slave */
+static uint8_t  TEST_u8I2cBit;          /* clocks of the current byte */
+static uint8_t  TEST_u8I2cByte;
+static uint8_t  TEST_bI2cAddressed;
+static uint8_t  TEST_bI2cAddress;       /* the byte is the address */
+static uint8_t  TEST_bI2cTransmit;
+static uint8_t  TEST_bI2cMasterAck;
+static uint8_t  TEST_au8I2cRx[16];
+static uint32_t TEST_u32I2cRx;
+static uint8_t  TEST_au8I2cTx[4] = { 0xDE, 0xAD, 0xBE, 0xEF };
+static uint32_t TEST_u32I2cTx;
+
+/* SPI slave, mode 0 */
+static uint8_t  TEST_u8SpiRx;
+static uint8_t  TEST_u8SpiTx = 0xC3;
+static uint8_t  TEST_u8SpiBit;
+static uint8_t  TEST_au8SpiRx[8];
+static uint32_t TEST_u32SpiRx;
+
+/* 1-Wire slave */
+static uint8_t  TEST_bOwPresence;
+static uint64_t TEST_u64OwFall;
+static uint8_t  TEST_u8OwTx = 0xA6;
+static uint8_t  TEST_u8OwTxBit;
+static uint8_t  TEST_bOwReading;
+
+static void TEST_Drive( uint8_t u8Pin, int bLevel )
+{
+  HOST_GpioDrive( 1, TEST_BIT( u8Pin ), bLevel ? 0xFFFFFFFF : 0 );
+}
+
+static void TEST_I2cSdaBit( void )
+{
+  TEST_Drive( TEST_SDA, TEST_au8I2cTx[TEST_u32I2cTx & 3] & ( 0x80 >> TEST_u8I2cBit ) );
+}
+
+static void TEST_I2c( uint32_t u32Levels, uint32_t u32Rising, uint32_t u32Falling )
+{
+  if ( u32Levels & TEST_BIT( TEST_SCL ) )
+  {
+    if ( u32Falling & TEST_BIT( TEST_SDA ) )
+    {
+      /* start */
+      TEST_u8I2cBit = 0;
+      TEST_bI2cAddress = 1;
+      TEST_bI2cTransmit = 0;
+      TEST_bI2cAddressed = 0;
+    }
+    else if ( u32Rising & TEST_BIT( TEST_SDA ) )
+    {
+      /* stop */
+      TEST_bI2cAddressed = 0;
+      TEST_bI2cTransmit = 0;
+    }
+  }
+
+  /* clocks 1 ~ 8 carry the data, 9 the acknowledge */
+  if ( u32Rising & TEST_BIT( TEST_SCL ) )
+  {
+    if ( TEST_u8I2cBit < 8 )
+      TEST_u8I2cByte = ( uint8_t )( ( TEST_u8I2cByte << 1 ) | !!( u32Levels & TEST_BIT( TEST_SDA ) ) );
+    else
+      TEST_bI2cMasterAck = !( u32Levels & TEST_BIT( TEST_SDA ) );
+
+    TEST_u8I2cBit++;
+  }
+
+  if ( !( u32Falling & TEST_BIT( TEST_SCL ) ) || TEST_u8I2cBit == 0 )
+    return;
+
+  if ( TEST_bI2cTransmit )
+  {
+    if ( TEST_u8I2cBit < 8 )
+    {
+      TEST_I2cSdaBit( );
+    }
+    else if ( TEST_u8I2cBit == 8 )
+    {
+      /* the master acknowledges */
+      TEST_Drive( TEST_SDA, 1 );
+    }
+    else
+    {
+      TEST_u8I2cBit = 0;
+      TEST_u32I2cTx++;
+
+      if ( TEST_bI2cMasterAck )
+        TEST_I2cSdaBit( );
+      else
+        TEST_bI2cTransmit = 0;
+    }
+
+    return;
+  }
+
+  if ( TEST_u8I2cBit == 8 )
+  {
+    if ( TEST_bI2cAddress )
+      TEST_bI2cAddressed = ( TEST_u8I2cByte >> 1 ) == TEST_I2C_ADDRESS;
+
+    if ( TEST_bI2cAddressed )
+      TEST_Drive( TEST_SDA, 0 );
+  }
+  else if ( TEST_u8I2cBit == 9 )
+  {
+    TEST_Drive( TEST_SDA, 1 );
+    TEST_u8I2cBit = 0;
+
+    if ( TEST_bI2cAddressed && TEST_bI2cAddress && ( TEST_u8I2cByte & 1 ) )
+    {
+      TEST_bI2cTransmit = 1;
+      TEST_I2cSdaBit( );
+    }
+    else if ( TEST_bI2cAddressed && !TEST_bI2cAddress && TEST_u32I2cRx < sizeof( TEST_au8I2cRx ) )
+    {
+      TEST_au8I2cRx[TEST_u32I2cRx++] = TEST_u8I2cByte;
+    }
+
+    TEST_bI2cAddress = 0;
+  }
+}
+
+static void TEST_Spi( uint32_t u32Levels, uint32_t u32Rising, uint32_t u32Falling )
+{
+  if ( u32Rising & TEST_BIT( TEST_SCK ) )
+  {
+    TEST_u8SpiRx = ( uint8_t )( ( TEST_u8SpiRx << 1 ) | !!( u32Levels & TEST_BIT( TEST_MOSI ) ) );
+
+    if ( ++TEST_u8SpiBit == 8 )
+    {
+      TEST_u8SpiBit = 0;
+
+      if ( TEST_u32SpiRx < sizeof( TEST_au8SpiRx ) )
+        TEST_au8SpiRx[TEST_u32SpiRx++] = TEST_u8SpiRx;
+    }
+  }
+
+  /* the next bit after the sampling edge */
+  if ( u32Falling & TEST_BIT( TEST_SCK ) )
+    TEST_Drive( TEST_MISO, TEST_u8SpiTx & ( 0x80 >> TEST_u8SpiBit ) );
+}
+
+static void TEST_OwRelease( void * pArg )
+{
+  ( void )pArg;
+  TEST_Drive( TEST_DQ, 1 );
+}
+
+static void TEST_OwPresence( void * pArg )
+{
+  ( void )pArg;
+  TEST_Drive( TEST_DQ, 0 );
+  HOST_Schedule( HOST_u64Clock + 120ULL * HOST_CoreHz( ) / 1000000, TEST_OwRelease, NULL );
+}
+
+static void TEST_Ow( uint32_t u32Rising, uint32_t u32Falling )
+{
+  uint64_t u64Low;
+
+  if ( u32Falling & TEST_BIT( TEST_DQ ) )
+  {
+    TEST_u64OwFall = HOST_u64Clock;
+
+    /* a 0 bit is held low for 30 us from the master's edge */
+    if ( TEST_bOwReading && !( TEST_u8OwTx & ( 1 << TEST_u8OwTxBit ) ) )
+    {
+      TEST_Drive( TEST_DQ, 0 );
+      HOST_Schedule( HOST_u64Clock + 30ULL * HOST_CoreHz( ) / 1000000, TEST_OwRelease, NULL );
+    }
+
+    if ( TEST_bOwReading )
+      TEST_u8OwTxBit = ( TEST_u8OwTxBit + 1 ) & 7;
+  }
+
+  if ( u32Rising & TEST_BIT( TEST_DQ ) )
+  {
+    u64Low = HOST_u64Clock - TEST_u64OwFall;
+
+    /* presence 30 us after the end of a reset pulse */
+    if ( u64Low >= 480ULL * HOST_CoreHz( ) / 1000000 && TEST_bOwPresence )
+      HOST_Schedule( HOST_u64Clock + 30ULL * HOST_CoreHz( ) / 1000000, TEST_OwPresence, NULL );
+  }
+}
+
+static void TEST_Edge( uint8_t u8Port, uint32_t u32Old, uint32_t u32New )
+{
+  uint32_t u32Rising = ~u32Old & u32New;
+  uint32_t u32Falling = u32Old & ~u32New;
+
+  if ( u8Port != 1 )
+    return;
+
+  if ( TEST_u32Edges < TEST_EDGES )
+  {
+    TEST_asEdge[TEST_u32Edges].u64Clock = HOST_u64Clock;
+    TEST_asEdge[TEST_u32Edges].u32Rising = u32Rising;
+    TEST_asEdge[TEST_u32Edges].u32Falling = u32Falling;
+    TEST_u32Edges++;
+  }
+
+  if ( ( u32Rising | u32Falling ) & ( TEST_BIT( TEST_SCL ) | TEST_BIT( TEST_SDA ) ) )
+    TEST_I2c( u32New, u32Rising, u32Falling );
+
+  if ( ( u32Rising | u32Falling ) & TEST_BIT( TEST_SCK ) )
+    TEST_Spi( u32New, u32Rising, u32Falling );
+
+  if ( ( u32Rising | u32Falling ) & TEST_BIT( TEST_DQ ) )
+    TEST_Ow( u32Rising, u32Falling );
+}
+
+/* clocks from a falling to the next rising edge of a pin and the other way */
+typedef struct
+{
+  uint64_t u64MinLow, u64MaxLow;
+  uint64_t u64MinHigh, u64MaxHigh;
+  uint64_t u64MinPeriod, u64MaxPeriod;
+  uint32_t u32Periods;
+} TEST_TimingType;
+
+static void TEST_Timing( uint32_t u32Mask, TEST_TimingType * pTiming )
+{
+  uint64_t u64Rise = 0, u64Fall = 0, u64Time;
+  uint32_t i;
+
+  memset( pTiming, 0, sizeof( *pTiming ) );
+  pTiming->u64MinLow = pTiming->u64MinHigh = pTiming->u64MinPeriod = ~0ULL;
+
+  for ( i = 0; i < TEST_u32Edges; i++ )
+  {
+    if ( TEST_asEdge[i].u32Rising & u32Mask )
+    {
+      if ( u64Fall )
+      {
+        u64Time = TEST_asEdge[i].u64Clock - u64Fall;
+        pTiming->u64MinLow = u64Time < pTiming->u64MinLow ? u64Time : pTiming->u64MinLow;
+        pTiming->u64MaxLow = u64Time > pTiming->u64MaxLow ? u64Time : pTiming->u64MaxLow;
+      }
+
+      if ( u64Rise )
+      {
+        u64Time = TEST_asEdge[i].u64Clock - u64Rise;
+        pTiming->u64MinPeriod = u64Time < pTiming->u64MinPeriod ? u64Time : pTiming->u64MinPeriod;
+        pTiming->u64MaxPeriod = u64Time > pTiming->u64MaxPeriod ? u64Time : pTiming->u64MaxPeriod;
+        pTiming->u32Periods++;
+      }
+
+      u64Rise = TEST_asEdge[i].u64Clock;
+    }
+
+    if ( TEST_asEdge[i].u32Falling & u32Mask )
+    {
+      if ( u64Rise )
+      {
+        u64Time = TEST_asEdge[i].u64Clock - u64Rise;
+        pTiming->u64MinHigh = u64Time < pTiming->u64MinHigh ? u64Time : pTiming->u64MinHigh;
+        pTiming->u64MaxHigh = u64Time > pTiming->u64MaxHigh ? u64Time : pTiming->u64MaxHigh;
+      }
+
+      u64Fall = TEST_asEdge[i].u64Clock;
+    }
+  }
+}
+
+static uint64_t TEST_Ns( uint64_t u64Clocks )
+{
+  return u64Clocks * 1000000000ULL / HOST_CoreHz( );
+}
+
+/* the edges of one configuration, the shortest SCL period in clocks */
+static uint64_t TEST_I2cAt( uint32_t u32Hz, uint32_t u32LowNs, uint32_t u32HighNs )
+{
+  static const uint8_t au8Data[3] = { 0x01, 0x80, 0x5A };
+  SWBUS_I2CConfigType sConfig = { TEST_SCL, TEST_SDA, 0, 0 };
+  SWBUS_I2CType sI2C;
+  TEST_TimingType sTiming;
+  uint8_t au8Read[3];
+  uint64_t u64Period = ( HOST_CoreHz( ) + u32Hz - 1 ) / u32Hz;
+
+  sConfig.u32Hz = u32Hz;
+  SWBUS_I2CInit( &sI2C, &sConfig );
+
+  TEST_u32Edges = 0;
+  TEST_u32I2cRx = 0;
+  HOST_CHECK( SWBUS_I2CWrite( &sI2C, TEST_I2C_ADDRESS, au8Data, 3 ) == SWBUS_ERROR_NULL );
+  HOST_CHECK( TEST_u32I2cRx == 3 && !memcmp( TEST_au8I2cRx, au8Data, 3 ) );
+  HOST_CHECK( SWBUS_I2CWrite( &sI2C, TEST_I2C_ADDRESS + 1, au8Data, 1 ) == SWBUS_ERROR_NO_ACK );
+
+  TEST_u32I2cTx = 0;
+  HOST_CHECK( SWBUS_I2CRead( &sI2C, TEST_I2C_ADDRESS, au8Read, 3 ) == SWBUS_ERROR_NULL );
+  HOST_CHECK( !memcmp( au8Read, TEST_au8I2cTx, 3 ) );
+
+  TEST_Timing( TEST_BIT( TEST_SCL ), &sTiming );
+  HOST_CHECK( sTiming.u32Periods > 3 * 9 );
+  /* never faster than asked */
+  HOST_CHECK( sTiming.u64MinPeriod >= u64Period );
+  HOST_CHECK( TEST_Ns( sTiming.u64MinLow ) >= u32LowNs );
+  HOST_CHECK( TEST_Ns( sTiming.u64MinHigh ) >= u32HighNs );
+  printf( "i2c %6u Hz: period %llu ~ %llu ns, low >= %llu ns, high >= %llu ns\n", ( unsigned )u32Hz,
+          ( unsigned long long )TEST_Ns( sTiming.u64MinPeriod ), ( unsigned long long )TEST_Ns( sTiming.u64MaxPeriod ),
+          ( unsigned long long )TEST_Ns( sTiming.u64MinLow ), ( unsigned long long )TEST_Ns( sTiming.u64MinHigh ) );
+  return sTiming.u64MinPeriod;
+}
+
+/* the edges of one configuration, the shortest SCK period in clocks */
+static uint64_t TEST_SpiAt( uint32_t u32Hz, uint8_t bTimed )
+{
+  static const uint8_t au8Tx[4] = { 0x96, 0x00, 0xFF, 0x3C };
+  SWBUS_SPIConfigType sConfig = { TEST_SCK, TEST_MOSI, TEST_MISO, 0, 0 };
+  SWBUS_SPIType sSPI;
+  TEST_TimingType sTiming;
+  uint8_t au8Rx[4];
+  uint64_t u64Half = ( HOST_CoreHz( ) + 2 * u32Hz - 1 ) / ( 2 * u32Hz );
+
+  sConfig.u32Hz = u32Hz;
+  SWBUS_SPIInit( &sSPI, &sConfig );
+  TEST_Drive( TEST_MISO, TEST_u8SpiTx & 0x80 );
+
+  TEST_u32Edges = 0;
+  TEST_u32SpiRx = 0;
+  TEST_u8SpiBit = 0;
+  SWBUS_SPITransferBlock( &sSPI, au8Tx, au8Rx, 4 );
+  HOST_CHECK( TEST_u32SpiRx == 4 && !memcmp( TEST_au8SpiRx, au8Tx, 4 ) );
+  HOST_CHECK( au8Rx[0] == TEST_u8SpiTx && au8Rx[3] == TEST_u8SpiTx );
+
+  TEST_Timing( TEST_BIT( TEST_SCK ), &sTiming );
+  HOST_CHECK( !bTimed || ( sTiming.u64MinHigh >= u64Half && sTiming.u64MinLow >= u64Half ) );
+  printf( "spi %6u Hz: period %llu ~ %llu ns, high >= %llu ns, low >= %llu ns\n", ( unsigned )u32Hz,
+          ( unsigned long long )TEST_Ns( sTiming.u64MinPeriod ), ( unsigned long long )TEST_Ns( sTiming.u64MaxPeriod ),
+          ( unsigned long long )TEST_Ns( sTiming.u64MinHigh ), ( unsigned long long )TEST_Ns( sTiming.u64MinLow ) );
+  return sTiming.u64MinPeriod;
+}
+
+/*
+ * the code between the delays costs what it costs on the host, the delays
+ * have to make up the difference between two speeds to within 3 %; the
+ * speeds are far apart so a loop rounded up per delay stays inside that
+ */
+static void TEST_Scaling( const char * pBus, uint64_t u64Slow, uint64_t u64Fast, uint32_t u32SlowHz, uint32_t u32FastHz )
+{
+  int64_t i64Asked = ( int64_t )( HOST_CoreHz( ) / u32SlowHz ) - ( int64_t )( HOST_CoreHz( ) / u32FastHz );
+  int64_t i64Got = ( int64_t )u64Slow - ( int64_t )u64Fast;
+
+  HOST_CHECK( ( i64Got - i64Asked ) * 100 <= 3 * i64Asked && ( i64Asked - i64Got ) * 100 <= 3 * i64Asked );
+  printf( "%s %u Hz to %u Hz: period shorter by %lld clocks, %lld asked\n", pBus, ( unsigned )u32SlowHz,
+          ( unsigned )u32FastHz, ( long long )i64Got, ( long long )i64Asked );
+}
+
+static void TEST_OneWire( void )
+{
+  SWBUS_OWConfigType sConfig = { TEST_DQ, 0 };
+  SWBUS_OWType sOW;
+  TEST_TimingType sTiming;
+  uint64_t u64Us = HOST_CoreHz( ) / 1000000;
+
+  SWBUS_OWInit( &sOW, &sConfig );
+
+  TEST_bOwPresence = 0;
+  HOST_CHECK( !SWBUS_OWReset( &sOW ) );
+  TEST_bOwPresence = 1;
+  TEST_u32Edges = 0;
+  HOST_CHECK( SWBUS_OWReset( &sOW ) );
+  TEST_Timing( TEST_BIT( TEST_DQ ), &sTiming );
+  /* the reset pulse, then the presence pulse */
+  HOST_CHECK( sTiming.u64MaxLow >= 480 * u64Us && sTiming.u64MaxLow < 600 * u64Us );
+  printf( "1-wire reset low %llu us\n", ( unsigned long long )( sTiming.u64MaxLow / u64Us ) );
+
+  /* write 1 then 0 slots */
+  TEST_u32Edges = 0;
+  SWBUS_OWWriteByte( &sOW, 0x0F );
+  TEST_Timing( TEST_BIT( TEST_DQ ), &sTiming );
+  HOST_CHECK( sTiming.u64MinLow >= 1 * u64Us && sTiming.u64MinLow <= 15 * u64Us );
+  HOST_CHECK( sTiming.u64MaxLow >= 60 * u64Us && sTiming.u64MaxLow <= 120 * u64Us );
+  HOST_CHECK( sTiming.u64MinPeriod >= 61 * u64Us );
+  printf( "1-wire write 1 low %llu us, write 0 low %llu us, slot >= %llu us\n",
+          ( unsigned long long )( sTiming.u64MinLow / u64Us ), ( unsigned long long )( sTiming.u64MaxLow / u64Us ),
+          ( unsigned long long )( sTiming.u64MinPeriod / u64Us ) );
+
+  TEST_bOwReading = 1;
+  TEST_u8OwTxBit = 0;
+  HOST_CHECK( SWBUS_OWReadByte( &sOW ) == TEST_u8OwTx );
+  TEST_bOwReading = 0;
+}
+
+int main( void )
+{
+  uint64_t u64Slow, u64Fast;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  HOST_GpioSetEdge( TEST_Edge );
+
+  HOST_StepBegin( );
+  u64Slow = TEST_I2cAt( 10000, 4700, 4000 );
+  u64Fast = TEST_I2cAt( 100000, 4700, 4000 );
+  TEST_Scaling( "i2c", u64Slow, u64Fast, 10000, 100000 );
+  TEST_I2cAt( 400000, 1300, 600 );
+  u64Slow = TEST_SpiAt( 20000, 1 );
+  u64Fast = TEST_SpiAt( 250000, 1 );
+  TEST_Scaling( "spi", u64Slow, u64Fast, 20000, 250000 );
+  /* the half period is mostly the SWBUS_SPI_HALF_CYCLES code, the data only */
+  TEST_SpiAt( 1000000, 0 );
+  TEST_OneWire( );
+  HOST_StepEnd( );
+
+  return HOST_Exit( );
+}
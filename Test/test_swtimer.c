@@ -0,0 +1,114 @@
+/******************************************************************************
+*
+* @brief host test of the software timers: a callback stopping another timer
+*        of its slot, expiry times, and a bus clock change under a running
+*        timer.
+*
+* The times are model time, SWTMR_TICK_US is 1000.
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_swtimer.h"
+#include "host.h"
+
+#define TEST_PS_PER_TICK        ( SWTMR_TICK_US * 1000000ULL )
+
+static SWTMR_TimerType TEST_sA, TEST_sB, TEST_sC, TEST_sD;
+static uint32_t TEST_au32Runs[4];
+static uint64_t TEST_au64Ps[4];
+
+void PIT_Ch0Isr( void );
+
+/* the application glue of startup_NV32.s, as in Application/main.c */
+void PIT_CH0_IRQHandler( void )
+{
+  PIT_Ch0Isr( );
+}
+
+static void TEST_Expired( void * pParam )
+{
+  uintptr_t uIndex = ( uintptr_t )pParam;
+
+  TEST_au32Runs[uIndex]++;
+  TEST_au64Ps[uIndex] = HOST_u64Ps;
+
+  if ( uIndex == 0 )
+  {
+    /* B is due in the same tick and still linked behind A */
+    SWTMR_Stop( &TEST_sB );
+    SWTMR_Start( &TEST_sC, 3, 0 );
+  }
+}
+
+static void TEST_Reset( void )
+{
+  memset( TEST_au32Runs, 0, sizeof( TEST_au32Runs ) );
+  memset( TEST_au64Ps, 0, sizeof( TEST_au64Ps ) );
+}
+
+int main( void )
+{
+  uint64_t u64Start;
+  uint32_t u32Ticks;
+  __istate_t interrupt_state;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  SWTMR_Init( );
+  SWTMR_TimerInit( &TEST_sA, TEST_Expired, ( void * )0 );
+  SWTMR_TimerInit( &TEST_sB, TEST_Expired, ( void * )1 );
+  SWTMR_TimerInit( &TEST_sC, TEST_Expired, ( void * )2 );
+  SWTMR_TimerInit( &TEST_sD, TEST_Expired, ( void * )3 );
+
+  /* B first, A is then ahead of it in the slot list */
+  u64Start = HOST_u64Ps;
+  SWTMR_Start( &TEST_sB, 10, 0 );
+  SWTMR_Start( &TEST_sA, 10, 0 );
+  HOST_AdvanceUs( 20 * SWTMR_TICK_US );
+
+  HOST_CHECK( TEST_au32Runs[0] == 1 && TEST_au32Runs[1] == 0 && TEST_au32Runs[2] == 1 );
+  HOST_CHECK( !SWTMR_IsActive( &TEST_sA ) && !SWTMR_IsActive( &TEST_sB ) && !SWTMR_IsActive( &TEST_sC ) );
+  HOST_CHECK( TEST_au64Ps[0] - u64Start >= 10 * TEST_PS_PER_TICK && TEST_au64Ps[0] - u64Start < 11 * TEST_PS_PER_TICK );
+  HOST_CHECK( TEST_au64Ps[2] - TEST_au64Ps[0] >= 2 * TEST_PS_PER_TICK && TEST_au64Ps[2] - TEST_au64Ps[0] < 4 * TEST_PS_PER_TICK );
+
+  /* a periodic timer through a cascade */
+  TEST_Reset( );
+  u64Start = HOST_u64Ps;
+  SWTMR_Start( &TEST_sD, 300, 300 );
+  HOST_AdvanceUs( 1000 * SWTMR_TICK_US );
+  SWTMR_Stop( &TEST_sD );
+  HOST_CHECK( TEST_au32Runs[3] == 3 );
+  HOST_CHECK( TEST_au64Ps[3] - u64Start >= 900 * TEST_PS_PER_TICK && TEST_au64Ps[3] - u64Start < 901 * TEST_PS_PER_TICK );
+  printf( "periodic 300 ticks, third expiry after %llu us\n",
+          ( unsigned long long )( ( TEST_au64Ps[3] - u64Start ) / 1000000 ) );
+
+  /* the bus clock doubles 20 ticks into a 50 tick timer */
+  TEST_Reset( );
+  u64Start = HOST_u64Ps;
+  u32Ticks = SWTMR_GetTicks( );
+  SWTMR_Start( &TEST_sD, 50, 0 );
+  HOST_AdvanceUs( 20 * SWTMR_TICK_US + SWTMR_TICK_US / 2 );
+
+  interrupt_state = __get_interrupt_state( );
+  __disable_interrupt( );
+  SIM->BUSDIV = 0;
+  SWTMR_ClockUpdate( );
+  __set_interrupt_state( interrupt_state );
+
+  HOST_CHECK( HOST_BusHz( ) == HOST_CoreHz( ) );
+  HOST_AdvanceUs( 10 * SWTMR_TICK_US );
+  /* the start was within a tick */
+  HOST_CHECK( SWTMR_GetTicks( ) - u32Ticks - 30 <= 1 );
+  HOST_AdvanceUs( 30 * SWTMR_TICK_US );
+  HOST_CHECK( TEST_au32Runs[3] == 1 );
+  HOST_CHECK( TEST_au64Ps[3] - u64Start > 49 * TEST_PS_PER_TICK && TEST_au64Ps[3] - u64Start < 51 * TEST_PS_PER_TICK );
+  printf( "50 ticks over a bus clock change: %llu us\n",
+          ( unsigned long long )( ( TEST_au64Ps[3] - u64Start ) / 1000000 ) );
+
+  SWTMR_DeInit( );
+  return HOST_Exit( );
+}
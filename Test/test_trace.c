@@ -0,0 +1,125 @@
+/******************************************************************************
+*
+* @brief host test of the trace ring: records go through TRACE_Drain and the
+*        UART model into a capture file, Test/host/trace_decode.py decodes
+*        it with the ELF file of this test, and the lines have to read as
+*        printf would, with the dropped records counted.
+*
+* HOST_CONFIG: TRACE_ENABLED 1
+*
+******************************************************************************/
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "NV32.h"
+#include "NV32_trace.h"
+#include "NV32_uart.h"
+#include "host.h"
+
+#define TEST_RECORDS            130         /* two words each, 128 fit the ring */
+
+static uint8_t TEST_au8Capture[4096];
+static uint32_t TEST_u32Captured;
+
+static void TEST_UartTx( uint8_t u8Port, uint8_t u8Data )
+{
+  if ( u8Port == 1 && TEST_u32Captured < sizeof( TEST_au8Capture ) )
+    TEST_au8Capture[TEST_u32Captured++] = u8Data;
+}
+
+int main( void )
+{
+  static const char * const apExpected[] =
+  {
+    "boot",
+    "adc 3300 mV",
+    "pos -5 vel 120",
+    "spi: 0xdeadbeef k",
+    "   42|00ff|",
+  };
+  UART_ConfigType sConfig = { { 0 } };
+  char acPath[64];
+  char acCommand[256];
+  char acLine[128];
+  FILE *pCapture;
+  FILE *pDecoder;
+  uint32_t u32Line = 0;
+  uint32_t u32Mismatch = 0;
+  uint32_t i;
+  int iFd;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  sConfig.u32SysClkHz = HOST_BusHz( );
+  sConfig.u32Baudrate = 115200;
+  UART_Init( UART1, &sConfig );
+  HOST_UartSetTx( 1, TEST_UartTx );
+  TRACE_Init( );
+
+  TRACE0( "boot" );
+  TRACE1( "adc %u mV", 3300 );
+  TRACE2( "pos %d vel %d", -5, 120 );
+  TRACE3( "%s: 0x%08lx %c", "spi", 0xDEADBEEF, 'k' );
+  TRACE2( "%5d|%04x|", 42, 0xFF );
+  TRACE_Flush( UART1 );
+
+  /* the ring fills up without a drain */
+  for ( i = 0; i < TEST_RECORDS; i++ )
+    TRACE1( "n %u", i );
+
+  HOST_CHECK( TRACE_u32Dropped == TEST_RECORDS - 128 );
+  TRACE_Flush( UART1 );
+  TRACE0( "after" );
+  TRACE_Flush( UART1 );
+  HOST_CHECK( TEST_u32Captured == 4 * ( 1 + 2 + 3 + 4 + 3 + 2 * 128 + 1 ) );
+
+  strcpy( acPath, "/tmp/test_trace_XXXXXX" );
+  iFd = mkstemp( acPath );
+  HOST_CHECK( iFd >= 0 );
+  pCapture = fdopen( iFd, "wb" );
+  fwrite( TEST_au8Capture, 1, TEST_u32Captured, pCapture );
+  fclose( pCapture );
+
+  /* the decoder sits next to host.c, found from the path of this file */
+  snprintf( acCommand, sizeof( acCommand ), "python3 %.*shost/trace_decode.py /proc/%d/exe %s",
+            ( int )( strrchr( __FILE__, '/' ) ? strrchr( __FILE__, '/' ) - __FILE__ + 1 : 0 ), __FILE__,
+            ( int )getpid( ), acPath );
+  pDecoder = popen( acCommand, "r" );
+  HOST_CHECK( pDecoder != NULL );
+
+  while ( pDecoder && fgets( acLine, sizeof( acLine ), pDecoder ) )
+  {
+    char acExpected[32];
+    const char *pExpected = acExpected;
+
+    acLine[strcspn( acLine, "\n" )] = 0;
+
+    if ( u32Line < 5 )
+      pExpected = apExpected[u32Line];
+    else if ( u32Line < 5 + 128 )
+      snprintf( acExpected, sizeof( acExpected ), "n %u", ( unsigned )( u32Line - 5 ) );
+    else if ( u32Line == 5 + 128 )
+      pExpected = "<2 records lost>";
+    else
+      pExpected = "after";
+
+    if ( strcmp( acLine, pExpected ) )
+    {
+      if ( !u32Mismatch++ )
+        printf( "line %u: \"%s\", not \"%s\"\n", ( unsigned )u32Line, acLine, pExpected );
+    }
+
+    u32Line++;
+  }
+
+  HOST_CHECK( pDecoder && pclose( pDecoder ) == 0 );
+  unlink( acPath );
+  HOST_CHECK( u32Line == 5 + 128 + 2 && u32Mismatch == 0 );
+  printf( "%u bytes decoded into %u lines\n", ( unsigned )TEST_u32Captured, ( unsigned )u32Line );
+
+  return HOST_Exit( );
+}
@@ -0,0 +1,268 @@
+/******************************************************************************
+*
+* @brief host test of an A/B update end to end: a host streams an image over
+*        the UART model to BOOT_Receive, one DATA frame corrupted on the
+*        line, and the image has to land in slot A, verified, as the
+*        pending image BOOT_Select then starts. The throughput BOOT_Receive
+*        measures is printed.
+*
+* The times are model time, BOOT_BAUDRATE on the bus clock of SystemInit,
+* flash commands as long as in host.c, TEST_LOOP_CLOCKS per pass of the
+* receive loop and a host answering every frame at once. No update was
+* timed on a NV32 with a real host.
+*
+******************************************************************************/
+#include "NV32.h"
+#include "NV32_boot.h"
+#include "NV32_flash.h"
+#include "host.h"
+
+#define TEST_PORT               1
+#define TEST_FRAME_HEAD         6               /* SOF, type, sequence, length */
+#define TEST_IMAGE_SIZE         ( 4096 + 36 )   /* the last DATA frame short */
+#define TEST_LOOP_CLOCKS        40              /* a pass of the BOOT_Receive loop */
+#define TEST_BLOCKS             ( ( TEST_IMAGE_SIZE + BOOT_BLOCK_SIZE - 1 ) / BOOT_BLOCK_SIZE )
+#define TEST_BAD_BLOCK          5               /* sent once with a wrong CRC */
+
+static uint8_t  TEST_au8Image[TEST_IMAGE_SIZE];
+static uint8_t  TEST_au8Reply[TEST_FRAME_HEAD + 16 + 2];
+static uint32_t TEST_u32Got;
+static uint16_t TEST_u16Acked;
+static uint16_t TEST_u16Sent;
+static uint8_t  TEST_bStarted;
+static uint8_t  TEST_bCorrupted;
+static uint32_t TEST_u32Naks;
+static uint32_t TEST_u32BadReplies;
+static uint8_t  TEST_au8Stats[14];
+static uint8_t  TEST_bEnd;
+
+void UART1_Isr( void );
+
+/* the application glue of startup_NV32.s, as in Application/main.c */
+void UART1_IRQHandler( void )
+{
+  UART1_Isr( );
+}
+
+static uint16_t TEST_Crc16( const uint8_t * pData, uint32_t u32Length )
+{
+  uint16_t u16Crc = 0xFFFF;
+  uint32_t i;
+
+  while ( u32Length-- )
+  {
+    u16Crc ^= ( uint16_t )( *pData++ << 8 );
+
+    for ( i = 0; i < 8; i++ )
+      u16Crc = ( u16Crc & 0x8000 ) ? ( uint16_t )( ( u16Crc << 1 ) ^ 0x1021 ) : ( uint16_t )( u16Crc << 1 );
+  }
+
+  return u16Crc;
+}
+
+static uint32_t TEST_Crc32( const uint8_t * pData, uint32_t u32Length )
+{
+  uint32_t u32Crc = 0xFFFFFFFF;
+  uint32_t i;
+
+  while ( u32Length-- )
+  {
+    u32Crc ^= *pData++;
+
+    for ( i = 0; i < 8; i++ )
+      u32Crc = ( u32Crc & 1 ) ? ( u32Crc >> 1 ) ^ 0xEDB88320 : u32Crc >> 1;
+  }
+
+  return ~u32Crc;
+}
+
+static void TEST_Put32( uint8_t * pData, uint32_t u32Value )
+{
+  pData[0] = ( uint8_t )u32Value;
+  pData[1] = ( uint8_t )( u32Value >> 8 );
+  pData[2] = ( uint8_t )( u32Value >> 16 );
+  pData[3] = ( uint8_t )( u32Value >> 24 );
+}
+
+static void TEST_Frame( uint8_t u8Type, uint16_t u16Seq, const uint8_t * pData, uint16_t u16Length, uint8_t bCorrupt )
+{
+  uint8_t au8Frame[TEST_FRAME_HEAD + BOOT_BLOCK_SIZE + 2];
+  uint16_t u16Crc;
+
+  au8Frame[0] = 0xA5;
+  au8Frame[1] = u8Type;
+  au8Frame[2] = ( uint8_t )u16Seq;
+  au8Frame[3] = ( uint8_t )( u16Seq >> 8 );
+  au8Frame[4] = ( uint8_t )u16Length;
+  au8Frame[5] = ( uint8_t )( u16Length >> 8 );
+  memcpy( &au8Frame[TEST_FRAME_HEAD], pData, u16Length );
+  u16Crc = TEST_Crc16( &au8Frame[1], TEST_FRAME_HEAD - 1 + u16Length ) ^ ( bCorrupt ? 1 : 0 );
+  au8Frame[TEST_FRAME_HEAD + u16Length]     = ( uint8_t )( u16Crc >> 8 );
+  au8Frame[TEST_FRAME_HEAD + u16Length + 1] = ( uint8_t )u16Crc;
+  HOST_UartSend( TEST_PORT, au8Frame, TEST_FRAME_HEAD + u16Length + 2 );
+}
+
+/* the DATA frames the window allows, then END */
+static void TEST_Stream( void )
+{
+  uint32_t u32Offset;
+  uint16_t u16Length;
+  uint8_t bCorrupt;
+
+  while ( TEST_u16Sent < TEST_BLOCKS && TEST_u16Sent < TEST_u16Acked + BOOT_WINDOW )
+  {
+    u32Offset = ( uint32_t )TEST_u16Sent * BOOT_BLOCK_SIZE;
+    u16Length = ( uint16_t )( TEST_IMAGE_SIZE - u32Offset < BOOT_BLOCK_SIZE ? TEST_IMAGE_SIZE - u32Offset : BOOT_BLOCK_SIZE );
+    bCorrupt = ( TEST_u16Sent == TEST_BAD_BLOCK ) && !TEST_bCorrupted;
+    TEST_bCorrupted |= bCorrupt;
+    TEST_Frame( BOOT_FRAME_DATA, TEST_u16Sent, &TEST_au8Image[u32Offset], u16Length, bCorrupt );
+    TEST_u16Sent++;
+  }
+
+  if ( TEST_u16Acked == TEST_BLOCKS && !TEST_bEnd )
+  {
+    TEST_bEnd = 1;
+    TEST_Frame( BOOT_FRAME_END, TEST_u16Sent, NULL, 0, 0 );
+  }
+}
+
+/* the host: a reply of the target complete, answer it */
+static void TEST_Reply( void )
+{
+  uint8_t au8Start[12];
+  uint16_t u16Seq = ( uint16_t )( TEST_au8Reply[2] | ( TEST_au8Reply[3] << 8 ) );
+  uint8_t u8Length = TEST_au8Reply[4];
+
+  if ( TEST_au8Reply[1] == BOOT_FRAME_NAK )
+  {
+    TEST_u32Naks++;
+    TEST_u16Acked = u16Seq;
+    TEST_u16Sent = u16Seq;
+    TEST_Stream( );
+  }
+  else if ( u8Length == 8 )
+  {
+    /* HELLO answered, the image is linked for the slot it names */
+    HOST_CHECK( TEST_au8Reply[TEST_FRAME_HEAD] == BOOT_SLOT_A );
+    TEST_Put32( &au8Start[0], TEST_IMAGE_SIZE );
+    TEST_Put32( &au8Start[4], TEST_Crc32( TEST_au8Image, TEST_IMAGE_SIZE ) );
+    TEST_Put32( &au8Start[8], BOOT_SLOT_A_ADDRESS );
+    TEST_Frame( BOOT_FRAME_START, 0, au8Start, sizeof( au8Start ), 0 );
+  }
+  else if ( u8Length == 14 )
+  {
+    memcpy( TEST_au8Stats, &TEST_au8Reply[TEST_FRAME_HEAD], sizeof( TEST_au8Stats ) );
+  }
+  else if ( !TEST_bStarted )
+  {
+    /* START answered, the slot erased */
+    TEST_bStarted = 1;
+    TEST_Stream( );
+  }
+  else
+  {
+    if ( ( uint16_t )( u16Seq + 1 - TEST_u16Acked ) <= BOOT_WINDOW )
+      TEST_u16Acked = u16Seq + 1;
+
+    TEST_Stream( );
+  }
+}
+
+static void TEST_UartTx( uint8_t u8Port, uint8_t u8Data )
+{
+  uint16_t u16Crc;
+
+  if ( u8Port != TEST_PORT || ( TEST_u32Got == 0 && u8Data != 0xA5 ) )
+    return;
+
+  TEST_au8Reply[TEST_u32Got++] = u8Data;
+
+  if ( TEST_u32Got < TEST_FRAME_HEAD || TEST_u32Got < TEST_FRAME_HEAD + TEST_au8Reply[4] + 2u )
+    return;
+
+  u16Crc = TEST_Crc16( &TEST_au8Reply[1], TEST_u32Got - 3 );
+  TEST_u32Got = 0;
+
+  if ( TEST_au8Reply[TEST_FRAME_HEAD + TEST_au8Reply[4]] != ( uint8_t )( u16Crc >> 8 ) ||
+       TEST_au8Reply[TEST_FRAME_HEAD + TEST_au8Reply[4] + 1] != ( uint8_t )u16Crc )
+  {
+    TEST_u32BadReplies++;
+    return;
+  }
+
+  TEST_Reply( );
+}
+
+static void TEST_Hello( void * pArg )
+{
+  TEST_Frame( BOOT_FRAME_HELLO, 0, NULL, 0, 0 );
+}
+
+static uint32_t TEST_Get32( const uint8_t * pData )
+{
+  return pData[0] | ( ( uint32_t )pData[1] << 8 ) | ( ( uint32_t )pData[2] << 16 ) | ( ( uint32_t )pData[3] << 24 );
+}
+
+int main( void )
+{
+  UART_ConfigType sUart = { { 0 } };
+  BOOT_StatsType sStats;
+  uint64_t u64Start;
+  uint32_t u32Seed = 1;
+  uint32_t u32Access = HOST_u32AccessClocks;
+  uint32_t u32Us;
+  uint32_t i;
+  uint8_t bDone;
+
+  HOST_Init( );
+
+  if ( HOST_BOOT( ) )
+    return HOST_Exit( );
+
+  SystemInit( );
+  SystemCoreClockUpdate( );
+  Flash_Init( );
+
+  /* a vector table for slot A, the rest random */
+  for ( i = 0; i < TEST_IMAGE_SIZE; i++ )
+  {
+    u32Seed = u32Seed * 1103515245 + 12345;
+    TEST_au8Image[i] = ( uint8_t )( u32Seed >> 16 );
+  }
+
+  TEST_Put32( &TEST_au8Image[0], 0x20001000 );
+  TEST_Put32( &TEST_au8Image[4], BOOT_SLOT_A_ADDRESS + 0x101 );
+
+  sUart.u32SysClkHz = SystemClockGet( CLOCK_BUS );
+  sUart.u32Baudrate = BOOT_BAUDRATE;
+  UART_Init( UART1, &sUart );
+  HOST_UartSetTx( TEST_PORT, TEST_UartTx );
+  HOST_Schedule( HOST_u64Clock + HOST_CoreHz( ) / 1000, TEST_Hello, NULL );
+
+  /* the loop reads the SysTick once a pass, charge the whole pass to it */
+  HOST_u32AccessClocks = TEST_LOOP_CLOCKS;
+  u64Start = HOST_u64Ps;
+  bDone = BOOT_Receive( UART1, 100, &sStats );
+  u32Us = ( uint32_t )( ( HOST_u64Ps - u64Start ) / 1000000 );
+  HOST_u32AccessClocks = u32Access;
+  UART_WaitTxComplete( UART1 );
+
+  HOST_CHECK( bDone && TEST_u32BadReplies == 0 );
+  HOST_CHECK( memcmp( HOST_Flash( BOOT_SLOT_A_ADDRESS ), TEST_au8Image, TEST_IMAGE_SIZE ) == 0 );
+  /* the corrupted frame asked again once */
+  HOST_CHECK( TEST_bCorrupted && sStats.u16Naks == 1 && TEST_u32Naks == 1 );
+  HOST_CHECK( sStats.u32Bytes == TEST_IMAGE_SIZE && TEST_Get32( &TEST_au8Stats[0] ) == TEST_IMAGE_SIZE );
+  HOST_CHECK( TEST_Get32( &TEST_au8Stats[8] ) == sStats.u32BytesPerSec );
+
+  /* the DATA frames at the line rate bound it, 10 bits a character */
+  HOST_CHECK( sStats.u32BytesPerSec < BOOT_BAUDRATE / 10 * BOOT_BLOCK_SIZE / ( TEST_FRAME_HEAD + BOOT_BLOCK_SIZE + 2 ) );
+  HOST_CHECK( sStats.u32BytesPerSec > BOOT_BAUDRATE / 10 / 2 );
+  printf( "%u bytes at %u baud: %u bytes/s, %u NAK, session %u us\n", ( unsigned )sStats.u32Bytes,
+          ( unsigned )BOOT_BAUDRATE, ( unsigned )sStats.u32BytesPerSec, ( unsigned )sStats.u16Naks,
+          ( unsigned )u32Us );
+
+  /* the new image is pending, started and counted */
+  HOST_CHECK( BOOT_Select( ) == BOOT_SLOT_A );
+
+  return HOST_Exit( );
+}